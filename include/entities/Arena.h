@@ -0,0 +1,90 @@
+/**
+ * @file Arena.h
+ * @brief Définit les arènes, les réserves de blocs de taille fixe et les compteurs d'allocations du serveur.
+ *
+ * Le serveur n'alloue plus sur le tas dans ses chemins fréquents (journalisation d'un changement d'état, réponse à
+ * une demande de repas, instantané) :
+ *  - une **arène** est un tampon alloué une seule fois, découpé par simple avancée d'un index et remis à zéro d'un
+ *    coup à la fin d'un lot de requêtes ; chaque thread a son arène de travail (voir getScratchArena()) ;
+ *  - une **réserve de blocs** (slab) fournit des blocs d'une taille fixe pris dans un tableau alloué une seule fois
+ *    et chaînés entre eux quand ils sont rendus : chemins des fichiers de log, sessions des threads de logs.
+ *
+ * Les allocations restantes sur le tas passent par countedMalloc(), qui les compte dans `AllocationStats`. Ces
+ * compteurs sont en mémoire partagée et affichés par la commande de contrôle `stats` : une fois les philosophes
+ * attablés, le nombre d'allocations sur le tas ne doit plus bouger tandis que les repas augmentent.
+ *
+ * Les structures définies sont :
+ *  - **Arena** : Tampon découpé par avancée d'un index.
+ *  - **SlabPool** : Réserve de blocs de taille fixe.
+ *  - **AllocationStats** : Compteurs d'allocations.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "../maxmin_philosophers.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <pthread.h>
+
+/**
+ * @brief Taille de l'arène de travail de chaque thread : de quoi formater un log, copier la table et en coder un
+ * instantané.
+ */
+#define SCRATCH_ARENA_SIZE (16384 + 64 * MAX_PHILOSOPHERS)
+
+/**
+ * @brief Alignement des blocs rendus par une arène.
+ */
+#define ARENA_ALIGNMENT _Alignof(max_align_t)
+
+/**
+ * @brief Nombre de chemins de fichiers de log pouvant être tenus en même temps.
+ */
+#define PATH_SLAB_BLOCKS 8
+
+/**
+ * @brief Nombre de sessions de threads de logs (un par client, plus celui du serveur) tenues sans allocation.
+ */
+#define SESSION_SLAB_BLOCKS (MAX_PHILOSOPHERS + 1)
+
+/**
+ * @brief Tampon découpé par avancée d'un index.
+ */
+typedef struct {
+    uint8_t *base;    /**< Début du tampon, NULL tant que l'arène n'est pas initialisée */
+    size_t capacity;  /**< Taille du tampon */
+    size_t used;      /**< Octets déjà distribués */
+    size_t highWater; /**< Plus grand nombre d'octets distribués entre deux remises à zéro */
+} Arena;
+
+/**
+ * @brief Réserve de blocs de taille fixe.
+ *
+ * Les blocs rendus sont chaînés par leurs premiers octets. Les blocs jamais distribués ne sont pas chaînés : ils
+ * sont pris dans l'ordre du tableau (`carved`), dont les pages ne sont ainsi touchées qu'à leur première utilisation.
+ * Une réserve épuisée se rabat sur le tas (compté dans `slabFallbacks`) : le bloc est reconnu à sa libération par
+ * son adresse, hors du tableau de la réserve.
+ */
+typedef struct {
+    uint8_t *storage;       /**< Tableau des blocs */
+    size_t blockSize;       /**< Taille d'un bloc, arrondie à ARENA_ALIGNMENT */
+    size_t blockCount;      /**< Nombre de blocs du tableau */
+    size_t carved;          /**< Nombre de blocs du tableau déjà distribués au moins une fois */
+    void *freeList;         /**< Premier bloc rendu */
+    pthread_mutex_t lock;   /**< Protège la liste des blocs libres (threads de logs et thread principal) */
+} SlabPool;
+
+/**
+ * @brief Compteurs d'allocations, tenus en mémoire partagée pour tous les processus du serveur.
+ */
+typedef struct {
+    uint64_t heapAllocations;  /**< Allocations sur le tas faites par le serveur (countedMalloc()) */
+    uint64_t arenaAllocations; /**< Blocs distribués par les arènes */
+    uint64_t slabAllocations;  /**< Blocs distribués par les réserves */
+    uint64_t slabFallbacks;    /**< Réserve épuisée, bloc alloué sur le tas (aussi compté dans heapAllocations) */
+    uint64_t arenaHighWater;   /**< Plus grande occupation d'une arène de travail, en octets */
+} AllocationStats;
+
+#endif
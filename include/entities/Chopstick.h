@@ -6,7 +6,8 @@
  *
  * La structure `Chopstick` comporte :
  *  - un entier `id` servant d'identifiant unique pour la baguette,
- *  - un sémaphore `usage` (de type `sem_t`) utilisé pour gérer l'accès concurrent à la baguette.
+ *  - un sémaphore `usage` (de type `sem_t`) utilisé pour gérer l'accès concurrent à la baguette,
+ *  - un entier `holderId` indiquant le philosophe qui tient la baguette (0 si elle est libre).
  *
  * L'inclusion de l'en-tête `<semaphore.h>` est nécessaire pour la gestion des sémaphores.
  *
@@ -30,6 +31,7 @@ typedef struct {
 
     int id;        /**< Identifiant de la baguette */
     sem_t usage;   /**< Semaphore pour l'utilisation de la baguette */
+    int holderId;  /**< Identifiant du philosophe qui tient la baguette, 0 si elle est libre */
 
 } Chopstick;
 
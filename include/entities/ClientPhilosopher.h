@@ -10,6 +10,7 @@
  *  - `base` : de type `Philosopher`, représentant les attributs et comportements de base d'un philosophe.
  *  - `thread` : de type `pthread_t`, représentant le thread d'exécution associé au philosophe.
  *  - `clientSocket` : de type `Socket`, utilisé pour gérer la communication entre le philosophe et le serveur.
+ *  - `token` et `sequence` : jeton de session et dernier numéro de séquence, en mode datagramme (voir Datagram.h).
  *
  * Les inclusions nécessaires pour ce fichier d'en-tête sont :
  *  - "Philosopher.h" pour la définition de la structure `Philosopher`.
@@ -28,6 +29,7 @@
 #include "Philosopher.h"
 #include "../utils/sockets.h"
 #include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 
 /**
@@ -47,10 +49,20 @@ typedef struct {
     pthread_t thread;
 
     /**
-     * Socket client associé au philosophe
+     * Socket client associé au philosophe (UDP en mode datagramme)
      */
     Socket clientSocket;
 
+    /**
+     * Jeton de session en mode datagramme (voir Datagram.h), 0 en mode TCP
+     */
+    uint64_t token;
+
+    /**
+     * Dernier numéro de séquence envoyé en mode datagramme
+     */
+    uint32_t sequence;
+
 } ClientPhilosopher;
 
 #endif
\ No newline at end of file
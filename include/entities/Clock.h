@@ -0,0 +1,68 @@
+/**
+ * @file Clock.h
+ * @brief Définit l'horloge à haute résolution qui horodate les logs, les repas et les histogrammes du serveur.
+ *
+ * Un appel à clock_gettime() coûte quelques dizaines de nanosecondes même servi par le vDSO : trop pour horodater
+ * chaque message de log et chaque événement des histogrammes. Sur les processeurs x86 dont le compteur de cycles
+ * (TSC) est invariant (fréquence constante, commun à tous les cœurs), l'horloge lit donc ce compteur, en quelques
+ * nanosecondes, et le convertit en nanosecondes CLOCK_MONOTONIC par un étalonnage :
+ *
+ *     heure = monotonicBase + ((tsc - tscBase) * multiplier) >> CLOCK_SHIFT
+ *
+ * Ailleurs (autre architecture, machine virtuelle qui masque le TSC invariant, ou compilation avec CLOCK_NO_TSC),
+ * elle lit CLOCK_MONOTONIC, servie par le vDSO sans appel système.
+ *
+ * L'étalonnage est fait par le processus principal au démarrage, et conservé en mémoire partagée (voir
+ * SharedResources.h) : tous les processus et tous les threads convertissent le même compteur avec les mêmes
+ * paramètres, leurs heures sont comparables. Elles le sont aussi avec celles d'un processus qui lit CLOCK_MONOTONIC,
+ * à l'erreur d'étalonnage près (une heure TSC est ancrée sur CLOCK_MONOTONIC). Le thread de compactage ré-ancre
+ * l'étalonnage toutes les CLOCK_RECALIBRATION_INTERVAL_MS, pour suivre les corrections de CLOCK_MONOTONIC par NTP
+ * et de l'écart avec l'heure murale ; un ré-ancrage ne fait jamais reculer l'horloge.
+ *
+ * Les heures restent monotones en nanosecondes : elles ne sont converties en heure murale (`realtimeOffset`) qu'à
+ * l'affichage, par exemple à l'écriture d'un message dans son fichier de log.
+ *
+ * Les structures définies sont :
+ *  - **ClockCalibration** : Étalonnage du compteur de cycles, en mémoire partagée.
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Durée de la mesure d'étalonnage au démarrage, en millisecondes.
+ */
+#define CLOCK_CALIBRATION_MS 20
+
+/**
+ * @brief Intervalle entre deux ré-ancrages de l'étalonnage, en millisecondes.
+ */
+#define CLOCK_RECALIBRATION_INTERVAL_MS 10000
+
+/**
+ * @brief Décalage binaire du multiplicateur de conversion des cycles en nanosecondes.
+ */
+#define CLOCK_SHIFT 32
+
+/**
+ * @brief Étalonnage du compteur de cycles.
+ *
+ * Les champs sont protégés par `sequence`, impair pendant un ré-ancrage : un lecteur qui lit une séquence impaire,
+ * ou différente avant et après sa lecture, recommence.
+ */
+typedef struct {
+    uint32_t sequence;        /**< Version de l'étalonnage, impaire pendant une mise à jour */
+    bool useTimestampCounter; /**< Le compteur de cycles est invariant et étalonné ; sinon CLOCK_MONOTONIC est lue */
+    uint64_t tscBase;         /**< Compteur de cycles à l'ancrage */
+    uint64_t monotonicBase;   /**< Heure CLOCK_MONOTONIC (ns) à l'ancrage */
+    uint64_t multiplier;      /**< Nanosecondes par cycle, multipliées par 2^CLOCK_SHIFT */
+    uint64_t tscOrigin;       /**< Compteur de cycles au premier étalonnage, pour affiner la fréquence */
+    uint64_t monotonicOrigin; /**< Heure CLOCK_MONOTONIC (ns) au premier étalonnage */
+    int64_t realtimeOffset;   /**< Écart entre CLOCK_REALTIME et CLOCK_MONOTONIC (ns) au dernier ancrage */
+    uint64_t frequency;       /**< Fréquence mesurée du compteur de cycles, en Hz (0 sans compteur de cycles) */
+} ClockCalibration;
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file Compaction.h
+ * @brief Définit le compactage en ligne des places de la table.
+ *
+ * Les places des philosophes partis ne sont pas réutilisées : sans compactage, les parcours de la table (instantanés,
+ * abonnements, commandes de contrôle, recherche des voisins) coûteraient autant que le plus grand nombre de places
+ * jamais occupées, même une fois la table presque vide. Le thread de compactage du processus principal (voir
+ * Compaction.c) déplace donc périodiquement les places encore occupées vers le début des tableaux, dans leur ordre
+ * (qui est celui de l'anneau), et ramène `numberPhilosophers` au nombre de places restantes.
+ *
+ * Un philosophe garde son identifiant lorsqu'il change de place : la table de renvoi `seatSlots` de SharedResources
+ * donne la place courante de chaque identifiant. La baguette gauche de la place la suit, à la même position du
+ * tableau des baguettes.
+ *
+ * Le compactage ne se fait que dans les moments calmes : il lui faut le sémaphore de création et le verrou de la
+ * politique en écriture, pris sans attendre (aucune arrivée, aucun départ ni aucune prise de baguettes en cours).
+ * Une place n'est de plus déplacée que si personne ne la tient (`pins`, voir pinPhilosopher()) et que sa baguette
+ * est libre. Une place qui ne peut pas bouger reste où elle est, et les suivantes se tassent derrière elle ; les
+ * positions restées libres devant elle deviennent des places vides (identifiant 0, marquées parties), reprises au
+ * passage suivant.
+ *
+ * Une place quittée n'est effacée qu'après COMPACTION_DEPARTED_GRACE_MS, pour que les abonnés et les outils
+ * d'observation aient le temps de voir le départ.
+ *
+ * Chaque passage, comme chaque échange de places (voir Migration.h), incrémente `epoch` deux fois (impair pendant le
+ * passage) et la version de la table : un lecteur sans verrou, comme l'instantané, sait que des places ont bougé
+ * pendant sa copie.
+ *
+ * Les structures définies sont :
+ *  - **CompactionStats** : Compteurs du compactage, en mémoire partagée.
+ */
+
+#ifndef COMPACTION_H
+#define COMPACTION_H
+
+#include <stdint.h>
+
+/**
+ * @brief Intervalle entre deux tentatives de compactage, en millisecondes.
+ */
+#define COMPACTION_INTERVAL_MS 500
+
+/**
+ * @brief Délai au bout duquel la place d'un philosophe parti peut être effacée, en millisecondes.
+ */
+#define COMPACTION_DEPARTED_GRACE_MS 2000
+
+/**
+ * @brief Valeur de `pins` d'une place en cours de déplacement : elle ne peut pas être tenue.
+ */
+#define SEAT_MOVING UINT32_MAX
+
+/**
+ * @brief Compteurs du compactage.
+ */
+typedef struct {
+    uint64_t epoch;          /**< Incrémenté au début et à la fin de chaque passage : impair pendant un passage */
+    uint64_t passes;         /**< Passages effectués */
+    uint64_t skippedPasses;  /**< Tentatives abandonnées faute de moment calme */
+    uint64_t movedSeats;     /**< Places déplacées */
+    uint64_t droppedSeats;   /**< Places de philosophes partis effacées */
+} CompactionStats;
+
+#endif
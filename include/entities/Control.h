@@ -0,0 +1,60 @@
+/**
+ * @file Control.h
+ * @brief Définit les constantes et structures du socket de contrôle du serveur.
+ *
+ * Le serveur écoute, en plus du port des clients, un socket Unix local sur lequel un opérateur peut envoyer des
+ * commandes texte (voir l'outil `control`) : consulter les statistiques, changer le niveau de logs, la capacité
+ * de la table ou la politique d'arbitrage, mettre à l'écart ou évincer un philosophe, écrire un point de reprise, régler le registre des repas.
+ * Chaque connexion porte une seule commande, terminée par un retour à la ligne ; le serveur répond en texte puis
+ * ferme la connexion.
+ *
+ * Les macros définies sont :
+ *  - **CONTROL_SOCKET_PATH** : Chemin du socket de contrôle.
+ *  - **CONTROL_BUFFER_SIZE** : Taille maximale d'une commande.
+ *  - **CONTROL_REPLY_SIZE** : Taille maximale d'une réponse.
+ *  - **CONTROL_MAX_CONNECTIONS** : Nombre maximum de connexions de contrôle en cours de lecture.
+ *  - **CHECKPOINT_PATH** : Chemin du fichier de point de reprise.
+ *
+ * La structure **ControlConnection** représente une connexion de contrôle dont la commande est en cours de lecture.
+ */
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <stddef.h>
+
+/**
+ * @brief Chemin du socket de contrôle (relatif au dossier src).
+ */
+#define CONTROL_SOCKET_PATH "../logs/server.ctl"
+
+/**
+ * @brief Taille maximale d'une commande.
+ */
+#define CONTROL_BUFFER_SIZE 256
+
+/**
+ * @brief Taille maximale d'une réponse.
+ */
+#define CONTROL_REPLY_SIZE 4096
+
+/**
+ * @brief Nombre maximum de connexions de contrôle en cours de lecture.
+ */
+#define CONTROL_MAX_CONNECTIONS 4
+
+/**
+ * @brief Chemin du fichier de point de reprise (relatif au dossier src).
+ */
+#define CHECKPOINT_PATH "../logs/server.checkpoint"
+
+/**
+ * @brief Connexion de contrôle dont la commande est en cours de lecture.
+ */
+typedef struct {
+    int socket;                         /**< Socket de la connexion */
+    char buffer[CONTROL_BUFFER_SIZE];   /**< Commande reçue jusqu'ici */
+    size_t length;                      /**< Nombre d'octets reçus */
+} ControlConnection;
+
+#endif
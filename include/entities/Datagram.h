@@ -0,0 +1,87 @@
+/**
+ * @file Datagram.h
+ * @brief Définit les messages du mode datagramme, transport UDP optionnel des philosophes.
+ *
+ * En mode datagramme (option DATAGRAM_OPTION du client), un philosophe n'ouvre pas de connexion TCP : il échange
+ * des datagrammes `Datagram` avec le service datagramme du serveur, un seul processus qui sert tous ces philosophes
+ * depuis un seul socket UDP, sur le même port que le socket d'écoute TCP.
+ *
+ * Déroulement d'une session :
+ *  - Le client envoie DATAGRAM_CREATE avec un nombre aléatoire dans `sequence`, et le renvoie toutes les
+ *    DATAGRAM_RETRY_INTERVAL ms tant qu'il n'a pas de réponse (le serveur reconnaît les doublons à ce nombre).
+ *    Le serveur répond DATAGRAM_CREATED avec le philosophe et le jeton de session, ou DATAGRAM_REFUSED.
+ *  - Chaque datagramme suivant du client porte ce jeton et un numéro de séquence croissant : le serveur ignore les
+ *    datagrammes en retard ou dupliqués.
+ *  - Les mises à jour THINKING et EATING ne sont pas acquittées : le client renvoie son état chaque seconde, une
+ *    mise à jour perdue est donc réparée par la suivante.
+ *  - Une demande HUNGRY est acquittée aussitôt (DATAGRAM_ACK) puis accordée par DATAGRAM_GRANT, que le serveur renvoie
+ *    toutes les DATAGRAM_RETRANSMIT_INTERVAL ms jusqu'à l'acquittement du client (DATAGRAM_ACK, ou tout datagramme
+ *    de séquence plus récente). Le client renvoie sa demande s'il n'a pas de nouvelles du serveur.
+ *  - DATAGRAM_LEAVE retire le philosophe de la table. Sans nouvelles d'un client pendant DATAGRAM_SESSION_TIMEOUT
+ *    ms, le serveur retire aussi son philosophe. Un datagramme dont le jeton n'est plus valide (philosophe évincé ou
+ *    retiré) reçoit DATAGRAM_REFUSED.
+ *
+ * Les macros définies sont :
+ *  - **DATAGRAM_OPTION** : Option du client activant le mode datagramme.
+ *  - **DATAGRAM_BATCH** : Nombre de datagrammes reçus ou envoyés en un seul appel système.
+ *  - **DATAGRAM_RETRANSMIT_INTERVAL** : Délai avant de renvoyer une autorisation non acquittée.
+ *  - **DATAGRAM_RETRY_INTERVAL** : Délai avant que le client ne renvoie une demande restée sans nouvelles.
+ *  - **DATAGRAM_SESSION_TIMEOUT** : Silence au-delà duquel le philosophe d'un client est retiré de la table.
+ */
+
+#ifndef DATAGRAM_H
+#define DATAGRAM_H
+
+#include "Philosopher.h"
+#include <stdint.h>
+
+/**
+ * @brief Option du client activant le mode datagramme.
+ */
+#define DATAGRAM_OPTION "--udp"
+
+/**
+ * @brief Nombre de datagrammes reçus (recvmmsg) ou envoyés (sendmmsg) en un seul appel système.
+ */
+#define DATAGRAM_BATCH 64
+
+/**
+ * @brief Délai avant de renvoyer une autorisation de manger non acquittée, en millisecondes.
+ */
+#define DATAGRAM_RETRANSMIT_INTERVAL 200
+
+/**
+ * @brief Délai avant que le client ne renvoie une création ou une demande restée sans nouvelles, en millisecondes.
+ */
+#define DATAGRAM_RETRY_INTERVAL 1000
+
+/**
+ * @brief Silence au-delà duquel le philosophe d'un client est retiré de la table, en millisecondes.
+ */
+#define DATAGRAM_SESSION_TIMEOUT 5000
+
+/**
+ * @brief Types de datagrammes.
+ */
+typedef enum {
+    DATAGRAM_CREATE,  /**< Client : création d'un philosophe, `sequence` porte un nombre aléatoire */
+    DATAGRAM_CREATED, /**< Serveur : philosophe créé, `token` porte le jeton de session */
+    DATAGRAM_REFUSED, /**< Serveur : création refusée, ou jeton inconnu */
+    DATAGRAM_UPDATE,  /**< Client : nouvel état du philosophe */
+    DATAGRAM_ACK,     /**< Acquittement de la séquence `sequence` (demande reçue, ou autorisation reçue) */
+    DATAGRAM_GRANT,   /**< Serveur : autorisation de manger, en réponse à la demande de séquence `sequence` */
+    DATAGRAM_LEAVE    /**< Client : le philosophe quitte la table */
+} DatagramType;
+
+/**
+ * @brief Datagramme échangé en mode datagramme.
+ */
+typedef struct {
+    uint64_t token;          /**< Jeton de session, 0 pour DATAGRAM_CREATE */
+    uint32_t sequence;       /**< Numéro de séquence du client */
+    uint32_t type;           /**< Type du datagramme (DatagramType) */
+    Philosopher philosopher; /**< État du philosophe */
+    uint32_t reserved;       /**< Réservé, toujours 0 */
+} Datagram;
+
+#endif
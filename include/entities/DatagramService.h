@@ -0,0 +1,102 @@
+/**
+ * @file DatagramService.h
+ * @brief Définit les sessions et l'état du service datagramme du serveur.
+ *
+ * Le service datagramme est un processus de service unique qui sert tous les philosophes en mode datagramme (voir
+ * Datagram.h) depuis un seul socket UDP. Sa boucle principale ne bloque jamais sur la table : elle vide le socket
+ * par lots avec recvmmsg(), applique aussitôt les mises à jour THINKING et EATING (qui ne font que libérer des
+ * sémaphores), et répond par lots avec sendmmsg().
+ *
+ * Les opérations qui peuvent attendre (création, demande de repas, départ de la table) sont confiées à la réserve
+ * élastique de threads du service (voir WorkerPool.h), qui les exécute avec les mêmes fonctions que les processus de
+ * service TCP. Une fois l'opération terminée, la session est ajoutée à la liste des sessions terminées et la boucle
+ * principale est réveillée par un eventfd : elle envoie alors la réponse, avec les autres du même tour.
+ *
+ * Les renvois d'autorisations et les départs des philosophes silencieux ont chacun une échéance par session. Les
+ * sessions ouvertes sont rangées dans un tas par échéance : la boucle principale ne les examine qu'une fois
+ * l'échéance de la première passée, et son attente sur le socket s'arrête à cette échéance. Une session entendue
+ * entre-temps voit son échéance reculer sans toucher au tas : elle est recalculée quand la session arrive en tête.
+ *
+ * Les champs d'une session ne sont modifiés que par la boucle principale, sauf le résultat de l'opération en cours,
+ * écrit par le thread de la réserve qui l'exécute tant que `busy` est vrai.
+ *
+ * Les structures définies sont :
+ *  - **DatagramJob** : Opérations confiées à la réserve de threads.
+ *  - **DatagramSession** : Session d'un philosophe.
+ *  - **DatagramService** : État du service : socket, sessions et datagrammes en attente d'envoi.
+ */
+
+#ifndef DATAGRAM_SERVICE_H
+#define DATAGRAM_SERVICE_H
+
+#include "../maxmin_philosophers.h"
+#include "Datagram.h"
+#include "ServerPhilosopher.h"
+#include "SharedResources.h"
+#include "WorkerPool.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+/**
+ * @brief Opérations confiées à la réserve de threads.
+ */
+typedef enum {
+    DATAGRAM_JOB_CREATE, /**< Créer le philosophe */
+    DATAGRAM_JOB_HUNGRY, /**< Attendre l'autorisation de manger */
+    DATAGRAM_JOB_LEAVE   /**< Quitter la table */
+} DatagramJob;
+
+/**
+ * @brief Session d'un philosophe en mode datagramme.
+ */
+typedef struct {
+    bool used;                   /**< La session est ouverte */
+    uint64_t token;              /**< Jeton de session : aléatoire sur 32 bits, suivi de l'indice de la session */
+    uint32_t createNonce;        /**< Nombre aléatoire de la création, pour reconnaître ses doublons */
+    struct sockaddr_in address;  /**< Adresse du client, celle de son dernier datagramme */
+    int seatId;                  /**< Identifiant du philosophe, 0 tant que la création n'a pas abouti */
+    uint32_t lastSequence;       /**< Dernier numéro de séquence reçu */
+    uint64_t lastHeard;          /**< Heure monotone (ns) du dernier datagramme reçu */
+
+    bool busy;                   /**< Une opération est confiée à la réserve de threads */
+    DatagramJob job;             /**< L'opération en cours */
+    Philosopher jobPhilosopher;  /**< L'état demandé par le client pour l'opération */
+    uint32_t jobSequence;        /**< Séquence de la demande à l'origine de l'opération */
+    bool jobSucceeded;           /**< Résultat de l'opération, écrit par le thread qui l'exécute */
+    bool leaving;                /**< Départ demandé pendant une opération : il suivra */
+
+    bool awaitingAck;            /**< Une autorisation de manger attend son acquittement */
+    uint32_t grantSequence;      /**< Séquence de la demande accordée */
+    uint64_t grantSentAt;        /**< Heure monotone (ns) du dernier envoi de l'autorisation */
+
+    uint64_t deadline;           /**< Heure monotone (ns) du prochain examen de la session */
+    int deadlineIndex;           /**< Position de la session dans le tas des échéances, -1 si elle n'y est pas */
+} DatagramSession;
+
+/**
+ * @brief État du service datagramme.
+ */
+typedef struct {
+    int socket;                                  /**< Socket UDP */
+    int eventFd;                                 /**< Réveille la boucle principale à la fin d'une opération */
+    SharedResources *sharedResources;            /**< Ressources partagées */
+    DatagramSession sessions[MAX_PHILOSOPHERS];  /**< Sessions, une par place au plus */
+    WorkerPool pool;                             /**< Réserve de threads exécutant les opérations des sessions */
+
+    pthread_mutex_t completedLock;               /**< Protège la liste des sessions terminées */
+    int completed[MAX_PHILOSOPHERS];             /**< Indices des sessions dont l'opération est terminée */
+    int numberCompleted;                         /**< Nombre de sessions terminées */
+
+    int deadlines[MAX_PHILOSOPHERS];             /**< Tas des sessions ouvertes, la plus proche échéance en tête */
+    int numberDeadlines;                         /**< Nombre de sessions ouvertes */
+
+    Datagram outgoing[DATAGRAM_BATCH];                  /**< Datagrammes en attente d'envoi */
+    struct sockaddr_in outgoingAddresses[DATAGRAM_BATCH]; /**< Destinataire de chaque datagramme */
+    int numberOutgoing;                                 /**< Nombre de datagrammes en attente d'envoi */
+} DatagramService;
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * @file Ledger.h
+ * @brief Définit le registre des repas : le journal binaire, durable, de chaque repas accordé et terminé.
+ *
+ * Les logs texte ne sont ni durables (aucun fsync) ni complets (un msgsnd() qui échoue perd le message). Le
+ * registre, lui, consigne chaque repas accordé (LEDGER_GRANT) et chaque libération de baguettes (LEDGER_RELEASE)
+ * dans le fichier LEDGER_FILE, en ajout seul, avec un numéro de séquence continu et une somme de contrôle par
+ * enregistrement : l'outil `ledger` vérifie qu'aucun événement ne manque ni n'a été altéré.
+ *
+ * Les processus de service ne touchent pas au fichier. Ils déposent leurs événements dans un anneau en mémoire
+ * partagée (`Ledger`) : un numéro de séquence est réservé par incrément atomique, l'enregistrement est écrit dans
+ * la case correspondante, puis publié. Le thread d'écriture du processus principal se réveille toutes les
+ * `commitIntervalMs` millisecondes, écrit d'un seul write() tous les enregistrements publiés depuis son dernier
+ * passage, puis appelle fdatasync() : c'est la validation groupée. Le coût de la durabilité dépend donc du nombre
+ * de fdatasync() par seconde (au plus 1000 / commitIntervalMs), et non du nombre de repas.
+ *
+ * Attendre la durabilité est facultatif : si `syncGrants` est actif, un repas n'est annoncé au client qu'une fois
+ * son enregistrement sur disque ; sinon le repas est annoncé aussitôt et sera durable au plus tard à la validation
+ * suivante. Les deux réglages se changent à chaud avec la commande de contrôle `ledger`.
+ *
+ * Si le fichier ne peut pas être ouvert ou écrit, le registre est désactivé (avertissement du serveur) : les repas
+ * continuent d'être servis, sans être consignés.
+ *
+ * Format du fichier : un en-tête `LedgerFileHeader`, puis des `LedgerRecord` de taille fixe. Un arrêt brutal
+ * pendant une écriture peut laisser un enregistrement tronqué en fin de fichier : il est retiré à la réouverture.
+ *
+ * Les structures définies sont :
+ *  - **LedgerFileHeader** : En-tête du fichier.
+ *  - **LedgerRecord** : Enregistrement d'un événement.
+ *  - **LedgerSlot** : Case de l'anneau.
+ *  - **Ledger** : Anneau et état de la validation, en mémoire partagée.
+ *  - **LedgerWriter** : État du thread d'écriture.
+ */
+
+#ifndef LEDGER_H
+#define LEDGER_H
+
+#include "../maxmin_philosophers.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Chemin du registre des repas (relatif au dossier src).
+ */
+#define LEDGER_FILE "../logs/meals.ledger"
+
+/**
+ * @brief Signature identifiant un registre ("LDGR" en petit-boutiste).
+ */
+#define LEDGER_MAGIC 0x5247444C
+
+/**
+ * @brief Version du format du registre.
+ */
+#define LEDGER_VERSION 2
+
+/**
+ * @brief Nombre de cases de l'anneau (puissance de 2). Un processus de service attend si l'anneau est plein.
+ */
+#define LEDGER_RING_SIZE 1024
+
+/**
+ * @brief Intervalle de validation par défaut, en millisecondes.
+ */
+#define LEDGER_DEFAULT_COMMIT_INTERVAL_MS 10
+
+/**
+ * @brief Intervalle de validation maximal, en millisecondes.
+ */
+#define LEDGER_MAX_COMMIT_INTERVAL_MS 10000
+
+/**
+ * @brief Délai au bout duquel une case réservée mais jamais publiée est sautée (processus tué pendant l'écriture).
+ */
+#define LEDGER_HOLE_TIMEOUT_MS 1000
+
+/**
+ * @brief Types d'événements du registre.
+ */
+typedef enum {
+    LEDGER_GRANT = 1,   /**< Repas accordé : le philosophe tient ses deux baguettes */
+    LEDGER_RELEASE = 2, /**< Repas terminé : les baguettes sont rendues */
+    LEDGER_HOLE = 3,    /**< Séquence réservée mais jamais publiée, l'événement est perdu */
+    LEDGER_OPEN = 4     /**< Nouvelle table : les repas en cours lors de l'arrêt précédent ne seront jamais terminés */
+} LedgerEventType;
+
+/**
+ * @brief En-tête du registre.
+ */
+typedef struct {
+    uint32_t magic;      /**< LEDGER_MAGIC */
+    uint32_t version;    /**< LEDGER_VERSION */
+    uint32_t recordSize; /**< sizeof(LedgerRecord) */
+    uint32_t reserved;
+} LedgerFileHeader;
+
+/**
+ * @brief Enregistrement d'un événement (40 octets).
+ */
+typedef struct {
+    uint64_t sequence;       /**< Numéro de séquence, continu dans tout le fichier */
+    uint64_t timestamp;      /**< Heure de l'événement, en nanosecondes depuis l'epoch */
+    int32_t philosopherId;   /**< Philosophe concerné */
+    uint32_t leftChopstick;  /**< Baguette gauche prise ou rendue */
+    uint32_t rightChopstick; /**< Baguette droite prise ou rendue */
+    uint16_t type;           /**< LedgerEventType */
+    uint16_t reserved[3];    /**< Réservé, toujours 0 : aligne l'enregistrement sur 8 octets */
+    uint32_t checksum;       /**< CRC-32 des octets précédents de l'enregistrement */
+} LedgerRecord;
+
+/**
+ * @brief Case de l'anneau.
+ *
+ * `stamp` vaut sequence + 1 une fois l'enregistrement de la séquence `sequence` publié : le thread d'écriture
+ * reconnaît ainsi les cases prêtes sans les confondre avec celles d'un tour précédent.
+ */
+typedef struct {
+    uint64_t stamp;      /**< Séquence publiée + 1, 0 pour une case jamais utilisée */
+    LedgerRecord record; /**< Enregistrement publié */
+} LedgerSlot;
+
+/**
+ * @brief Anneau du registre et état de la validation, en mémoire partagée.
+ */
+typedef struct {
+    bool enabled;              /**< Fichier ouvert par le thread d'écriture ; sinon aucun événement n'est déposé */
+    uint64_t nextSequence;     /**< Prochaine séquence à réserver */
+    uint64_t writtenSequence;  /**< Séquences inférieures copiées par le thread d'écriture : leurs cases sont libres */
+    uint64_t durableSequence;  /**< Séquences inférieures sur disque */
+    uint32_t durableFutex;     /**< Incrémenté à chaque validation, réveille les attentes de durabilité */
+    uint32_t spaceFutex;       /**< Incrémenté quand des cases se libèrent, réveille les attentes d'anneau plein */
+    uint32_t commitIntervalMs; /**< Intervalle de validation */
+    bool syncGrants;           /**< Annoncer un repas seulement une fois son enregistrement durable */
+    uint64_t commits;          /**< Nombre de validations (write() + fdatasync()) */
+    uint64_t records;          /**< Nombre d'enregistrements écrits */
+    uint64_t holes;            /**< Nombre de séquences sautées */
+    LedgerSlot slots[LEDGER_RING_SIZE];
+} Ledger;
+
+/**
+ * @brief État du thread d'écriture du registre.
+ */
+typedef struct {
+    int fd;                                 /**< Descripteur du fichier, ouvert en ajout */
+    uint64_t stalledSequence;               /**< Séquence attendue lors du dernier passage, pour détecter un trou */
+    uint64_t stalledSince;                  /**< Heure monotone (ns) depuis laquelle cette séquence est attendue */
+    LedgerRecord buffer[LEDGER_RING_SIZE];  /**< Enregistrements d'une validation, écrits d'un seul write() */
+} LedgerWriter;
+
+_Static_assert(sizeof(LedgerRecord) == 40, "LedgerRecord : taille différente du format du registre");
+_Static_assert(MAX_PHILOSOPHERS <= UINT32_MAX, "LedgerRecord : identifiant de baguette trop grand pour le registre");
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file LogIndex.h
+ * @brief Définit les constantes et structures de l'index des fichiers de logs.
+ *
+ * Chaque fichier de log (`server.log` et les fichiers `client_<pid>.log`) peut être accompagné d'un fichier
+ * d'index (même nom suivi de l'extension `LOG_INDEX_EXTENSION`). Cet index associe à chaque message écrit
+ * l'identifiant du philosophe concerné, l'horodatage de son émission, ainsi que la position et la taille du message
+ * dans le fichier de log. Il permet de retrouver les événements d'un philosophe sur une plage horaire sans relire
+ * tout le texte.
+ *
+ * Le fichier d'index est composé :
+ *  - d'un en-tête **LogIndexHeader** (nombre magique, version, nombre d'entrées déjà triées),
+ *  - d'une suite d'entrées **LogIndexEntry** : les `sortedEntries` premières sont triées par
+ *    (philosophe, horodatage, position), les suivantes sont ajoutées au fil de l'eau par le serveur.
+ *
+ * Les macros définies sont :
+ *  - **LOG_INDEX_EXTENSION** : Extension ajoutée au chemin du fichier de log pour obtenir son index.
+ *  - **LOG_INDEX_MAGIC** : Nombre magique identifiant un fichier d'index.
+ *  - **LOG_INDEX_VERSION** : Version du format de l'index.
+ *  - **LOG_INDEX_NO_SEAT** : Identifiant utilisé pour les messages qui ne concernent aucun philosophe.
+ *
+ * L'inclusion de `<stdint.h>` est requise pour les types entiers de taille fixe, le fichier étant relu
+ * par un outil séparé du serveur.
+ */
+
+#ifndef LOG_INDEX_H
+#define LOG_INDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Extension ajoutée au chemin d'un fichier de log pour obtenir son index.
+ */
+#define LOG_INDEX_EXTENSION ".idx"
+
+/**
+ * @brief Nombre magique en tête des fichiers d'index ("LIDX").
+ */
+#define LOG_INDEX_MAGIC 0x5844494C
+
+/**
+ * @brief Version du format de l'index.
+ */
+#define LOG_INDEX_VERSION 1
+
+/**
+ * @brief Identifiant de philosophe utilisé pour les messages qui n'en concernent aucun.
+ */
+#define LOG_INDEX_NO_SEAT 0
+
+/**
+ * @brief En-tête d'un fichier d'index.
+ */
+typedef struct {
+    uint32_t magic;         /**< Nombre magique `LOG_INDEX_MAGIC` */
+    uint32_t version;       /**< Version du format `LOG_INDEX_VERSION` */
+    uint64_t sortedEntries; /**< Nombre d'entrées triées en tête de fichier, les suivantes sont dans l'ordre d'écriture */
+} LogIndexHeader;
+
+/**
+ * @brief Entrée de l'index décrivant un message du fichier de log.
+ *
+ * L'horodatage est l'heure d'émission du message. Il vaut 0 lorsque l'index a été reconstruit à partir d'un
+ * fichier de log qui ne contient pas l'heure des messages.
+ */
+typedef struct {
+    int32_t seatId;     /**< Identifiant du philosophe concerné, ou LOG_INDEX_NO_SEAT */
+    uint32_t length;    /**< Taille du message en octets */
+    uint64_t timestamp; /**< Horodatage du message en nanosecondes depuis l'epoch, 0 si inconnu */
+    uint64_t offset;    /**< Position du message dans le fichier de log */
+} LogIndexEntry;
+
+/**
+ * @brief Écrivain d'index associé à un fichier de log ouvert par un thread de logs.
+ *
+ * Pour les fichiers de logs d'un client, les messages ne rappellent pas tous l'identifiant du philosophe
+ * ("Baguette gauche libérée", ...). Le mode `stickySeat` attribue alors à ces messages le dernier
+ * philosophe rencontré dans le fichier.
+ */
+typedef struct {
+    int fd;             /**< Descripteur du fichier d'index, -1 si l'index n'a pas pu être ouvert */
+    bool stickySeat;    /**< Attribue le dernier philosophe connu aux messages qui n'en mentionnent pas */
+    int32_t lastSeatId; /**< Dernier philosophe rencontré dans le fichier */
+} LogIndexWriter;
+
+#endif
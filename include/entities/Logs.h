@@ -13,6 +13,10 @@
  *  - **CLIENT_INFO_PREFIX** : Préfixe du chemin d'accès pour les fichiers de logs du client.
  *  - **LOG_EXTENSION** : Extension utilisée pour les fichiers de logs.
  *  - **LOG_BUFFER_SIZE** : Taille du tampon alloué pour le texte d'un log.
+ *  - **LOG_MESSAGE_SIZE** : Taille d'un message de log dans la file, texte et horodatage.
+ *  - **LOG_TIMESTAMP_LENGTH** : Taille de l'heure écrite en tête de chaque message des fichiers de log.
+ *
+ * L'énumération **LogLevel** définit les niveaux de logs réglables à chaud depuis le socket de contrôle.
  *
  * Les structures définies dans ce fichier sont :
  *  - **Log** : Représente un message de log avec un type et un texte.
@@ -31,6 +35,8 @@
 #define LOGS_H
 
 #include <sys/types.h>
+#include <stdint.h>
+#include <stddef.h>
 
 /**
  * @brief Chemin d'accès au fichier de log du serveur.
@@ -57,30 +63,60 @@
  */
 #define LOG_BUFFER_SIZE 256
 
+/**
+ * @brief Taille de l'heure écrite en tête de chaque message des fichiers de log, espace comprise :
+ * "AAAA-MM-JJ HH:MM:SS.uuuuuu ".
+ */
+#define LOG_TIMESTAMP_LENGTH 27
+
+/**
+ * @brief Niveaux de logs.
+ *
+ * Le niveau est conservé en mémoire partagée : il s'applique immédiatement au processus principal comme aux
+ * processus de service.
+ */
+typedef enum {
+    LOG_LEVEL_NONE,   /**< Aucun log */
+    LOG_LEVEL_SERVER, /**< Logs d'état du serveur uniquement */
+    LOG_LEVEL_ALL     /**< Logs du serveur et des clients (par défaut) */
+} LogLevel;
+
 /**
  * @brief Structure représentant un message de log dans une file de message IPC.
  *
- * Cette structure contient un champ `type` indiquant le type du log et un tableau de caractères
- * `text` servant à stocker le contenu du message de log. La taille du tableau est définie par la
- * macro `LOG_BUFFER_SIZE`.
- * 
- * Il s'agit de la même signature que `struct msgbuf`. 
+ * Cette structure contient un champ `type` indiquant le type du log, un tableau de caractères
+ * `text` servant à stocker le contenu du message de log, dont la taille est définie par la
+ * macro `LOG_BUFFER_SIZE`, et l'heure monotone de son émission (voir Clock.h). L'heure n'est convertie en
+ * heure murale qu'à l'écriture du message dans son fichier.
+ *
+ * Il s'agit de la même signature que `struct msgbuf`. L'heure suit le texte : un message sans heure (envoyé par un
+ * binaire antérieur, pendant une mise à jour à chaud) se reconnaît à sa taille, LOG_BUFFER_SIZE.
  */
 typedef struct {
     long type;
     char text[LOG_BUFFER_SIZE];
+    uint64_t timestamp; /**< Heure monotone de l'émission, en nanosecondes */
 } Log;
 
+/**
+ * @brief Taille d'un message de log dans la file (sans son type).
+ */
+#define LOG_MESSAGE_SIZE (offsetof(Log, timestamp) + sizeof(uint64_t) - sizeof(long))
+
 /**
  * @brief Structure contenant les informations du thread de gestion des logs des processus de service.
  *
  * Cette structure regroupe :
  *  - l'identifiant de la file de logs (`logsQueueId`) utilisée pour la communication IPC,
- *  - l'identifiant du processus enfant (`childProcessId`) gérant la connexion d'un client.
+ *  - l'identifiant du processus enfant (`childProcessId`) gérant la connexion d'un client,
+ *  - le message en cours de réception (`log`).
+ *
+ * Les sessions sont prises dans une réserve de blocs (voir Arena.h) et rendues par le thread à sa fin.
  */
 typedef struct {
     int logsQueueId; /**< Identifiant de la file de message IPC */
-    pid_t childProcessId; /**< Identifiant du processus enfant associé */
+    pid_t childProcessId; /**< Identifiant du processus enfant associé, 0 pour le thread des logs du serveur */
+    Log log; /**< Message en cours de réception */
 } LogThreadInfo;
 
 
@@ -0,0 +1,115 @@
+/**
+ * @file Metrics.h
+ * @brief Définit le format du fichier circulaire des métriques du serveur.
+ *
+ * Le serveur échantillonne ses compteurs à intervalle fixe (METRICS_INTERVAL_MS) dans un fichier de taille fixe,
+ * projeté en mémoire. Le fichier est découpé en METRICS_BLOCKS blocs de METRICS_BLOCK_SAMPLES échantillons,
+ * réutilisés en anneau : une fois le dernier bloc rempli, le plus ancien est écrasé. La taille sur disque ne
+ * dépend donc que de ces macros, quelle que soit la durée de fonctionnement du serveur.
+ *
+ * Chaque bloc est stocké par colonnes : une valeur de base par colonne (le premier échantillon du bloc), puis,
+ * pour chaque colonne, les écarts successifs entre échantillons sur 32 bits. Les compteurs variant peu d'un
+ * échantillon à l'autre, ce codage divise par deux la place occupée par rapport à des valeurs brutes sur 64 bits.
+ * Si un écart ne tient pas sur 32 bits, le bloc est clos et un nouveau bloc commence avec de nouvelles bases.
+ *
+ * Les structures définies sont :
+ *  - **MetricsHeader** : En-tête du fichier (format, dimensions, numéro du bloc en cours d'écriture).
+ *  - **MetricsBlock** : Bloc de METRICS_BLOCK_SAMPLES échantillons codés par colonnes.
+ *  - **MetricsStore** : Fichier de métriques ouvert et projeté en mémoire.
+ *
+ * L'énumération **MetricsColumn** liste les colonnes enregistrées pour chaque échantillon.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Chemin du fichier des métriques (relatif au dossier src).
+ */
+#define METRICS_FILE "../logs/server.tsdb"
+
+/**
+ * @brief Signature identifiant un fichier de métriques ("TSDB" en petit-boutiste).
+ */
+#define METRICS_MAGIC 0x42445354
+
+/**
+ * @brief Version du format du fichier de métriques.
+ */
+#define METRICS_VERSION 1
+
+/**
+ * @brief Intervalle d'échantillonnage en millisecondes.
+ */
+#define METRICS_INTERVAL_MS 1000
+
+/**
+ * @brief Nombre d'échantillons par bloc.
+ */
+#define METRICS_BLOCK_SAMPLES 64
+
+/**
+ * @brief Nombre de blocs du fichier (1024 blocs de 64 échantillons d'une seconde : un peu plus de 18 heures).
+ */
+#define METRICS_BLOCKS 1024
+
+/**
+ * @brief Colonnes enregistrées pour chaque échantillon.
+ */
+typedef enum {
+    METRICS_TIMESTAMP,        /**< Heure de l'échantillon, en millisecondes depuis l'epoch */
+    METRICS_MEALS,            /**< Nombre total de repas accordés depuis le démarrage */
+    METRICS_PHILOSOPHERS,     /**< Nombre de philosophes à table */
+    METRICS_WAITERS,          /**< Nombre de philosophes attendant de manger */
+    METRICS_ADMISSION_TOKENS, /**< Places libres au compteur */
+    METRICS_LOG_QUEUE_DEPTH,  /**< Nombre de messages en attente dans la file des logs */
+    METRICS_WAIT_P50,         /**< Médiane des attentes servies pendant l'intervalle, en microsecondes */
+    METRICS_WAIT_P90,         /**< 90e percentile des attentes servies pendant l'intervalle, en microsecondes */
+    METRICS_WAIT_P99,         /**< 99e percentile des attentes servies pendant l'intervalle, en microsecondes */
+    METRICS_COLUMNS           /**< Nombre de colonnes */
+} MetricsColumn;
+
+/**
+ * @brief En-tête du fichier de métriques.
+ */
+typedef struct {
+    uint32_t magic;         /**< METRICS_MAGIC */
+    uint32_t version;       /**< METRICS_VERSION */
+    uint32_t intervalMs;    /**< Intervalle d'échantillonnage */
+    uint32_t blocks;        /**< Nombre de blocs du fichier */
+    uint32_t blockSamples;  /**< Nombre d'échantillons par bloc */
+    uint32_t columns;       /**< Nombre de colonnes */
+    uint64_t currentBlock;  /**< Numéro (croissant, jamais remis à zéro) du bloc en cours d'écriture */
+} MetricsHeader;
+
+/**
+ * @brief Bloc d'échantillons codés par colonnes.
+ *
+ * Le bloc numéro n est rangé à l'emplacement n % METRICS_BLOCKS. Le nombre d'échantillons n'est incrémenté
+ * qu'après l'écriture des écarts : un lecteur ne voit jamais d'échantillon partiellement écrit.
+ */
+typedef struct {
+    uint64_t number;                                    /**< Numéro du bloc, 0 pour un emplacement jamais écrit */
+    uint32_t numberSamples;                             /**< Nombre d'échantillons valides */
+    uint32_t padding;
+    int64_t bases[METRICS_COLUMNS];                     /**< Valeurs du premier échantillon */
+    int64_t lasts[METRICS_COLUMNS];                     /**< Valeurs du dernier échantillon (pour l'écriture) */
+    int32_t deltas[METRICS_COLUMNS][METRICS_BLOCK_SAMPLES]; /**< Écarts avec l'échantillon précédent */
+} MetricsBlock;
+
+/**
+ * @brief Fichier de métriques ouvert et projeté en mémoire.
+ */
+typedef struct {
+    int fd;                 /**< Descripteur du fichier, -1 s'il n'est pas ouvert */
+    size_t size;            /**< Taille de la projection */
+    MetricsHeader *header;  /**< En-tête, au début de la projection */
+    MetricsBlock *blocks;   /**< Blocs, à la suite de l'en-tête */
+    bool startBlock;        /**< true pour commencer un nouveau bloc au prochain échantillon */
+} MetricsStore;
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file Migration.h
+ * @brief Définit la migration des philosophes entre les voisinages de la table.
+ *
+ * Un philosophe ne se dispute ses baguettes qu'avec ses deux voisins : lorsque des philosophes qui attendent
+ * longtemps leurs repas sont assis côte à côte, leur voisinage est chaud, alors qu'ailleurs la table peut rester
+ * calme. La migration échange les places de deux philosophes qui pensent : celui qui attend le plus, au milieu du
+ * voisinage le plus chaud, va s'asseoir entre des voisins calmes, et un philosophe peu demandeur prend sa place.
+ * Le serveur n'a qu'une table : la migration se fait entre ses voisinages (segments de l'anneau).
+ *
+ * La charge d'une place est `waitLoad`, la moyenne glissante de l'attente de ses derniers repas. La contention d'une
+ * paire de voisins est estimée par le produit de leurs charges : échanger un philosophe de charge `lH`, entouré de
+ * voisins de charge totale `SH`, avec un philosophe de charge `lL` entouré de `SL` réduit la contention de la table
+ * de `(lH - lL) * (SH - SL)`. Le thread de compactage (voir Compaction.h) évalue la table à chaque passage et
+ * n'échange deux places que si ce gain est positif, que le philosophe déplacé attend en moyenne au moins
+ * MIGRATION_MIN_LOAD_US et que son voisinage est au moins MIGRATION_MIN_IMBALANCE fois plus chargé que l'autre : la contention ne faisant que
+ * diminuer, deux philosophes ne se renvoient pas leur place.
+ *
+ * Un échange ne bloque aucune autre place : il n'est tenté que si le sémaphore de création et les deux places (voir
+ * pinPhilosopher()) peuvent être pris sans attendre. Les baguettes restent à leur position dans l'anneau, avec leurs
+ * identifiants : un philosophe qui a changé de place prend les baguettes de sa nouvelle place, et ses voisins n'ont
+ * pas à changer de baguette. La table de renvoi `seatSlots` suit l'échange, les connexions désignant leur philosophe
+ * par son identifiant : le client n'a pas à se reconnecter.
+ *
+ * Les structures définies sont :
+ *  - **MigrationState** : Réglage et compteurs de la migration, en mémoire partagée.
+ */
+
+#ifndef MIGRATION_H
+#define MIGRATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Nombre minimal de philosophes à table pour évaluer une migration.
+ *
+ * En dessous, deux places quelconques sont voisines : un échange ne change pas les voisinages.
+ */
+#define MIGRATION_MIN_SEATS 5
+
+/**
+ * @brief Attente moyenne minimale du philosophe à déplacer, en microsecondes.
+ */
+#define MIGRATION_MIN_LOAD_US 1000
+
+/**
+ * @brief Rapport minimal entre les charges des voisinages chaud et calme.
+ */
+#define MIGRATION_MIN_IMBALANCE 2
+
+/**
+ * @brief Réglage et compteurs de la migration.
+ */
+typedef struct {
+    bool enabled;               /**< Migrations déclenchées automatiquement (commande de contrôle `migration`) */
+    uint64_t passes;            /**< Évaluations de la table */
+    uint64_t migrations;        /**< Échanges de places effectués */
+    uint64_t busy;              /**< Échanges abandonnés : places ou baguettes prises */
+    uint64_t imbalancePercent;  /**< Rapport entre les voisinages chaud et calme lors de la dernière évaluation, en % */
+} MigrationState;
+
+#endif
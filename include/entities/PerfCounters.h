@@ -0,0 +1,117 @@
+/**
+ * @file PerfCounters.h
+ * @brief Définit les compteurs matériels mesurés autour des étapes d'un repas accordé.
+ *
+ * Le profileur (voir Profiler.h) dit où passe le temps ; ces compteurs disent pourquoi une étape coûte ce qu'elle
+ * coûte : cycles, instructions (et donc instructions par cycle), défauts de cache, changements de contexte. Ils
+ * s'activent et se désactivent à chaud par la commande de contrôle `perf`, et ne coûtent qu'un test tant qu'ils sont
+ * désactivés.
+ *
+ * Activés, chaque thread qui sert des demandes de repas (processus de service, threads de la réserve du service
+ * datagramme) ouvre à sa première demande un groupe de compteurs perf_event_open() sur lui-même, lu d'un seul appel
+ * read() à chaque frontière d'étape. Les écarts entre deux lectures sont attribués à l'étape qui vient de se
+ * terminer :
+ *  - **decode** : de la lecture du bloc reçu au décodage de la demande ;
+ *  - **lookup** : recherche et prise de la place du philosophe ;
+ *  - **admission** : attente de pouvoir être servi (politique, compteur de la politique `counter`) ;
+ *  - **chopsticks** : prise des deux baguettes ;
+ *  - **send** : de la prise des baguettes à l'écriture de la réponse (registre, abonnés, envoi des réponses du lot).
+ * Le service datagramme décode et répond depuis sa boucle principale : seules les étapes lookup à send (sans l'envoi)
+ * de ses threads sont mesurées. Une demande qui n'aboutit pas (philosophe évincé) n'est pas comptée.
+ *
+ * Les compteurs sont totalisés par étape pour toute la table et par thread de service ; le total de chaque compteur
+ * sur un repas alimente en plus un histogramme, dont la commande `stats` donne les percentiles.
+ *
+ * Les compteurs matériels sont souvent indisponibles (machine virtuelle sans PMU : ENOENT) ou restreints
+ * (/proc/sys/kernel/perf_event_paranoid : EACCES). Chaque compteur qui ne s'ouvre pas est simplement omis ; si le
+ * noyau refuse de compter en mode noyau, le groupe est rouvert en mode utilisateur seul (`exclude_kernel`), sans les
+ * changements de contexte, qui ne sont comptés que dans le noyau. Un thread sans aucun compteur n'est pas mesuré, et
+ * la raison du dernier refus est publiée.
+ *
+ * Les structures définies sont :
+ *  - **PerfStage** : Étapes mesurées.
+ *  - **PerfCounter** : Compteurs mesurés.
+ *  - **PerfWorker** : Totaux d'un thread de service.
+ *  - **PerfCounterState** : Réglage et totaux, en mémoire partagée.
+ *  - **PerfThread** : Groupe de compteurs et mesure en cours d'un thread.
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "../entities/Statistics.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+/**
+ * @brief Nombre maximal de threads de service suivis individuellement ; les suivants ne comptent que dans les totaux.
+ */
+#define PERF_MAX_WORKERS 64
+
+/**
+ * @brief Étapes mesurées d'un repas accordé, dans l'ordre.
+ */
+typedef enum {
+    PERF_STAGE_DECODE,
+    PERF_STAGE_LOOKUP,
+    PERF_STAGE_ADMISSION,
+    PERF_STAGE_CHOPSTICKS,
+    PERF_STAGE_SEND,
+    PERF_STAGES
+} PerfStage;
+
+/**
+ * @brief Compteurs mesurés, dans l'ordre de leur groupe (le premier ouvert en est le meneur).
+ */
+typedef enum {
+    PERF_COUNTER_CYCLES,
+    PERF_COUNTER_INSTRUCTIONS,
+    PERF_COUNTER_CACHE_MISSES,
+    PERF_COUNTER_CONTEXT_SWITCHES,
+    PERF_COUNTERS
+} PerfCounter;
+
+/**
+ * @brief Totaux d'un thread de service, écrits par ce seul thread.
+ *
+ * Une case est libre quand `processId` vaut 0 ; celle d'un processus terminé sans la rendre (tué) est reprise.
+ */
+typedef struct {
+    pid_t processId;                                 /**< Processus du thread */
+    pid_t threadId;                                  /**< Identifiant noyau du thread */
+    uint64_t grants;                                 /**< Repas mesurés */
+    uint64_t totals[PERF_STAGES][PERF_COUNTERS];     /**< Totaux par étape */
+} PerfWorker;
+
+/**
+ * @brief Réglage et totaux des compteurs.
+ */
+typedef struct {
+    bool enabled;                                    /**< Les demandes de repas sont mesurées */
+    uint32_t available;                              /**< Compteurs ouverts par au moins un thread (bits PerfCounter) */
+    bool userOnly;                                   /**< Au moins un thread ne compte que le mode utilisateur */
+    uint32_t unmeasuredThreads;                      /**< Threads qui n'ont pu ouvrir aucun compteur */
+    int32_t lastError;                               /**< errno du dernier refus de perf_event_open(), 0 sinon */
+    uint64_t grants;                                 /**< Repas mesurés */
+    uint64_t totals[PERF_STAGES][PERF_COUNTERS];     /**< Totaux par étape, tous threads confondus */
+    Histogram grantHistograms[PERF_COUNTERS];        /**< Total de chaque compteur sur un repas */
+    PerfWorker workers[PERF_MAX_WORKERS];            /**< Totaux par thread de service */
+} PerfCounterState;
+
+/**
+ * @brief Groupe de compteurs et mesure en cours d'un thread, propre au thread.
+ */
+typedef struct {
+    bool opened;                                     /**< Le groupe a été ouvert (ou son ouverture a échoué) */
+    int numberCounters;                              /**< Compteurs du groupe, 0 si le thread n'est pas mesuré */
+    int fds[PERF_COUNTERS];                          /**< Descripteurs, le premier est le meneur du groupe */
+    PerfCounter counters[PERF_COUNTERS];             /**< Compteur de chaque descripteur, dans l'ordre de lecture */
+    PerfWorker *worker;                              /**< Case du thread, NULL si la table des threads est pleine */
+    bool active;                                     /**< Une demande est en cours de mesure */
+    bool granted;                                    /**< Le repas est accordé, sa réponse reste à envoyer */
+    uint64_t last[PERF_COUNTERS];                    /**< Valeurs à la dernière frontière d'étape */
+    uint64_t pending[PERF_STAGES][PERF_COUNTERS];    /**< Écarts de la demande en cours, par étape */
+} PerfThread;
+
+#endif
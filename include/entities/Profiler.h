@@ -0,0 +1,180 @@
+/**
+ * @file Profiler.h
+ * @brief Définit le profileur par échantillonnage intégré au serveur.
+ *
+ * Quand le serveur ralentit, le profileur dit où passe le temps processeur : envoi des logs (msgsnd()), mise en forme
+ * (vsnprintf()), sémaphores, sockets... Il s'active et se désactive à chaud par la commande de contrôle `profile`,
+ * et ne coûte rien tant qu'il est désactivé : aucun minuteur n'est armé.
+ *
+ * Activé, chaque thread enregistré (threads du processus principal, processus de service, threads de la réserve du
+ * service datagramme) a son minuteur POSIX sur son propre temps processeur (timer_create() sur
+ * CLOCK_THREAD_CPUTIME_ID, livré au thread par SIGEV_THREAD_ID) : toutes les 1/`frequency` secondes de calcul, le
+ * thread reçoit SIGPROF. Le profil mesure donc le temps passé sur le processeur, appels système compris, et non les
+ * attentes : un thread endormi dans read() ou sem_wait() ne reçoit pas d'échantillon. Le noyau ne vérifie ces
+ * minuteurs qu'à chaque tick d'horloge : la fréquence effective est bornée par CONFIG_HZ (souvent 250 Hz).
+ *
+ * Le handler de SIGPROF remonte la pile du thread interrompu par ses pointeurs de cadre (adresse de l'instruction
+ * interrompue, puis adresses de retour), sans appel de fonction ni allocation, en ne lisant que la pile du thread.
+ * L'échantillon est écrit dans l'anneau du thread, qui n'a qu'un producteur (le handler, sur ce thread) et qu'un
+ * consommateur (le thread collecteur du processus) : aucun verrou n'est pris. Un anneau plein compte l'échantillon
+ * comme perdu. Une fonction compilée sans pointeur de cadre (certaines fonctions de la libc) masque son appelant :
+ * compiler le serveur avec `-fno-omit-frame-pointer` donne des piles complètes.
+ *
+ * Chaque processus a un thread collecteur, endormi sur un futex de la mémoire partagée : il applique les réglages à
+ * chaque commande `profile`, vide les anneaux dans la table des piles du processus toutes les
+ * PROFILER_DRAIN_INTERVAL_MS pendant le profilage, et, à chaque `profile dump`, ajoute ses piles à PROFILE_FILE au
+ * format "replié" (une pile par ligne, de la racine à la feuille, séparée par des ';' et suivie de son nombre
+ * d'échantillons), directement lisible par flamegraph.pl ou speedscope. Chaque profil couvre la période écoulée
+ * depuis le précédent. La racine de chaque pile est le rôle du processus (`server`, `service` ou `datagram`).
+ *
+ * Les noms des fonctions du serveur sont lus dans la table des symboles de son binaire (/proc/self/exe), ceux des
+ * bibliothèques partagées par dladdr() ; une adresse sans symbole est écrite `binaire+0xdécalage`.
+ *
+ * Les structures définies sont :
+ *  - **ProfilerState** : Réglages et compteurs du profileur, en mémoire partagée.
+ *  - **ProfilerSample** : Pile d'un échantillon.
+ *  - **ProfilerThread** : Thread enregistré, avec son minuteur et son anneau d'échantillons.
+ *  - **ProfilerStack** : Pile agrégée, avec son nombre d'échantillons.
+ *  - **ProfilerSymbol** : Symbole du binaire du serveur.
+ *  - **ProfileLine** : Ligne d'un profil écrit.
+ *  - **Profiler** : État du profileur dans un processus.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/types.h>
+
+/**
+ * @brief Fichier des profils, relatif au dossier src.
+ */
+#define PROFILE_FILE "../logs/server.folded"
+
+/**
+ * @brief Fréquence d'échantillonnage par défaut, en échantillons par seconde de calcul de chaque thread.
+ *
+ * Un nombre premier, pour ne pas échantillonner en phase avec les activités périodiques du serveur.
+ */
+#define PROFILER_DEFAULT_FREQUENCY 99
+
+/**
+ * @brief Fréquence d'échantillonnage maximale.
+ */
+#define PROFILER_MAX_FREQUENCY 1000
+
+/**
+ * @brief Profondeur maximale d'une pile.
+ */
+#define PROFILER_MAX_DEPTH 32
+
+/**
+ * @brief Nombre d'échantillons de l'anneau de chaque thread (puissance de deux).
+ *
+ * Vidé toutes les PROFILER_DRAIN_INTERVAL_MS, l'anneau tient deux intervalles de calcul à la fréquence maximale.
+ */
+#define PROFILER_BUFFER_SAMPLES 1024
+
+/**
+ * @brief Nombre maximal de threads profilés par processus ; les threads suivants ne sont pas profilés.
+ */
+#define PROFILER_MAX_THREADS 64
+
+/**
+ * @brief Nombre de piles distinctes gardées par processus entre deux profils (puissance de deux).
+ */
+#define PROFILER_MAX_STACKS 4096
+
+/**
+ * @brief Intervalle entre deux vidages des anneaux pendant le profilage, en millisecondes.
+ */
+#define PROFILER_DRAIN_INTERVAL_MS 500
+
+/**
+ * @brief Réglages et compteurs du profileur.
+ *
+ * Chaque commande `profile` incrémente `generation` et réveille les threads collecteurs qui l'attendent.
+ */
+typedef struct {
+    uint32_t generation;      /**< Version des réglages, compteur du futex des collecteurs */
+    bool enabled;             /**< Les minuteurs sont armés */
+    uint32_t frequency;       /**< Échantillons par seconde de calcul de chaque thread */
+    uint32_t dumpRequests;    /**< Nombre de profils demandés */
+    uint64_t samples;         /**< Échantillons collectés */
+    uint64_t dropped;         /**< Échantillons perdus (anneau ou table des piles pleins) */
+    uint64_t dumps;           /**< Profils de processus écrits */
+} ProfilerState;
+
+/**
+ * @brief Pile d'un échantillon, de la feuille (instruction interrompue) vers la racine.
+ */
+typedef struct {
+    uint32_t depth;                        /**< Nombre d'adresses */
+    uintptr_t frames[PROFILER_MAX_DEPTH];  /**< Adresses : instruction interrompue, puis adresses de retour */
+} ProfilerSample;
+
+/**
+ * @brief Thread enregistré auprès du profileur.
+ *
+ * `head` n'est écrit que par le handler de SIGPROF, sur le thread lui-même ; `tail` que par le collecteur.
+ */
+typedef struct {
+    bool used;                /**< La case est occupée */
+    pid_t threadId;           /**< Identifiant noyau du thread */
+    timer_t timer;            /**< Minuteur sur le temps processeur du thread */
+    uintptr_t stackLow;       /**< Début de la pile du thread */
+    uintptr_t stackHigh;      /**< Fin de la pile du thread */
+    uint64_t head;            /**< Nombre d'échantillons écrits */
+    uint64_t tail;            /**< Nombre d'échantillons lus */
+    ProfilerSample samples[PROFILER_BUFFER_SAMPLES]; /**< Anneau des échantillons */
+} ProfilerThread;
+
+/**
+ * @brief Pile agrégée.
+ */
+typedef struct {
+    uint64_t count;           /**< Nombre d'échantillons, 0 pour une case libre */
+    uint64_t hash;            /**< Empreinte de la pile */
+    ProfilerSample sample;    /**< La pile */
+} ProfilerStack;
+
+/**
+ * @brief Symbole de fonction du binaire du serveur.
+ */
+typedef struct {
+    uintptr_t address;        /**< Adresse, relative au chargement pour un binaire position-indépendant */
+    uintptr_t size;           /**< Taille de la fonction */
+    const char *name;         /**< Nom, dans la projection du binaire */
+} ProfilerSymbol;
+
+/**
+ * @brief Ligne d'un profil : pile nommée et nombre d'échantillons.
+ */
+typedef struct {
+    char *stack;              /**< Noms des fonctions, de la racine à la feuille, séparés par des ';' */
+    uint64_t count;           /**< Nombre d'échantillons */
+} ProfileLine;
+
+/**
+ * @brief État du profileur dans un processus.
+ */
+typedef struct {
+    ProfilerState *state;                         /**< Réglages et compteurs, en mémoire partagée */
+    const char *role;                             /**< Rôle du processus, racine de ses piles */
+    pthread_mutex_t lock;                         /**< Protège les cases des threads et la table des piles */
+    pthread_key_t threadKey;                      /**< Désenregistre un thread à sa sortie */
+    ProfilerThread threads[PROFILER_MAX_THREADS]; /**< Threads enregistrés */
+    ProfilerStack stacks[PROFILER_MAX_STACKS];    /**< Piles collectées depuis le dernier profil */
+    uint32_t appliedGeneration;                   /**< Dernière version des réglages appliquée */
+    uint32_t appliedDumpRequests;                 /**< Nombre de profils demandés déjà écrits */
+    ProfilerSymbol *symbols;                      /**< Symboles du binaire, triés par adresse */
+    size_t numberSymbols;                         /**< Nombre de symboles */
+    bool positionIndependent;                     /**< Le binaire est chargé à une adresse variable */
+    uintptr_t binaryBase;                         /**< Adresse de chargement du binaire */
+} Profiler;
+
+#endif
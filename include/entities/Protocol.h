@@ -0,0 +1,135 @@
+/**
+ * @file Protocol.h
+ * @brief Déclare en un seul endroit le schéma des requêtes et réponses échangées entre client et serveur.
+ *
+ * Les requêtes (`Request`) et les réponses (`Response`) sont copiées telles quelles sur le socket : leur disposition
+ * en mémoire est le format du protocole. Ce fichier la déclare une seule fois, sous forme de X-macros, et tout le
+ * reste en est généré :
+ *  - les énumérations `RequestType` et `ResponseType` et les structures `Request` et `Response` (Request.h,
+ *    Response.h) ;
+ *  - les encodeurs `<nom>Request()` et `<nom>Response()` (Request.c, Response.c) ;
+ *  - les décodeurs validants decodeRequest() et decodeResponse(), qui vérifient le type et le contenu d'un message
+ *    et le lisent directement dans le tampon de réception, sans copie ;
+ *  - les vérifications `_Static_assert` de la taille et du décalage de chaque champ : un client et un serveur
+ *    compilés différemment (options, compilateur, `-fshort-enums`...) ne peuvent pas diverger sans erreur de
+ *    compilation.
+ *
+ * Ajouter un type de message revient à ajouter une ligne à REQUEST_SCHEMA ou RESPONSE_SCHEMA ; un nouveau contenu
+ * s'ajoute à REQUEST_LAYOUT ou RESPONSE_LAYOUT, avec son encodeur (PROTOCOL_ENCODER_<contenu>) et sa validation
+ * (PROTOCOL_VALID_<contenu>, voir Protocol.c). Le décodage reste un seul `switch` sur le type.
+ *
+ * Les macros définies sont :
+ *  - **REQUEST_SCHEMA**, **RESPONSE_SCHEMA** : Types de messages, `X(type, nom de l'encodeur, contenu)`.
+ *  - **REQUEST_LAYOUT**, **RESPONSE_LAYOUT** : Champs sur le fil, `X(type C, champ, décalage, taille)`.
+ *  - **PHILOSOPHER_LAYOUT**, **WATCH_SUBSCRIPTION_LAYOUT** : Champs des contenus `Philosopher` et `WatchSubscription`.
+ *  - **REQUEST_WIRE_SIZE**, **RESPONSE_WIRE_SIZE** : Taille d'un message sur le fil.
+ *  - **PROTOCOL_ENUM_VALUE**, **PROTOCOL_DECLARE_FIELD**, **PROTOCOL_CHECK_FIELD** : Générateurs d'énumération, de
+ *    structure et de vérifications.
+ */
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "Philosopher.h"
+#include "Watch.h"
+#include <stddef.h>
+
+/**
+ * @brief Types de requêtes : `X(type, nom de l'encodeur, contenu)`.
+ *
+ *  - REQUEST_CREATE : demander la création d'un nouveau philosophe.
+ *  - REQUEST_UPDATE : mettre à jour un philosophe existant (contenu `philosopher`).
+ *  - REQUEST_WATCH : s'abonner aux changements d'état de la table (contenu `watch`, voir Watch.h).
+ *  - REQUEST_SNAPSHOT : obtenir un instantané de toute la table (voir Snapshot.h).
+ */
+#define REQUEST_SCHEMA(X) \
+    X(REQUEST_CREATE, create, NONE) \
+    X(REQUEST_UPDATE, update, PHILOSOPHER) \
+    X(REQUEST_WATCH, watch, WATCH) \
+    X(REQUEST_SNAPSHOT, snapshot, NONE)
+
+/**
+ * @brief Types de réponses : `X(type, nom de l'encodeur, contenu)`.
+ *
+ *  - RESPONSE_CREATE : philosophe créé (contenu `philosopher`).
+ *  - RESPONSE_UPDATE : autorisation de manger (contenu `philosopher`).
+ *  - RESPONSE_REFUSED : refus d'une création, la table ayant atteint sa capacité, d'un abonnement invalide, ou d'un
+ *    instantané que le serveur n'a pas pu prendre.
+ *  - RESPONSE_WATCH : acceptation d'un abonnement, suivie des lots de changements d'état (voir Watch.h).
+ *  - RESPONSE_SNAPSHOT : réponse à une requête d'instantané, suivie de l'instantané (voir Snapshot.h).
+ */
+#define RESPONSE_SCHEMA(X) \
+    X(RESPONSE_CREATE, create, PHILOSOPHER) \
+    X(RESPONSE_UPDATE, update, PHILOSOPHER) \
+    X(RESPONSE_REFUSED, refused, NONE) \
+    X(RESPONSE_WATCH, watch, NONE) \
+    X(RESPONSE_SNAPSHOT, snapshot, NONE)
+
+/**
+ * @brief Champs d'une requête sur le fil : `X(type C, champ, décalage, taille)`.
+ */
+#define REQUEST_LAYOUT(X) \
+    X(RequestType, type, 0, 4) \
+    X(Philosopher, philosopher, 4, 12) \
+    X(WatchSubscription, watch, 16, 12)
+
+/**
+ * @brief Taille d'une requête sur le fil, en octets.
+ */
+#define REQUEST_WIRE_SIZE 28
+
+/**
+ * @brief Champs d'une réponse sur le fil : `X(type C, champ, décalage, taille)`.
+ */
+#define RESPONSE_LAYOUT(X) \
+    X(ResponseType, type, 0, 4) \
+    X(Philosopher, philosopher, 4, 12)
+
+/**
+ * @brief Taille d'une réponse sur le fil, en octets.
+ */
+#define RESPONSE_WIRE_SIZE 16
+
+/**
+ * @brief Champs du contenu `Philosopher` : `X(type C, champ, décalage, taille)`.
+ */
+#define PHILOSOPHER_LAYOUT(X) \
+    X(int, id, 0, 4) \
+    X(PhilosopherState, state, 4, 4) \
+    X(int, stateTimer, 8, 4)
+
+/**
+ * @brief Champs du contenu `WatchSubscription` : `X(type C, champ, décalage, taille)`.
+ */
+#define WATCH_SUBSCRIPTION_LAYOUT(X) \
+    X(WatchScope, scope, 0, 4) \
+    X(int, seat, 4, 4) \
+    X(int, maxRate, 8, 4)
+
+/**
+ * @brief Génère une valeur d'énumération à partir d'une ligne de schéma.
+ */
+#define PROTOCOL_ENUM_VALUE(type, name, payload) type,
+
+/**
+ * @brief Génère un champ de structure à partir d'une ligne de disposition.
+ */
+#define PROTOCOL_DECLARE_FIELD(ctype, field, offset, size) ctype field;
+
+/**
+ * @brief Vérifie à la compilation le décalage et la taille d'un champ d'une structure du protocole.
+ */
+#define PROTOCOL_CHECK_FIELD(structure, field, offset, size) \
+    _Static_assert(offsetof(structure, field) == (offset) && sizeof(((structure *) 0)->field) == (size), \
+        #structure "." #field " : disposition différente du protocole");
+
+#define PHILOSOPHER_CHECK_FIELD(ctype, field, offset, size) PROTOCOL_CHECK_FIELD(Philosopher, field, offset, size)
+#define WATCH_SUBSCRIPTION_CHECK_FIELD(ctype, field, offset, size) PROTOCOL_CHECK_FIELD(WatchSubscription, field, offset, size)
+
+PHILOSOPHER_LAYOUT(PHILOSOPHER_CHECK_FIELD)
+WATCH_SUBSCRIPTION_LAYOUT(WATCH_SUBSCRIPTION_CHECK_FIELD)
+
+_Static_assert(sizeof(Philosopher) == 12, "Philosopher : taille différente du protocole");
+_Static_assert(sizeof(WatchSubscription) == 12, "WatchSubscription : taille différente du protocole");
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file Proxy.h
+ * @brief Définit les constantes et réglages du proxy de dégradation réseau (outil `proxy`).
+ *
+ * Le proxy s'intercale entre le client et le serveur, en TCP comme en mode datagramme (voir Datagram.h), et dégrade
+ * le trafic comme le ferait un vrai réseau. Chaque sens (montant : client vers serveur, descendant : serveur vers
+ * client) a ses propres réglages `Impairment` :
+ *  - latence et gigue : chaque bloc reçu est retenu `latency` ms, plus ou moins `jitter` ms tirés au hasard ;
+ *  - débit : le sens est un lien de `rate` octets par seconde partagé par toutes les connexions, les blocs y passent
+ *    les uns après les autres ;
+ *  - désordre : un datagramme sur `1/reorder` est retenu PROXY_REORDER_DELAY ms de plus, et se fait doubler ;
+ *  - perte : un datagramme sur `1/loss` est perdu ;
+ *  - coupure : à chaque bloc, une connexion TCP est coupée brutalement (RST des deux côtés) avec la probabilité `reset`.
+ *
+ * Un flux TCP n'est jamais désordonné : la gigue ne fait que retarder les blocs suivants. Le désordre et la perte
+ * ne concernent que les datagrammes, les coupures que les connexions TCP.
+ *
+ * Tant qu'il fonctionne, le proxy écrit ses réglages dans PROXY_SETTINGS_PATH, une ligne par sens au format
+ * `<up|down> latency=<ms> jitter=<ms> rate=<octets/s> reorder=<p> loss=<p> reset=<p>`, suivie de `seed=<graine>` :
+ * les outils de mesure de charge les joignent à leurs résultats.
+ *
+ * Les macros définies sont :
+ *  - **PROXY_PORT** : Port d'écoute par défaut du proxy (TCP et UDP).
+ *  - **PROXY_SETTINGS_PATH** : Fichier des réglages du proxy en fonctionnement.
+ *  - **PROXY_MAX_LINKS** : Nombre maximum de connexions et de flux de datagrammes relayés.
+ *  - **PROXY_CHUNK_SIZE** : Taille maximale d'un bloc lu en une fois.
+ *  - **PROXY_REORDER_DELAY** : Retard supplémentaire d'un datagramme désordonné.
+ */
+
+#ifndef PROXY_H
+#define PROXY_H
+
+#include <stdint.h>
+
+/**
+ * @brief Port d'écoute par défaut du proxy, en TCP et en UDP.
+ */
+#define PROXY_PORT 9003
+
+/**
+ * @brief Fichier des réglages du proxy en fonctionnement (relatif au dossier src).
+ */
+#define PROXY_SETTINGS_PATH "../logs/proxy.settings"
+
+/**
+ * @brief Nombre maximum de connexions TCP et de flux de datagrammes relayés en même temps.
+ */
+#define PROXY_MAX_LINKS 512
+
+/**
+ * @brief Taille maximale d'un bloc lu en une fois sur une connexion (ou d'un datagramme).
+ */
+#define PROXY_CHUNK_SIZE 4096
+
+/**
+ * @brief Retard supplémentaire d'un datagramme désordonné, en millisecondes.
+ */
+#define PROXY_REORDER_DELAY 20
+
+/**
+ * @brief Sens du trafic.
+ */
+typedef enum {
+    PROXY_UPSTREAM,  /**< Du client vers le serveur */
+    PROXY_DOWNSTREAM /**< Du serveur vers le client */
+} ProxyDirection;
+
+/**
+ * @brief Dégradations appliquées à un sens du trafic, et leurs compteurs.
+ */
+typedef struct {
+    int latency;           /**< Latence ajoutée, en millisecondes */
+    int jitter;            /**< Variation maximale de la latence, en millisecondes */
+    long rate;             /**< Débit maximal en octets par seconde, 0 sans limite */
+    double reorder;        /**< Probabilité qu'un datagramme soit désordonné */
+    double loss;           /**< Probabilité qu'un datagramme soit perdu */
+    double reset;          /**< Probabilité, à chaque bloc, de couper la connexion TCP */
+
+    uint64_t linkFreeAt;   /**< Heure (µs) à laquelle le lien limité en débit sera libre */
+    uint64_t forwarded;    /**< Blocs et datagrammes relayés */
+    uint64_t bytes;        /**< Octets relayés */
+    uint64_t reordered;    /**< Datagrammes désordonnés */
+    uint64_t lost;         /**< Datagrammes perdus */
+    uint64_t resets;       /**< Connexions coupées */
+} Impairment;
+
+#endif
@@ -9,12 +9,19 @@
  * La définition de `RequestType` inclut :
  *  - **REQUEST_CREATE** : Requête pour demander au serveur de créer un nouveau philosophe.
  *  - **REQUEST_UPDATE** : Requête pour demander au serveur de mettre à jour un philosophe existant.
+ *  - **REQUEST_WATCH** : Requête pour s'abonner aux changements d'état d'une place, de ses voisins ou de la table.
+ *  - **REQUEST_SNAPSHOT** : Requête pour obtenir en un seul message l'état de toute la table.
  *
  * La structure `Request` comporte :
  *  - un champ `type` de type `RequestType` indiquant la nature de la requête,
- *  - un champ `philosopher` de type `Philosopher`, contenant les informations du philosophe concerné.
+ *  - un champ `philosopher` de type `Philosopher`, contenant les informations du philosophe concerné,
+ *  - un champ `watch` de type `WatchSubscription`, décrivant l'abonnement demandé par une requête REQUEST_WATCH.
  *
- * L'inclusion de "Philosopher.h" est nécessaire pour accéder à la définition de la structure `Philosopher`.
+ * L'énumération et la structure sont générées depuis le schéma du protocole (Protocol.h), qui vérifie aussi à la
+ * compilation leur disposition sur le fil.
+ *
+ * L'inclusion de "Philosopher.h" et "Watch.h" est nécessaire pour accéder aux définitions des structures
+ * `Philosopher` et `WatchSubscription`.
  *
  * Les directives de préprocesseur (#ifndef, #define, #endif) garantissent que ce fichier d'en-tête est inclus
  * une seule fois lors de la compilation.
@@ -24,38 +31,30 @@
 #define REQUEST_H
 
 #include "Philosopher.h"
+#include "Watch.h"
+#include "Protocol.h"
 
 /**
- * @brief Énumération des types de requêtes adressées au serveur.
- *
- * Cette énumération définit les différents types de requêtes qui peuvent être envoyées par les
- * processus clients pour interagir avec le serveur dans la gestion des philosophes.
+ * @brief Énumération des types de requêtes adressées au serveur, générée depuis REQUEST_SCHEMA (voir Protocol.h).
  */
 typedef enum {
-    
-    /**
-     * @brief Requête pour demander au serveur de créer un nouveau philosophe.
-     */
-    REQUEST_CREATE,
-
-    /**
-     * @brief Requête pour demander au serveur de mettre à jour un philosophe existant.
-     */
-    REQUEST_UPDATE,
-
+    REQUEST_SCHEMA(PROTOCOL_ENUM_VALUE)
 } RequestType;
 
 /**
- * @brief Structure représentant une requête adressée au serveur.
+ * @brief Structure représentant une requête adressée au serveur, générée depuis REQUEST_LAYOUT (voir Protocol.h).
  *
- * Cette structure encapsule une requête envoyée au serveur, incluant le type de requête
- * et les informations du philosophe concerné.
+ * Champs : `type` (RequestType), `philosopher` (REQUEST_UPDATE) et `watch` (REQUEST_WATCH uniquement).
  */
 typedef struct {
-    RequestType type;       /**< Type de la requête (création ou mise à jour) */
-    Philosopher philosopher;/**< Structure contenant les informations du philosophe */
+    REQUEST_LAYOUT(PROTOCOL_DECLARE_FIELD)
 } Request;
 
+#define REQUEST_CHECK_FIELD(ctype, field, offset, size) PROTOCOL_CHECK_FIELD(Request, field, offset, size)
+
+REQUEST_LAYOUT(REQUEST_CHECK_FIELD)
 
+_Static_assert(sizeof(RequestType) == 4, "RequestType : taille différente du protocole");
+_Static_assert(sizeof(Request) == REQUEST_WIRE_SIZE, "Request : taille différente du protocole");
 
-#endif
\ No newline at end of file
+#endif
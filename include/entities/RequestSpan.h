@@ -0,0 +1,84 @@
+/**
+ * @file RequestSpan.h
+ * @brief Définit le découpage du temps de service d'une demande de repas en étapes horodatées.
+ *
+ * Le temps d'attente d'un repas (voir Statistics.h) mêle la file d'attente des baguettes et le traitement de la
+ * demande. Chaque requête traitée par un processus de service (clientProcess()) porte donc un span : les heures
+ * (horloge à haute résolution, voir Clock.h) auxquelles elle franchit chaque étape :
+ *  - **read** : bloc reçu lu sur le socket ;
+ *  - **decoded** : requête décodée ;
+ *  - **seat** : place du philosophe trouvée et tenue ;
+ *  - **admitted** : philosophe admis (politique, compteur de la politique `counter`) ;
+ *  - **left** / **right** : baguette gauche / droite prise, dans l'ordre de la politique ;
+ *  - **written** : réponse écrite sur le socket.
+ *
+ * Seuls les repas accordés sont comptés. La durée de chaque étape va de l'étape franchie juste avant à la sienne ;
+ * elle alimente l'histogramme de l'étape, en nanosecondes, et la durée totale celui du repas. Les spans complets
+ * des SPAN_EXEMPLARS repas les plus lents sont gardés comme exemples, pour voir où ils ont attendu.
+ *
+ * Un span tient dans une ligne de cache ; les horodatages ne coûtent qu'une lecture du compteur de cycles chacun.
+ *
+ * Les structures définies sont :
+ *  - **SpanMark** : Étapes horodatées.
+ *  - **RequestSpan** : Span d'une requête.
+ *  - **SpanThread** : Span en cours d'un thread.
+ *  - **SpanStatistics** : Histogrammes des étapes et exemples, en mémoire partagée.
+ */
+
+#ifndef REQUEST_SPAN_H
+#define REQUEST_SPAN_H
+
+#include "../entities/Statistics.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+/**
+ * @brief Nombre de spans des repas les plus lents gardés comme exemples.
+ */
+#define SPAN_EXEMPLARS 8
+
+/**
+ * @brief Étapes horodatées d'une requête, dans l'ordre (les deux baguettes peuvent être prises dans l'autre ordre).
+ */
+typedef enum {
+    SPAN_READ,
+    SPAN_DECODED,
+    SPAN_SEAT_FOUND,
+    SPAN_ADMITTED,
+    SPAN_LEFT_ACQUIRED,
+    SPAN_RIGHT_ACQUIRED,
+    SPAN_WRITTEN,
+    SPAN_MARKS
+} SpanMark;
+
+/**
+ * @brief Span d'une requête : une ligne de cache.
+ */
+typedef struct {
+    uint64_t marks[SPAN_MARKS];   /**< Heure de chaque étape (ns, voir Clock.h), 0 si non franchie */
+    int32_t seatId;               /**< Philosophe de la requête */
+    pid_t processId;              /**< Processus de service */
+} RequestSpan;
+
+/**
+ * @brief Span en cours d'un thread, propre au thread.
+ */
+typedef struct {
+    bool active;                  /**< Une requête est en cours */
+    RequestSpan span;             /**< Son span */
+} SpanThread;
+
+/**
+ * @brief Histogrammes des étapes et exemples des repas les plus lents.
+ */
+typedef struct {
+    uint64_t spans;                                 /**< Repas comptés */
+    Histogram stageHistograms[SPAN_MARKS - 1];      /**< Durée (ns) de chaque étape, indexée par son SpanMark - 1 */
+    Histogram totalHistogram;                       /**< Durée (ns) de la lecture à l'écriture de la réponse */
+    uint32_t exemplarLock;                          /**< Pris le temps de remplacer un exemple, jamais attendu */
+    uint64_t exemplarThreshold;                     /**< Durée du plus rapide des exemples, 0 tant qu'il en manque */
+    RequestSpan exemplars[SPAN_EXEMPLARS];          /**< Spans des repas les plus lents */
+} SpanStatistics;
+
+#endif
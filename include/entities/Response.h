@@ -9,11 +9,18 @@
  * L'énumération `ResponseType` inclut :
  *  - **RESPONSE_CREATE** : Réponse à une requête de création d'un nouveau philosophe.
  *  - **RESPONSE_UPDATE** : Réponse à une requête de mise à jour d'un philosophe existant.
+ *  - **RESPONSE_REFUSED** : Refus d'une requête de création, la table ayant atteint sa capacité, d'un abonnement
+ *    invalide, ou d'un instantané que le serveur n'a pas pu prendre.
+ *  - **RESPONSE_WATCH** : Acceptation d'un abonnement, suivie des lots de changements d'état (voir Watch.h).
+ *  - **RESPONSE_SNAPSHOT** : Réponse à une requête d'instantané, suivie de l'instantané (voir Snapshot.h).
  *
  * La structure `Response` contient :
  *  - un champ `type` de type `ResponseType` indiquant le type de réponse,
  *  - un champ `philosopher` de type `Philosopher` contenant les informations du philosophe concerné.
  *
+ * L'énumération et la structure sont générées depuis le schéma du protocole (Protocol.h), qui vérifie aussi à la
+ * compilation leur disposition sur le fil.
+ *
  * L'inclusion de "Philosopher.h" est nécessaire pour accéder à la définition de la structure `Philosopher`.
  *
  * Les directives de préprocesseur (#ifndef, #define, #endif) garantissent que ce fichier d'en-tête est inclus
@@ -24,29 +31,29 @@
 #define RESPONSE_H
 
 #include "Philosopher.h"
+#include "Protocol.h"
 
 /**
- * @brief Énumération des types de réponses envoyées par le serveur.
- *
- * Cette énumération définit les différents types de réponses possibles lors de l'interaction avec le serveur
- * pour la gestion des philosophes.
+ * @brief Énumération des types de réponses envoyées par le serveur, générée depuis RESPONSE_SCHEMA (voir Protocol.h).
  */
 typedef enum {
-    RESPONSE_CREATE, /**< Réponse à une requête de création d'un nouveau philosophe. */
-    RESPONSE_UPDATE  /**< Réponse à une requête de mise à jour d'un philosophe existant. */
+    RESPONSE_SCHEMA(PROTOCOL_ENUM_VALUE)
 } ResponseType;
 
 /**
- * @brief Structure représentant une réponse envoyée par le serveur.
+ * @brief Structure représentant une réponse envoyée par le serveur, générée depuis RESPONSE_LAYOUT (voir Protocol.h).
  *
- * Cette structure encapsule une réponse envoyée par le serveur, incluant le type de réponse et les informations
- * du philosophe concerné.
+ * Champs : `type` (ResponseType) et `philosopher`, les informations du philosophe concerné.
  */
 typedef struct {
-    ResponseType type;       /**< Type de la réponse (création ou mise à jour) */
-    Philosopher philosopher; /**< Informations du philosophe concerné */
+    RESPONSE_LAYOUT(PROTOCOL_DECLARE_FIELD)
 } Response;
 
+#define RESPONSE_CHECK_FIELD(ctype, field, offset, size) PROTOCOL_CHECK_FIELD(Response, field, offset, size)
+
+RESPONSE_LAYOUT(RESPONSE_CHECK_FIELD)
 
+_Static_assert(sizeof(ResponseType) == 4, "ResponseType : taille différente du protocole");
+_Static_assert(sizeof(Response) == RESPONSE_WIRE_SIZE, "Response : taille différente du protocole");
 
-#endif
\ No newline at end of file
+#endif
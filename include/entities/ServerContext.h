@@ -11,14 +11,23 @@
  *  - **sharedResources** : Pointeur vers la structure `SharedResources` regroupant les ressources partagées (baguettes,
  *    philosophes, file de messages de logs, etc).
  *  - **serviceSockets** : Tableau des sockets de service. Sa taille maximale est définie par la constante
- *    `MAX_PHILOSOPHERS` (définie dans "maxmin_philosophers.h").
+ *    `MAX_SERVICE_PROCESSES` : un processus par philosophe et par abonné (voir Watch.h), plus le service datagramme.
  *  - **numberServiceSockets** : Nombre actuel de sockets de service utilisés.
  *  - **clientsProcessIds** : Tableau contenant les PID des processus clients connectés. Sa taille maximale est également
- *    définie par `MAX_PHILOSOPHERS`.
+ *    définie par `MAX_SERVICE_PROCESSES`.
  *  - **numberClients** : Nombre actuel de clients connectés.
+ *  - **controlSocket** : Socket Unix de contrôle, écouté par la boucle d'événements.
+ *  - **signalFd** : Descripteur par lequel la boucle d'événements reçoit les signaux (signalfd).
+ *  - **controlConnections** : Connexions de contrôle dont la commande est en cours de lecture.
+ *  - **numberControlConnections** : Nombre de connexions de contrôle en cours de lecture.
+ *  - **serverStateThread**, **metricsThread**, **ledgerThread**, **compactionThread**, **tableCoreThread**,
+ *    **tableConsumers** et **clientsLogsThreads** : Threads du processus principal, arrêtés avant une mise à jour à chaud.
+ *  - **executablePath** : Chemin du binaire du serveur, utilisé par défaut pour une mise à jour à chaud.
+ *  - **upgradePath** : Chemin du binaire vers lequel basculer, vide si aucune mise à jour n'est demandée.
+ *  - **datagramProcessId** : PID du service datagramme (voir DatagramService.h), 0 s'il n'est pas lancé.
  *
  * Les inclusions nécessaires sont :
- *  - "../maxmin_philosophers.h" pour la définition de la constante `MAX_PHILOSOPHERS`.
+ *  - "../maxmin_philosophers.h" et "Watch.h" pour les constantes `MAX_PHILOSOPHERS` et `MAX_WATCHERS`.
  *  - "SharedResources.h" pour la définition de la structure `SharedResources`.
  *  - `<sys/types.h>` pour la définition du type `pid_t`.
  *  - `<stdlib.h>` pour les fonctions et définitions de la bibliothèque standard.
@@ -32,8 +41,26 @@
 
 #include "../maxmin_philosophers.h"
 #include "SharedResources.h"
+#include "Control.h"
+#include "Watch.h"
 #include <sys/types.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
+
+/**
+ * @brief Nombre maximum de processus de service : un par philosophe, un par abonné et le service datagramme.
+ */
+#define MAX_SERVICE_PROCESSES (MAX_PHILOSOPHERS + MAX_WATCHERS + 1)
+
+/**
+ * @brief Thread d'un consommateur de l'anneau du cœur de la table (voir TableCore.h) et son argument.
+ */
+typedef struct {
+    pthread_t thread;                   /**< Le thread */
+    TableConsumer consumer;             /**< Son rôle */
+    SharedResources *sharedResources;   /**< Les ressources partagées */
+} TableConsumerThread;
 
 /**
  * @brief Structure regroupant les ressources et informations du serveur.
@@ -68,9 +95,9 @@ typedef struct {
      * @brief Tableau des sockets de service.
      *
      * Chaque socket de service est associé à un client.
-     * La taille maximale de ce tableau est définie par la constante `MAX_PHILOSOPHERS`.
+     * La taille maximale de ce tableau est définie par la constante `MAX_SERVICE_PROCESSES`.
      */
-    int serviceSockets[MAX_PHILOSOPHERS];
+    int serviceSockets[MAX_SERVICE_PROCESSES];
 
     /**
      * @brief Nombre de sockets de services utilisés.
@@ -81,15 +108,85 @@ typedef struct {
      * @brief Tableau des PID des processus clients.
      *
      * Ce tableau contient l'identifiant des processus clients connectés.
-     * Sa taille maximale est définie par `MAX_PHILOSOPHERS`.
+     * Sa taille maximale est définie par `MAX_SERVICE_PROCESSES`.
      */
-    pid_t clientsProcessIds[MAX_PHILOSOPHERS];
+    pid_t clientsProcessIds[MAX_SERVICE_PROCESSES];
 
     /**
      * @brief Nombre de clients connectés.
      */
     size_t numberClients;
 
+    /**
+     * @brief Socket Unix de contrôle.
+     */
+    int controlSocket;
+
+    /**
+     * @brief Descripteur de réception des signaux SIGINT, SIGTERM et SIGCHLD par la boucle d'événements.
+     */
+    int signalFd;
+
+    /**
+     * @brief Connexions de contrôle dont la commande est en cours de lecture.
+     */
+    ControlConnection controlConnections[CONTROL_MAX_CONNECTIONS];
+
+    /**
+     * @brief Nombre de connexions de contrôle en cours de lecture.
+     */
+    int numberControlConnections;
+
+    /**
+     * @brief Thread d'écriture des logs globaux du serveur.
+     */
+    pthread_t serverStateThread;
+
+    /**
+     * @brief Thread d'échantillonnage des métriques.
+     */
+    pthread_t metricsThread;
+
+    /**
+     * @brief Thread d'écriture du registre des repas (validation groupée).
+     */
+    pthread_t ledgerThread;
+
+    /**
+     * @brief Thread de compactage des places et de migration des philosophes (voir Compaction.h et Migration.h).
+     */
+    pthread_t compactionThread;
+
+    /**
+     * @brief Thread du cœur de la table, seul à appliquer les événements de la politique `sequenced`.
+     */
+    pthread_t tableCoreThread;
+
+    /**
+     * @brief Threads des consommateurs de l'anneau du cœur : logs, registre et réponses.
+     */
+    TableConsumerThread tableConsumers[TABLE_CONSUMERS];
+
+    /**
+     * @brief Threads d'écriture des logs de chaque client, rangés comme `clientsProcessIds`.
+     */
+    pthread_t clientsLogsThreads[MAX_SERVICE_PROCESSES];
+
+    /**
+     * @brief Chemin du binaire du serveur, tel que lancé.
+     */
+    char executablePath[PATH_MAX];
+
+    /**
+     * @brief Chemin du binaire vers lequel basculer, vide si aucune mise à jour à chaud n'est demandée.
+     */
+    char upgradePath[PATH_MAX];
+
+    /**
+     * @brief PID du service datagramme, compté parmi les processus de service, 0 s'il n'est pas lancé.
+     */
+    pid_t datagramProcessId;
+
 } ServerContext;
 
 #endif
\ No newline at end of file
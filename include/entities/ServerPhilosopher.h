@@ -10,6 +10,12 @@
  *  - **base** : Structure `Philosopher` contenant les informations de base du philosophe (identifiant, état, et timer).
  *  - **leftChopstick** : Pointeur vers la baguette gauche en mémoire partagée.
  *  - **rightChopstick** : Pointeur vers la baguette droite en mémoire partagée.
+ *  - **meals** : Nombre de repas accordés au philosophe.
+ *  - **hungrySince** : Heure monotone (en nanosecondes) de sa demande de repas en cours, 0 s'il n'attend pas.
+ *  - **heldAdmission** : Indique si le philosophe a pris une place au compteur pour son repas en cours.
+ *  - **draining**, **evicted** et **departed** : Indicateurs de mise à l'écart positionnés depuis le socket de contrôle.
+ *  - **departedAt** : Heure monotone du départ, pour le délai avant l'effacement de la place par le compactage.
+ *  - **pins** : Nombre de processus et de threads qui tiennent la place, pour empêcher son déplacement.
  *
  * Les inclusions nécessaires pour ce fichier d'en-tête sont :
  *  - "Philosopher.h" pour la définition de la structure `Philosopher`.
@@ -17,6 +23,7 @@
  *  - <pthread.h> pour la gestion des threads.
  *  - <stdio.h> pour les fonctions d'entrée/sortie.
  *  - <sys/types.h> pour les types de données système.
+ *  - <stdint.h> pour les entiers de taille fixe.
  *
  * Les directives de préprocesseur (#ifndef, #define, #endif) garantissent que ce fichier est inclus une seule fois
  * lors de la compilation.
@@ -35,6 +42,8 @@
 #include <pthread.h>
 #include <stdio.h>
 #include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 /**
  * @brief Structure représentant un philosophe côté serveur.
@@ -67,6 +76,79 @@ typedef struct {
      */
     Chopstick *rightChopstick;
 
+    /**
+     * @brief Nombre de repas accordés au philosophe depuis sa création.
+     */
+    uint64_t meals;
+
+    /**
+     * @brief Heure monotone (en nanosecondes) à laquelle le philosophe a demandé à manger.
+     *
+     * Vaut 0 lorsqu'aucune demande n'est en attente. Permet aux outils d'observation de calculer l'âge de la faim.
+     */
+    uint64_t hungrySince;
+
+    /**
+     * @brief Attente moyenne des derniers repas du philosophe, en microsecondes (moyenne glissante).
+     *
+     * Charge de la place, qui guide la migration des philosophes (voir Migration.h).
+     */
+    uint64_t waitLoad;
+
+    /**
+     * @brief Indique si le philosophe a pris une place au compteur pour son repas en cours.
+     *
+     * La politique d'arbitrage pouvant changer entre la prise des baguettes et leur libération, la libération se
+     * fonde sur cet indicateur plutôt que sur la politique courante.
+     */
+    bool heldAdmission;
+
+    /**
+     * @brief Le philosophe finit son repas en cours mais n'est plus servi tant qu'il n'est pas repris.
+     */
+    bool draining;
+
+    /**
+     * @brief Le philosophe doit quitter la table à sa prochaine requête.
+     */
+    bool evicted;
+
+    /**
+     * @brief Le philosophe a quitté la table : sa place et sa baguette ne sont plus dans l'anneau.
+     */
+    bool departed;
+
+    /**
+     * @brief Numéro de version de la place, incrémenté après chaque changement de son état (voir Watch.h).
+     */
+    uint64_t version;
+
+    /**
+     * @brief Heure monotone (en nanosecondes) du départ du philosophe, 0 s'il est encore à table.
+     */
+    uint64_t departedAt;
+
+    /**
+     * @brief Nombre de détenteurs de la place (voir pinPhilosopher()), ou SEAT_MOVING pendant son déplacement.
+     *
+     * Le compactage ne déplace ni n'efface une place tenue : un pointeur obtenu par pinPhilosopher() reste valable
+     * jusqu'à unpinPhilosopher().
+     */
+    uint32_t pins;
+
+    /**
+     * @brief Nombre de repas accordés par le cœur de la table (politique `sequenced`, voir TableCore.h).
+     *
+     * Incrémenté par le consommateur des réponses une fois le repas consigné ; le processus de service du philosophe
+     * l'attend (futex).
+     */
+    uint32_t coreGrants;
+
+    /**
+     * @brief Séquence dans le registre du dernier repas accordé par le cœur, UINT64_MAX si le registre est désactivé.
+     */
+    uint64_t grantLedgerSequence;
+
 } ServerPhilosopher;
 
 
@@ -0,0 +1,50 @@
+/**
+ * @file ServiceConnection.h
+ * @brief Définit les tampons d'entrée et de sortie d'une connexion client côté serveur.
+ *
+ * Le processus de service lit le socket par blocs dans un tampon d'entrée, et traite en lot toutes les requêtes
+ * complètes qu'il contient. Les réponses produites pendant le lot sont accumulées dans un tampon de sortie et
+ * envoyées ensemble, en un seul appel à write(), à la fin du lot (writev() lorsqu'elles sont suivies de données
+ * trop grandes pour le tampon, comme un instantané volumineux). Lorsque le client envoie plusieurs requêtes
+ * sans attendre les réponses, le nombre d'appels système par requête diminue d'autant.
+ *
+ * Les requêtes sont lues sur place dans le tampon d'entrée (voir decodeRequest()) : il est aligné pour `Request`, et
+ * les requêtes s'y suivent à des multiples de leur taille.
+ *
+ * Les macros définies sont :
+ *  - **CONNECTION_INPUT_REQUESTS** : Nombre de requêtes que peut contenir le tampon d'entrée.
+ *  - **CONNECTION_OUTPUT_SIZE** : Taille du tampon de sortie.
+ *
+ * La structure **ServiceConnection** regroupe le socket de la connexion et ses deux tampons.
+ */
+
+#ifndef SERVICE_CONNECTION_H
+#define SERVICE_CONNECTION_H
+
+#include "Request.h"
+#include "Response.h"
+#include <stddef.h>
+
+/**
+ * @brief Nombre de requêtes que peut contenir le tampon d'entrée.
+ */
+#define CONNECTION_INPUT_REQUESTS 64
+
+/**
+ * @brief Taille du tampon de sortie ; au-delà, il est vidé en cours de lot.
+ */
+#define CONNECTION_OUTPUT_SIZE 16384
+
+/**
+ * @brief Connexion client côté serveur, avec ses tampons.
+ */
+typedef struct {
+    int socket;                                              /**< Socket de service */
+    _Alignas(Request) char input[CONNECTION_INPUT_REQUESTS * sizeof(Request)]; /**< Octets reçus, pas encore traités */
+    size_t inputStart;                                       /**< Début de la prochaine requête dans `input` */
+    size_t inputLength;                                      /**< Fin des octets reçus dans `input` */
+    char output[CONNECTION_OUTPUT_SIZE];                     /**< Réponses en attente d'envoi */
+    size_t outputLength;                                     /**< Nombre d'octets en attente d'envoi */
+} ServiceConnection;
+
+#endif
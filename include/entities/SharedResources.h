@@ -14,16 +14,48 @@
  *    en assurant une synchronisation lors de l'accès à la mémoire partagée.
  *  - **philosophers** : Tableau de structures `ServerPhilosopher` représentant les philosophes côté serveur.
  *    La taille maximale de ce tableau est définie par la constante `MAX_PHILOSOPHERS`.
- *  - **numberPhilosophers** : Nombre actuel de philosophes présents dans la mémoire partagée.
+ *  - **numberPhilosophers** : Nombre de places utilisées dans le tableau des philosophes.
  *  - **chopsticks** : Tableau de structures `Chopstick` représentant les baguettes utilisées par les philosophes.
  *    La taille maximale de ce tableau est également définie par `MAX_PHILOSOPHERS`.
  *  - **numberChopsticks** : Nombre actuel de baguettes dans la mémoire partagée.
+ *  - **seatSlots** et **lastPhilosopherId** : Place courante de chaque philosophe et dernier identifiant attribué.
+ *  - **compaction** : Compteurs du compactage des places (voir Compaction.h).
+ *  - **migration** : Réglage et compteurs de la migration des philosophes (voir Migration.h).
+ *  - **workerPool** : Réglages et compteurs de la réserve de threads du service datagramme (voir WorkerPool.h).
  *  - **logsQueueId** : Identifiant de la file de logs utilisée pour la communication inter-processus dans la gestion des logs.
+ *  - **statistics** : Compteurs globaux de la table, lus par les outils d'observation.
+ *  - **numberSeated** : Nombre de philosophes encore à table (sans les places de ceux qui sont partis).
+ *  - **capacity** : Nombre maximum de philosophes à table, réglable à chaud jusqu'à `MAX_PHILOSOPHERS`.
+ *  - **policy** et **policyLock** : Politique d'arbitrage des repas et verrou permettant d'en changer sans risque.
+ *  - **logLevel** : Niveau de logs courant.
+ *  - **clock** : Étalonnage de l'horloge à haute résolution, commun à tous les processus (voir Clock.h).
+ *  - **profiler** : Réglages et compteurs du profileur par échantillonnage (voir Profiler.h).
+ *  - **perf** : Réglage et totaux des compteurs matériels des repas accordés (voir PerfCounters.h).
+ *  - **spans** : Durées des étapes des repas accordés et exemples des plus lents (voir RequestSpan.h).
+ *  - **allocations** : Compteurs d'allocations de tous les processus du serveur (voir Arena.h).
+ *  - **ledger** : Anneau du registre des repas (voir Ledger.h).
+ *  - **tableCore** : Anneau d'événements et file des affamés de la politique `sequenced` (voir TableCore.h).
+ *  - **structureSize** : Taille de la structure telle que compilée par le serveur qui a créé le segment.
+ *
+ * Le segment est créé avec une clé nommée (macros SHARED_RESOURCES_KEY_PATH et SHARED_RESOURCES_KEY_ID, via `ftok`)
+ * afin que des outils externes, comme le tableau de bord, puissent s'y attacher en lecture seule, et qu'un nouveau
+ * binaire du serveur puisse reprendre la table lors d'une mise à jour à chaud.
  *
  * Les inclusions nécessaires sont :
  *  - "../maxmin_philosophers.h" pour la définition de la constante `MAX_PHILOSOPHERS`.
  *  - "../entities/ServerPhilosopher.h" pour la définition de la structure `ServerPhilosopher`.
  *  - "../entities/Chopstick.h" pour la définition de la structure `Chopstick`.
+ *  - "../entities/Statistics.h" pour la définition de la structure `TableStatistics`.
+ *  - "../entities/Arena.h" pour la définition de la structure `AllocationStats`.
+ *  - "../entities/Ledger.h" pour la définition de la structure `Ledger`.
+ *  - "../entities/Compaction.h" pour la définition de la structure `CompactionStats`.
+ *  - "../entities/Migration.h" pour la définition de la structure `MigrationState`.
+ *  - "../entities/WorkerPool.h" pour la définition de la structure `WorkerPoolState`.
+ *  - "../entities/Clock.h" pour la définition de la structure `ClockCalibration`.
+ *  - "../entities/Profiler.h" pour la définition de la structure `ProfilerState`.
+ *  - "../entities/PerfCounters.h" pour la définition de la structure `PerfCounterState`.
+ *  - "../entities/RequestSpan.h" pour la définition de la structure `SpanStatistics`.
+ *  - "../entities/TableCore.h" pour la définition de la structure `TableCore`.
  *
  * Les directives de préprocesseur (#ifndef, #define, #endif) garantissent que ce fichier est inclus une seule fois
  * lors de la compilation.
@@ -35,6 +67,73 @@
 #include "../maxmin_philosophers.h"
 #include "../entities/ServerPhilosopher.h"
 #include "../entities/Chopstick.h"
+#include "../entities/Statistics.h"
+#include "../entities/Logs.h"
+#include "../entities/Arena.h"
+#include "../entities/Ledger.h"
+#include "../entities/Compaction.h"
+#include "../entities/Migration.h"
+#include "../entities/WorkerPool.h"
+#include "../entities/Clock.h"
+#include "../entities/Profiler.h"
+#include "../entities/PerfCounters.h"
+#include "../entities/RequestSpan.h"
+#include "../entities/TableCore.h"
+#include <pthread.h>
+
+/**
+ * @brief Chemin utilisé pour générer la clé du segment de mémoire partagée (relatif au dossier src).
+ */
+#define SHARED_RESOURCES_KEY_PATH "../logs"
+
+/**
+ * @brief Identifiant de projet utilisé pour générer la clé du segment de mémoire partagée.
+ */
+#define SHARED_RESOURCES_KEY_ID 'P'
+
+/**
+ * @brief Argument du serveur demandant l'initialisation de toutes les places dès la création de la table.
+ *
+ * Sans cet argument, le segment est seulement réservé : ses pages ne sont touchées qu'à l'arrivée de chaque
+ * philosophe (createChopstick()). Avec, les baguettes et les places sont initialisées au démarrage, en parallèle
+ * sur tous les cœurs (preallocateSharedResources()), pour ne plus payer ces défauts de page pendant le service.
+ */
+#define PREALLOCATE_ARGUMENT "--preallocate"
+
+/**
+ * @brief Nombre minimum de places initialisées par chaque thread de préallocation.
+ *
+ * En deçà, créer un thread coûte plus cher que l'initialisation qu'il se partage avec les autres.
+ */
+#define PREALLOCATE_MIN_SEATS_PER_THREAD 4096
+
+/**
+ * @brief Nombre maximum de threads de préallocation.
+ */
+#define PREALLOCATE_MAX_THREADS 64
+
+/**
+ * @brief Politiques d'arbitrage de l'accès aux baguettes.
+ */
+typedef enum {
+    /**
+     * Un compteur limite à la moitié des philosophes ceux qui cherchent à manger, puis chacun prend sa baguette
+     * gauche avant sa baguette droite (fonctionnement historique).
+     */
+    POLICY_COUNTER,
+
+    /**
+     * Sans compteur : chaque philosophe prend d'abord la baguette de plus petit identifiant (hiérarchie des
+     * ressources), ce qui suffit à empêcher l'interblocage.
+     */
+    POLICY_ORDERED,
+
+    /**
+     * Un seul thread, le cœur de la table, tient la file des affamés et accorde les deux baguettes ensemble (voir
+     * TableCore.h) ; les processus de service ne font que publier leurs demandes et attendre leur repas.
+     */
+    POLICY_SEQUENCED
+} ArbitrationPolicy;
 
 /**
  * @brief Structure regroupant les ressources partagées du serveur.
@@ -69,7 +168,8 @@ typedef struct {
     ServerPhilosopher philosophers[MAX_PHILOSOPHERS];
 
     /**
-     * @brief Nombre actuel de philosophes dans la mémoire partagée.
+     * @brief Nombre de places utilisées dans le tableau des philosophes, y compris celles des philosophes partis
+     * que le compactage n'a pas encore effacées.
      */
     int numberPhilosophers;
     
@@ -86,6 +186,34 @@ typedef struct {
      */
     int numberChopsticks;
 
+    /**
+     * @brief Table de renvoi des identifiants : `seatSlots[id - 1]` vaut la place du philosophe `id` plus 1, ou 0
+     * s'il n'existe pas ou que sa place a été effacée.
+     *
+     * Mise à jour par le compactage et la migration quand ils déplacent une place (voir Compaction.h et Migration.h).
+     */
+    int seatSlots[MAX_PHILOSOPHERS];
+
+    /**
+     * @brief Dernier identifiant de philosophe attribué : les identifiants ne sont pas réutilisés.
+     */
+    int lastPhilosopherId;
+
+    /**
+     * @brief Compteurs du compactage des places.
+     */
+    CompactionStats compaction;
+
+    /**
+     * @brief Réglage et compteurs de la migration des philosophes.
+     */
+    MigrationState migration;
+
+    /**
+     * @brief Réglages et compteurs de la réserve de threads du service datagramme.
+     */
+    WorkerPoolState workerPool;
+
     /**
      * @brief Identifiant de la file de logs.
      *
@@ -93,6 +221,110 @@ typedef struct {
      */
     int logsQueueId;
 
+    /**
+     * @brief Compteurs globaux de la table.
+     *
+     * Mis à jour par les processus de service à chaque repas accordé, et lus sans verrou par les outils d'observation.
+     */
+    TableStatistics statistics;
+
+    /**
+     * @brief Nombre de philosophes encore à table.
+     *
+     * `numberPhilosophers` compte aussi les places des philosophes partis que le compactage n'a pas encore effacées,
+     * tandis que ce compteur ne compte que les philosophes présents. Le compteur `maxAllowedEating` suit sa moitié.
+     */
+    int numberSeated;
+
+    /**
+     * @brief Nombre maximum de philosophes à table, entre `MIN_PHILOSOPHERS` et `MAX_PHILOSOPHERS`.
+     */
+    int capacity;
+
+    /**
+     * @brief Politique d'arbitrage appliquée aux nouvelles demandes de repas.
+     */
+    ArbitrationPolicy policy;
+
+    /**
+     * @brief Verrou protégeant le changement de politique.
+     *
+     * Chaque prise de baguettes se fait sous ce verrou en lecture ; le changement de politique le prend en écriture
+     * et attend donc que les prises en cours, commencées avec l'ancienne politique, soient terminées. Mélanger les
+     * deux politiques pourrait sinon créer un interblocage.
+     */
+    pthread_rwlock_t policyLock;
+
+    /**
+     * @brief Niveau de logs courant.
+     */
+    LogLevel logLevel;
+
+    /**
+     * @brief Étalonnage de l'horloge à haute résolution.
+     *
+     * Mesuré par le processus principal à la création du segment, ré-ancré par son thread de compactage ; une mise à
+     * jour à chaud le reprend tel quel.
+     */
+    ClockCalibration clock;
+
+    /**
+     * @brief Réglages et compteurs du profileur, modifiables à chaud par la commande de contrôle `profile`.
+     *
+     * Chaque processus du serveur attend les changements de réglage sur le compteur `generation` (futex).
+     */
+    ProfilerState profiler;
+
+    /**
+     * @brief Réglage et totaux des compteurs matériels des repas accordés, activés à chaud par la commande de
+     * contrôle `perf`.
+     */
+    PerfCounterState perf;
+
+    /**
+     * @brief Histogrammes des durées des étapes des repas accordés et spans des plus lents, remis à zéro par la
+     * commande de contrôle `spans reset`.
+     */
+    SpanStatistics spans;
+
+    /**
+     * @brief Numéro de version de la table, incrémenté après chaque changement d'état d'une place.
+     *
+     * Permet aux abonnés (voir Watch.h) de savoir sans parcourir les places que rien n'a changé.
+     */
+    uint64_t tableVersion;
+
+    /**
+     * @brief Compteurs d'allocations de tous les processus du serveur.
+     *
+     * Le nombre d'allocations sur le tas ne doit plus bouger une fois les philosophes attablés : les repas
+     * accordés n'allouent que dans les arènes et les réserves de blocs.
+     */
+    AllocationStats allocations;
+
+    /**
+     * @brief Anneau du registre des repas, alimenté par les processus de service et vidé par le processus principal.
+     *
+     * Nul à la création du segment : le processus principal l'initialise à l'ouverture du fichier du registre.
+     * Une mise à jour à chaud le reprend tel quel.
+     */
+    Ledger ledger;
+
+    /**
+     * @brief Anneau d'événements, séquences et file des affamés du cœur de la table (politique `sequenced`).
+     *
+     * Nul à la création du segment, hormis le processeur du cœur ; une mise à jour à chaud le reprend tel quel.
+     */
+    TableCore tableCore;
+
+    /**
+     * @brief Taille de la structure telle que compilée par le serveur qui a créé le segment.
+     *
+     * Lors d'une mise à jour à chaud, le nouveau binaire ne reprend la table que si sa propre structure a la même
+     * taille : un changement de disposition rendrait l'état partagé illisible.
+     */
+    size_t structureSize;
+
 } SharedResources;
 
 
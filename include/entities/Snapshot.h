@@ -0,0 +1,53 @@
+/**
+ * @file Snapshot.h
+ * @brief Définit le format de l'instantané de la table renvoyé par une requête REQUEST_SNAPSHOT.
+ *
+ * L'instantané décrit en un seul message toute la table : l'état et le timer de chaque place, le détenteur de
+ * chaque baguette, et les places libres au compteur. Il est pris sans arrêter la table : les valeurs sont copiées
+ * sans verrou, puis la copie est validée par le numéro de version de la table (voir Watch.h) ; si un changement a
+ * été publié pendant la copie, elle est recommencée, jusqu'à SNAPSHOT_MAX_ATTEMPTS fois.
+ *
+ * Après la réponse RESPONSE_SNAPSHOT, le serveur envoie un en-tête `SnapshotHeader` suivi de `length` octets :
+ *  - les états, sur 2 bits par place (THINKING, HUNGRY, EATING ou WATCH_STATE_DEPARTED), quatre places par octet
+ *    en commençant par les bits de poids faible ;
+ *  - l'identifiant de chaque place, en varint zigzag de l'écart avec le précédent (à partir de 0) : un octet par
+ *    place tant que les identifiants se suivent ;
+ *  - l'identifiant de chaque baguette, en varint zigzag de l'écart avec celui de la place de même rang (un octet,
+ *    0, tant que le philosophe n'a pas changé de place, voir Migration.h), ou avec la baguette précédente pour la
+ *    baguette d'un philosophe en cours de création ;
+ *  - le timer de chaque place, en varint zigzag (voir varint.h) ;
+ *  - le détenteur de chaque baguette, en varint : 0 si elle est libre, sinon 1 + l'écart zigzag entre l'identifiant
+ *    du détenteur et celui de la baguette (un seul octet pour l'un de ses deux voisins).
+ *
+ * Les places et les baguettes sont rangées dans l'ordre de l'anneau. Les identifiants ne sont pas réutilisés et le
+ * compactage (voir Compaction.h) efface les places des philosophes partis : ils ne se suivent donc pas toujours.
+ * Un instantané de 100 000 places occupe 425 Ko environ (4,25 octets par place : 2 bits d'état et un octet pour
+ * l'identifiant, la baguette, le timer et le détenteur), et au plus 4 Mo (voir getSnapshotMaxSize()), si chaque
+ * varint prend sa taille maximale.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+
+/**
+ * @brief Nombre maximum de copies tentées pour obtenir un instantané cohérent.
+ */
+#define SNAPSHOT_MAX_ATTEMPTS 64
+
+/**
+ * @brief En-tête d'un instantané.
+ */
+typedef struct {
+    uint64_t tableVersion;      /**< Numéro de version de la table au moment de la copie */
+    uint32_t length;            /**< Nombre d'octets qui suivent l'en-tête */
+    uint32_t numberSeats;       /**< Nombre de places, y compris celles des philosophes partis */
+    uint32_t numberChopsticks;  /**< Nombre de baguettes */
+    int32_t admissionAvailable; /**< Places libres au compteur */
+    uint8_t policy;             /**< Politique d'arbitrage (ArbitrationPolicy) */
+    uint8_t consistent;         /**< 0 si aucune copie n'a pu être validée : l'instantané peut mêler deux états */
+    uint16_t reserved;          /**< Réservé, toujours 0 */
+} SnapshotHeader;
+
+#endif
@@ -0,0 +1,52 @@
+/**
+ * @file Statistics.h
+ * @brief Définit les structures des statistiques de la table tenues en mémoire partagée.
+ *
+ * Ces statistiques sont mises à jour par les processus de service au moment où les repas sont accordés, et lues
+ * sans verrou par les outils d'observation (tableau de bord, échantillonnage des métriques). Elles ne passent
+ * pas par la file de messages des logs : les consulter n'ajoute aucune charge au serveur.
+ *
+ * Les structures définies sont :
+ *  - **Histogram** : Histogramme à échelle logarithmique (puissances de 2) d'une grandeur entière.
+ *  - **TableStatistics** : Compteurs globaux de la table (repas accordés, histogramme des temps d'attente).
+ *
+ * Les macros définies sont :
+ *  - **HISTOGRAM_BUCKETS** : Nombre de classes d'un histogramme. La classe 0 compte les valeurs nulles, la classe
+ *    i (i > 0) les valeurs comprises dans [2^(i-1), 2^i).
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <stdint.h>
+
+/**
+ * @brief Nombre de classes d'un histogramme (couvre toutes les valeurs sur 64 bits).
+ */
+#define HISTOGRAM_BUCKETS 64
+
+/**
+ * @brief Histogramme à échelle logarithmique.
+ */
+typedef struct {
+    uint64_t buckets[HISTOGRAM_BUCKETS]; /**< Nombre de valeurs par classe */
+} Histogram;
+
+/**
+ * @brief Compteurs globaux de la table.
+ */
+typedef struct {
+
+    /**
+     * @brief Nombre total de repas accordés depuis le démarrage du serveur.
+     */
+    uint64_t meals;
+
+    /**
+     * @brief Histogramme des temps d'attente (en microsecondes) entre la demande d'un philosophe et son repas.
+     */
+    Histogram waitHistogram;
+
+} TableStatistics;
+
+#endif
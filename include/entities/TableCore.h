@@ -0,0 +1,141 @@
+/**
+ * @file TableCore.h
+ * @brief Définit le cœur séquencé de la table : un anneau d'événements appliqués par un seul thread.
+ *
+ * Avec les politiques `counter` et `ordered`, chaque processus de service prend lui-même les baguettes de son
+ * philosophe : les sémaphores et les champs de la table sont modifiés en concurrence par tous les processus. La
+ * politique `sequenced` confie l'arbitrage à un seul écrivain, sur le modèle du disruptor :
+ *
+ *  - Les processus de service (et les threads du service datagramme) publient leurs événements (arrivée, départ,
+ *    faim, fin de repas) dans un anneau préalloué en mémoire partagée : la séquence est réservée par incrément
+ *    atomique, la case écrite puis publiée, comme pour le registre des repas (voir Ledger.h).
+ *  - Le thread du cœur, épinglé sur un processeur, applique les événements publiés dans l'ordre des séquences, par
+ *    lots, sans verrou : il tient seul la file des philosophes affamés et seul prend et rend les baguettes. Les
+ *    repas qu'il accorde sont notés dans la case de l'événement qui les a permis.
+ *  - Trois consommateurs suivent le cœur sur le même anneau, chacun à sa séquence : les logs de la table, le
+ *    registre des repas, puis les réponses, qui réveillent les philosophes servis une fois leur repas consigné.
+ *    Une case n'est réutilisée qu'une fois lue par tous.
+ *
+ * Aucun philosophe ne prend une baguette puis attend l'autre : le cœur accorde les deux ensemble, ou aucune. Après
+ * chaque événement, aucun philosophe de la file ne peut être servi ; une fin de repas ne rend que deux baguettes,
+ * et ne permet donc qu'au plus deux repas (TABLE_EVENT_MAX_GRANTS).
+ *
+ * Les arrivées et les départs continuent de modifier l'anneau des places sous le verrou de la politique (voir
+ * ServerPhilosopher.c) ; ils sont publiés pour que le flux d'événements retrace toute la vie de la table. Les
+ * logs consignent tout le flux, le registre ses repas et ses fins de repas. La file des affamés et les séquences
+ * sont en mémoire partagée : une mise à jour à chaud reprend le cœur là où il s'était arrêté.
+ *
+ * Les structures définies sont :
+ *  - **TableEventType** : Types d'événements.
+ *  - **TableGrant** : Repas accordé par le cœur.
+ *  - **TableEvent** : Case de l'anneau.
+ *  - **TableConsumer** : Consommateurs de l'anneau.
+ *  - **TableCore** : Anneau, séquences et file des affamés, en mémoire partagée.
+ */
+
+#ifndef TABLE_CORE_H
+#define TABLE_CORE_H
+
+#include "../maxmin_philosophers.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Nombre de cases de l'anneau (puissance de 2). Un producteur attend si l'anneau est plein.
+ */
+#define TABLE_EVENT_RING_SIZE 1024
+
+/**
+ * @brief Nombre maximal de repas accordés à la suite d'un événement.
+ */
+#define TABLE_EVENT_MAX_GRANTS 2
+
+/**
+ * @brief Délai au bout duquel une case réservée mais jamais publiée est sautée (processus tué pendant l'écriture).
+ */
+#define TABLE_EVENT_HOLE_TIMEOUT_MS 1000
+
+/**
+ * @brief Attente maximale d'un thread de l'anneau avant de revérifier l'arrêt et les cases non publiées.
+ */
+#define TABLE_CORE_WAIT_MS 100
+
+/**
+ * @brief Attente au bout de laquelle un philosophe affamé relance le cœur (voir TABLE_EVENT_RETRY).
+ */
+#define TABLE_GRANT_RETRY_MS 1000
+
+/**
+ * @brief Types d'événements.
+ */
+typedef enum {
+    TABLE_EVENT_HOLE = 0,    /**< Séquence réservée mais jamais publiée */
+    TABLE_EVENT_JOIN = 1,    /**< Un philosophe s'est attablé */
+    TABLE_EVENT_LEAVE = 2,   /**< Un philosophe a quitté la table */
+    TABLE_EVENT_HUNGRY = 3,  /**< Un philosophe demande à manger */
+    TABLE_EVENT_RELEASE = 4, /**< Un philosophe a fini de manger et rend ses baguettes */
+    TABLE_EVENT_RETRY = 5    /**< Un philosophe affamé attend depuis longtemps : le cœur réexamine sa demande, et la
+                                  remet dans la file si elle a été perdue */
+} TableEventType;
+
+/**
+ * @brief Repas accordé par le cœur.
+ */
+typedef struct {
+    int32_t philosopherId;   /**< Philosophe servi, 0 pour une case vide */
+    uint32_t leftChopstick;  /**< Baguette gauche prise */
+    uint32_t rightChopstick; /**< Baguette droite prise */
+    uint64_t ledgerSequence; /**< Séquence du repas dans le registre, écrite par le consommateur du registre */
+} TableGrant;
+
+/**
+ * @brief Case de l'anneau.
+ *
+ * Écrite par son producteur, puis complétée par le cœur (baguettes rendues, repas accordés) et par le consommateur
+ * du registre (séquences) : chaque champ n'a qu'un écrivain, et chaque consommateur ne lit la case qu'après ceux
+ * qui l'ont complétée.
+ */
+typedef struct {
+    uint64_t stamp;                             /**< Séquence publiée + 1, 0 pour une case jamais utilisée */
+    uint16_t type;                              /**< TableEventType */
+    int32_t philosopherId;                      /**< Philosophe de l'événement */
+    uint64_t timestamp;                         /**< Heure de publication (ns, voir Clock.h) */
+    uint32_t releasedLeftChopstick;             /**< Baguette gauche rendue par une fin de repas, 0 sinon */
+    uint32_t releasedRightChopstick;            /**< Baguette droite rendue par une fin de repas, 0 sinon */
+    TableGrant grants[TABLE_EVENT_MAX_GRANTS];  /**< Repas accordés par le cœur à la suite de l'événement */
+} TableEvent;
+
+/**
+ * @brief Consommateurs de l'anneau, qui suivent le cœur.
+ */
+typedef enum {
+    TABLE_CONSUMER_LOGS,     /**< Logs de la table */
+    TABLE_CONSUMER_LEDGER,   /**< Registre des repas */
+    TABLE_CONSUMER_RESPONSES,/**< Réveil des philosophes servis, après le registre */
+    TABLE_CONSUMERS
+} TableConsumer;
+
+/**
+ * @brief Anneau d'événements, séquences du cœur et des consommateurs, et file des philosophes affamés.
+ */
+typedef struct {
+    uint64_t nextSequence;                           /**< Prochaine séquence à réserver */
+    uint32_t publishedFutex;                         /**< Incrémenté à chaque publication, réveille le cœur */
+    uint64_t appliedSequence;                        /**< Séquences inférieures appliquées par le cœur */
+    uint32_t appliedFutex;                           /**< Incrémenté à chaque lot du cœur */
+    uint64_t consumedSequences[TABLE_CONSUMERS];     /**< Séquences inférieures traitées par chaque consommateur */
+    uint32_t consumedFutex;                          /**< Incrémenté à chaque lot d'un consommateur */
+    int32_t cpu;                                     /**< Processeur du cœur, -1 s'il n'est pas épinglé */
+    uint64_t stalledSequence;                        /**< Séquence non publiée attendue par le cœur */
+    uint64_t stalledSince;                           /**< Heure (ns) depuis laquelle elle est attendue */
+    uint64_t appliedEvents;                          /**< Événements appliqués */
+    uint64_t batches;                                /**< Lots appliqués */
+    uint32_t largestBatch;                           /**< Plus grand lot appliqué */
+    uint64_t grants;                                 /**< Repas accordés */
+    uint64_t holes;                                  /**< Séquences sautées */
+    int32_t numberWaiting;                           /**< Philosophes dans la file des affamés */
+    TableEvent slots[TABLE_EVENT_RING_SIZE];         /**< Anneau */
+    int32_t waiting[MAX_PHILOSOPHERS];               /**< File des affamés, par ordre d'arrivée */
+} TableCore;
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * @file Upgrade.h
+ * @brief Définit les constantes de la mise à jour à chaud du serveur.
+ *
+ * Lors d'une mise à jour à chaud (commande de contrôle `upgrade`), le processus principal du serveur remplace son
+ * binaire par exec() sans se terminer : il garde son PID, ses processus de service (qui continuent de servir les
+ * philosophes sans interruption) et les descripteurs qu'il a rendus héritables. Le nouveau binaire est lancé avec
+ * l'argument UPGRADE_ARGUMENT suivi du numéro d'un descripteur (l'extrémité en lecture d'un tube) sur lequel
+ * l'ancien binaire a décrit l'état à reprendre, une ligne par élément :
+ *  - `server <fd>` : socket d'écoute des clients.
+ *  - `control <fd>` : socket de contrôle, -1 s'il n'est pas ouvert.
+ *  - `binary <fd>` : ancien binaire ouvert en lecture, pour y revenir si le nouveau ne peut pas reprendre la table.
+ *  - `executable <chemin>` : chemin du binaire lancé à l'origine.
+ *  - `segment <adresse>` : adresse de la mémoire partagée dans le processus principal. Les places y rangent des
+ *    pointeurs vers leurs baguettes, partagés par tous les processus : le nouveau binaire attache le segment à la
+ *    même adresse, ou revient à l'ancien binaire.
+ *  - `client <pid> <fd>` : processus de service et copie de son socket de service, un par client.
+ *  - `datagram <pid>` : service datagramme (voir DatagramService.h), parmi les processus de service, s'il est lancé.
+ *
+ * Les macros définies sont :
+ *  - **UPGRADE_ARGUMENT** : Argument indiquant au serveur qu'il reprend une table en fonctionnement.
+ *  - **UPGRADE_EXECUTABLE_PREFIX** : Préfixe de la ligne du chemin du binaire.
+ *  - **UPGRADE_LINE_SIZE** : Taille maximale d'une ligne de l'état transmis.
+ */
+
+#ifndef UPGRADE_H
+#define UPGRADE_H
+
+#include <limits.h>
+
+/**
+ * @brief Argument indiquant au serveur qu'il reprend une table en fonctionnement.
+ */
+#define UPGRADE_ARGUMENT "--upgrade"
+
+/**
+ * @brief Préfixe de la ligne du chemin du binaire.
+ */
+#define UPGRADE_EXECUTABLE_PREFIX "executable "
+
+/**
+ * @brief Taille maximale d'une ligne de l'état transmis : la plus longue est celle du chemin du binaire (au plus
+ * PATH_MAX - 1 caractères), avec son préfixe, son retour à la ligne et le caractère nul final.
+ */
+#define UPGRADE_LINE_SIZE (PATH_MAX + sizeof(UPGRADE_EXECUTABLE_PREFIX))
+
+#endif
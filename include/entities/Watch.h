@@ -0,0 +1,98 @@
+/**
+ * @file Watch.h
+ * @brief Définit les constantes et structures des abonnements aux changements d'état de la table.
+ *
+ * Une connexion qui envoie une requête REQUEST_WATCH au lieu de REQUEST_CREATE ne reçoit pas de philosophe : son
+ * processus de service lui envoie, au plus `maxRate` fois par seconde, un lot des changements d'état survenus sur
+ * les places suivies (une place, la place et ses deux voisins, ou toute la table).
+ *
+ * Chaque place porte en mémoire partagée un numéro de version, incrémenté à chaque changement de son état ; la table
+ * porte un numéro global. Le chemin d'attribution des repas ne fait donc qu'incrémenter deux compteurs, quel que soit
+ * le nombre d'abonnés : c'est le processus de chaque abonné qui compare les versions à celles déjà envoyées. Les
+ * changements survenus entre deux envois sont fusionnés, seul le dernier état de chaque place est envoyé. Un
+ * abonné trop lent (tampon du socket plein) ne reçoit pas le lot : il recevra le suivant, qui contient l'état le
+ * plus récent, plutôt qu'une file de lots qui grandirait sans limite.
+ *
+ * Après la réponse RESPONSE_WATCH, le serveur envoie une suite de lots, chacun composé d'un en-tête `WatchBatchHeader`
+ * suivi de `count` structures `WatchEntry`. Le premier lot contient l'état de toutes les places suivies.
+ *
+ * Les macros définies sont :
+ *  - **MAX_WATCHERS** : Nombre maximum d'abonnés simultanés.
+ *  - **WATCH_DEFAULT_RATE** / **WATCH_MAX_RATE** : Fréquence d'envoi par défaut et maximale.
+ *  - **WATCH_STATE_DEPARTED** : État envoyé pour une place dont le philosophe a quitté la table.
+ *  - **WATCH_FLAG_DRAINING** / **WATCH_FLAG_EVICTED** : Indicateurs d'une place.
+ */
+
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <stdint.h>
+
+/**
+ * @brief Nombre maximum d'abonnés simultanés, en plus des philosophes.
+ */
+#define MAX_WATCHERS 256
+
+/**
+ * @brief Nombre de lots envoyés par seconde lorsque l'abonné ne précise pas de fréquence.
+ */
+#define WATCH_DEFAULT_RATE 10
+
+/**
+ * @brief Nombre maximum de lots envoyés par seconde.
+ */
+#define WATCH_MAX_RATE 100
+
+/**
+ * @brief État envoyé pour une place dont le philosophe a quitté la table (à la suite de THINKING, HUNGRY, EATING).
+ */
+#define WATCH_STATE_DEPARTED 3
+
+/**
+ * @brief Le philosophe n'est plus servi (drain).
+ */
+#define WATCH_FLAG_DRAINING 1
+
+/**
+ * @brief Le philosophe quittera la table à sa prochaine requête.
+ */
+#define WATCH_FLAG_EVICTED 2
+
+/**
+ * @brief Étendue d'un abonnement.
+ */
+typedef enum {
+    WATCH_SEAT,       /**< Une seule place */
+    WATCH_NEIGHBOURS, /**< Une place et ses deux voisins dans l'anneau */
+    WATCH_TABLE       /**< Toutes les places */
+} WatchScope;
+
+/**
+ * @brief Abonnement demandé par une requête REQUEST_WATCH.
+ */
+typedef struct {
+    WatchScope scope; /**< Étendue de l'abonnement */
+    int seat;         /**< Identifiant du philosophe suivi (ignoré pour WATCH_TABLE) */
+    int maxRate;      /**< Nombre maximum de lots par seconde, 0 pour WATCH_DEFAULT_RATE */
+} WatchSubscription;
+
+/**
+ * @brief En-tête d'un lot de changements.
+ */
+typedef struct {
+    uint32_t sequence;  /**< Numéro du lot, à partir de 0 */
+    uint16_t count;     /**< Nombre de places qui suivent l'en-tête */
+    uint16_t coalesced; /**< Nombre de changements fusionnés dans le lot (plafonné à 65535) */
+} WatchBatchHeader;
+
+/**
+ * @brief Dernier état d'une place.
+ */
+typedef struct {
+    uint16_t id;    /**< Identifiant du philosophe */
+    uint8_t state;  /**< PhilosopherState, ou WATCH_STATE_DEPARTED */
+    uint8_t flags;  /**< WATCH_FLAG_DRAINING, WATCH_FLAG_EVICTED */
+    uint32_t meals; /**< Nombre de repas accordés */
+} WatchEntry;
+
+#endif
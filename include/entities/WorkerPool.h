@@ -0,0 +1,98 @@
+/**
+ * @file WorkerPool.h
+ * @brief Définit la réserve élastique de threads qui exécute les opérations bloquantes du service datagramme.
+ *
+ * Les opérations qui peuvent attendre (création, demande de repas, départ, voir DatagramService.h) sont déposées
+ * dans une file et exécutées par une réserve de threads dont la taille suit la charge :
+ *  - elle grandit aussitôt qu'une opération déposée ne trouve pas de thread libre (la file est plus longue que le
+ *    nombre de threads libres), ou que la plus ancienne opération de la file attend depuis plus de
+ *    `growLatencyMs` : une rafale obtient ses threads sans attendre ;
+ *  - elle rétrécit d'un thread chaque fois qu'un thread est resté libre pendant `idleTimeoutMs`, sans descendre
+ *    sous `minWorkers`. Ce délai fait l'hystérésis : une charge qui oscille ne crée et ne détruit pas de threads
+ *    à chaque opération.
+ * Un thread libre attend sur une variable de condition : une table calme ne consomme rien. La réserve ne dépasse
+ * jamais `maxWorkers` ; au-delà, les opérations attendent dans la file.
+ *
+ * Une demande de repas occupe son thread jusqu'au repas : `maxWorkers` borne donc le nombre de philosophes en mode
+ * datagramme qui attendent leurs baguettes en même temps. Les baguettes étant rendues par la boucle principale du
+ * service, sans passer par la réserve, les philosophes en attente finissent toujours par être servis.
+ *
+ * Les processus de service TCP ne sont pas concernés : chaque connexion garde son processus, qui dort dans read()
+ * tant que son client ne demande rien.
+ *
+ * Les réglages, modifiables à chaud par la commande de contrôle `pool`, et les compteurs sont en mémoire partagée ;
+ * la file et les threads appartiennent au processus du service datagramme, qui applique un changement de réglage au
+ * tour suivant de sa boucle principale.
+ *
+ * Les structures définies sont :
+ *  - **WorkerPoolState** : Réglages et compteurs de la réserve, en mémoire partagée.
+ *  - **WorkerPool** : File des opérations et état des threads.
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "../maxmin_philosophers.h"
+#include "Statistics.h"
+#include <stdint.h>
+#include <pthread.h>
+
+/**
+ * @brief Nombre minimal de threads par défaut.
+ */
+#define WORKER_POOL_DEFAULT_MIN 2
+
+/**
+ * @brief Nombre maximal de threads par défaut (une opération par place au plus).
+ */
+#define WORKER_POOL_DEFAULT_MAX (MAX_PHILOSOPHERS < 1024 ? MAX_PHILOSOPHERS : 1024)
+
+/**
+ * @brief Délai par défaut au bout duquel un thread libre s'arrête, en millisecondes.
+ */
+#define WORKER_POOL_DEFAULT_IDLE_TIMEOUT_MS 2000
+
+/**
+ * @brief Attente par défaut dans la file au-delà de laquelle un thread est ajouté, en millisecondes.
+ */
+#define WORKER_POOL_DEFAULT_GROW_LATENCY_MS 5
+
+/**
+ * @brief Réglages et compteurs de la réserve.
+ */
+typedef struct {
+    int minWorkers;           /**< Nombre de threads gardés même sans opération */
+    int maxWorkers;           /**< Nombre maximal de threads */
+    uint32_t idleTimeoutMs;   /**< Délai au bout duquel un thread libre s'arrête */
+    uint32_t growLatencyMs;   /**< Attente dans la file au-delà de laquelle un thread est ajouté */
+
+    int workers;              /**< Threads en vie */
+    int idleWorkers;          /**< Threads libres */
+    int queued;               /**< Opérations en attente d'un thread */
+    int peakWorkers;          /**< Nombre maximal de threads atteint */
+    uint64_t spawned;         /**< Threads créés */
+    uint64_t retired;         /**< Threads arrêtés faute d'opération */
+    uint64_t jobs;            /**< Opérations exécutées */
+    Histogram queueWaits;     /**< Attente des opérations dans la file, en microsecondes */
+} WorkerPoolState;
+
+/**
+ * @brief File des opérations et état des threads de la réserve.
+ *
+ * Une opération est désignée par un entier (l'indice de la session pour le service datagramme) : chaque session
+ * n'a qu'une opération à la fois, la file tient donc en MAX_PHILOSOPHERS cases.
+ */
+typedef struct {
+    pthread_mutex_t lock;              /**< Protège la file et les compteurs de threads */
+    pthread_cond_t available;          /**< Signalée au dépôt d'une opération */
+    int items[MAX_PHILOSOPHERS];       /**< File circulaire des opérations */
+    uint64_t queuedAt[MAX_PHILOSOPHERS]; /**< Heure monotone (ns) du dépôt de chaque opération */
+    int head;                          /**< Indice de la plus ancienne opération */
+    int appliedMinWorkers;             /**< Valeur de `minWorkers` connue des threads libres */
+    int appliedMaxWorkers;             /**< Valeur de `maxWorkers` connue des threads libres */
+    void (*run)(void *context, int item); /**< Exécute une opération */
+    void *context;                     /**< Premier argument de `run` */
+    WorkerPoolState *state;            /**< Réglages et compteurs, en mémoire partagée */
+} WorkerPool;
+
+#endif
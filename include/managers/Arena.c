@@ -0,0 +1,263 @@
+/**
+ * @file Arena.c
+ * @brief Implémente les arènes, les réserves de blocs de taille fixe et le comptage des allocations sur le tas.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **setAllocationStatsSource()** : Indique où tenir les compteurs d'allocations (en mémoire partagée).
+ *  - **countedMalloc()** : Alloue sur le tas en comptant l'allocation.
+ *  - **initArena()**, **arenaAlloc()**, **resetArena()** : Création, découpage et remise à zéro d'une arène.
+ *  - **getScratchArena()** : Retourne l'arène de travail du thread courant, créée à sa première utilisation.
+ *  - **initSlabPool()**, **slabAlloc()**, **slabFree()** : Création d'une réserve, prise et rendu d'un bloc.
+ *  - **getPathPool()**, **getSessionPool()** : Réserves des chemins de fichiers de log et des sessions de logs.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Arena.h" pour les structures et les tailles.
+ *  - "../entities/Logs.h" pour la taille d'une session de logs (`LogThreadInfo`).
+ */
+
+#ifndef ARENA_C
+#define ARENA_C
+
+#include "../entities/Arena.h"
+#include "../entities/Logs.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Compteurs du processus tant que ceux de la mémoire partagée ne sont pas connus.
+ */
+AllocationStats localAllocationStats;
+
+/**
+ * @brief Compteurs d'allocations courants.
+ *
+ * Pointe vers la mémoire partagée une fois le serveur initialisé : les processus de service, créés par fork(),
+ * héritent du pointeur et comptent donc au même endroit que le processus principal.
+ */
+AllocationStats *allocationStats = &localAllocationStats;
+
+/**
+ * @brief Indique où tenir les compteurs d'allocations.
+ *
+ * @param stats Pointeur vers les compteurs, en mémoire partagée.
+ */
+void setAllocationStatsSource(AllocationStats *stats) {
+    allocationStats = stats;
+}
+
+/**
+ * @brief Alloue sur le tas en comptant l'allocation.
+ *
+ * @param size Taille demandée.
+ * @return void* Le bloc, à libérer avec free(), ou NULL en cas d'échec.
+ */
+void *countedMalloc(size_t size) {
+    __atomic_add_fetch(&allocationStats->heapAllocations, 1, __ATOMIC_RELAXED);
+    return malloc(size);
+}
+
+/**
+ * @brief Arrondit une taille au multiple supérieur de ARENA_ALIGNMENT.
+ *
+ * @param size La taille.
+ * @return size_t La taille arrondie.
+ */
+size_t alignArenaSize(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t) (ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Crée une arène : son tampon est la seule allocation sur le tas de toute sa durée de vie.
+ *
+ * @param arena L'arène.
+ * @param capacity Taille du tampon.
+ * @return bool false en cas d'échec de l'allocation.
+ */
+bool initArena(Arena *arena, size_t capacity) {
+    arena->base = countedMalloc(capacity);
+    arena->capacity = arena->base ? capacity : 0;
+    arena->used = 0;
+    arena->highWater = 0;
+
+    return arena->base != NULL;
+}
+
+/**
+ * @brief Découpe un bloc dans une arène.
+ *
+ * @param arena L'arène.
+ * @param size Taille demandée.
+ * @return void* Le bloc, valable jusqu'à la prochaine remise à zéro de l'arène, ou NULL si elle est pleine.
+ */
+void *arenaAlloc(Arena *arena, size_t size) {
+    size_t alignedSize = alignArenaSize(size);
+
+    if (alignedSize > arena->capacity - arena->used) {
+        return NULL;
+    }
+
+    void *block = arena->base + arena->used;
+    arena->used += alignedSize;
+
+    if (arena->used > arena->highWater) {
+        arena->highWater = arena->used;
+    }
+
+    __atomic_add_fetch(&allocationStats->arenaAllocations, 1, __ATOMIC_RELAXED);
+    return block;
+}
+
+/**
+ * @brief Remet une arène à zéro : tous les blocs distribués sont rendus d'un coup.
+ *
+ * Si une position est donnée (valeur de `used` relevée plus tôt), seuls les blocs distribués depuis sont rendus.
+ *
+ * @param arena L'arène.
+ * @param mark Position à laquelle revenir, 0 pour vider l'arène.
+ */
+void resetArena(Arena *arena, size_t mark) {
+    size_t highWater = __atomic_load_n(&allocationStats->arenaHighWater, __ATOMIC_RELAXED);
+
+    while (arena->highWater > highWater
+        && !__atomic_compare_exchange_n(&allocationStats->arenaHighWater, &highWater, arena->highWater, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    arena->used = mark;
+}
+
+/**
+ * @brief Arène de travail du thread courant.
+ */
+__thread Arena scratchArena;
+
+/**
+ * @brief Retourne l'arène de travail du thread courant, créée à sa première utilisation.
+ *
+ * Un processus de service la remet à zéro à la fin de chaque lot de requêtes ; une fonction qui n'y prend qu'un
+ * tampon temporaire le rend elle-même (resetArena() avec la position relevée avant).
+ *
+ * @return Arena* L'arène, ou NULL si son tampon n'a pas pu être alloué.
+ */
+Arena *getScratchArena() {
+    if (!scratchArena.base && !initArena(&scratchArena, SCRATCH_ARENA_SIZE)) {
+        return NULL;
+    }
+
+    return &scratchArena;
+}
+
+/**
+ * @brief Crée une réserve de blocs de taille fixe.
+ *
+ * Le tableau n'est pas parcouru : dimensionné pour toutes les places de la table, il n'occupe de mémoire qu'au fil
+ * des blocs distribués.
+ *
+ * @param pool La réserve.
+ * @param blockSize Taille d'un bloc.
+ * @param blockCount Nombre de blocs.
+ * @return bool false en cas d'échec de l'allocation du tableau.
+ */
+bool initSlabPool(SlabPool *pool, size_t blockSize, size_t blockCount) {
+    pool->blockSize = alignArenaSize(blockSize < sizeof(void *) ? sizeof(void *) : blockSize);
+    pool->storage = countedMalloc(pool->blockSize * blockCount);
+    pool->blockCount = pool->storage ? blockCount : 0;
+    pool->carved = 0;
+    pool->freeList = NULL;
+    pthread_mutex_init(&pool->lock, NULL);
+
+    return pool->storage != NULL;
+}
+
+/**
+ * @brief Prend un bloc dans une réserve (un bloc rendu, sinon le suivant du tableau), ou sur le tas si elle est épuisée.
+ *
+ * @param pool La réserve.
+ * @return void* Le bloc, à rendre avec slabFree(), ou NULL en cas d'échec.
+ */
+void *slabAlloc(SlabPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    void **block = pool->freeList;
+
+    if (block) {
+        pool->freeList = *block;
+    } else if (pool->carved < pool->blockCount) {
+        block = (void **) (pool->storage + pool->carved * pool->blockSize);
+        pool->carved += 1;
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    if (!block) {
+        __atomic_add_fetch(&allocationStats->slabFallbacks, 1, __ATOMIC_RELAXED);
+        return countedMalloc(pool->blockSize);
+    }
+
+    __atomic_add_fetch(&allocationStats->slabAllocations, 1, __ATOMIC_RELAXED);
+    return block;
+}
+
+/**
+ * @brief Rend un bloc à sa réserve (ou au tas s'il y a été pris).
+ *
+ * @param pool La réserve.
+ * @param block Le bloc, éventuellement NULL.
+ */
+void slabFree(SlabPool *pool, void *block) {
+    if (!block) {
+        return;
+    }
+
+    uint8_t *address = block;
+
+    if (address < pool->storage || address >= pool->storage + pool->blockSize * pool->blockCount) {
+        free(block);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    *(void **) block = pool->freeList;
+    pool->freeList = block;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+SlabPool pathPool;
+SlabPool sessionPool;
+pthread_once_t pathPoolOnce = PTHREAD_ONCE_INIT;
+pthread_once_t sessionPoolOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Crée la réserve des chemins de fichiers de log.
+ */
+void initPathPool() {
+    initSlabPool(&pathPool, PATH_MAX, PATH_SLAB_BLOCKS);
+}
+
+/**
+ * @brief Crée la réserve des sessions de logs.
+ */
+void initSessionPool() {
+    initSlabPool(&sessionPool, sizeof(LogThreadInfo), SESSION_SLAB_BLOCKS);
+}
+
+/**
+ * @brief Retourne la réserve des chemins de fichiers de log (blocs de PATH_MAX octets), créée à sa première utilisation.
+ *
+ * @return SlabPool* La réserve.
+ */
+SlabPool *getPathPool() {
+    pthread_once(&pathPoolOnce, initPathPool);
+    return &pathPool;
+}
+
+/**
+ * @brief Retourne la réserve des sessions de logs (`LogThreadInfo`), créée à sa première utilisation.
+ *
+ * @return SlabPool* La réserve.
+ */
+SlabPool *getSessionPool() {
+    pthread_once(&sessionPoolOnce, initSessionPool);
+    return &sessionPool;
+}
+
+#endif
@@ -4,7 +4,8 @@
  *
  * Ce fichier d'implémentation fournit la fonction `createChopstick` qui initialise une baguette avec
  * l'identifiant fourni, met à zéro ses champs, initialise son sémaphore d'utilisation en mode inter-processus,
- * copie la baguette dans la mémoire partagée, et envoie un message de log pour indiquer sa création.
+ * copie la baguette dans la mémoire partagée, et envoie un message de log pour indiquer sa création. Une baguette
+ * déjà initialisée au démarrage du serveur (voir PREALLOCATE_ARGUMENT) est reprise telle quelle.
  *
  * Les inclusions nécessaires dans ce fichier sont :
  *  - "../entities/Chopstick.h" pour la définition de la structure `Chopstick`.
@@ -28,29 +29,42 @@
  * @brief Crée et initialise une baguette.
  *
  * Cette fonction réalise les opérations suivantes :
- *  - Initialise une baguette avec l'identifiant fourni et remet à zéro ses champs.
- *  - Initialise le sémaphore d'utilisation de la baguette en mode inter-processus avec une valeur initiale de 1.
- *  - Copie la baguette dans la mémoire partagée à l'index correspondant (id - 1) pour assurer une gestion cohérente.
+ *  - Si l'emplacement n'a pas été préalloué (il ne porte pas encore d'identifiant) :
+ *     - Initialise une baguette avec l'identifiant fourni et remet à zéro ses champs.
+ *     - Initialise le sémaphore d'utilisation de la baguette en mode inter-processus avec une valeur initiale de 1.
+ *     - Copie la baguette dans la mémoire partagée à l'emplacement donné.
+ *  - Sinon, la baguette préallouée (sémaphore déjà initialisé et libre) reçoit seulement son identifiant.
  *  - Envoie un message de log pour notifier la création de la baguette, en indiquant son identifiant et son adresse
  *    dans la mémoire partagée.
  *
+ * L'emplacement est celui de la place de son philosophe : il ne correspond à `id - 1` que tant que la table n'a pas
+ * été compactée (voir Compaction.h).
+ *
  * @param id L'identifiant unique de la baguette.
+ * @param slot L'emplacement de la baguette dans le tableau des baguettes.
  * @param sharedResources Pointeur vers la structure `SharedResources` contenant les baguettes et la file de logs.
  * @return Chopstick* Pointeur vers la baguette nouvellement créée dans la mémoire partagée.
  */
-Chopstick *createChopstick(int id, SharedResources *sharedResources) {
-    Chopstick chopstick;
-    memset(&chopstick, 0, sizeof(chopstick));
+Chopstick *createChopstick(int id, int slot, SharedResources *sharedResources) {
+    // Les emplacements libérés par le compactage sont remis à zéro : un identifiant présent vient de la préallocation
+    if (sharedResources->chopsticks[slot].id == 0) {
+        Chopstick chopstick;
+        memset(&chopstick, 0, sizeof(chopstick));
+
+        chopstick.id = id;
+        sem_init(&chopstick.usage, 1, 1);
 
-    chopstick.id = id;
-    sem_init(&chopstick.usage, 1, 1);
+        // Ajout dans la mémoire partagée
+        // Copie avec memcpy pour être certain copier les données à la bonne adresse
+        memcpy(&sharedResources->chopsticks[slot], &chopstick, sizeof(Chopstick));
+    } else {
+        sharedResources->chopsticks[slot].id = id;
+    }
 
-    // Ajout dans la mémoire partagée
-    // Copie avec memcpy pour être certain copier les données à la bonne adresse
-    memcpy(&sharedResources->chopsticks[id - 1], &chopstick, sizeof(Chopstick));
-    logServerState(sharedResources->logsQueueId, "Baguette %d créée (adresse %p)...\n", id, &sharedResources->chopsticks[id - 1]);
+    sharedResources->numberChopsticks += 1;
+    logServerState(sharedResources->logsQueueId, "Baguette %d créée (adresse %p)...\n", id, &sharedResources->chopsticks[slot]);
 
-    return &sharedResources->chopsticks[id - 1];
+    return &sharedResources->chopsticks[slot];
 }
 
 #endif
\ No newline at end of file
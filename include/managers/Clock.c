@@ -0,0 +1,269 @@
+/**
+ * @file Clock.c
+ * @brief Implémente l'horloge à haute résolution du serveur : compteur de cycles étalonné, ou CLOCK_MONOTONIC.
+ *
+ * Le principe de l'horloge est décrit dans Clock.h. Chaque processus lit l'étalonnage à l'adresse donnée par
+ * setClockSource() (la mémoire partagée, héritée par les processus de service créés par fork()). Tant qu'aucun
+ * étalonnage n'est donné, ou s'il n'utilise pas le compteur de cycles, l'heure est lue par clock_gettime().
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **readTimestampCounter()** : Lit le compteur de cycles du processeur.
+ *  - **hasInvariantTimestampCounter()** : Indique si le compteur de cycles est invariant.
+ *  - **readClock()** : Lit une horloge du système en nanosecondes.
+ *  - **calibrateClock()** : Mesure la fréquence du compteur de cycles et ancre l'étalonnage.
+ *  - **recalibrateClock()** : Ré-ancre l'étalonnage sans faire reculer l'horloge.
+ *  - **setClockSource()** : Indique où lire l'étalonnage.
+ *  - **getTimestamp()** : Retourne l'heure monotone en nanosecondes.
+ *  - **getRealtimeFromTimestamp()** : Convertit une heure monotone en heure murale.
+ *  - **formatTimestamp()** : Écrit l'heure murale d'une heure monotone, à la microseconde.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Clock.h" pour l'étalonnage.
+ *  - <x86intrin.h> et <cpuid.h> pour le compteur de cycles, sur x86 seulement.
+ *  - <time.h> et <stdio.h>.
+ */
+
+#ifndef CLOCK_C
+#define CLOCK_C
+
+#include "../entities/Clock.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(CLOCK_NO_TSC)
+#define CLOCK_HAS_TSC 1
+#include <x86intrin.h>
+#include <cpuid.h>
+#else
+#define CLOCK_HAS_TSC 0
+#endif
+
+/**
+ * @brief Étalonnage lu par getTimestamp(), NULL tant que setClockSource() n'a pas été appelée.
+ */
+const ClockCalibration *currentClock = NULL;
+
+/**
+ * @brief Lit le compteur de cycles du processeur.
+ *
+ * @return uint64_t Le compteur, 0 sans compteur de cycles.
+ */
+static inline uint64_t readTimestampCounter() {
+#if CLOCK_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Indique si le compteur de cycles est invariant : même fréquence quel que soit l'état du cœur, et commun à
+ * tous les cœurs.
+ *
+ * @return bool true si le compteur peut servir d'horloge.
+ */
+bool hasInvariantTimestampCounter() {
+#if CLOCK_HAS_TSC
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid_max(0x80000000, NULL) < 0x80000007 || !__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Lit une horloge du système en nanosecondes (servie par le vDSO, sans appel système).
+ *
+ * @param clockId CLOCK_MONOTONIC ou CLOCK_REALTIME.
+ * @return uint64_t L'heure en nanosecondes.
+ */
+uint64_t readClock(clockid_t clockId) {
+    struct timespec now;
+    clock_gettime(clockId, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+/**
+ * @brief Lit ensemble le compteur de cycles et CLOCK_MONOTONIC.
+ *
+ * La lecture de CLOCK_MONOTONIC est encadrée par deux lectures du compteur ; la plus courte de trois tentatives est
+ * gardée, et le compteur est pris au milieu de l'encadrement.
+ *
+ * @param tsc Compteur de cycles.
+ * @param monotonic Heure CLOCK_MONOTONIC (ns).
+ */
+void readClockPair(uint64_t *tsc, uint64_t *monotonic) {
+    uint64_t bestSpan = UINT64_MAX;
+
+    for (int i = 0; i < 3; i++) {
+        uint64_t before = readTimestampCounter();
+        uint64_t now = readClock(CLOCK_MONOTONIC);
+        uint64_t after = readTimestampCounter();
+
+        if (after - before < bestSpan) {
+            bestSpan = after - before;
+            *tsc = before + (after - before) / 2;
+            *monotonic = now;
+        }
+    }
+}
+
+/**
+ * @brief Mesure la fréquence du compteur de cycles pendant CLOCK_CALIBRATION_MS et ancre l'étalonnage.
+ *
+ * Sans compteur de cycles invariant, l'étalonnage indique de lire CLOCK_MONOTONIC.
+ *
+ * @param clock L'étalonnage, en mémoire partagée.
+ */
+void calibrateClock(ClockCalibration *clock) {
+    clock->sequence = 0;
+    clock->useTimestampCounter = false;
+    clock->frequency = 0;
+    clock->multiplier = 0;
+    clock->realtimeOffset = (int64_t) (readClock(CLOCK_REALTIME) - readClock(CLOCK_MONOTONIC));
+
+    if (!hasInvariantTimestampCounter()) {
+        return;
+    }
+
+    uint64_t startTsc, startMonotonic, endTsc, endMonotonic;
+    struct timespec pause = { .tv_sec = 0, .tv_nsec = CLOCK_CALIBRATION_MS * 1000000L };
+
+    readClockPair(&startTsc, &startMonotonic);
+    while (nanosleep(&pause, &pause) == -1);
+    readClockPair(&endTsc, &endMonotonic);
+
+    if (endTsc <= startTsc || endMonotonic <= startMonotonic) {
+        return;
+    }
+
+    clock->multiplier = (uint64_t) (((unsigned __int128) (endMonotonic - startMonotonic) << CLOCK_SHIFT) / (endTsc - startTsc));
+    clock->frequency = (uint64_t) ((unsigned __int128) (endTsc - startTsc) * 1000000000ULL / (endMonotonic - startMonotonic));
+    clock->tscOrigin = startTsc;
+    clock->monotonicOrigin = startMonotonic;
+    clock->tscBase = endTsc;
+    clock->monotonicBase = endMonotonic;
+    clock->useTimestampCounter = clock->multiplier != 0;
+}
+
+/**
+ * @brief Convertit un compteur de cycles en heure monotone avec un étalonnage.
+ *
+ * @param clock L'étalonnage.
+ * @param tsc Le compteur de cycles, postérieur à l'ancrage.
+ * @return uint64_t L'heure monotone en nanosecondes.
+ */
+static inline uint64_t convertTimestampCounter(const ClockCalibration *clock, uint64_t tsc) {
+    return clock->monotonicBase + (uint64_t) (((unsigned __int128) (tsc - clock->tscBase) * clock->multiplier) >> CLOCK_SHIFT);
+}
+
+/**
+ * @brief Ré-ancre l'étalonnage sur CLOCK_MONOTONIC, et affine la fréquence sur toute la durée écoulée depuis le
+ * premier étalonnage. Appelée par un seul thread, le thread de compactage.
+ *
+ * L'ancrage ne recule jamais : si l'horloge étalonnée est en avance sur CLOCK_MONOTONIC, elle est gardée comme
+ * nouvelle base, et la fréquence affinée résorbe l'avance.
+ *
+ * @param clock L'étalonnage, en mémoire partagée.
+ */
+void recalibrateClock(ClockCalibration *clock) {
+    uint64_t tsc = 0, monotonic = 0;
+    int64_t realtimeOffset = (int64_t) (readClock(CLOCK_REALTIME) - readClock(CLOCK_MONOTONIC));
+
+    if (clock->useTimestampCounter) {
+        readClockPair(&tsc, &monotonic);
+    }
+
+    __atomic_add_fetch(&clock->sequence, 1, __ATOMIC_ACQ_REL);
+
+    if (clock->useTimestampCounter && tsc > clock->tscOrigin && monotonic > clock->monotonicOrigin) {
+        uint64_t current = convertTimestampCounter(clock, tsc);
+
+        clock->multiplier = (uint64_t) (((unsigned __int128) (monotonic - clock->monotonicOrigin) << CLOCK_SHIFT) / (tsc - clock->tscOrigin));
+        clock->frequency = (uint64_t) ((unsigned __int128) (tsc - clock->tscOrigin) * 1000000000ULL / (monotonic - clock->monotonicOrigin));
+        clock->tscBase = tsc;
+        clock->monotonicBase = current > monotonic ? current : monotonic;
+    }
+
+    clock->realtimeOffset = realtimeOffset;
+    __atomic_add_fetch(&clock->sequence, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Indique où lire l'étalonnage de l'horloge.
+ *
+ * @param clock L'étalonnage, en mémoire partagée ; NULL pour lire CLOCK_MONOTONIC.
+ */
+void setClockSource(const ClockCalibration *clock) {
+    currentClock = clock;
+}
+
+/**
+ * @brief Retourne l'heure monotone en nanosecondes, comparable entre tous les processus et tous les threads.
+ *
+ * Avec le compteur de cycles, la lecture ne coûte que quelques nanosecondes : une lecture du compteur, une
+ * multiplication et la vérification de la séquence de l'étalonnage.
+ *
+ * @return uint64_t L'heure monotone en nanosecondes.
+ */
+uint64_t getTimestamp() {
+    const ClockCalibration *clock = currentClock;
+
+    if (!clock || !clock->useTimestampCounter) {
+        return readClock(CLOCK_MONOTONIC);
+    }
+
+    while (1) {
+        uint32_t sequence = __atomic_load_n(&clock->sequence, __ATOMIC_ACQUIRE);
+        uint64_t tsc = readTimestampCounter();
+        uint64_t timestamp = convertTimestampCounter(clock, tsc);
+
+        // Un compteur lu avant le dernier ancrage (autre cœur, lecture en avance) se compte depuis l'ancrage
+        if (tsc < clock->tscBase) {
+            timestamp = clock->monotonicBase;
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (!(sequence & 1) && __atomic_load_n(&clock->sequence, __ATOMIC_RELAXED) == sequence) {
+            return timestamp;
+        }
+    }
+}
+
+/**
+ * @brief Convertit une heure monotone en heure murale.
+ *
+ * @param timestamp L'heure monotone en nanosecondes (getTimestamp()).
+ * @return uint64_t L'heure murale en nanosecondes depuis l'epoch.
+ */
+uint64_t getRealtimeFromTimestamp(uint64_t timestamp) {
+    int64_t realtimeOffset = currentClock ? currentClock->realtimeOffset : (int64_t) (readClock(CLOCK_REALTIME) - readClock(CLOCK_MONOTONIC));
+    return timestamp + (uint64_t) realtimeOffset;
+}
+
+/**
+ * @brief Écrit une heure murale au format "AAAA-MM-JJ HH:MM:SS.uuuuuu", dans le fuseau local.
+ *
+ * @param realtime L'heure murale en nanosecondes depuis l'epoch (getRealtimeFromTimestamp()).
+ * @param buffer Le tampon.
+ * @param size La taille du tampon, au moins 27 octets.
+ * @return int Le nombre de caractères écrits.
+ */
+int formatTimestamp(uint64_t realtime, char *buffer, size_t size) {
+    time_t seconds = (time_t) (realtime / 1000000000ULL);
+    struct tm date;
+    localtime_r(&seconds, &date);
+
+    size_t length = strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &date);
+    return (int) length + snprintf(buffer + length, size - length, ".%06lu", (unsigned long) (realtime % 1000000000ULL / 1000));
+}
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file Compaction.c
+ * @brief Implémente le compactage en ligne des places de la table.
+ *
+ * Le principe et les garanties du compactage sont décrits dans Compaction.h. Un passage parcourt les places
+ * utilisées dans l'ordre, en tenant à jour la position `destination` où ranger la prochaine place gardée :
+ *  - une place quittée depuis plus de COMPACTION_DEPARTED_GRACE_MS est effacée ;
+ *  - une place libre de tout détenteur, dont la baguette est libre, est déplacée vers `destination` avec sa baguette ;
+ *  - une place qui ne peut pas bouger reste où elle est, `destination` repart juste après elle ; les positions
+ *    libérées devant elle deviennent des places vides (identifiant 0, marquées parties), reprises au passage suivant.
+ * L'anneau est ensuite refermé entre les places restantes, puis les positions libérées en fin de tableau sont remises
+ * à zéro. Le passage coûte donc autant que le nombre de places utilisées, qu'il ramène au nombre de places gardées.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **moveSeat()** : Déplace une place et sa baguette.
+ *  - **vacateSeats()** : Transforme des positions libérées en places vides.
+ *  - **relinkSeats()** : Referme l'anneau des places après un passage.
+ *  - **compactTable()** : Effectue un passage si la table est calme.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Compaction.h" et "../entities/SharedResources.h" pour les compteurs et la table.
+ *  - "../managers/ServerPhilosopher.c" pour les versions des places et l'heure monotone.
+ *  - <semaphore.h>, <pthread.h> et <string.h>.
+ */
+
+#ifndef COMPACTION_C
+#define COMPACTION_C
+
+#include "../maxmin_philosophers.h"
+#include "../entities/Compaction.h"
+#include "../entities/SharedResources.h"
+#include "../managers/ServerPhilosopher.c"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <pthread.h>
+
+/**
+ * @brief Déplace une place et sa baguette.
+ *
+ * La place source est marquée SEAT_MOVING par l'appelant, et sa baguette est libre. La baguette reçoit un nouveau
+ * sémaphore à sa nouvelle position ; les pointeurs des voisins sont corrigés par relinkSeats(). La table de renvoi
+ * n'est mise à jour qu'une fois la copie faite, puis la nouvelle place peut de nouveau être tenue.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @param source La position de la place.
+ * @param destination Sa nouvelle position, libre (effacée ou déjà déplacée), avant `source`.
+ */
+void moveSeat(SharedResources *sharedResources, int source, int destination) {
+    ServerPhilosopher *seat = &sharedResources->philosophers[destination];
+    Chopstick *chopstick = &sharedResources->chopsticks[destination];
+    int id = sharedResources->philosophers[source].base.id;
+
+    memset(chopstick, 0, sizeof(Chopstick));
+    chopstick->id = sharedResources->chopsticks[source].id;
+    sem_init(&chopstick->usage, 1, 1);
+
+    *seat = sharedResources->philosophers[source];
+    seat->leftChopstick = chopstick;
+
+    __atomic_store_n(&sharedResources->seatSlots[id - 1], destination + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&seat->pins, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Transforme des positions libérées au cours du passage en places vides.
+ *
+ * Une place vide n'a ni identifiant ni baguette, et passe pour partie auprès des lecteurs de la table.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @param first La première position.
+ * @param last La position suivant la dernière.
+ */
+void vacateSeats(SharedResources *sharedResources, int first, int last) {
+    for (int i = first; i < last; i++) {
+        memset(&sharedResources->philosophers[i], 0, sizeof(ServerPhilosopher));
+        memset(&sharedResources->chopsticks[i], 0, sizeof(Chopstick));
+        sharedResources->philosophers[i].departed = true;
+    }
+}
+
+/**
+ * @brief Referme l'anneau entre les places restantes après un passage.
+ *
+ * Les places étant dans l'ordre de l'anneau, la baguette droite de chaque philosophe encore à table est la baguette
+ * gauche du suivant, et celle du dernier la baguette gauche du premier. Un philosophe seul à table n'a pas de
+ * baguette droite, ni un philosophe parti.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @param numberSeats Le nombre de places restantes.
+ */
+void relinkSeats(SharedResources *sharedResources, int numberSeats) {
+    ServerPhilosopher *first = NULL;
+    ServerPhilosopher *previous = NULL;
+
+    for (int i = 0; i < numberSeats; i++) {
+        ServerPhilosopher *seat = &sharedResources->philosophers[i];
+
+        if (seat->departed) {
+            seat->rightChopstick = NULL;
+            continue;
+        }
+
+        if (previous) {
+            previous->rightChopstick = seat->leftChopstick;
+        } else {
+            first = seat;
+        }
+        previous = seat;
+    }
+
+    if (previous) {
+        previous->rightChopstick = previous == first ? NULL : first->leftChopstick;
+    }
+}
+
+/**
+ * @brief Effectue un passage de compactage si la table est calme.
+ *
+ * Rien n'est fait s'il n'y a aucune place quittée, ou si le sémaphore de création ou le verrou de la politique en
+ * écriture ne peuvent être pris sans attendre : une arrivée, un départ ou une prise de baguettes est en cours.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return int Le nombre de places déplacées ou effacées, -1 si la table n'était pas calme.
+ */
+int compactTable(SharedResources *sharedResources) {
+    if (sharedResources->numberPhilosophers == sharedResources->numberSeated) {
+        return 0;
+    }
+
+    if (sem_trywait(&sharedResources->philosopherCreationProcess) == -1) {
+        __atomic_add_fetch(&sharedResources->compaction.skippedPasses, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    if (pthread_rwlock_trywrlock(&sharedResources->policyLock) != 0) {
+        sem_post(&sharedResources->philosopherCreationProcess);
+        __atomic_add_fetch(&sharedResources->compaction.skippedPasses, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    // Époque impaire et nouvelle version : les lecteurs sans verrou savent que les places bougent
+    __atomic_add_fetch(&sharedResources->compaction.epoch, 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&sharedResources->tableVersion, 1, __ATOMIC_RELEASE);
+
+    uint64_t now = getMonotonicTime();
+    int numberSeats = sharedResources->numberPhilosophers;
+    int destination = 0;
+    int moved = 0;
+    int dropped = 0;
+
+    for (int source = 0; source < numberSeats; source++) {
+        ServerPhilosopher *seat = &sharedResources->philosophers[source];
+        Chopstick *chopstick = &sharedResources->chopsticks[source];
+        bool vacant = seat->base.id == 0;
+        bool expired = seat->departed && (vacant || now - seat->departedAt >= (uint64_t) COMPACTION_DEPARTED_GRACE_MS * 1000000);
+
+        if (!expired && source == destination) {
+            destination += 1;
+            continue;
+        }
+
+        // Une place tenue (mise à jour, départ ou commande de contrôle en cours) ne bouge pas
+        uint32_t unpinned = 0;
+
+        if (!__atomic_compare_exchange_n(&seat->pins, &unpinned, SEAT_MOVING, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            vacateSeats(sharedResources, destination, source);
+            destination = source + 1;
+            continue;
+        }
+
+        if (expired) {
+            if (!vacant) {
+                __atomic_store_n(&sharedResources->seatSlots[seat->base.id - 1], 0, __ATOMIC_RELEASE);
+                dropped += 1;
+            }
+            continue;
+        }
+
+        int usage = 0;
+        sem_getvalue(&chopstick->usage, &usage);
+
+        if (usage != 1 || chopstick->holderId != 0) {
+            __atomic_store_n(&seat->pins, 0, __ATOMIC_RELEASE);
+            vacateSeats(sharedResources, destination, source);
+            destination = source + 1;
+            continue;
+        }
+
+        moveSeat(sharedResources, source, destination);
+        destination += 1;
+        moved += 1;
+    }
+
+    if (moved > 0 || dropped > 0) {
+        relinkSeats(sharedResources, destination);
+
+        // Les positions libérées en fin de tableau ne sont plus tenues par personne (SEAT_MOVING) : remises à zéro
+        memset(&sharedResources->philosophers[destination], 0, (numberSeats - destination) * sizeof(ServerPhilosopher));
+        memset(&sharedResources->chopsticks[destination], 0, (numberSeats - destination) * sizeof(Chopstick));
+        sharedResources->numberPhilosophers = destination;
+        sharedResources->numberChopsticks = destination;
+    }
+
+    sharedResources->compaction.passes += 1;
+    sharedResources->compaction.movedSeats += moved;
+    sharedResources->compaction.droppedSeats += dropped;
+
+    __atomic_add_fetch(&sharedResources->tableVersion, 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&sharedResources->compaction.epoch, 1, __ATOMIC_RELEASE);
+
+    pthread_rwlock_unlock(&sharedResources->policyLock);
+    sem_post(&sharedResources->philosopherCreationProcess);
+
+    if (moved > 0 || dropped > 0) {
+        logServerState(sharedResources->logsQueueId, "Compactage : %d place(s) déplacée(s), %d effacée(s), %d place(s) utilisée(s)\n", moved, dropped, destination);
+    }
+
+    return moved + dropped;
+}
+
+#endif
@@ -0,0 +1,943 @@
+/**
+ * @file Control.c
+ * @brief Implémente le socket de contrôle du serveur et l'exécution de ses commandes.
+ *
+ * Les commandes sont reçues par la boucle d'événements du processus principal (voir server.c) et exécutées sans
+ * jamais bloquer : les réglages sont écrits directement en mémoire partagée, où les processus de service les lisent
+ * à chaque requête. Le seul changement qui doit attendre (la politique d'arbitrage, qui ne peut changer pendant
+ * une prise de baguettes) est confié à un thread dédié.
+ *
+ * Les commandes reconnues sont :
+ *  - `stats` : état de la table, statistiques, compteurs d'allocations, du compactage et de la migration des places,
+ *    de la réserve de threads du service datagramme, source de l'horloge (voir Clock.h), état du profileur et
+ *    compteurs matériels des repas accordés, par étape et par thread de service, durées de leurs étapes, et compteurs
+ *    du cœur de la table (voir TableCore.h).
+ *  - `loglevel [none|server|all]` : affiche ou change le niveau de logs.
+ *  - `capacity [n]` : affiche ou change le nombre maximum de philosophes à table.
+ *  - `policy [counter|ordered|sequenced]` : affiche ou change la politique d'arbitrage.
+ *  - `drain <philosophe>` / `resume <philosophe>` : cesse ou reprend le service d'un philosophe (son repas en cours
+ *    se termine normalement).
+ *  - `evict <philosophe>` : retire un philosophe de la table à sa prochaine requête et ferme sa connexion.
+ *  - `checkpoint` : écrit l'état de la table dans CHECKPOINT_PATH.
+ *  - `migration [on|off]` : affiche l'état de la migration automatique des philosophes, ou l'active ou la désactive
+ *    (voir Migration.h).
+ *  - `migrate <philosophe> <philosophe>` : échange les places de deux philosophes qui pensent.
+ *  - `pool [min max [idle_ms]]` : affiche l'état de la réserve de threads du service datagramme, ou change ses
+ *    nombres minimal et maximal de threads et le délai d'inactivité au bout duquel un thread s'arrête (voir
+ *    WorkerPool.h).
+ *  - `ledger [sync|async|<ms>]` : affiche l'état du registre des repas, ou change l'attente de durabilité des repas
+ *    ou l'intervalle de validation (voir Ledger.h).
+ *  - `profile [on [hz]|off|dump]` : affiche l'état du profileur par échantillonnage, le démarre (à `hz` échantillons
+ *    par seconde de calcul de chaque thread) ou l'arrête, ou demande à chaque processus d'écrire ses piles dans
+ *    PROFILE_FILE, au format replié des flame graphs (voir Profiler.h).
+ *  - `perf [on|off]` : affiche l'état des compteurs matériels des repas accordés, ou les active ou les désactive
+ *    (voir PerfCounters.h) ; leurs totaux sont détaillés par `stats`.
+ *  - `spans [reset]` : affiche les spans des repas les plus lents, étape par étape, ou remet à zéro les durées des
+ *    étapes et les exemples (voir RequestSpan.h).
+ *  - `upgrade [chemin]` : met à jour le serveur à chaud vers un nouveau binaire (par défaut, celui lancé à l'origine,
+ *    recompilé entre-temps). La bascule est faite par la boucle d'événements une fois la réponse envoyée.
+ *  - `help` : liste des commandes.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **openControlSocket()** : Crée le socket Unix de contrôle.
+ *  - **executeControlCommand()** : Exécute une commande et rédige sa réponse.
+ *  - **writeCheckpoint()** : Écrit l'état de la table dans un fichier.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Control.h" et "../entities/ServerContext.h" pour les structures manipulées.
+ *  - "../managers/ServerPhilosopher.c" pour la recherche des philosophes.
+ *  - "../managers/Statistics.c" pour les percentiles d'attente.
+ *  - "../managers/Arena.c" pour les compteurs d'allocations.
+ *  - "../managers/Migration.c" pour l'échange des places.
+ *  - "../managers/Profiler.c" pour réveiller les profileurs des processus.
+ *  - "../managers/PerfCounters.c" pour les compteurs matériels.
+ *  - "../managers/RequestSpan.c" pour les durées des étapes des spans.
+ *  - <sys/socket.h>, <sys/un.h>, <sys/stat.h>, <pthread.h>, <stdio.h>, <string.h>, <stdarg.h>, <time.h>, <unistd.h> et <fcntl.h>.
+ */
+
+#ifndef CONTROL_C
+#define CONTROL_C
+
+#include "../maxmin_philosophers.h"
+#include "../entities/Control.h"
+#include "../entities/ServerContext.h"
+#include "../managers/ServerPhilosopher.c"
+#include "../managers/Statistics.c"
+#include "../managers/Arena.c"
+#include "../managers/Migration.c"
+#include "../managers/Profiler.c"
+#include "../managers/PerfCounters.c"
+#include "../managers/RequestSpan.c"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+/**
+ * @brief Libellés des niveaux de logs, indexés par LogLevel.
+ */
+const char *LOG_LEVEL_NAMES[] = { "none", "server", "all" };
+
+/**
+ * @brief Libellés des politiques d'arbitrage, indexés par ArbitrationPolicy.
+ */
+const char *POLICY_NAMES[] = { "counter", "ordered", "sequenced" };
+
+/**
+ * @brief Libellés des consommateurs de l'anneau du cœur de la table, indexés par TableConsumer.
+ */
+const char *TABLE_CONSUMER_NAMES[] = { "logs", "ledger", "responses" };
+
+/**
+ * @brief Libellés des étapes d'un repas, indexés par PerfStage.
+ */
+const char *PERF_STAGE_NAMES[] = { "decode", "lookup", "admission", "chopsticks", "send" };
+
+/**
+ * @brief Libellés des compteurs matériels, indexés par PerfCounter.
+ */
+const char *PERF_COUNTER_NAMES[] = { "cycles", "instructions", "cache_misses", "context_switches" };
+
+/**
+ * @brief Libellés des étapes d'un span, indexés par SpanMark (l'étape se termine à cette marque).
+ */
+const char *SPAN_STAGE_NAMES[] = { "read", "decode", "lookup", "admission", "left", "right", "send" };
+
+/**
+ * @brief Nombre de changements de politique en cours.
+ *
+ * Une mise à jour à chaud est refusée tant qu'un changement est en cours : exec() terminerait le thread alors
+ * qu'il détient (ou attend) le verrou de la politique, qui ne serait jamais rendu.
+ */
+int pendingPolicySwitches = 0;
+
+/**
+ * @brief Demande de changement de politique confiée au thread dédié.
+ */
+typedef struct {
+    SharedResources *sharedResources;
+    ArbitrationPolicy policy;
+} PolicySwitch;
+
+/**
+ * @brief Crée le socket Unix de contrôle et le met en écoute.
+ *
+ * Un fichier de socket laissé par un serveur arrêté brutalement est supprimé avant la création. Les droits sont
+ * restreints à l'utilisateur du serveur.
+ *
+ * @return int Le socket de contrôle, ou -1 en cas d'erreur.
+ */
+int openControlSocket() {
+    int controlSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (controlSocket == -1) {
+        return -1;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, CONTROL_SOCKET_PATH, sizeof(address.sun_path) - 1);
+
+    unlink(CONTROL_SOCKET_PATH);
+
+    if (bind(controlSocket, (struct sockaddr *) &address, sizeof(address)) == -1 || listen(controlSocket, CONTROL_MAX_CONNECTIONS) == -1) {
+        close(controlSocket);
+        return -1;
+    }
+
+    chmod(CONTROL_SOCKET_PATH, 0600);
+
+    return controlSocket;
+}
+
+/**
+ * @brief Ajoute du texte formaté à la fin d'une réponse.
+ *
+ * @param reply La réponse.
+ * @param size La taille du tampon de la réponse.
+ * @param format Le format, comme pour printf.
+ */
+void appendReply(char *reply, size_t size, const char *format, ...) {
+    size_t length = strnlen(reply, size);
+
+    if (length + 1 >= size) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(reply + length, size - length, format, args);
+    va_end(args);
+}
+
+/**
+ * @brief Retourne le libellé d'un état de philosophe.
+ *
+ * @param philosopher Le philosophe.
+ * @return const char* Le libellé.
+ */
+const char *getSeatStateName(const ServerPhilosopher *philosopher) {
+    if (philosopher->departed) {
+        return "departed";
+    }
+
+    switch (philosopher->base.state) {
+        case THINKING: return "thinking";
+        case HUNGRY:   return "hungry";
+        case EATING:   return "eating";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Écrit l'état de la table dans un fichier.
+ *
+ * Le fichier est d'abord écrit sous un nom temporaire puis renommé : un lecteur ne voit jamais de point de reprise
+ * à moitié écrit. Chaque ligne décrit un réglage, un philosophe ou une baguette.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @param path Le chemin du fichier.
+ * @return bool true si le fichier a été écrit.
+ */
+bool writeCheckpoint(SharedResources *sharedResources, const char *path) {
+    char temporaryPath[512];
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", path);
+
+    FILE *file = fopen(temporaryPath, "w");
+
+    if (!file) {
+        return false;
+    }
+
+    time_t now = time(NULL);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+    fprintf(file, "# Point de reprise de la table, %s\n", date);
+    fprintf(file, "policy %s\n", POLICY_NAMES[sharedResources->policy]);
+    fprintf(file, "capacity %d\n", sharedResources->capacity);
+    fprintf(file, "loglevel %s\n", LOG_LEVEL_NAMES[sharedResources->logLevel]);
+    fprintf(file, "meals %lu\n", (unsigned long) sharedResources->statistics.meals);
+
+    for (int i = 0; i < sharedResources->numberPhilosophers; i++) {
+        ServerPhilosopher *philosopher = &sharedResources->philosophers[i];
+
+        // Place vide laissée par le compactage
+        if (philosopher->base.id == 0) {
+            continue;
+        }
+
+        fprintf(
+            file,
+            "seat %d %s timer %d meals %lu left %d right %d%s%s\n",
+            philosopher->base.id,
+            getSeatStateName(philosopher),
+            philosopher->base.stateTimer,
+            (unsigned long) philosopher->meals,
+            philosopher->leftChopstick ? philosopher->leftChopstick->id : 0,
+            philosopher->rightChopstick ? philosopher->rightChopstick->id : 0,
+            philosopher->draining ? " draining" : "",
+            philosopher->evicted ? " evicted" : ""
+        );
+    }
+
+    for (int i = 0; i < sharedResources->numberPhilosophers; i++) {
+        if (sharedResources->chopsticks[i].id == 0) {
+            continue;
+        }
+        fprintf(file, "chopstick %d holder %d\n", sharedResources->chopsticks[i].id, sharedResources->chopsticks[i].holderId);
+    }
+
+    bool written = fflush(file) == 0 && fsync(fileno(file)) == 0;
+    fclose(file);
+
+    return written && rename(temporaryPath, path) == 0;
+}
+
+/**
+ * @brief Thread appliquant un changement de politique d'arbitrage.
+ *
+ * Le verrou de la politique est pris en écriture : le thread attend que les prises de baguettes commencées avec
+ * l'ancienne politique soient terminées, les nouvelles demandes attendant de leur côté le changement.
+ *
+ * @param arg Pointeur vers une structure PolicySwitch, libérée par le thread.
+ * @return void* Retourne toujours NULL.
+ */
+void *policySwitchThread(void *arg) {
+    PolicySwitch *policySwitch = (PolicySwitch *) arg;
+    SharedResources *sharedResources = policySwitch->sharedResources;
+
+    pthread_rwlock_wrlock(&sharedResources->policyLock);
+    sharedResources->policy = policySwitch->policy;
+    pthread_rwlock_unlock(&sharedResources->policyLock);
+
+    logServerState(sharedResources->logsQueueId, "Politique d'arbitrage : %s\n", POLICY_NAMES[policySwitch->policy]);
+    free(policySwitch);
+    __atomic_sub_fetch(&pendingPolicySwitches, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/**
+ * @brief Retourne un philosophe encore à table à partir de l'argument d'une commande.
+ *
+ * @param argument L'identifiant saisi, éventuellement NULL.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return ServerPhilosopher* Le philosophe, tenu (à rendre avec unpinPhilosopher()) pour que le compactage ne le
+ *         déplace pas pendant la commande, ou NULL s'il n'existe pas ou a quitté la table.
+ */
+ServerPhilosopher *getControlledPhilosopher(const char *argument, SharedResources *sharedResources) {
+    if (!argument) {
+        return NULL;
+    }
+
+    ServerPhilosopher *philosopher = pinPhilosopher(atoi(argument), sharedResources);
+
+    if (philosopher && philosopher->departed) {
+        unpinPhilosopher(philosopher);
+        return NULL;
+    }
+
+    return philosopher;
+}
+
+/**
+ * @brief Rédige les lignes des compteurs matériels de la commande `stats`.
+ *
+ * Les moyennes sont données par repas mesuré, par étape pour la table et au total pour chaque thread de service ;
+ * un compteur qu'aucun thread n'a pu ouvrir est écrit `-`.
+ *
+ * @param perf Le réglage et les totaux.
+ * @param reply La réponse.
+ * @param size La taille du tampon de la réponse.
+ */
+void describePerfCounters(const PerfCounterState *perf, char *reply, size_t size) {
+    char counters[128] = "";
+
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        if (perf->available & (1u << i)) {
+            appendReply(counters, sizeof(counters), "%s%s", counters[0] ? "," : "", PERF_COUNTER_NAMES[i]);
+        }
+    }
+
+    appendReply(
+        reply, size, "perf %s counters %s mode %s grants %lu unmeasured_threads %u last_errno %d\n",
+        perf->enabled ? "on" : "off",
+        counters[0] ? counters : "-",
+        perf->userOnly ? "user" : "all",
+        (unsigned long) perf->grants,
+        perf->unmeasuredThreads,
+        perf->lastError
+    );
+
+    if (perf->grants == 0) {
+        return;
+    }
+
+    for (int stage = 0; stage < PERF_STAGES; stage++) {
+        appendReply(reply, size, "perf_stage %s", PERF_STAGE_NAMES[stage]);
+
+        for (int i = 0; i < PERF_COUNTERS; i++) {
+            if (perf->available & (1u << i)) {
+                appendReply(reply, size, " %s %.1f", PERF_COUNTER_NAMES[i], (double) perf->totals[stage][i] / perf->grants);
+            } else {
+                appendReply(reply, size, " %s -", PERF_COUNTER_NAMES[i]);
+            }
+        }
+
+        appendReply(reply, size, "\n");
+    }
+
+    appendReply(reply, size, "perf_grant");
+
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        if (perf->available & (1u << i)) {
+            appendReply(
+                reply, size, " %s p50<%lu p99<%lu", PERF_COUNTER_NAMES[i],
+                (unsigned long) getHistogramPercentile(&perf->grantHistograms[i], 50),
+                (unsigned long) getHistogramPercentile(&perf->grantHistograms[i], 99)
+            );
+        } else {
+            appendReply(reply, size, " %s -", PERF_COUNTER_NAMES[i]);
+        }
+    }
+
+    appendReply(reply, size, "\n");
+
+    for (int w = 0; w < PERF_MAX_WORKERS; w++) {
+        const PerfWorker *worker = &perf->workers[w];
+        uint64_t grants = worker->grants;
+
+        if (worker->processId == 0 || grants == 0) {
+            continue;
+        }
+
+        appendReply(reply, size, "perf_worker %d/%d grants %lu", worker->processId, worker->threadId, (unsigned long) grants);
+
+        for (int i = 0; i < PERF_COUNTERS; i++) {
+            uint64_t total = 0;
+
+            for (int stage = 0; stage < PERF_STAGES; stage++) {
+                total += worker->totals[stage][i];
+            }
+
+            if (perf->available & (1u << i)) {
+                appendReply(reply, size, " %s %.1f", PERF_COUNTER_NAMES[i], (double) total / grants);
+            } else {
+                appendReply(reply, size, " %s -", PERF_COUNTER_NAMES[i]);
+            }
+        }
+
+        appendReply(reply, size, "\n");
+    }
+}
+
+/**
+ * @brief Ajoute à la réponse les compteurs du cœur de la table (politique `sequenced`, voir TableCore.h).
+ *
+ * `pending` compte les événements publiés que le cœur n'a pas encore appliqués ; le retard de chaque consommateur
+ * est compté depuis la séquence appliquée par le cœur.
+ *
+ * @param core Le cœur de la table.
+ * @param reply Le tampon de la réponse.
+ * @param size La taille du tampon.
+ */
+void describeTableCore(TableCore *core, char *reply, size_t size) {
+    uint64_t applied = __atomic_load_n(&core->appliedSequence, __ATOMIC_ACQUIRE);
+
+    appendReply(
+        reply, size, "core events %lu batches %lu largest_batch %u grants %lu waiting %d holes %lu cpu %d pending %lu",
+        (unsigned long) core->appliedEvents,
+        (unsigned long) core->batches,
+        core->largestBatch,
+        (unsigned long) core->grants,
+        core->numberWaiting,
+        (unsigned long) core->holes,
+        core->cpu,
+        (unsigned long) (__atomic_load_n(&core->nextSequence, __ATOMIC_ACQUIRE) - applied)
+    );
+
+    for (int consumer = 0; consumer < TABLE_CONSUMERS; consumer++) {
+        uint64_t consumed = __atomic_load_n(&core->consumedSequences[consumer], __ATOMIC_ACQUIRE);
+        appendReply(reply, size, " lag_%s %lu", TABLE_CONSUMER_NAMES[consumer], (unsigned long) (applied - consumed));
+    }
+
+    appendReply(reply, size, "\n");
+}
+
+/**
+ * @brief Rédige la réponse à la commande `stats`.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ * @param reply La réponse.
+ * @param size La taille du tampon de la réponse.
+ */
+void describeStats(ServerContext *serverContext, char *reply, size_t size) {
+    SharedResources *sharedResources = serverContext->sharedResources;
+
+    int allowedEating = 0;
+    sem_getvalue(&sharedResources->maxAllowedEating, &allowedEating);
+
+    Histogram waits = sharedResources->statistics.waitHistogram;
+
+    appendReply(reply, size, "philosophers %d/%d (max %d)\n", sharedResources->numberSeated, sharedResources->capacity, MAX_PHILOSOPHERS);
+    appendReply(reply, size, "clients %zu\n", serverContext->numberClients);
+    appendReply(reply, size, "policy %s\n", POLICY_NAMES[sharedResources->policy]);
+    appendReply(reply, size, "loglevel %s\n", LOG_LEVEL_NAMES[sharedResources->logLevel]);
+    appendReply(reply, size, "admission_tokens %d\n", allowedEating);
+    appendReply(reply, size, "meals %lu\n", (unsigned long) sharedResources->statistics.meals);
+    appendReply(
+        reply, size, "allocations heap %lu arena %lu slab %lu slab_fallbacks %lu arena_high_water %lu\n",
+        (unsigned long) sharedResources->allocations.heapAllocations,
+        (unsigned long) sharedResources->allocations.arenaAllocations,
+        (unsigned long) sharedResources->allocations.slabAllocations,
+        (unsigned long) sharedResources->allocations.slabFallbacks,
+        (unsigned long) sharedResources->allocations.arenaHighWater
+    );
+    appendReply(
+        reply, size, "compaction seats %d passes %lu skipped %lu moved %lu dropped %lu\n",
+        sharedResources->numberPhilosophers,
+        (unsigned long) sharedResources->compaction.passes,
+        (unsigned long) sharedResources->compaction.skippedPasses,
+        (unsigned long) sharedResources->compaction.movedSeats,
+        (unsigned long) sharedResources->compaction.droppedSeats
+    );
+    appendReply(
+        reply, size, "migration %s passes %lu moved %lu busy %lu imbalance %lu%%\n",
+        sharedResources->migration.enabled ? "on" : "off",
+        (unsigned long) sharedResources->migration.passes,
+        (unsigned long) sharedResources->migration.migrations,
+        (unsigned long) sharedResources->migration.busy,
+        (unsigned long) sharedResources->migration.imbalancePercent
+    );
+    appendReply(
+        reply, size, "pool workers %d idle %d queued %d min %d max %d peak %d spawned %lu retired %lu jobs %lu queue_wait_us p50<%lu p99<%lu\n",
+        sharedResources->workerPool.workers,
+        sharedResources->workerPool.idleWorkers,
+        sharedResources->workerPool.queued,
+        sharedResources->workerPool.minWorkers,
+        sharedResources->workerPool.maxWorkers,
+        sharedResources->workerPool.peakWorkers,
+        (unsigned long) sharedResources->workerPool.spawned,
+        (unsigned long) sharedResources->workerPool.retired,
+        (unsigned long) sharedResources->workerPool.jobs,
+        (unsigned long) getHistogramPercentile(&sharedResources->workerPool.queueWaits, 50),
+        (unsigned long) getHistogramPercentile(&sharedResources->workerPool.queueWaits, 99)
+    );
+    appendReply(
+        reply, size, "clock %s frequency_hz %lu\n",
+        sharedResources->clock.useTimestampCounter ? "tsc" : "monotonic",
+        (unsigned long) sharedResources->clock.frequency
+    );
+    appendReply(
+        reply, size, "profiler %s frequency_hz %u samples %lu dropped %lu dumps %lu\n",
+        sharedResources->profiler.enabled ? "on" : "off",
+        sharedResources->profiler.frequency,
+        (unsigned long) sharedResources->profiler.samples,
+        (unsigned long) sharedResources->profiler.dropped,
+        (unsigned long) sharedResources->profiler.dumps
+    );
+    describePerfCounters(&sharedResources->perf, reply, size);
+
+    appendReply(reply, size, "span_ns count %lu", (unsigned long) sharedResources->spans.spans);
+
+    for (int mark = SPAN_DECODED; mark < SPAN_MARKS; mark++) {
+        appendReply(
+            reply, size, " %s p50<%lu p99<%lu", SPAN_STAGE_NAMES[mark],
+            (unsigned long) getHistogramPercentile(&sharedResources->spans.stageHistograms[mark - 1], 50),
+            (unsigned long) getHistogramPercentile(&sharedResources->spans.stageHistograms[mark - 1], 99)
+        );
+    }
+
+    appendReply(
+        reply, size, " total p50<%lu p99<%lu\n",
+        (unsigned long) getHistogramPercentile(&sharedResources->spans.totalHistogram, 50),
+        (unsigned long) getHistogramPercentile(&sharedResources->spans.totalHistogram, 99)
+    );
+    describeTableCore(&sharedResources->tableCore, reply, size);
+    appendReply(
+        reply, size, "wait_us p50<%lu p90<%lu p99<%lu\n",
+        (unsigned long) getHistogramPercentile(&waits, 50),
+        (unsigned long) getHistogramPercentile(&waits, 90),
+        (unsigned long) getHistogramPercentile(&waits, 99)
+    );
+
+    for (int i = 0; i < sharedResources->numberPhilosophers; i++) {
+        ServerPhilosopher *philosopher = &sharedResources->philosophers[i];
+
+        if (philosopher->base.id == 0) {
+            continue;
+        }
+
+        appendReply(
+            reply, size, "seat %d %s timer %d meals %lu load_us %lu%s%s\n",
+            philosopher->base.id,
+            getSeatStateName(philosopher),
+            philosopher->base.stateTimer,
+            (unsigned long) philosopher->meals,
+            (unsigned long) philosopher->waitLoad,
+            philosopher->draining ? " draining" : "",
+            philosopher->evicted && !philosopher->departed ? " evicting" : ""
+        );
+    }
+}
+
+/**
+ * @brief Exécute une commande de contrôle et rédige sa réponse.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ * @param command La commande reçue, sans retour à la ligne (modifiée par le découpage en mots).
+ * @param reply Le tampon de la réponse.
+ * @param size La taille du tampon de la réponse.
+ */
+void executeControlCommand(ServerContext *serverContext, char *command, char *reply, size_t size) {
+    SharedResources *sharedResources = serverContext->sharedResources;
+    char *savePointer = NULL;
+    char *name = strtok_r(command, " \t\r", &savePointer);
+    char *argument = strtok_r(NULL, " \t\r", &savePointer);
+
+    reply[0] = '\0';
+
+    if (!name) {
+        appendReply(reply, size, "error commande vide (voir help)\n");
+        return;
+    }
+
+    if (strcmp(name, "stats") == 0) {
+        describeStats(serverContext, reply, size);
+        return;
+    }
+
+    if (strcmp(name, "loglevel") == 0) {
+        for (int level = LOG_LEVEL_NONE; argument && level <= LOG_LEVEL_ALL; level++) {
+            if (strcmp(argument, LOG_LEVEL_NAMES[level]) == 0) {
+                sharedResources->logLevel = (LogLevel) level;
+            }
+        }
+
+        if (argument && strcmp(argument, LOG_LEVEL_NAMES[sharedResources->logLevel]) != 0) {
+            appendReply(reply, size, "error niveau inconnu : %s (none, server, all)\n", argument);
+            return;
+        }
+
+        appendReply(reply, size, "ok loglevel %s\n", LOG_LEVEL_NAMES[sharedResources->logLevel]);
+        return;
+    }
+
+    if (strcmp(name, "capacity") == 0) {
+        if (argument) {
+            int capacity = atoi(argument);
+
+            if (capacity < MIN_PHILOSOPHERS || capacity > MAX_PHILOSOPHERS) {
+                appendReply(reply, size, "error la capacité doit être comprise entre %d et %d\n", MIN_PHILOSOPHERS, MAX_PHILOSOPHERS);
+                return;
+            }
+
+            if (capacity < sharedResources->numberSeated) {
+                appendReply(reply, size, "error %d philosophes sont à table, en évincer avant de réduire la capacité\n", sharedResources->numberSeated);
+                return;
+            }
+
+            sharedResources->capacity = capacity;
+            logServerState(sharedResources->logsQueueId, "Capacité de la table : %d\n", capacity);
+        }
+
+        appendReply(reply, size, "ok capacity %d\n", sharedResources->capacity);
+        return;
+    }
+
+    if (strcmp(name, "policy") == 0) {
+        if (!argument) {
+            appendReply(reply, size, "ok policy %s\n", POLICY_NAMES[sharedResources->policy]);
+            return;
+        }
+
+        int policy = strcmp(argument, POLICY_NAMES[POLICY_COUNTER]) == 0 ? POLICY_COUNTER
+                   : strcmp(argument, POLICY_NAMES[POLICY_ORDERED]) == 0 ? POLICY_ORDERED
+                   : strcmp(argument, POLICY_NAMES[POLICY_SEQUENCED]) == 0 ? POLICY_SEQUENCED : -1;
+
+        if (policy == -1) {
+            appendReply(reply, size, "error politique inconnue : %s (counter, ordered, sequenced)\n", argument);
+            return;
+        }
+
+        PolicySwitch *policySwitch = countedMalloc(sizeof(PolicySwitch));
+        pthread_t thread;
+
+        if (!policySwitch) {
+            appendReply(reply, size, "error mémoire insuffisante\n");
+            return;
+        }
+
+        policySwitch->sharedResources = sharedResources;
+        policySwitch->policy = (ArbitrationPolicy) policy;
+        __atomic_add_fetch(&pendingPolicySwitches, 1, __ATOMIC_ACQUIRE);
+
+        if (pthread_create(&thread, NULL, policySwitchThread, policySwitch) != 0) {
+            __atomic_sub_fetch(&pendingPolicySwitches, 1, __ATOMIC_RELEASE);
+            free(policySwitch);
+            appendReply(reply, size, "error impossible de lancer le changement de politique\n");
+            return;
+        }
+
+        pthread_detach(thread);
+        appendReply(reply, size, "ok policy %s (appliquée dès la fin des prises de baguettes en cours)\n", argument);
+        return;
+    }
+
+    if (strcmp(name, "drain") == 0 || strcmp(name, "resume") == 0 || strcmp(name, "evict") == 0) {
+        ServerPhilosopher *philosopher = getControlledPhilosopher(argument, sharedResources);
+
+        if (!philosopher) {
+            appendReply(reply, size, "error philosophe introuvable ou déjà parti : %s\n", argument ? argument : "(aucun)");
+            return;
+        }
+
+        if (strcmp(name, "evict") == 0) {
+            philosopher->evicted = true;
+            notifyPhilosopherChange(philosopher, sharedResources);
+            logServerState(sharedResources->logsQueueId, "Le philosophe %d va être évincé\n", philosopher->base.id);
+            appendReply(reply, size, "ok evict %d (effective à sa prochaine requête)\n", philosopher->base.id);
+            unpinPhilosopher(philosopher);
+            return;
+        }
+
+        philosopher->draining = strcmp(name, "drain") == 0;
+        notifyPhilosopherChange(philosopher, sharedResources);
+        logServerState(sharedResources->logsQueueId, "Le philosophe %d %s\n", philosopher->base.id, philosopher->draining ? "n'est plus servi (drain)" : "est de nouveau servi");
+        appendReply(reply, size, "ok %s %d\n", name, philosopher->base.id);
+        unpinPhilosopher(philosopher);
+        return;
+    }
+
+    if (strcmp(name, "checkpoint") == 0) {
+        if (!writeCheckpoint(sharedResources, CHECKPOINT_PATH)) {
+            appendReply(reply, size, "error écriture de %s impossible\n", CHECKPOINT_PATH);
+            return;
+        }
+
+        appendReply(reply, size, "ok checkpoint %s\n", CHECKPOINT_PATH);
+        return;
+    }
+
+    if (strcmp(name, "ledger") == 0) {
+        Ledger *ledger = &sharedResources->ledger;
+
+        if (argument && strcmp(argument, "sync") == 0) {
+            ledger->syncGrants = true;
+        } else if (argument && strcmp(argument, "async") == 0) {
+            ledger->syncGrants = false;
+        } else if (argument) {
+            int intervalMs = atoi(argument);
+
+            if (intervalMs < 1 || intervalMs > LEDGER_MAX_COMMIT_INTERVAL_MS) {
+                appendReply(reply, size, "error argument invalide : %s (sync, async ou intervalle de 1 à %d ms)\n", argument, LEDGER_MAX_COMMIT_INTERVAL_MS);
+                return;
+            }
+
+            __atomic_store_n(&ledger->commitIntervalMs, (uint32_t) intervalMs, __ATOMIC_RELAXED);
+        }
+
+        if (!ledger->enabled) {
+            appendReply(reply, size, "ok ledger disabled\n");
+            return;
+        }
+
+        appendReply(
+            reply, size, "ok ledger %s interval %u ms sequence %lu durable %lu commits %lu records %lu holes %lu\n",
+            ledger->syncGrants ? "sync" : "async",
+            ledger->commitIntervalMs,
+            (unsigned long) __atomic_load_n(&ledger->nextSequence, __ATOMIC_RELAXED),
+            (unsigned long) __atomic_load_n(&ledger->durableSequence, __ATOMIC_RELAXED),
+            (unsigned long) ledger->commits,
+            (unsigned long) ledger->records,
+            (unsigned long) ledger->holes
+        );
+        return;
+    }
+
+    if (strcmp(name, "migration") == 0) {
+        if (argument && strcmp(argument, "on") != 0 && strcmp(argument, "off") != 0) {
+            appendReply(reply, size, "error argument invalide : %s (on, off)\n", argument);
+            return;
+        }
+
+        if (argument) {
+            sharedResources->migration.enabled = strcmp(argument, "on") == 0;
+            logServerState(sharedResources->logsQueueId, "Migration automatique des philosophes %s\n", sharedResources->migration.enabled ? "activée" : "désactivée");
+        }
+
+        appendReply(
+            reply, size, "ok migration %s moved %lu busy %lu\n",
+            sharedResources->migration.enabled ? "on" : "off",
+            (unsigned long) sharedResources->migration.migrations,
+            (unsigned long) sharedResources->migration.busy
+        );
+        return;
+    }
+
+    if (strcmp(name, "migrate") == 0) {
+        char *secondArgument = strtok_r(NULL, " \t\r", &savePointer);
+        int firstId = argument ? atoi(argument) : 0;
+        int secondId = secondArgument ? atoi(secondArgument) : 0;
+
+        if (firstId < 1 || secondId < 1) {
+            appendReply(reply, size, "error deux philosophes attendus : migrate <philosophe> <philosophe>\n");
+            return;
+        }
+
+        if (!swapSeats(firstId, secondId, sharedResources)) {
+            appendReply(reply, size, "error échange impossible : philosophes introuvables, pas en train de penser, ou places occupées (réessayer)\n");
+            return;
+        }
+
+        appendReply(reply, size, "ok migrate %d %d\n", firstId, secondId);
+        return;
+    }
+
+    if (strcmp(name, "pool") == 0) {
+        WorkerPoolState *pool = &sharedResources->workerPool;
+
+        if (argument) {
+            char *maxArgument = strtok_r(NULL, " \t\r", &savePointer);
+            char *idleArgument = strtok_r(NULL, " \t\r", &savePointer);
+            int minWorkers = atoi(argument);
+            int maxWorkers = maxArgument ? atoi(maxArgument) : 0;
+            int idleTimeoutMs = idleArgument ? atoi(idleArgument) : (int) pool->idleTimeoutMs;
+
+            if (!maxArgument || minWorkers < 0 || maxWorkers < 1 || minWorkers > maxWorkers || maxWorkers > MAX_PHILOSOPHERS || idleTimeoutMs < 1) {
+                appendReply(reply, size, "error arguments invalides : pool <min> <max> [idle_ms] (0 <= min <= max <= %d)\n", MAX_PHILOSOPHERS);
+                return;
+            }
+
+            // Le service datagramme applique un minimum relevé à son prochain tour, un maximum abaissé au réveil des
+            // threads libres
+            pool->idleTimeoutMs = (uint32_t) idleTimeoutMs;
+            pool->maxWorkers = maxWorkers;
+            pool->minWorkers = minWorkers;
+            logServerState(sharedResources->logsQueueId, "Réserve de threads du service datagramme : %d à %d threads, arrêt après %d ms d'inactivité\n", minWorkers, maxWorkers, idleTimeoutMs);
+        }
+
+        appendReply(
+            reply, size, "ok pool min %d max %d idle_ms %u workers %d idle %d queued %d\n",
+            pool->minWorkers, pool->maxWorkers, pool->idleTimeoutMs, pool->workers, pool->idleWorkers, pool->queued
+        );
+        return;
+    }
+
+    if (strcmp(name, "profile") == 0) {
+        ProfilerState *profiler = &sharedResources->profiler;
+
+        if (argument && strcmp(argument, "on") == 0) {
+            char *frequencyArgument = strtok_r(NULL, " \t\r", &savePointer);
+            int frequency = frequencyArgument ? atoi(frequencyArgument) : (int) profiler->frequency;
+
+            if (frequency < 1 || frequency > PROFILER_MAX_FREQUENCY) {
+                appendReply(reply, size, "error fréquence invalide : profile on [hz] (1 <= hz <= %d)\n", PROFILER_MAX_FREQUENCY);
+                return;
+            }
+
+            profiler->frequency = (uint32_t) frequency;
+            __atomic_store_n(&profiler->enabled, true, __ATOMIC_RELEASE);
+            requestProfilerUpdate(profiler);
+            logServerState(sharedResources->logsQueueId, "Profileur démarré à %d échantillons par seconde\n", frequency);
+        } else if (argument && strcmp(argument, "off") == 0) {
+            __atomic_store_n(&profiler->enabled, false, __ATOMIC_RELEASE);
+            requestProfilerUpdate(profiler);
+            logServerState(sharedResources->logsQueueId, "Profileur arrêté\n");
+        } else if (argument && strcmp(argument, "dump") == 0) {
+            // Le fichier est vidé ici, chaque processus y ajoute ensuite ses piles
+            int fd = open(PROFILE_FILE, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+            if (fd == -1) {
+                appendReply(reply, size, "error impossible d'ouvrir %s\n", PROFILE_FILE);
+                return;
+            }
+
+            close(fd);
+            __atomic_add_fetch(&profiler->dumpRequests, 1, __ATOMIC_RELEASE);
+            requestProfilerUpdate(profiler);
+            appendReply(reply, size, "ok profile dump %s (écrit par chaque processus dans l'instant)\n", PROFILE_FILE);
+            return;
+        } else if (argument) {
+            appendReply(reply, size, "error argument invalide : profile [on [hz]|off|dump]\n");
+            return;
+        }
+
+        appendReply(
+            reply, size, "ok profile %s frequency_hz %u samples %lu dropped %lu\n",
+            profiler->enabled ? "on" : "off", profiler->frequency,
+            (unsigned long) profiler->samples, (unsigned long) profiler->dropped
+        );
+        return;
+    }
+
+    if (strcmp(name, "perf") == 0) {
+        PerfCounterState *perf = &sharedResources->perf;
+
+        if (argument && (strcmp(argument, "on") == 0 || strcmp(argument, "off") == 0)) {
+            bool enabled = strcmp(argument, "on") == 0;
+
+            // Chaque thread de service lit le réglage au début de sa prochaine demande
+            __atomic_store_n(&perf->enabled, enabled, __ATOMIC_RELEASE);
+            logServerState(sharedResources->logsQueueId, "Compteurs matériels des repas %s\n", enabled ? "activés" : "désactivés");
+        } else if (argument) {
+            appendReply(reply, size, "error argument invalide : perf [on|off]\n");
+            return;
+        }
+
+        appendReply(
+            reply, size, "ok perf %s grants %lu unmeasured_threads %u\n",
+            perf->enabled ? "on" : "off", (unsigned long) perf->grants, perf->unmeasuredThreads
+        );
+        return;
+    }
+
+    if (strcmp(name, "spans") == 0) {
+        SpanStatistics *spans = &sharedResources->spans;
+
+        if (argument && strcmp(argument, "reset") == 0) {
+            memset(spans, 0, sizeof(SpanStatistics));
+            appendReply(reply, size, "ok spans reset\n");
+            return;
+        } else if (argument) {
+            appendReply(reply, size, "error argument invalide : spans [reset]\n");
+            return;
+        }
+
+        appendReply(reply, size, "ok spans count %lu\n", (unsigned long) spans->spans);
+
+        // Copie : les exemples peuvent être remplacés pendant la rédaction
+        RequestSpan exemplars[SPAN_EXEMPLARS];
+        memcpy(exemplars, spans->exemplars, sizeof(exemplars));
+
+        for (int i = 0; i < SPAN_EXEMPLARS; i++) {
+            int slowest = i;
+
+            for (int j = i + 1; j < SPAN_EXEMPLARS; j++) {
+                if (getSpanDuration(&exemplars[j]) > getSpanDuration(&exemplars[slowest])) {
+                    slowest = j;
+                }
+            }
+
+            RequestSpan span = exemplars[slowest];
+            exemplars[slowest] = exemplars[i];
+
+            if (getSpanDuration(&span) == 0) {
+                break;
+            }
+
+            char readTime[32];
+            formatTimestamp(getRealtimeFromTimestamp(span.marks[SPAN_READ]), readTime, sizeof(readTime));
+
+            appendReply(
+                reply, size, "span %s seat %d pid %d total_ns %lu", readTime, span.seatId, span.processId,
+                (unsigned long) getSpanDuration(&span)
+            );
+
+            for (int mark = SPAN_DECODED; mark < SPAN_MARKS; mark++) {
+                appendReply(reply, size, " %s %lu", SPAN_STAGE_NAMES[mark], (unsigned long) getSpanStageDuration(&span, mark));
+            }
+
+            appendReply(reply, size, "\n");
+        }
+        return;
+    }
+
+    if (strcmp(name, "upgrade") == 0) {
+        const char *path = argument ? argument : serverContext->executablePath;
+
+        if (__atomic_load_n(&pendingPolicySwitches, __ATOMIC_ACQUIRE) > 0) {
+            appendReply(reply, size, "error un changement de politique est en cours, réessayer une fois appliqué\n");
+            return;
+        }
+
+        if (access(path, X_OK) == -1) {
+            appendReply(reply, size, "error binaire introuvable ou non exécutable : %s\n", path);
+            return;
+        }
+
+        snprintf(serverContext->upgradePath, sizeof(serverContext->upgradePath), "%s", path);
+        appendReply(reply, size, "ok upgrade %s (les philosophes restent servis pendant la bascule)\n", path);
+        return;
+    }
+
+    if (strcmp(name, "help") == 0) {
+        appendReply(reply, size, "stats\nloglevel [none|server|all]\ncapacity [n]\npolicy [counter|ordered|sequenced]\n");
+        appendReply(reply, size, "drain <philosophe>\nresume <philosophe>\nevict <philosophe>\ncheckpoint\nledger [sync|async|ms]\n");
+        appendReply(reply, size, "migration [on|off]\nmigrate <philosophe> <philosophe>\npool [min max [idle_ms]]\n");
+        appendReply(reply, size, "profile [on [hz]|off|dump]\nperf [on|off]\nspans [reset]\nupgrade [chemin]\n");
+        return;
+    }
+
+    appendReply(reply, size, "error commande inconnue : %s (voir help)\n", name);
+}
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file Datagram.c
+ * @brief Implémente la construction et la réception des datagrammes du mode datagramme, côté client et serveur.
+ *
+ * Le protocole est décrit dans Datagram.h ; le service datagramme du serveur est implémenté dans DatagramService.c.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **buildDatagram()** : Construit un datagramme.
+ *  - **receiveDatagram()** : Attend et lit un datagramme sur un socket UDP connecté.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Datagram.h" pour le format des datagrammes.
+ *  - <poll.h> et <sys/socket.h> pour l'attente et la réception.
+ */
+
+#ifndef DATAGRAM_C
+#define DATAGRAM_C
+
+#include "../entities/Datagram.h"
+#include "../entities/Philosopher.h"
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+/**
+ * @brief Construit un datagramme.
+ *
+ * @param type Le type du datagramme.
+ * @param token Le jeton de session, 0 s'il n'y en a pas encore.
+ * @param sequence Le numéro de séquence.
+ * @param philosopher L'état du philosophe.
+ * @return Datagram Le datagramme initialisé.
+ */
+Datagram buildDatagram(DatagramType type, uint64_t token, uint32_t sequence, Philosopher philosopher) {
+    Datagram datagram;
+    memset(&datagram, 0, sizeof(datagram));
+
+    datagram.token = token;
+    datagram.sequence = sequence;
+    datagram.type = type;
+    datagram.philosopher = philosopher;
+
+    return datagram;
+}
+
+/**
+ * @brief Attend et lit un datagramme sur un socket UDP connecté au serveur.
+ *
+ * Les datagrammes d'une autre taille sont ignorés.
+ *
+ * @param socket Le socket UDP.
+ * @param datagram Reçoit le datagramme.
+ * @param timeout Attente maximale en millisecondes, 0 pour ne pas attendre.
+ * @return int 1 si un datagramme a été lu, 0 si le délai a expiré, -1 en cas d'erreur.
+ */
+int receiveDatagram(int socket, Datagram *datagram, int timeout) {
+    struct pollfd event = { .fd = socket, .events = POLLIN };
+
+    while (1) {
+        int ready = poll(&event, 1, timeout);
+
+        if (ready == -1 && errno == EINTR) {
+            continue;
+        }
+
+        if (ready <= 0) {
+            return ready;
+        }
+
+        ssize_t bytesReceived = recv(socket, datagram, sizeof(*datagram), MSG_DONTWAIT);
+
+        if (bytesReceived == sizeof(*datagram)) {
+            return 1;
+        }
+
+        // ECONNREFUSED : un envoi précédent n'a trouvé personne (serveur pas encore lancé ou arrêté), on attend encore
+        if (bytesReceived == -1 && errno != EAGAIN && errno != EINTR && errno != ECONNREFUSED) {
+            return -1;
+        }
+    }
+}
+
+#endif
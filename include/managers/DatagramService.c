@@ -0,0 +1,771 @@
+/**
+ * @file DatagramService.c
+ * @brief Implémente le service datagramme du serveur, qui sert tous les philosophes en mode datagramme.
+ *
+ * Le protocole est décrit dans Datagram.h, l'organisation du service (boucle principale et réserve de threads)
+ * dans DatagramService.h. À chaque tour, la boucle principale :
+ *  - vide le socket par lots de DATAGRAM_BATCH datagrammes (recvmmsg()) et traite chacun d'eux ;
+ *  - reprend les opérations terminées par la réserve de threads et prépare leurs réponses ;
+ *  - renvoie les autorisations non acquittées et retire les philosophes évincés ou silencieux ;
+ *  - ajuste la réserve de threads à son minimum et à l'attente des opérations déposées ;
+ *  - envoie toutes les réponses préparées pendant le tour, par lots (sendmmsg()).
+ *
+ * Le jeton d'une session contient son indice : un datagramme retrouve sa session sans recherche. Il identifie seul
+ * le client : l'identifiant de philosophe d'une mise à jour est ignoré, seule la place de la session est modifiée.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **openDatagramSocket()** : Ouvre le socket UDP du service.
+ *  - **queueDatagram()** / **flushDatagrams()** : Préparent et envoient les réponses par lots.
+ *  - **findSession()** / **openSession()** / **closeSession()** : Retrouvent, ouvrent ou ferment la session d'un client.
+ *  - **scheduleSession()** / **unscheduleSession()** : Rangent une session dans le tas des échéances, ou l'en retirent.
+ *  - **runSessionJob()** / **startJob()** : Exécutent les opérations bloquantes d'une session.
+ *  - **handleCompletedJobs()** : Répond aux opérations terminées.
+ *  - **handleDatagram()** / **receiveDatagrams()** : Reçoivent et traitent les datagrammes des clients.
+ *  - **checkSessions()** : Renvoie les autorisations non acquittées et retire les philosophes évincés ou silencieux,
+ *    pour les seules sessions dont l'échéance est passée.
+ *  - **datagramService()** : Boucle principale du service.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/DatagramService.h" pour les sessions, "../managers/Datagram.c" pour les datagrammes.
+ *  - "../managers/ServerPhilosopher.c" pour la création, la mise à jour et le départ des philosophes.
+ *  - "../managers/WorkerPool.c" pour la réserve de threads.
+ *  - <sys/eventfd.h>, <sys/random.h>, <poll.h> et <sys/socket.h>.
+ */
+
+#ifndef DATAGRAM_SERVICE_C
+#define DATAGRAM_SERVICE_C
+
+#include "../maxmin_philosophers.h"
+#include "../utils/sockets.h"
+#include "../entities/DatagramService.h"
+#include "../managers/Datagram.c"
+#include "../managers/ServerPhilosopher.c"
+#include "../managers/Statistics.c"
+#include "../managers/Logs.c"
+#include "../managers/WorkerPool.c"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <sys/random.h>
+
+/**
+ * @brief Ouvre le socket UDP du service, sur l'adresse et le port du socket d'écoute TCP.
+ *
+ * @return int Le socket, non bloquant, ou -1 en cas d'erreur.
+ */
+int openDatagramSocket() {
+    int datagramSocket = getDatagramSocket();
+
+    if (datagramSocket == -1) {
+        return -1;
+    }
+
+    struct sockaddr_in socketAddress = getSocketAddress();
+
+    if (bind(datagramSocket, (struct sockaddr *) &socketAddress, sizeof(socketAddress)) == -1) {
+        close(datagramSocket);
+        return -1;
+    }
+
+    fcntl(datagramSocket, F_SETFL, fcntl(datagramSocket, F_GETFL) | O_NONBLOCK);
+
+    return datagramSocket;
+}
+
+/**
+ * @brief Envoie les datagrammes en attente, par lots de DATAGRAM_BATCH en un seul appel à sendmmsg().
+ *
+ * Un datagramme que le noyau refuse (tampon plein) est abandonné, comme s'il s'était perdu : les autorisations sont
+ * renvoyées jusqu'à leur acquittement, et le client renvoie ses demandes restées sans réponse.
+ *
+ * @param service Le service.
+ */
+void flushDatagrams(DatagramService *service) {
+    struct mmsghdr messages[DATAGRAM_BATCH];
+    struct iovec vectors[DATAGRAM_BATCH];
+
+    for (int i = 0; i < service->numberOutgoing; i++) {
+        vectors[i] = (struct iovec) { .iov_base = &service->outgoing[i], .iov_len = sizeof(Datagram) };
+        memset(&messages[i], 0, sizeof(messages[i]));
+        messages[i].msg_hdr.msg_name = &service->outgoingAddresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent = 0;
+
+    while (sent < service->numberOutgoing) {
+        int result = sendmmsg(service->socket, messages + sent, service->numberOutgoing - sent, MSG_DONTWAIT);
+
+        if (result == -1 && errno == EINTR) {
+            continue;
+        }
+
+        // Le premier datagramme restant est abandonné, les suivants peuvent encore passer
+        sent += result == -1 ? 1 : result;
+    }
+
+    service->numberOutgoing = 0;
+}
+
+/**
+ * @brief Ajoute un datagramme à ceux qui seront envoyés à la fin du tour.
+ *
+ * @param service Le service.
+ * @param datagram Le datagramme.
+ * @param address Le destinataire.
+ */
+void queueDatagram(DatagramService *service, Datagram datagram, struct sockaddr_in address) {
+    if (service->numberOutgoing == DATAGRAM_BATCH) {
+        flushDatagrams(service);
+    }
+
+    service->outgoing[service->numberOutgoing] = datagram;
+    service->outgoingAddresses[service->numberOutgoing] = address;
+    service->numberOutgoing += 1;
+}
+
+/**
+ * @brief Retrouve la session d'un jeton.
+ *
+ * @param service Le service.
+ * @param token Le jeton reçu.
+ * @return DatagramSession* La session, ou NULL si le jeton ne correspond à aucune session ouverte.
+ */
+DatagramSession *findSession(DatagramService *service, uint64_t token) {
+    uint32_t index = (uint32_t) token;
+
+    if (index >= MAX_PHILOSOPHERS || !service->sessions[index].used || service->sessions[index].token != token) {
+        return NULL;
+    }
+
+    return &service->sessions[index];
+}
+
+/**
+ * @brief Échange deux sessions dans le tas des échéances.
+ *
+ * @param service Le service.
+ * @param first Position de la première session.
+ * @param second Position de la seconde session.
+ */
+void swapDeadlines(DatagramService *service, int first, int second) {
+    int session = service->deadlines[first];
+    service->deadlines[first] = service->deadlines[second];
+    service->deadlines[second] = session;
+    service->sessions[service->deadlines[first]].deadlineIndex = first;
+    service->sessions[service->deadlines[second]].deadlineIndex = second;
+}
+
+/**
+ * @brief Replace une session dans le tas des échéances après un changement de son échéance.
+ *
+ * @param service Le service.
+ * @param index Position de la session.
+ */
+void siftDeadline(DatagramService *service, int index) {
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+
+        if (service->sessions[service->deadlines[parent]].deadline <= service->sessions[service->deadlines[index]].deadline) {
+            break;
+        }
+
+        swapDeadlines(service, index, parent);
+        index = parent;
+    }
+
+    while (1) {
+        int smallest = index;
+
+        for (int child = 2 * index + 1; child <= 2 * index + 2 && child < service->numberDeadlines; child++) {
+            if (service->sessions[service->deadlines[child]].deadline < service->sessions[service->deadlines[smallest]].deadline) {
+                smallest = child;
+            }
+        }
+
+        if (smallest == index) {
+            return;
+        }
+
+        swapDeadlines(service, index, smallest);
+        index = smallest;
+    }
+}
+
+/**
+ * @brief Fixe la prochaine échéance d'une session, et l'ajoute au tas des échéances si elle n'y est pas.
+ *
+ * @param service Le service.
+ * @param session La session.
+ * @param deadline Heure monotone (ns) de son prochain examen.
+ */
+void scheduleSession(DatagramService *service, DatagramSession *session, uint64_t deadline) {
+    if (session->deadlineIndex == -1) {
+        session->deadlineIndex = service->numberDeadlines++;
+        service->deadlines[session->deadlineIndex] = session - service->sessions;
+    }
+
+    session->deadline = deadline;
+    siftDeadline(service, session->deadlineIndex);
+}
+
+/**
+ * @brief Retire une session du tas des échéances.
+ *
+ * @param service Le service.
+ * @param session La session.
+ */
+void unscheduleSession(DatagramService *service, DatagramSession *session) {
+    int index = session->deadlineIndex;
+
+    if (index == -1) {
+        return;
+    }
+
+    swapDeadlines(service, index, --service->numberDeadlines);
+    session->deadlineIndex = -1;
+
+    if (index < service->numberDeadlines) {
+        siftDeadline(service, index);
+    }
+}
+
+/**
+ * @brief Retourne l'échéance d'une session : le renvoi de son autorisation, ou son départ faute de nouvelles.
+ *
+ * @param session La session.
+ * @return uint64_t Heure monotone (ns) de son prochain examen.
+ */
+uint64_t getSessionDeadline(const DatagramSession *session) {
+    uint64_t deadline = session->lastHeard + (uint64_t) DATAGRAM_SESSION_TIMEOUT * 1000000;
+    uint64_t retransmit = session->grantSentAt + (uint64_t) DATAGRAM_RETRANSMIT_INTERVAL * 1000000;
+
+    return session->awaitingAck && retransmit < deadline ? retransmit : deadline;
+}
+
+/**
+ * @brief Ferme une session.
+ *
+ * @param service Le service.
+ * @param session La session.
+ */
+void closeSession(DatagramService *service, DatagramSession *session) {
+    session->used = false;
+    unscheduleSession(service, session);
+}
+
+/**
+ * @brief Ouvre une session pour un client qui demande la création d'un philosophe.
+ *
+ * @param service Le service.
+ * @param createNonce Le nombre aléatoire de la demande de création.
+ * @param address L'adresse du client.
+ * @return DatagramSession* La session, ou NULL si toutes les sessions sont ouvertes.
+ */
+DatagramSession *openSession(DatagramService *service, uint32_t createNonce, struct sockaddr_in address) {
+    for (uint32_t i = 0; i < MAX_PHILOSOPHERS; i++) {
+        DatagramSession *session = &service->sessions[i];
+
+        // Une session fermée dont une opération est encore en cours ne peut pas être reprise
+        if (session->used || session->busy) {
+            continue;
+        }
+
+        uint32_t secret = 0;
+
+        if (getrandom(&secret, sizeof(secret), 0) != sizeof(secret)) {
+            secret = (uint32_t) rand();
+        }
+
+        // La partie aléatoire n'est jamais nulle : le jeton 0 désigne l'absence de session
+        session->used = true;
+        session->token = ((uint64_t) (secret | 1) << 32) | i;
+        session->createNonce = createNonce;
+        session->address = address;
+        session->seatId = 0;
+        session->lastSequence = 0;
+        session->lastHeard = getMonotonicTime();
+        session->leaving = false;
+        session->awaitingAck = false;
+        scheduleSession(service, session, getSessionDeadline(session));
+
+        return session;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Retourne l'état du philosophe d'une session.
+ *
+ * Le compactage pouvant déplacer les places, une session ne garde que l'identifiant de son philosophe : son état
+ * est copié à chaque lecture.
+ *
+ * @param session La session, dont la création a abouti.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return ServerPhilosopher La copie de la place ; une place effacée est rendue comme partie, avec son identifiant.
+ */
+ServerPhilosopher getSessionSeat(DatagramSession *session, SharedResources *sharedResources) {
+    ServerPhilosopher seat;
+
+    if (!copyPhilosopher(session->seatId, sharedResources, &seat)) {
+        memset(&seat, 0, sizeof(seat));
+        seat.base.id = session->seatId;
+        seat.departed = true;
+    }
+
+    return seat;
+}
+
+/**
+ * @brief Exécute l'opération bloquante d'une session, depuis un thread de la réserve.
+ *
+ * @param context Pointeur vers le service.
+ * @param index L'indice de la session.
+ */
+void runSessionJob(void *context, int index) {
+    DatagramService *service = (DatagramService *) context;
+    DatagramSession *session = &service->sessions[index];
+    SharedResources *sharedResources = service->sharedResources;
+
+    switch (session->job) {
+
+        case DATAGRAM_JOB_CREATE: {
+            ServerPhilosopher created = createPhilosopher(sharedResources);
+            session->seatId = created.base.id;
+            session->jobSucceeded = session->seatId != 0;
+            break;
+        }
+
+        case DATAGRAM_JOB_HUNGRY:
+            // La demande a été décodée, et sa réponse sera envoyée, par la boucle principale du service
+            beginPerfSpan();
+            session->jobSucceeded = updatePhilosopher(session->jobPhilosopher, sharedResources, NULL);
+            endPerfSpan();
+            break;
+
+        case DATAGRAM_JOB_LEAVE: {
+            ServerPhilosopher seat = getSessionSeat(session, sharedResources);
+
+            // Un philosophe qui mange rend d'abord ses baguettes, hors du sémaphore de création : deux voisins
+            // qui partent ensemble en mangeant ne s'attendent pas l'un l'autre
+            if (session->seatId && !seat.departed && seat.base.state == EATING) {
+                Philosopher thinking = seat.base;
+                thinking.state = THINKING;
+                updatePhilosopher(thinking, sharedResources, NULL);
+            }
+
+            if (session->seatId) {
+                leaveTable(session->seatId, sharedResources);
+            }
+            session->jobSucceeded = true;
+            break;
+        }
+    }
+
+    pthread_mutex_lock(&service->completedLock);
+    service->completed[service->numberCompleted++] = session - service->sessions;
+    pthread_mutex_unlock(&service->completedLock);
+
+    uint64_t one = 1;
+    write(service->eventFd, &one, sizeof(one));
+}
+
+/**
+ * @brief Confie une opération d'une session à la réserve de threads.
+ *
+ * @param service Le service.
+ * @param session La session, sans opération en cours.
+ * @param job L'opération.
+ * @param sequence La séquence de la demande à l'origine de l'opération.
+ * @return bool false si la réserve n'a aucun thread et ne peut pas en créer.
+ */
+bool startJob(DatagramService *service, DatagramSession *session, DatagramJob job, uint32_t sequence) {
+    session->job = job;
+    session->jobSequence = sequence;
+    session->busy = true;
+
+    if (session->seatId) {
+        session->jobPhilosopher.id = session->seatId;
+    }
+
+    if (!submitWork(&service->pool, session - service->sessions)) {
+        session->busy = false;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Répond aux opérations terminées par la réserve de threads.
+ *
+ * @param service Le service.
+ */
+void handleCompletedJobs(DatagramService *service) {
+    SharedResources *sharedResources = service->sharedResources;
+    uint64_t count;
+    read(service->eventFd, &count, sizeof(count));
+
+    int completed[MAX_PHILOSOPHERS];
+
+    pthread_mutex_lock(&service->completedLock);
+    int numberCompleted = service->numberCompleted;
+    memcpy(completed, service->completed, numberCompleted * sizeof(int));
+    service->numberCompleted = 0;
+    pthread_mutex_unlock(&service->completedLock);
+
+    char message[LOG_BUFFER_SIZE];
+
+    for (int i = 0; i < numberCompleted; i++) {
+        DatagramSession *session = &service->sessions[completed[i]];
+        session->busy = false;
+
+        switch (session->job) {
+
+            case DATAGRAM_JOB_CREATE:
+                if (!session->jobSucceeded) {
+                    queueDatagram(service, buildDatagram(DATAGRAM_REFUSED, 0, session->createNonce, (Philosopher) { 0 }), session->address);
+                    logClientInfo(sharedResources->logsQueueId, "Table pleine, création d'un philosophe en mode datagramme refusée.\n");
+                    closeSession(service, session);
+                    continue;
+                }
+
+                queueDatagram(service, buildDatagram(DATAGRAM_CREATED, session->token, session->createNonce, getSessionSeat(session, sharedResources).base), session->address);
+                snprintf(message, sizeof(message), "Philosophe %d ajouté à la table en mode datagramme.\n", session->seatId);
+                logClientInfo(sharedResources->logsQueueId, message);
+                break;
+
+            case DATAGRAM_JOB_HUNGRY:
+                if (session->jobSucceeded) {
+                    session->awaitingAck = true;
+                    session->grantSequence = session->jobSequence;
+                    session->grantSentAt = getMonotonicTime();
+                    scheduleSession(service, session, getSessionDeadline(session));
+                    queueDatagram(service, buildDatagram(DATAGRAM_GRANT, session->token, session->grantSequence, getSessionSeat(session, sharedResources).base), session->address);
+                }
+                break;
+
+            case DATAGRAM_JOB_LEAVE:
+                // Le client encore présent (évincé) apprend qu'il n'a plus de place
+                queueDatagram(service, buildDatagram(DATAGRAM_REFUSED, session->token, session->lastSequence, getSessionSeat(session, sharedResources).base), session->address);
+                snprintf(message, sizeof(message), "Philosophe %d retiré de la table, session fermée.\n", session->seatId);
+                logClientInfo(sharedResources->logsQueueId, message);
+                closeSession(service, session);
+                continue;
+        }
+
+        if (session->leaving || getSessionSeat(session, sharedResources).evicted) {
+            startJob(service, session, DATAGRAM_JOB_LEAVE, session->lastSequence);
+        }
+    }
+}
+
+/**
+ * @brief Traite un datagramme reçu d'un client.
+ *
+ * @param service Le service.
+ * @param datagram Le datagramme.
+ * @param address L'adresse de l'expéditeur.
+ * @param now Heure monotone de réception (ns).
+ */
+void handleDatagram(DatagramService *service, Datagram datagram, struct sockaddr_in address, uint64_t now) {
+
+    if (datagram.type == DATAGRAM_CREATE) {
+        for (int i = 0; i < MAX_PHILOSOPHERS; i++) {
+            DatagramSession *session = &service->sessions[i];
+
+            // Doublon d'une création déjà demandée : réponse renvoyée si elle est prête, sinon elle suivra
+            if (session->used && session->createNonce == datagram.sequence && session->address.sin_port == address.sin_port && session->address.sin_addr.s_addr == address.sin_addr.s_addr) {
+                if (!(session->busy && session->job == DATAGRAM_JOB_CREATE) && session->seatId) {
+                    queueDatagram(service, buildDatagram(DATAGRAM_CREATED, session->token, session->createNonce, getSessionSeat(session, service->sharedResources).base), address);
+                }
+                return;
+            }
+        }
+
+        DatagramSession *session = openSession(service, datagram.sequence, address);
+
+        if (!session || !startJob(service, session, DATAGRAM_JOB_CREATE, datagram.sequence)) {
+            if (session) {
+                closeSession(service, session);
+            }
+            queueDatagram(service, buildDatagram(DATAGRAM_REFUSED, 0, datagram.sequence, (Philosopher) { 0 }), address);
+        }
+        return;
+    }
+
+    DatagramSession *session = findSession(service, datagram.token);
+
+    // Pendant la création, la place est écrite par le thread qui l'exécute : elle n'est lue qu'une fois la création terminée
+    if (!session || (session->busy && session->job == DATAGRAM_JOB_CREATE) || !session->seatId) {
+        queueDatagram(service, buildDatagram(DATAGRAM_REFUSED, datagram.token, datagram.sequence, (Philosopher) { 0 }), address);
+        return;
+    }
+
+    session->address = address;
+    session->lastHeard = now;
+
+    if (datagram.type == DATAGRAM_ACK) {
+        if (session->awaitingAck && datagram.sequence == session->grantSequence) {
+            session->awaitingAck = false;
+        }
+        return;
+    }
+
+    // Doublon : une demande de repas renvoyée est acquittée, ou son autorisation renvoyée si elle est déjà accordée
+    if (datagram.sequence == session->lastSequence) {
+        if (datagram.type == DATAGRAM_UPDATE && datagram.philosopher.state == HUNGRY) {
+            if (session->busy && session->job == DATAGRAM_JOB_HUNGRY) {
+                queueDatagram(service, buildDatagram(DATAGRAM_ACK, session->token, datagram.sequence, getSessionSeat(session, service->sharedResources).base), address);
+            } else if (session->awaitingAck && session->grantSequence == datagram.sequence) {
+                session->grantSentAt = now;
+                queueDatagram(service, buildDatagram(DATAGRAM_GRANT, session->token, datagram.sequence, getSessionSeat(session, service->sharedResources).base), address);
+            }
+        }
+        return;
+    }
+
+    // Datagramme en retard sur un plus récent
+    if (datagram.sequence < session->lastSequence) {
+        return;
+    }
+
+    // Tout datagramme plus récent que la demande accordée vaut acquittement de l'autorisation
+    session->lastSequence = datagram.sequence;
+    session->awaitingAck = false;
+
+    if (datagram.type == DATAGRAM_LEAVE) {
+        if (session->busy) {
+            session->leaving = true;
+        } else {
+            startJob(service, session, DATAGRAM_JOB_LEAVE, datagram.sequence);
+        }
+        return;
+    }
+
+    if (datagram.type != DATAGRAM_UPDATE || session->busy) {
+        return;
+    }
+
+    ServerPhilosopher seat = getSessionSeat(session, service->sharedResources);
+
+    if (seat.evicted) {
+        return;
+    }
+
+    // Seule la place de la session peut être modifiée, quel que soit l'identifiant envoyé
+    datagram.philosopher.id = session->seatId;
+
+    if (datagram.philosopher.state == HUNGRY) {
+        session->jobPhilosopher = datagram.philosopher;
+
+        if (startJob(service, session, DATAGRAM_JOB_HUNGRY, datagram.sequence)) {
+            queueDatagram(service, buildDatagram(DATAGRAM_ACK, session->token, datagram.sequence, seat.base), address);
+        }
+        return;
+    }
+
+    // THINKING et EATING ne font que libérer des sémaphores ou copier l'état : la boucle ne bloque pas
+    updatePhilosopher(datagram.philosopher, service->sharedResources, NULL);
+}
+
+/**
+ * @brief Vide le socket du service par lots, en un seul appel à recvmmsg() par lot.
+ *
+ * @param service Le service.
+ * @return bool false en cas d'erreur de lecture du socket.
+ */
+bool receiveDatagrams(DatagramService *service) {
+    Datagram datagrams[DATAGRAM_BATCH];
+    struct sockaddr_in addresses[DATAGRAM_BATCH];
+    struct iovec vectors[DATAGRAM_BATCH];
+    struct mmsghdr messages[DATAGRAM_BATCH];
+
+    for (int i = 0; i < DATAGRAM_BATCH; i++) {
+        vectors[i] = (struct iovec) { .iov_base = &datagrams[i], .iov_len = sizeof(Datagram) };
+        memset(&messages[i], 0, sizeof(messages[i]));
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while (1) {
+        for (int i = 0; i < DATAGRAM_BATCH; i++) {
+            messages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        }
+
+        int received = recvmmsg(service->socket, messages, DATAGRAM_BATCH, MSG_DONTWAIT, NULL);
+
+        if (received == -1) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+
+        uint64_t now = getMonotonicTime();
+
+        for (int i = 0; i < received; i++) {
+            // Les datagrammes d'une autre taille (ou tronqués) ne viennent pas d'un client
+            if (messages[i].msg_len == sizeof(Datagram) && !(messages[i].msg_hdr.msg_flags & MSG_TRUNC)) {
+                handleDatagram(service, datagrams[i], addresses[i], now);
+            }
+        }
+
+        // Lot incomplet : le socket est vide, inutile de le vérifier par un appel de plus
+        if (received < DATAGRAM_BATCH) {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Renvoie les autorisations non acquittées, et retire de la table les philosophes évincés ou silencieux.
+ *
+ * Seules les sessions dont l'échéance est passée sont examinées, puis replacées dans le tas à leur échéance
+ * suivante. Une session dont une opération est en cours (ou dont la création n'a pas abouti) est revue
+ * DATAGRAM_RETRANSMIT_INTERVAL ms plus tard.
+ *
+ * Un philosophe en attente de repas n'est pas retiré : sa demande est en cours, le client la renvoie tant qu'il
+ * attend. Il le sera après l'autorisation, faute d'acquittement.
+ *
+ * @param service Le service.
+ * @param now Heure monotone (ns).
+ * @return uint64_t Heure monotone (ns) de la prochaine échéance, 0 si aucune session n'est ouverte.
+ */
+uint64_t checkSessions(DatagramService *service, uint64_t now) {
+    while (service->numberDeadlines > 0) {
+        DatagramSession *session = &service->sessions[service->deadlines[0]];
+
+        if (session->deadline > now) {
+            break;
+        }
+
+        if (session->busy || !session->seatId) {
+            scheduleSession(service, session, now + (uint64_t) DATAGRAM_RETRANSMIT_INTERVAL * 1000000);
+            continue;
+        }
+
+        ServerPhilosopher seat = getSessionSeat(session, service->sharedResources);
+
+        if (session->awaitingAck && now - session->grantSentAt >= (uint64_t) DATAGRAM_RETRANSMIT_INTERVAL * 1000000) {
+            session->grantSentAt = now;
+            queueDatagram(service, buildDatagram(DATAGRAM_GRANT, session->token, session->grantSequence, seat.base), session->address);
+        }
+
+        bool silent = now - session->lastHeard >= (uint64_t) DATAGRAM_SESSION_TIMEOUT * 1000000;
+
+        if (seat.evicted || silent) {
+            char message[LOG_BUFFER_SIZE];
+            snprintf(message, sizeof(message), "Philosophe %d %s, départ de la table.\n", session->seatId, silent ? "sans nouvelles de son client" : "évincé");
+            logClientInfo(service->sharedResources->logsQueueId, message);
+            startJob(service, session, DATAGRAM_JOB_LEAVE, session->lastSequence);
+            scheduleSession(service, session, now + (uint64_t) DATAGRAM_RETRANSMIT_INTERVAL * 1000000);
+            continue;
+        }
+
+        scheduleSession(service, session, getSessionDeadline(session));
+    }
+
+    return service->numberDeadlines > 0 ? service->sessions[service->deadlines[0]].deadline : 0;
+}
+
+/**
+ * @brief Boucle principale du service datagramme.
+ *
+ * Le service attend sans délai tant qu'aucune session n'est ouverte ; sinon il se réveille au plus tard à la
+ * prochaine échéance des sessions (renvoi d'une autorisation ou départ d'un philosophe silencieux), et toutes les
+ * `growLatencyMs` tant que des opérations attendent un thread de la réserve.
+ *
+ * Si le socket ne peut plus être lu, un arrêt contrôlé du serveur est déclenché lorsque des philosophes sont à table,
+ * comme pour un processus de service TCP.
+ *
+ * @param datagramSocket Le socket UDP du service.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ */
+void datagramService(int datagramSocket, SharedResources *sharedResources) {
+    DatagramService *service = calloc(1, sizeof(DatagramService));
+
+    if (!service) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+
+    service->socket = datagramSocket;
+    service->sharedResources = sharedResources;
+    service->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    pthread_mutex_init(&service->completedLock, NULL);
+
+    for (int i = 0; i < MAX_PHILOSOPHERS; i++) {
+        service->sessions[i].deadlineIndex = -1;
+    }
+
+    initWorkerPool(&service->pool, &sharedResources->workerPool, runSessionJob, service);
+
+    if (service->eventFd == -1) {
+        logClientInfo(sharedResources->logsQueueId, "Erreur lors de la création de l'eventfd du service datagramme.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    logClientInfo(sharedResources->logsQueueId, "Service datagramme ouvert.\n");
+
+    uint64_t nextDeadline = 0;
+    int queued = 0;
+
+    while (1) {
+        struct pollfd events[2] = {
+            { .fd = service->socket, .events = POLLIN },
+            { .fd = service->eventFd, .events = POLLIN }
+        };
+
+        int timeout = -1;
+
+        if (nextDeadline) {
+            uint64_t now = getMonotonicTime();
+            timeout = nextDeadline > now ? (int) ((nextDeadline - now + 999999) / 1000000) : 0;
+        }
+
+        if (queued > 0 && (timeout == -1 || (int) sharedResources->workerPool.growLatencyMs < timeout)) {
+            timeout = (int) sharedResources->workerPool.growLatencyMs;
+        }
+
+        if (poll(events, 2, timeout) == -1 && errno != EINTR) {
+            break;
+        }
+
+        if (events[0].revents && !receiveDatagrams(service)) {
+            break;
+        }
+
+        if (events[1].revents) {
+            handleCompletedJobs(service);
+        }
+
+        nextDeadline = checkSessions(service, getMonotonicTime());
+        queued = growWorkerPool(&service->pool);
+        flushDatagrams(service);
+    }
+
+    logClientInfo(sharedResources->logsQueueId, "Erreur à la lecture du socket du service datagramme.\n");
+
+    for (int i = 0; i < MAX_PHILOSOPHERS; i++) {
+        if (service->sessions[i].used && service->sessions[i].seatId) {
+            // En coupant le parent, on lance le mécanisme de cleanup centralisé.
+            kill(getppid(), SIGINT);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    exit(EXIT_FAILURE);
+}
+
+#endif
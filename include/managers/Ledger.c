@@ -0,0 +1,317 @@
+/**
+ * @file Ledger.c
+ * @brief Implémente le registre des repas : dépôt des événements dans l'anneau partagé et validation groupée.
+ *
+ * Le fonctionnement et le format du registre sont décrits dans Ledger.h.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **initLedger()** : Initialise l'anneau d'une nouvelle table, à la suite des séquences déjà sur disque.
+ *  - **getLedgerChecksum()** : Calcule la somme de contrôle d'un enregistrement.
+ *  - **appendLedgerRecord()** : Dépose un événement dans l'anneau (processus de service).
+ *  - **waitLedgerDurable()** : Attend qu'un événement soit sur disque.
+ *  - **openLedgerWriter()** : Ouvre le fichier du registre, en retire un enregistrement tronqué et lit la séquence suivante.
+ *  - **commitLedger()** : Écrit d'un seul write() les événements publiés, puis les valide par fdatasync().
+ *  - **disableLedger()** : Désactive le registre et libère les processus qui l'attendent.
+ *
+ * Les attentes (anneau plein, durabilité) passent par des futex sur des compteurs de la mémoire partagée ; elles
+ * sont bornées dans le temps pour qu'un réveil manqué ne bloque jamais un processus de service.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Ledger.h" pour les structures du registre.
+ *  - "../utils/crc32.h" pour les sommes de contrôle.
+ *  - "Statistics.c" pour l'heure monotone.
+ *  - <linux/futex.h> et <sys/syscall.h> pour les attentes.
+ */
+
+#ifndef LEDGER_C
+#define LEDGER_C
+
+#include "../entities/Ledger.h"
+#include "../utils/crc32.h"
+#include "Statistics.c"
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <sys/stat.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Attend qu'un compteur de la mémoire partagée change de valeur, au plus `timeoutMs` millisecondes.
+ *
+ * @param address Le compteur.
+ * @param value Sa valeur lue avant l'attente.
+ * @param timeoutMs Durée maximale de l'attente.
+ */
+void ledgerFutexWait(uint32_t *address, uint32_t value, long timeoutMs) {
+    struct timespec timeout = { .tv_sec = timeoutMs / 1000, .tv_nsec = (timeoutMs % 1000) * 1000000L };
+    syscall(SYS_futex, address, FUTEX_WAIT, value, &timeout, NULL, 0);
+}
+
+/**
+ * @brief Incrémente un compteur de la mémoire partagée et réveille tous les processus qui l'attendent.
+ *
+ * @param address Le compteur.
+ */
+void ledgerFutexWake(uint32_t *address) {
+    __atomic_add_fetch(address, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, address, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+/**
+ * @brief Initialise l'anneau du registre d'une nouvelle table.
+ *
+ * @param ledger L'anneau.
+ * @param firstSequence Première séquence à réserver, à la suite de celles déjà dans le fichier.
+ */
+void initLedger(Ledger *ledger, uint64_t firstSequence) {
+    memset(ledger, 0, sizeof(Ledger));
+    ledger->nextSequence = firstSequence;
+    ledger->writtenSequence = firstSequence;
+    ledger->durableSequence = firstSequence;
+    ledger->commitIntervalMs = LEDGER_DEFAULT_COMMIT_INTERVAL_MS;
+    ledger->syncGrants = false;
+}
+
+/**
+ * @brief Calcule la somme de contrôle d'un enregistrement (tous ses octets avant le champ `checksum`).
+ *
+ * @param record L'enregistrement.
+ * @return uint32_t La somme de contrôle.
+ */
+uint32_t getLedgerChecksum(const LedgerRecord *record) {
+    return crc32(record, offsetof(LedgerRecord, checksum));
+}
+
+/**
+ * @brief Dépose un événement dans l'anneau du registre.
+ *
+ * Sans verrou : la séquence est réservée par incrément atomique, puis la case est écrite et publiée. Si l'anneau
+ * est plein (le thread d'écriture a LEDGER_RING_SIZE événements de retard), l'appelant attend qu'il se vide.
+ *
+ * @param ledger L'anneau.
+ * @param type Le type d'événement.
+ * @param philosopherId Le philosophe concerné.
+ * @param leftChopstick Sa baguette gauche.
+ * @param rightChopstick Sa baguette droite.
+ * @return uint64_t La séquence de l'événement, à passer à waitLedgerDurable(), ou UINT64_MAX si le registre est désactivé.
+ */
+uint64_t appendLedgerRecord(Ledger *ledger, LedgerEventType type, int philosopherId, int leftChopstick, int rightChopstick) {
+    if (!__atomic_load_n(&ledger->enabled, __ATOMIC_ACQUIRE)) {
+        return UINT64_MAX;
+    }
+
+    uint64_t sequence = __atomic_fetch_add(&ledger->nextSequence, 1, __ATOMIC_RELAXED);
+
+    while (sequence - __atomic_load_n(&ledger->writtenSequence, __ATOMIC_ACQUIRE) >= LEDGER_RING_SIZE
+        && __atomic_load_n(&ledger->enabled, __ATOMIC_ACQUIRE)) {
+        uint32_t space = __atomic_load_n(&ledger->spaceFutex, __ATOMIC_ACQUIRE);
+
+        if (sequence - __atomic_load_n(&ledger->writtenSequence, __ATOMIC_ACQUIRE) < LEDGER_RING_SIZE) {
+            break;
+        }
+
+        ledgerFutexWait(&ledger->spaceFutex, space, 10);
+    }
+
+    LedgerSlot *slot = &ledger->slots[sequence % LEDGER_RING_SIZE];
+    slot->record = (LedgerRecord) {
+        .sequence = sequence,
+        .timestamp = getRealtimeFromTimestamp(getTimestamp()),
+        .philosopherId = philosopherId,
+        .leftChopstick = (uint32_t) leftChopstick,
+        .rightChopstick = (uint32_t) rightChopstick,
+        .type = (uint16_t) type
+    };
+    slot->record.checksum = getLedgerChecksum(&slot->record);
+
+    __atomic_store_n(&slot->stamp, sequence + 1, __ATOMIC_RELEASE);
+    return sequence;
+}
+
+/**
+ * @brief Attend qu'un événement du registre soit sur disque (sans attendre si le registre est désactivé).
+ *
+ * @param ledger L'anneau.
+ * @param sequence La séquence de l'événement.
+ */
+void waitLedgerDurable(Ledger *ledger, uint64_t sequence) {
+    while (__atomic_load_n(&ledger->durableSequence, __ATOMIC_ACQUIRE) <= sequence
+        && __atomic_load_n(&ledger->enabled, __ATOMIC_ACQUIRE)) {
+        uint32_t durable = __atomic_load_n(&ledger->durableFutex, __ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&ledger->durableSequence, __ATOMIC_ACQUIRE) > sequence) {
+            break;
+        }
+
+        ledgerFutexWait(&ledger->durableFutex, durable, 100);
+    }
+}
+
+/**
+ * @brief Ouvre le fichier du registre en ajout.
+ *
+ * Un fichier neuf reçoit son en-tête. Un enregistrement tronqué en fin de fichier (arrêt brutal pendant une
+ * écriture) est retiré, et la séquence suivant le dernier enregistrement complet est retournée.
+ *
+ * @param writer L'état du thread d'écriture.
+ * @param path Le chemin du fichier.
+ * @param nextSequence Reçoit la séquence suivant le dernier enregistrement du fichier (0 pour un fichier neuf).
+ * @return bool false si le fichier ne peut pas être ouvert ou n'est pas un registre de ce format.
+ */
+bool openLedgerWriter(LedgerWriter *writer, const char *path, uint64_t *nextSequence) {
+    writer->fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    writer->stalledSequence = UINT64_MAX;
+    writer->stalledSince = 0;
+    *nextSequence = 0;
+
+    if (writer->fd == -1) {
+        return false;
+    }
+
+    struct stat fileStat;
+    LedgerFileHeader header;
+
+    if (fstat(writer->fd, &fileStat) == -1) {
+        close(writer->fd);
+        return false;
+    }
+
+    if (fileStat.st_size < (off_t) sizeof(LedgerFileHeader)) {
+        header = (LedgerFileHeader) {
+            .magic = LEDGER_MAGIC, .version = LEDGER_VERSION, .recordSize = sizeof(LedgerRecord), .reserved = 0
+        };
+
+        bool created = ftruncate(writer->fd, 0) == 0
+            && write(writer->fd, &header, sizeof(header)) == (ssize_t) sizeof(header)
+            && fdatasync(writer->fd) == 0;
+
+        if (!created) {
+            close(writer->fd);
+        }
+        return created;
+    }
+
+    if (pread(writer->fd, &header, sizeof(header), 0) != (ssize_t) sizeof(header)
+        || header.magic != LEDGER_MAGIC || header.version != LEDGER_VERSION || header.recordSize != sizeof(LedgerRecord)) {
+        close(writer->fd);
+        return false;
+    }
+
+    off_t recordsSize = fileStat.st_size - (off_t) sizeof(LedgerFileHeader);
+    off_t completeSize = recordsSize - recordsSize % (off_t) sizeof(LedgerRecord);
+
+    if (completeSize != recordsSize && ftruncate(writer->fd, (off_t) sizeof(LedgerFileHeader) + completeSize) == -1) {
+        close(writer->fd);
+        return false;
+    }
+
+    if (completeSize > 0) {
+        LedgerRecord last;
+
+        if (pread(writer->fd, &last, sizeof(last), (off_t) sizeof(LedgerFileHeader) + completeSize - (off_t) sizeof(LedgerRecord)) == (ssize_t) sizeof(last)) {
+            *nextSequence = last.sequence + 1;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Écrit d'un seul write() les événements publiés depuis la validation précédente, puis les valide.
+ *
+ * Les cases sont libérées dès leur copie, avant l'écriture. Une séquence réservée mais toujours pas publiée après
+ * LEDGER_HOLE_TIMEOUT_MS, alors que des séquences suivantes ont été réservées, est remplacée par un événement
+ * LEDGER_HOLE : le processus qui l'avait réservée a été tué, et l'écriture ne doit pas rester bloquée.
+ *
+ * @param ledger L'anneau.
+ * @param writer L'état du thread d'écriture.
+ * @return int Le nombre d'événements écrits, ou -1 en cas d'erreur d'écriture.
+ */
+int commitLedger(Ledger *ledger, LedgerWriter *writer) {
+    uint64_t written = __atomic_load_n(&ledger->writtenSequence, __ATOMIC_RELAXED);
+    int count = 0;
+
+    while (count < LEDGER_RING_SIZE) {
+        LedgerSlot *slot = &ledger->slots[written % LEDGER_RING_SIZE];
+
+        if (__atomic_load_n(&slot->stamp, __ATOMIC_ACQUIRE) == written + 1) {
+            writer->buffer[count++] = slot->record;
+            written += 1;
+            continue;
+        }
+
+        if (written >= __atomic_load_n(&ledger->nextSequence, __ATOMIC_RELAXED)) {
+            break;
+        }
+
+        // Séquence réservée mais pas encore publiée : elle le sera au prochain passage, sauf si elle est abandonnée
+        uint64_t now = getMonotonicTime();
+
+        if (writer->stalledSequence != written) {
+            writer->stalledSequence = written;
+            writer->stalledSince = now;
+            break;
+        }
+
+        if (now - writer->stalledSince < LEDGER_HOLE_TIMEOUT_MS * 1000000ULL) {
+            break;
+        }
+
+        LedgerRecord *hole = &writer->buffer[count++];
+        *hole = (LedgerRecord) { .sequence = written, .type = LEDGER_HOLE };
+        hole->checksum = getLedgerChecksum(hole);
+        __atomic_add_fetch(&ledger->holes, 1, __ATOMIC_RELAXED);
+        written += 1;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    __atomic_store_n(&ledger->writtenSequence, written, __ATOMIC_RELEASE);
+    ledgerFutexWake(&ledger->spaceFutex);
+
+    size_t size = (size_t) count * sizeof(LedgerRecord);
+    size_t offset = 0;
+
+    while (offset < size) {
+        ssize_t bytesWritten = write(writer->fd, (const char *) writer->buffer + offset, size - offset);
+
+        if (bytesWritten == -1 && errno == EINTR) {
+            continue;
+        }
+        if (bytesWritten <= 0) {
+            return -1;
+        }
+
+        offset += (size_t) bytesWritten;
+    }
+
+    if (fdatasync(writer->fd) == -1) {
+        return -1;
+    }
+
+    __atomic_store_n(&ledger->durableSequence, written, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&ledger->commits, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&ledger->records, (uint64_t) count, __ATOMIC_RELAXED);
+    ledgerFutexWake(&ledger->durableFutex);
+
+    return count;
+}
+
+/**
+ * @brief Désactive le registre (fichier illisible ou erreur d'écriture) et libère les processus qui l'attendent.
+ *
+ * @param ledger L'anneau.
+ */
+void disableLedger(Ledger *ledger) {
+    __atomic_store_n(&ledger->enabled, false, __ATOMIC_RELEASE);
+    ledgerFutexWake(&ledger->spaceFutex);
+    ledgerFutexWake(&ledger->durableFutex);
+}
+
+#endif
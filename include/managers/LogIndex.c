@@ -0,0 +1,527 @@
+/**
+ * @file LogIndex.c
+ * @brief Implémente la construction et la lecture des index de fichiers de logs.
+ *
+ * Ce fichier d'implémentation fournit les fonctions utilisées d'une part par les threads de logs du serveur, qui
+ * alimentent l'index au fil de l'écriture, et d'autre part par l'outil `logquery`, qui trie, reconstruit et
+ * interroge les index.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **getLogIndexPath()** : Construit le chemin du fichier d'index associé à un fichier de log.
+ *  - **parseLogSeatId()** : Extrait l'identifiant du philosophe mentionné dans un message de log.
+ *  - **parseLogTimestamp()** : Lit l'heure écrite en tête d'un message de log.
+ *  - **openLogIndexWriter()** : Ouvre (ou réinitialise) l'index d'un fichier de log pour y ajouter des entrées.
+ *  - **appendLogIndexEntry()** : Ajoute l'entrée correspondant à un message venant d'être écrit.
+ *  - **closeLogIndexWriter()** : Ferme l'index ouvert en écriture.
+ *  - **compareLogIndexEntries()** : Ordre (philosophe, horodatage, position) utilisé pour le tri.
+ *  - **sortLogIndex()** : Trie sur place les entrées d'un index existant.
+ *  - **buildLogIndex()** : Reconstruit entièrement l'index à partir du texte d'un fichier de log.
+ *  - **mapLogIndex()** / **unmapLogIndex()** : Projettent un index en mémoire pour l'interroger.
+ *  - **lowerBoundLogIndex()** : Recherche dichotomique de la première entrée triée d'un philosophe à partir d'une date.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/LogIndex.h" pour la définition des structures de l'index.
+ *  - "../entities/Logs.h" pour le format de l'heure des messages.
+ *  - <fcntl.h>, <unistd.h>, <sys/stat.h> et <sys/mman.h> pour l'accès aux fichiers et leur projection en mémoire.
+ *  - <stdio.h>, <stdlib.h>, <string.h>, <ctype.h> et <time.h> pour diverses fonctions utilitaires.
+ */
+
+#ifndef LOGINDEX_C
+#define LOGINDEX_C
+
+#include "../entities/LogIndex.h"
+#include "../entities/Logs.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+/**
+ * @brief Index projeté en mémoire, utilisé pour les requêtes.
+ */
+typedef struct {
+    void *address;          /**< Adresse de la projection, NULL si l'index n'existe pas */
+    size_t size;            /**< Taille de la projection */
+    LogIndexEntry *entries; /**< Première entrée de l'index */
+    size_t numberEntries;   /**< Nombre total d'entrées */
+    size_t sortedEntries;   /**< Nombre d'entrées triées en tête */
+} LogIndexMap;
+
+/**
+ * @brief Construit le chemin du fichier d'index associé à un fichier de log.
+ *
+ * @param logFilePath Chemin du fichier de log.
+ * @param indexPath Tampon recevant le chemin de l'index.
+ * @param size Taille du tampon.
+ */
+void getLogIndexPath(const char *logFilePath, char *indexPath, size_t size) {
+    snprintf(indexPath, size, "%s%s", logFilePath, LOG_INDEX_EXTENSION);
+}
+
+/**
+ * @brief Extrait l'identifiant du philosophe mentionné dans un message de log.
+ *
+ * Les messages du serveur et des clients désignent un philosophe par "philosophe N" ou "Philosophe N"
+ * ("Le philosophe 3 prend la baguette...", "Création du philosophe 4..."). La première occurrence est retenue.
+ * Le message n'a pas besoin d'être terminé par '\0', ce qui permet de l'appeler directement sur un fichier projeté.
+ *
+ * @param text Début du message.
+ * @param length Taille du message.
+ * @return int32_t L'identifiant du philosophe, ou LOG_INDEX_NO_SEAT si le message n'en mentionne aucun.
+ */
+int32_t parseLogSeatId(const char *text, size_t length) {
+    static const char pattern[] = "hilosophe ";
+    size_t patternLength = sizeof(pattern) - 1;
+
+    for (size_t i = 1; i + patternLength < length; i++) {
+        if ((text[i - 1] != 'p' && text[i - 1] != 'P') || memcmp(text + i, pattern, patternLength) != 0) {
+            continue;
+        }
+
+        size_t position = i + patternLength;
+        int32_t seatId = 0;
+
+        if (!isdigit((unsigned char) text[position])) {
+            continue;
+        }
+
+        while (position < length && isdigit((unsigned char) text[position])) {
+            seatId = seatId * 10 + (text[position] - '0');
+            position++;
+        }
+
+        return seatId;
+    }
+
+    return LOG_INDEX_NO_SEAT;
+}
+
+/**
+ * @brief Lit l'heure écrite en tête d'un message de log ("AAAA-MM-JJ HH:MM:SS.uuuuuu ", heure locale).
+ *
+ * La conversion de la date en heure de l'epoch (mktime()) n'est refaite que lorsque la minute change : relire un
+ * fichier de log ne coûte qu'une comparaison et quelques chiffres par ligne.
+ *
+ * @param text Début du message.
+ * @param length Taille du message.
+ * @param timestamp Heure du message en nanosecondes depuis l'epoch.
+ * @return size_t La taille de l'heure (LOG_TIMESTAMP_LENGTH), 0 si le message ne commence pas par une heure.
+ */
+size_t parseLogTimestamp(const char *text, size_t length, uint64_t *timestamp) {
+    // Forme attendue, '0' désignant un chiffre quelconque
+    static const char pattern[LOG_TIMESTAMP_LENGTH + 1] = "0000-00-00 00:00:00.000000 ";
+    static __thread char cachedMinute[16];
+    static __thread uint64_t cachedSeconds;
+
+    if (length < LOG_TIMESTAMP_LENGTH) {
+        return 0;
+    }
+
+    for (int i = 0; i < LOG_TIMESTAMP_LENGTH; i++) {
+        if (pattern[i] == '0' ? !isdigit((unsigned char) text[i]) : text[i] != pattern[i]) {
+            return 0;
+        }
+    }
+
+    if (memcmp(cachedMinute, text, sizeof(cachedMinute)) != 0) {
+        struct tm date;
+        memset(&date, 0, sizeof(date));
+        date.tm_year = atoi(text) - 1900;
+        date.tm_mon = atoi(text + 5) - 1;
+        date.tm_mday = atoi(text + 8);
+        date.tm_hour = atoi(text + 11);
+        date.tm_min = atoi(text + 14);
+        date.tm_isdst = -1;
+
+        time_t seconds = mktime(&date);
+        if (seconds == -1) {
+            return 0;
+        }
+
+        memcpy(cachedMinute, text, sizeof(cachedMinute));
+        cachedSeconds = (uint64_t) seconds;
+    }
+
+    uint64_t seconds = (uint64_t) ((text[17] - '0') * 10 + (text[18] - '0'));
+    uint64_t microseconds = 0;
+
+    for (int i = 20; i < 26; i++) {
+        microseconds = microseconds * 10 + (uint64_t) (text[i] - '0');
+    }
+
+    *timestamp = (cachedSeconds + seconds) * 1000000000ULL + microseconds * 1000ULL;
+    return LOG_TIMESTAMP_LENGTH;
+}
+
+/**
+ * @brief Ouvre l'index d'un fichier de log pour y ajouter des entrées.
+ *
+ * L'index est créé s'il n'existe pas. Si le fichier de log est vide (nouveau fichier client, ou fichier tronqué),
+ * l'index est réinitialisé afin de ne pas conserver des positions qui ne correspondent plus au texte.
+ * En cas d'échec, le champ `fd` vaut -1 et les ajouts sont ignorés : l'index ne doit jamais empêcher l'écriture
+ * des logs.
+ *
+ * @param writer Écrivain à initialiser.
+ * @param logFilePath Chemin du fichier de log indexé.
+ * @param logSize Taille actuelle du fichier de log.
+ * @param stickySeat Attribue le dernier philosophe connu aux messages qui n'en mentionnent pas.
+ */
+void openLogIndexWriter(LogIndexWriter *writer, const char *logFilePath, off_t logSize, bool stickySeat) {
+    char indexPath[4096];
+    getLogIndexPath(logFilePath, indexPath, sizeof(indexPath));
+
+    writer->stickySeat = stickySeat;
+    writer->lastSeatId = LOG_INDEX_NO_SEAT;
+    writer->fd = open(indexPath, O_WRONLY | O_CREAT | O_APPEND | (logSize == 0 ? O_TRUNC : 0), 0600);
+
+    if (writer->fd == -1) {
+        return;
+    }
+
+    struct stat indexStat;
+    if (fstat(writer->fd, &indexStat) == 0 && indexStat.st_size == 0) {
+        LogIndexHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = LOG_INDEX_MAGIC;
+        header.version = LOG_INDEX_VERSION;
+
+        if (write(writer->fd, &header, sizeof(header)) != sizeof(header)) {
+            close(writer->fd);
+            writer->fd = -1;
+        }
+    }
+}
+
+/**
+ * @brief Ajoute à l'index l'entrée correspondant à un message venant d'être écrit.
+ *
+ * L'horodatage est celui de l'émission du message, à la nanoseconde (le fichier de log ne garde que la
+ * microseconde) ; à défaut, celui de son écriture.
+ *
+ * @param writer Écrivain de l'index.
+ * @param offset Position du message dans le fichier de log.
+ * @param text Texte du message, heure comprise.
+ * @param length Taille du message.
+ * @param timestamp Heure d'émission en nanosecondes depuis l'epoch, 0 si inconnue.
+ */
+void appendLogIndexEntry(LogIndexWriter *writer, uint64_t offset, const char *text, size_t length, uint64_t timestamp) {
+    if (writer->fd == -1) {
+        return;
+    }
+
+    LogIndexEntry entry;
+    memset(&entry, 0, sizeof(entry));
+
+    entry.seatId = parseLogSeatId(text, length);
+
+    if (writer->stickySeat) {
+        if (entry.seatId == LOG_INDEX_NO_SEAT) {
+            entry.seatId = writer->lastSeatId;
+        }
+        writer->lastSeatId = entry.seatId;
+    }
+
+    if (timestamp == 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        timestamp = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+    }
+
+    entry.timestamp = timestamp;
+    entry.offset = offset;
+    entry.length = (uint32_t) length;
+
+    // Pas besoin de gérer l'erreur, une entrée manquante rend seulement le message introuvable par l'index
+    write(writer->fd, &entry, sizeof(entry));
+}
+
+/**
+ * @brief Ferme l'index ouvert en écriture.
+ *
+ * @param writer Écrivain de l'index.
+ */
+void closeLogIndexWriter(LogIndexWriter *writer) {
+    if (writer->fd != -1) {
+        close(writer->fd);
+        writer->fd = -1;
+    }
+}
+
+/**
+ * @brief Compare deux entrées selon l'ordre (philosophe, horodatage, position).
+ *
+ * @param a Première entrée.
+ * @param b Seconde entrée.
+ * @return int Négatif, nul ou positif, à la manière de `qsort`.
+ */
+int compareLogIndexEntries(const void *a, const void *b) {
+    const LogIndexEntry *first = (const LogIndexEntry *) a;
+    const LogIndexEntry *second = (const LogIndexEntry *) b;
+
+    if (first->seatId != second->seatId) {
+        return first->seatId < second->seatId ? -1 : 1;
+    }
+
+    if (first->timestamp != second->timestamp) {
+        return first->timestamp < second->timestamp ? -1 : 1;
+    }
+
+    if (first->offset != second->offset) {
+        return first->offset < second->offset ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Trie sur place les entrées d'un index existant.
+ *
+ * L'index est projeté en mémoire et ses entrées sont triées, puis l'en-tête est mis à jour. Le serveur peut
+ * continuer d'ajouter des entrées pendant le tri : elles sont écrites après la zone projetée et resteront dans
+ * la partie non triée jusqu'au prochain tri.
+ *
+ * @param logFilePath Chemin du fichier de log dont l'index doit être trié.
+ * @return long Le nombre d'entrées triées, ou -1 si l'index est absent ou invalide.
+ */
+long sortLogIndex(const char *logFilePath) {
+    char indexPath[4096];
+    getLogIndexPath(logFilePath, indexPath, sizeof(indexPath));
+
+    int fd = open(indexPath, O_RDWR);
+    if (fd == -1) {
+        return -1;
+    }
+
+    struct stat indexStat;
+    if (fstat(fd, &indexStat) == -1 || indexStat.st_size < (off_t) sizeof(LogIndexHeader)) {
+        close(fd);
+        return -1;
+    }
+
+    size_t numberEntries = (indexStat.st_size - sizeof(LogIndexHeader)) / sizeof(LogIndexEntry);
+    size_t size = sizeof(LogIndexHeader) + numberEntries * sizeof(LogIndexEntry);
+
+    void *address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (address == MAP_FAILED) {
+        return -1;
+    }
+
+    LogIndexHeader *header = (LogIndexHeader *) address;
+    if (header->magic != LOG_INDEX_MAGIC || header->version != LOG_INDEX_VERSION) {
+        munmap(address, size);
+        return -1;
+    }
+
+    qsort((char *) address + sizeof(LogIndexHeader), numberEntries, sizeof(LogIndexEntry), compareLogIndexEntries);
+    header->sortedEntries = numberEntries;
+
+    msync(address, size, MS_SYNC);
+    munmap(address, size);
+
+    return (long) numberEntries;
+}
+
+/**
+ * @brief Reconstruit entièrement l'index à partir du texte d'un fichier de log.
+ *
+ * Utilisée pour les fichiers de logs écrits sans index. Chaque ligne devient une entrée, horodatée par l'heure
+ * écrite en tête de son message (à la microseconde) ; une ligne sans heure (suite d'un message sur plusieurs lignes)
+ * reprend celle de la ligne précédente, et les fichiers écrits avant l'horodatage des messages restent sans
+ * horodatage (0). L'index produit est entièrement trié.
+ *
+ * @param logFilePath Chemin du fichier de log.
+ * @param stickySeat Attribue le dernier philosophe connu aux lignes qui n'en mentionnent pas.
+ * @return long Le nombre d'entrées écrites, ou -1 en cas d'erreur.
+ */
+long buildLogIndex(const char *logFilePath, bool stickySeat) {
+    int logFd = open(logFilePath, O_RDONLY);
+    if (logFd == -1) {
+        return -1;
+    }
+
+    struct stat logStat;
+    if (fstat(logFd, &logStat) == -1) {
+        close(logFd);
+        return -1;
+    }
+
+    const char *text = NULL;
+    if (logStat.st_size > 0) {
+        text = mmap(NULL, logStat.st_size, PROT_READ, MAP_PRIVATE, logFd, 0);
+        if (text == MAP_FAILED) {
+            close(logFd);
+            return -1;
+        }
+        madvise((void *) text, logStat.st_size, MADV_SEQUENTIAL);
+    }
+    close(logFd);
+
+    size_t capacity = 1024;
+    size_t numberEntries = 0;
+    LogIndexEntry *entries = malloc(capacity * sizeof(LogIndexEntry));
+    int32_t lastSeatId = LOG_INDEX_NO_SEAT;
+    uint64_t lastTimestamp = 0;
+
+    size_t position = 0;
+    while (entries && position < (size_t) logStat.st_size) {
+        const char *end = memchr(text + position, '\n', logStat.st_size - position);
+        size_t length = end ? (size_t) (end - (text + position)) + 1 : logStat.st_size - position;
+
+        if (numberEntries == capacity) {
+            capacity *= 2;
+            LogIndexEntry *grown = realloc(entries, capacity * sizeof(LogIndexEntry));
+            if (!grown) {
+                free(entries);
+                entries = NULL;
+                break;
+            }
+            entries = grown;
+        }
+
+        LogIndexEntry *entry = &entries[numberEntries++];
+        memset(entry, 0, sizeof(LogIndexEntry));
+        entry->seatId = parseLogSeatId(text + position, length);
+
+        if (parseLogTimestamp(text + position, length, &entry->timestamp) == 0) {
+            entry->timestamp = lastTimestamp;
+        }
+        lastTimestamp = entry->timestamp;
+
+        if (stickySeat) {
+            if (entry->seatId == LOG_INDEX_NO_SEAT) {
+                entry->seatId = lastSeatId;
+            }
+            lastSeatId = entry->seatId;
+        }
+
+        entry->offset = position;
+        entry->length = (uint32_t) length;
+        position += length;
+    }
+
+    if (text) {
+        munmap((void *) text, logStat.st_size);
+    }
+
+    if (!entries) {
+        return -1;
+    }
+
+    qsort(entries, numberEntries, sizeof(LogIndexEntry), compareLogIndexEntries);
+
+    char indexPath[4096];
+    getLogIndexPath(logFilePath, indexPath, sizeof(indexPath));
+
+    FILE *indexFile = fopen(indexPath, "w");
+    if (!indexFile) {
+        free(entries);
+        return -1;
+    }
+
+    LogIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = LOG_INDEX_MAGIC;
+    header.version = LOG_INDEX_VERSION;
+    header.sortedEntries = numberEntries;
+
+    fwrite(&header, sizeof(header), 1, indexFile);
+    fwrite(entries, sizeof(LogIndexEntry), numberEntries, indexFile);
+    fclose(indexFile);
+    free(entries);
+
+    return (long) numberEntries;
+}
+
+/**
+ * @brief Projette en lecture seule l'index d'un fichier de log.
+ *
+ * @param logFilePath Chemin du fichier de log.
+ * @param map Structure recevant la projection.
+ * @return int 0 en cas de succès, -1 si l'index est absent ou invalide.
+ */
+int mapLogIndex(const char *logFilePath, LogIndexMap *map) {
+    memset(map, 0, sizeof(LogIndexMap));
+
+    char indexPath[4096];
+    getLogIndexPath(logFilePath, indexPath, sizeof(indexPath));
+
+    int fd = open(indexPath, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+
+    struct stat indexStat;
+    if (fstat(fd, &indexStat) == -1 || indexStat.st_size < (off_t) sizeof(LogIndexHeader)) {
+        close(fd);
+        return -1;
+    }
+
+    map->size = indexStat.st_size;
+    map->address = mmap(NULL, map->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map->address == MAP_FAILED) {
+        map->address = NULL;
+        return -1;
+    }
+
+    LogIndexHeader *header = (LogIndexHeader *) map->address;
+    if (header->magic != LOG_INDEX_MAGIC || header->version != LOG_INDEX_VERSION) {
+        munmap(map->address, map->size);
+        map->address = NULL;
+        return -1;
+    }
+
+    map->entries = (LogIndexEntry *) ((char *) map->address + sizeof(LogIndexHeader));
+    map->numberEntries = (map->size - sizeof(LogIndexHeader)) / sizeof(LogIndexEntry);
+    map->sortedEntries = header->sortedEntries <= map->numberEntries ? header->sortedEntries : map->numberEntries;
+
+    return 0;
+}
+
+/**
+ * @brief Libère la projection d'un index.
+ *
+ * @param map Index projeté.
+ */
+void unmapLogIndex(LogIndexMap *map) {
+    if (map->address) {
+        munmap(map->address, map->size);
+        map->address = NULL;
+    }
+}
+
+/**
+ * @brief Recherche la première entrée triée d'un philosophe dont l'horodatage est supérieur ou égal à `from`.
+ *
+ * @param map Index projeté.
+ * @param seatId Identifiant du philosophe.
+ * @param from Horodatage minimal en nanosecondes.
+ * @return size_t Position de la première entrée correspondante dans la partie triée (ou `sortedEntries`).
+ */
+size_t lowerBoundLogIndex(const LogIndexMap *map, int32_t seatId, uint64_t from) {
+    size_t low = 0;
+    size_t high = map->sortedEntries;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        const LogIndexEntry *entry = &map->entries[middle];
+
+        if (entry->seatId < seatId || (entry->seatId == seatId && entry->timestamp < from)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+#endif
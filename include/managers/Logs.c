@@ -5,10 +5,13 @@
  * Ce fichier d'implémentation fournit des fonctions pour :
  *  - Initialiser une file de messages IPC destinée à la gestion des logs.
  *  - Générer les chemins des fichiers de log pour les clients et le serveur.
- *  - Envoyer des messages de log depuis le client et le serveur via des files de messages IPC.
+ *  - Envoyer des messages de log depuis le client et le serveur via des files de messages IPC, horodatés à leur
+ *    émission par l'horloge à haute résolution (voir Clock.h) : quelques nanosecondes par message.
  *
  * Les fonctions définies dans ce fichier sont :
  *  - **initLogsQueue()** : Initialise une file de messages IPC pour les logs et retourne son identifiant.
+ *  - **setLogLevelSource(const LogLevel *level)** : Indique où lire le niveau de logs courant (en mémoire partagée).
+ *  - **releaseFilePath(char *filePath)** : Rend un chemin de fichier de log à sa réserve.
  *  - **getClientInfoFilepath(pid_t pid)** : Construit et retourne le chemin du fichier de log associé à un client, basé sur son PID.
  *  - **getServerStateFilePath()** : Retourne le chemin complet du fichier de log du serveur.
  *  - **logClientInfo(int logsQueueId, char *message)** : Envoie un message de log dans la file de logs pour un client.
@@ -17,16 +20,20 @@
  *
  * Les inclusions nécessaires dans ce fichier sont :
  *  - "../utils/files.h" pour la gestion des chemins de fichiers.
+ *  - "Arena.c" pour la réserve des chemins et l'arène de travail.
  *  - "../entities/Philosopher.h" pour la définition de la structure `Philosopher`.
  *  - "../entities/Logs.h" pour la définition de la structure `Log` et des constantes associées.
+ *  - "Clock.c" pour l'horodatage des messages à leur émission.
  *  - <sys/msg.h> pour la gestion des files de messages IPC.
- *  - <string.h>, <unistd.h>, <stdio.h>, <stdlib.h> et <stdarg.h> pour diverses fonctions utilitaires.
+ *  - <string.h>, <unistd.h>, <stdio.h>, <stdlib.h>, <stdarg.h> et <errno.h> pour diverses fonctions utilitaires.
  *
  */
 #ifndef LOGS_C
 #define LOGS_C
 
 #include "../utils/files.h"
+#include "Arena.c"
+#include "Clock.c"
 #include "../entities/Philosopher.h"
 #include "../entities/Logs.h"
 #include <sys/msg.h>
@@ -35,6 +42,25 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <errno.h>
+
+/**
+ * @brief Niveau de logs courant, lu à chaque envoi de log.
+ *
+ * Pointe vers la mémoire partagée une fois le serveur initialisé : les processus de service, créés par fork(),
+ * héritent du pointeur et voient donc tout changement de niveau fait depuis le socket de contrôle. Tant qu'il
+ * n'est pas défini, tous les logs sont envoyés.
+ */
+const volatile LogLevel *currentLogLevel = NULL;
+
+/**
+ * @brief Indique où lire le niveau de logs courant.
+ *
+ * @param level Pointeur vers le niveau de logs, en mémoire partagée.
+ */
+void setLogLevelSource(const LogLevel *level) {
+    currentLogLevel = level;
+}
 
 /**
  * @brief Initialise une file de messages IPC pour la gestion des logs.
@@ -48,20 +74,35 @@ int initLogsQueue() {
     return msgget(IPC_PRIVATE, IPC_CREAT | 0600);
 }
 
+/**
+ * @brief Rend à sa réserve un chemin obtenu par getClientInfoFilepath() ou getServerStateFilePath().
+ *
+ * @param filePath Le chemin, éventuellement NULL.
+ */
+void releaseFilePath(char *filePath) {
+    slabFree(getPathPool(), filePath);
+}
+
 /**
  * @brief Construit le chemin complet du fichier de log associé à un client.
  *
  * Cette fonction formate un nom de fichier en utilisant le préfixe `CLIENT_INFO_PREFIX`, le PID du client,
- * et l'extension `LOG_EXTENSION`, puis appelle la fonction `getFilePath` pour obtenir le chemin complet.
+ * et l'extension `LOG_EXTENSION`, puis appelle la fonction `getFilePath` pour obtenir le chemin complet dans un
+ * bloc de la réserve des chemins (voir Arena.h).
  *
  * @param pid Le PID du client.
- * @return char* Le chemin complet du fichier de log du client.
+ * @return char* Le chemin complet du fichier de log du client, à rendre avec releaseFilePath(), ou NULL en cas d'erreur.
  */
 char *getClientInfoFilepath(pid_t pid) {
     char filename[256];
     snprintf(filename, sizeof(filename), "%s%d%s", CLIENT_INFO_PREFIX, pid, LOG_EXTENSION);
 
-    char *filePath = getFilePath(filename);
+    char *filePath = slabAlloc(getPathPool());
+
+    if (filePath && !getFilePath(filename, filePath, PATH_MAX)) {
+        releaseFilePath(filePath);
+        return NULL;
+    }
 
     return filePath;
 }
@@ -70,12 +111,17 @@ char *getClientInfoFilepath(pid_t pid) {
  * @brief Retourne le chemin complet du fichier de log du serveur.
  *
  * Cette fonction utilise la constante `SERVER_STATE_PATH` pour obtenir le chemin complet du fichier de log
- * du serveur via la fonction `getFilePath`.
+ * du serveur via la fonction `getFilePath`, dans un bloc de la réserve des chemins.
  *
- * @return char* Le chemin complet du fichier de log du serveur.
+ * @return char* Le chemin complet du fichier de log du serveur, à rendre avec releaseFilePath(), ou NULL en cas d'erreur.
  */
 char *getServerStateFilePath() {
-    char *filePath = getFilePath(SERVER_STATE_PATH);
+    char *filePath = slabAlloc(getPathPool());
+
+    if (filePath && !getFilePath(SERVER_STATE_PATH, filePath, PATH_MAX)) {
+        releaseFilePath(filePath);
+        return NULL;
+    }
 
     return filePath;
 }
@@ -93,22 +139,28 @@ char *getServerStateFilePath() {
  */
 void logClientInfo(int logsQueueId, char *message) {
 
+    if (currentLogLevel && *currentLogLevel < LOG_LEVEL_ALL) {
+        return;
+    }
+
     Log log;
     memset(&log, 0, sizeof(Log));
+    log.timestamp = getTimestamp();
     log.type = (long) getpid(); // PID comme type pour que le bon thread récéptionne le log
     strncpy(log.text, message, LOG_BUFFER_SIZE - 1); 
     
     // Pas besoin de gérer l'erreur, si ça ne passe pas on essai de log au prochain
-    msgsnd(logsQueueId, &log, LOG_BUFFER_SIZE, 0);
+    // Un envoi interrompu par un signal (échantillon du profileur) pendant que la file est pleine est recommencé
+    while (msgsnd(logsQueueId, &log, LOG_MESSAGE_SIZE, 0) == -1 && errno == EINTR);
 }
 
 /**
  * @brief Formate et envoie un message de log décrivant l'action d'un philosophe.
  *
  * Cette fonction détermine l'action en cours du philosophe (penser ou manger) et lui associe une mise en forme
- * colorée pour la sortie console. Elle alloue dynamiquement un buffer pour formater le message, qui indique
- * l'identifiant du philosophe, l'action en cours et la durée restante de l'état. Le message est ensuite envoyé
- * en appelant `logClientInfo`, puis le buffer est libéré.
+ * colorée pour la sortie console. Le message, qui indique l'identifiant du philosophe, l'action en cours et la durée
+ * restante de l'état, est formaté dans l'arène de travail du thread (appelée à chaque changement d'état, cette
+ * fonction n'alloue pas sur le tas), envoyé en appelant `logClientInfo`, puis le tampon est rendu à l'arène.
  *
  * @param logsQueueId L'identifiant de la file de messages IPC utilisée pour les logs.
  * @param philosopher La structure `Philosopher` contenant les informations sur le philosophe.
@@ -130,11 +182,17 @@ void logClientAction(int logsQueueId, Philosopher philosopher) {
             break;
     }
 
-    char *message = (char *) malloc(512);
+    Arena *arena = getScratchArena();
+    size_t mark = arena ? arena->used : 0;
+    char *message = arena ? arenaAlloc(arena, LOG_BUFFER_SIZE) : NULL;
+
+    if (!message) {
+        return;
+    }
 
     snprintf(
         message,
-        512,
+        LOG_BUFFER_SIZE,
         "%s %d %s %s %d%s",
         "Le philosophe", 
         philosopher.id, 
@@ -145,7 +203,7 @@ void logClientAction(int logsQueueId, Philosopher philosopher) {
     );
 
     logClientInfo(logsQueueId, message);
-    free(message);
+    resetArena(arena, mark);
 }
 
 /**
@@ -161,8 +219,13 @@ void logClientAction(int logsQueueId, Philosopher philosopher) {
  */
 void logServerState(int logsQueueId, const char *format, ...) {
 
+    if (currentLogLevel && *currentLogLevel < LOG_LEVEL_SERVER) {
+        return;
+    }
+
     Log log;
     memset(&log, 0, sizeof(Log));
+    log.timestamp = getTimestamp();
     log.type = SERVER_LOG_TYPE;
 
     va_list args;
@@ -170,7 +233,7 @@ void logServerState(int logsQueueId, const char *format, ...) {
     vsnprintf(log.text, LOG_BUFFER_SIZE, format, args);
     va_end(args);
 
-    msgsnd(logsQueueId, &log, LOG_BUFFER_SIZE, 0);
+    while (msgsnd(logsQueueId, &log, LOG_MESSAGE_SIZE, 0) == -1 && errno == EINTR);
 }
 
 #endif
\ No newline at end of file
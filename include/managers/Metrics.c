@@ -0,0 +1,265 @@
+/**
+ * @file Metrics.c
+ * @brief Implémente l'écriture et la lecture du fichier circulaire des métriques.
+ *
+ * Le format du fichier est décrit dans Metrics.h. Le fichier est projeté en mémoire (MAP_SHARED) : écrire un
+ * échantillon revient à quelques affectations en mémoire, le noyau se chargeant de reporter les pages modifiées
+ * sur le disque. Un outil peut lire le fichier pendant que le serveur l'alimente.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **getMetricsStoreSize()** : Retourne la taille du fichier de métriques.
+ *  - **openMetricsStore()** : Ouvre (et crée ou réinitialise si besoin en écriture) le fichier de métriques.
+ *  - **closeMetricsStore()** : Ferme le fichier de métriques.
+ *  - **startMetricsBlock()** : Commence un nouveau bloc, en écrasant le plus ancien si le fichier est plein.
+ *  - **appendMetricsSample()** : Ajoute un échantillon au bloc en cours.
+ *  - **decodeMetricsBlock()** : Décode les échantillons d'un bloc.
+ *  - **getMetricsBlock()** : Retourne l'emplacement d'un bloc à partir de son numéro.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Metrics.h" pour la définition du format.
+ *  - <stdbool.h>, <string.h>, <fcntl.h>, <unistd.h>, <sys/mman.h> et <sys/stat.h> pour la gestion du fichier.
+ */
+
+#ifndef METRICS_C
+#define METRICS_C
+
+#include "../entities/Metrics.h"
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Retourne la taille du fichier de métriques.
+ *
+ * @return size_t La taille de l'en-tête et des METRICS_BLOCKS blocs.
+ */
+size_t getMetricsStoreSize() {
+    return sizeof(MetricsHeader) + (size_t) METRICS_BLOCKS * sizeof(MetricsBlock);
+}
+
+/**
+ * @brief Indique si l'en-tête d'un fichier de métriques correspond au format compilé.
+ *
+ * @param header L'en-tête.
+ * @return bool true si le fichier peut être relu ou complété.
+ */
+bool isMetricsHeaderValid(const MetricsHeader *header) {
+    return header->magic == METRICS_MAGIC
+        && header->version == METRICS_VERSION
+        && header->blocks == METRICS_BLOCKS
+        && header->blockSamples == METRICS_BLOCK_SAMPLES
+        && header->columns == METRICS_COLUMNS;
+}
+
+/**
+ * @brief Ouvre le fichier de métriques et le projette en mémoire.
+ *
+ * En écriture, le fichier est créé s'il n'existe pas ; s'il a été écrit dans un autre format (dimensions
+ * différentes), il est réinitialisé. L'historique d'un fichier valide est conservé : le serveur reprend l'écriture
+ * dans un nouveau bloc après le dernier bloc écrit.
+ *
+ * @param store Le fichier à ouvrir.
+ * @param path Le chemin du fichier.
+ * @param writable true pour alimenter le fichier, false pour le lire.
+ * @return bool true si le fichier est ouvert et valide.
+ */
+bool openMetricsStore(MetricsStore *store, const char *path, bool writable) {
+    memset(store, 0, sizeof(MetricsStore));
+    store->fd = open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+
+    if (store->fd == -1) {
+        return false;
+    }
+
+    size_t size = getMetricsStoreSize();
+    struct stat fileStat;
+
+    if (fstat(store->fd, &fileStat) == -1 || (!writable && (size_t) fileStat.st_size != size)) {
+        close(store->fd);
+        store->fd = -1;
+        return false;
+    }
+
+    bool reset = (size_t) fileStat.st_size != size;
+
+    if (writable && reset && (ftruncate(store->fd, 0) == -1 || ftruncate(store->fd, size) == -1)) {
+        close(store->fd);
+        store->fd = -1;
+        return false;
+    }
+
+    void *address = mmap(NULL, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, store->fd, 0);
+
+    if (address == MAP_FAILED) {
+        close(store->fd);
+        store->fd = -1;
+        return false;
+    }
+
+    store->size = size;
+    store->header = (MetricsHeader *) address;
+    store->blocks = (MetricsBlock *) ((char *) address + sizeof(MetricsHeader));
+
+    if (writable && (reset || !isMetricsHeaderValid(store->header))) {
+        memset(address, 0, size);
+        store->header->magic = METRICS_MAGIC;
+        store->header->version = METRICS_VERSION;
+        store->header->intervalMs = METRICS_INTERVAL_MS;
+        store->header->blocks = METRICS_BLOCKS;
+        store->header->blockSamples = METRICS_BLOCK_SAMPLES;
+        store->header->columns = METRICS_COLUMNS;
+        store->header->currentBlock = 0;
+    }
+
+    if (!isMetricsHeaderValid(store->header)) {
+        munmap(address, size);
+        close(store->fd);
+        store->fd = -1;
+        return false;
+    }
+
+    // Reprise dans un nouveau bloc : les écarts ne doivent pas enjamber l'arrêt du serveur
+    store->startBlock = true;
+
+    return true;
+}
+
+/**
+ * @brief Ferme le fichier de métriques.
+ *
+ * @param store Le fichier à fermer.
+ */
+void closeMetricsStore(MetricsStore *store) {
+    if (store->fd == -1) {
+        return;
+    }
+
+    munmap(store->header, store->size);
+    close(store->fd);
+    store->fd = -1;
+}
+
+/**
+ * @brief Retourne l'emplacement d'un bloc à partir de son numéro.
+ *
+ * @param store Le fichier de métriques.
+ * @param number Le numéro du bloc.
+ * @return MetricsBlock* L'emplacement du bloc.
+ */
+MetricsBlock *getMetricsBlock(const MetricsStore *store, uint64_t number) {
+    return &store->blocks[number % METRICS_BLOCKS];
+}
+
+/**
+ * @brief Commence un nouveau bloc dont le premier échantillon est donné.
+ *
+ * Le nombre d'échantillons de l'emplacement est remis à zéro avant de changer son numéro : un lecteur qui
+ * parcourait l'ancien bloc le voit vide plutôt que mélangé au nouveau.
+ *
+ * @param store Le fichier de métriques.
+ * @param values Les valeurs du premier échantillon.
+ */
+void startMetricsBlock(MetricsStore *store, const int64_t values[METRICS_COLUMNS]) {
+    uint64_t number = store->header->currentBlock + 1;
+    MetricsBlock *block = getMetricsBlock(store, number);
+
+    __atomic_store_n(&block->numberSamples, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&block->number, number, __ATOMIC_RELEASE);
+
+    for (int column = 0; column < METRICS_COLUMNS; column++) {
+        block->bases[column] = values[column];
+        block->lasts[column] = values[column];
+        block->deltas[column][0] = 0;
+    }
+
+    __atomic_store_n(&block->numberSamples, 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&store->header->currentBlock, number, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Ajoute un échantillon au fichier de métriques.
+ *
+ * L'échantillon est ajouté au bloc en cours sous forme d'écarts avec l'échantillon précédent. Un nouveau bloc
+ * est commencé si le bloc en cours est plein ou si l'un des écarts ne tient pas sur 32 bits.
+ *
+ * @param store Le fichier de métriques, ouvert en écriture.
+ * @param values Les valeurs de l'échantillon, une par colonne.
+ */
+void appendMetricsSample(MetricsStore *store, const int64_t values[METRICS_COLUMNS]) {
+    if (store->startBlock || store->header->currentBlock == 0) {
+        store->startBlock = false;
+        startMetricsBlock(store, values);
+        return;
+    }
+
+    MetricsBlock *block = getMetricsBlock(store, store->header->currentBlock);
+    uint32_t sample = block->numberSamples;
+
+    if (sample == 0 || sample >= METRICS_BLOCK_SAMPLES) {
+        startMetricsBlock(store, values);
+        return;
+    }
+
+    for (int column = 0; column < METRICS_COLUMNS; column++) {
+        int64_t delta = values[column] - block->lasts[column];
+
+        if (delta > INT32_MAX || delta < INT32_MIN) {
+            startMetricsBlock(store, values);
+            return;
+        }
+    }
+
+    for (int column = 0; column < METRICS_COLUMNS; column++) {
+        block->deltas[column][sample] = (int32_t) (values[column] - block->lasts[column]);
+        block->lasts[column] = values[column];
+    }
+
+    // Publication de l'échantillon une fois toutes ses colonnes écrites
+    __atomic_store_n(&block->numberSamples, sample + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Décode les échantillons d'un bloc.
+ *
+ * Le bloc peut être réécrit par le serveur pendant la lecture : son numéro est relu après le décodage et
+ * le bloc est ignoré s'il a changé.
+ *
+ * @param store Le fichier de métriques.
+ * @param number Le numéro du bloc à décoder.
+ * @param samples Tableau recevant les valeurs, METRICS_BLOCK_SAMPLES lignes de METRICS_COLUMNS colonnes.
+ * @return int Le nombre d'échantillons décodés, 0 si le bloc n'existe plus.
+ */
+int decodeMetricsBlock(const MetricsStore *store, uint64_t number, int64_t samples[METRICS_BLOCK_SAMPLES][METRICS_COLUMNS]) {
+    const MetricsBlock *block = getMetricsBlock(store, number);
+
+    if (__atomic_load_n(&block->number, __ATOMIC_ACQUIRE) != number) {
+        return 0;
+    }
+
+    uint32_t numberSamples = __atomic_load_n(&block->numberSamples, __ATOMIC_ACQUIRE);
+
+    if (numberSamples > METRICS_BLOCK_SAMPLES) {
+        return 0;
+    }
+
+    // Décodage colonne par colonne : les écarts d'une colonne sont contigus en mémoire
+    for (int column = 0; column < METRICS_COLUMNS; column++) {
+        int64_t value = block->bases[column];
+
+        for (uint32_t sample = 0; sample < numberSamples; sample++) {
+            value += block->deltas[column][sample];
+            samples[sample][column] = value;
+        }
+    }
+
+    if (__atomic_load_n(&block->number, __ATOMIC_ACQUIRE) != number) {
+        return 0;
+    }
+
+    return (int) numberSamples;
+}
+
+#endif
@@ -0,0 +1,246 @@
+/**
+ * @file Migration.c
+ * @brief Implémente la migration des philosophes entre les voisinages de la table.
+ *
+ * Le principe et les garanties de la migration sont décrits dans Migration.h. Un échange recopie chaque philosophe
+ * sur la place de l'autre, sauf les champs liés à la position dans l'anneau (les baguettes). Les deux places restent
+ * tenues (SEAT_MOVING) et l'époque du compactage impaire pendant l'échange : une recherche qui trouve l'autre
+ * philosophe à la place indiquée par la table de renvoi recommence.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **moveSeatContent()** : Copie un philosophe vers une autre place, sans ses baguettes.
+ *  - **isMigratable()** : Indique si un philosophe peut changer de place.
+ *  - **swapSeats()** : Échange les places de deux philosophes qui pensent.
+ *  - **getNeighboursLoad()** : Charge totale des deux voisins d'une place.
+ *  - **rebalanceTable()** : Évalue la table et échange deux places si un voisinage est trop chargé.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Migration.h" et "../entities/SharedResources.h" pour le réglage, les compteurs et la table.
+ *  - "../managers/ServerPhilosopher.c" pour la recherche et les versions des places.
+ *  - <semaphore.h> et <stdlib.h>.
+ */
+
+#ifndef MIGRATION_C
+#define MIGRATION_C
+
+#include "../maxmin_philosophers.h"
+#include "../entities/Migration.h"
+#include "../entities/SharedResources.h"
+#include "../managers/ServerPhilosopher.c"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <semaphore.h>
+
+/**
+ * @brief Copie un philosophe vers une autre place, sans ses baguettes, et met à jour la table de renvoi.
+ *
+ * La place de destination garde ses baguettes et reste tenue (SEAT_MOVING).
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @param philosopher Le philosophe à copier.
+ * @param destination La place de destination.
+ */
+void moveSeatContent(SharedResources *sharedResources, const ServerPhilosopher *philosopher, int destination) {
+    ServerPhilosopher *seat = &sharedResources->philosophers[destination];
+    Chopstick *leftChopstick = seat->leftChopstick;
+    Chopstick *rightChopstick = seat->rightChopstick;
+
+    *seat = *philosopher;
+    seat->leftChopstick = leftChopstick;
+    seat->rightChopstick = rightChopstick;
+    seat->pins = SEAT_MOVING;
+
+    __atomic_store_n(&sharedResources->seatSlots[philosopher->base.id - 1], destination + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Indique si un philosophe peut changer de place : il pense, n'est ni parti ni évincé, ni mis à l'écart.
+ *
+ * @param philosopher Le philosophe.
+ * @return bool true s'il peut changer de place.
+ */
+bool isMigratable(const ServerPhilosopher *philosopher) {
+    return philosopher->base.id != 0 && philosopher->base.state == THINKING && philosopher->hungrySince == 0
+        && !philosopher->departed && !philosopher->evicted && !philosopher->draining;
+}
+
+/**
+ * @brief Échange les places de deux philosophes qui pensent.
+ *
+ * L'échange n'attend jamais : il est abandonné si le sémaphore de création ou l'une des places sont pris. Les
+ * philosophes pensant, ils ne tiennent ni n'attendent aucune baguette : les baguettes et leurs détenteurs ne sont
+ * pas touchés.
+ *
+ * @param firstId L'identifiant du premier philosophe.
+ * @param secondId L'identifiant du second philosophe.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return bool true si les places ont été échangées.
+ */
+bool swapSeats(int firstId, int secondId, SharedResources *sharedResources) {
+    ServerPhilosopher *first = getPhilosopherFromId(firstId, sharedResources);
+    ServerPhilosopher *second = getPhilosopherFromId(secondId, sharedResources);
+
+    if (!first || !second || first == second || !isMigratable(first) || !isMigratable(second)) {
+        return false;
+    }
+
+    if (sem_trywait(&sharedResources->philosopherCreationProcess) == -1) {
+        __atomic_add_fetch(&sharedResources->migration.busy, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    uint32_t unpinned = 0;
+
+    if (!__atomic_compare_exchange_n(&first->pins, &unpinned, SEAT_MOVING, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        sem_post(&sharedResources->philosopherCreationProcess);
+        __atomic_add_fetch(&sharedResources->migration.busy, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    unpinned = 0;
+
+    if (!__atomic_compare_exchange_n(&second->pins, &unpinned, SEAT_MOVING, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&first->pins, 0, __ATOMIC_RELEASE);
+        sem_post(&sharedResources->philosopherCreationProcess);
+        __atomic_add_fetch(&sharedResources->migration.busy, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    // Les places tenues, leur état ne peut plus changer : vérification définitive
+    if (first->base.id != firstId || second->base.id != secondId || !isMigratable(first) || !isMigratable(second)) {
+        __atomic_store_n(&first->pins, 0, __ATOMIC_RELEASE);
+        __atomic_store_n(&second->pins, 0, __ATOMIC_RELEASE);
+        sem_post(&sharedResources->philosopherCreationProcess);
+        return false;
+    }
+
+    int firstSlot = first - sharedResources->philosophers;
+    int secondSlot = second - sharedResources->philosophers;
+    ServerPhilosopher moving = *first;
+
+    // Époque impaire et nouvelle version, comme pour un compactage : une recherche qui trouve une place échangée
+    // recommence (voir getPhilosopherFromId()), un instantané qui chevauche l'échange n'est pas validé
+    __atomic_add_fetch(&sharedResources->compaction.epoch, 1, __ATOMIC_ACQ_REL);
+    __atomic_add_fetch(&sharedResources->tableVersion, 1, __ATOMIC_ACQ_REL);
+
+    moveSeatContent(sharedResources, second, firstSlot);
+    moveSeatContent(sharedResources, &moving, secondSlot);
+
+    __atomic_add_fetch(&sharedResources->tableVersion, 1, __ATOMIC_ACQ_REL);
+    __atomic_add_fetch(&sharedResources->compaction.epoch, 1, __ATOMIC_ACQ_REL);
+
+    notifyPhilosopherChange(first, sharedResources);
+    notifyPhilosopherChange(second, sharedResources);
+    __atomic_add_fetch(&sharedResources->migration.migrations, 1, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&first->pins, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&second->pins, 0, __ATOMIC_RELEASE);
+    sem_post(&sharedResources->philosopherCreationProcess);
+
+    logServerState(
+        sharedResources->logsQueueId,
+        "Migration : le philosophe %d passe de la place %d à la place %d, le philosophe %d de la place %d à la place %d\n",
+        firstId, firstSlot + 1, secondSlot + 1, secondId, secondSlot + 1, firstSlot + 1
+    );
+
+    return true;
+}
+
+/**
+ * @brief Retourne la charge totale des deux voisins d'une place.
+ *
+ * @param loads Charges des places à table, dans l'ordre de l'anneau.
+ * @param numberSeats Nombre de places à table.
+ * @param index Rang de la place dans l'anneau.
+ * @return uint64_t La charge de ses voisins.
+ */
+uint64_t getNeighboursLoad(const uint64_t *loads, int numberSeats, int index) {
+    return loads[(index + numberSeats - 1) % numberSeats] + loads[(index + 1) % numberSeats];
+}
+
+/**
+ * @brief Évalue la charge des voisinages de la table et échange deux places si l'un d'eux est trop chargé.
+ *
+ * Le philosophe à déplacer est celui dont la contention avec ses voisins (sa charge multipliée par la leur) est la
+ * plus forte ; il est échangé avec le philosophe qui réduit le plus la contention de la table (voir Migration.h).
+ * Les charges sont lues sans verrou : l'évaluation est approchée, les conditions de l'échange sont vérifiées par
+ * swapSeats().
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return bool true si deux places ont été échangées.
+ */
+bool rebalanceTable(SharedResources *sharedResources) {
+    // Places des philosophes à table dans l'ordre de l'anneau, et leurs charges (seul le thread de compactage appelle)
+    static int seats[MAX_PHILOSOPHERS];
+    static uint64_t loads[MAX_PHILOSOPHERS];
+    int numberSeats = 0;
+
+    if (!sharedResources->migration.enabled || sharedResources->numberSeated < MIGRATION_MIN_SEATS) {
+        return false;
+    }
+
+    for (int i = 0; i < sharedResources->numberPhilosophers; i++) {
+        if (!sharedResources->philosophers[i].departed) {
+            seats[numberSeats] = i;
+            loads[numberSeats] = sharedResources->philosophers[i].waitLoad;
+            numberSeats += 1;
+        }
+    }
+
+    if (numberSeats < MIGRATION_MIN_SEATS) {
+        return false;
+    }
+
+    sharedResources->migration.passes += 1;
+
+    int hot = -1;
+    uint64_t hotContention = 0;
+
+    for (int i = 0; i < numberSeats; i++) {
+        uint64_t contention = loads[i] * getNeighboursLoad(loads, numberSeats, i);
+
+        if (loads[i] >= MIGRATION_MIN_LOAD_US && contention > hotContention && isMigratable(&sharedResources->philosophers[seats[i]])) {
+            hot = i;
+            hotContention = contention;
+        }
+    }
+
+    if (hot == -1) {
+        sharedResources->migration.imbalancePercent = 0;
+        return false;
+    }
+
+    uint64_t hotNeighbours = getNeighboursLoad(loads, numberSeats, hot);
+    uint64_t coldNeighbours = hotNeighbours;
+    int cold = -1;
+    uint64_t bestGain = 0;
+
+    for (int i = 0; i < numberSeats; i++) {
+        uint64_t neighbours = getNeighboursLoad(loads, numberSeats, i);
+        int distance = abs(i - hot);
+
+        // Un voisin du philosophe chaud partage son voisinage : l'échange ne déplacerait pas la contention
+        if (distance <= 1 || distance == numberSeats - 1 || loads[i] >= loads[hot] || neighbours >= hotNeighbours) {
+            continue;
+        }
+
+        uint64_t gain = (loads[hot] - loads[i]) * (hotNeighbours - neighbours);
+
+        if (gain > bestGain && isMigratable(&sharedResources->philosophers[seats[i]])) {
+            cold = i;
+            coldNeighbours = neighbours;
+            bestGain = gain;
+        }
+    }
+
+    sharedResources->migration.imbalancePercent = hotNeighbours * 100 / (coldNeighbours ? coldNeighbours : 1);
+
+    if (cold == -1 || hotNeighbours < MIGRATION_MIN_IMBALANCE * coldNeighbours) {
+        return false;
+    }
+
+    return swapSeats(sharedResources->philosophers[seats[hot]].base.id, sharedResources->philosophers[seats[cold]].base.id, sharedResources);
+}
+
+#endif
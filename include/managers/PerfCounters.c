@@ -0,0 +1,369 @@
+/**
+ * @file PerfCounters.c
+ * @brief Implémente les compteurs matériels mesurés autour des étapes d'un repas accordé.
+ *
+ * Le principe des compteurs est décrit dans PerfCounters.h. Chaque processus lit le réglage et publie ses totaux à
+ * l'adresse donnée par setPerfCountersSource() (la mémoire partagée, héritée par les processus de service créés par
+ * fork()). Une mesure suit la demande en cours du thread : beginPerfSpan() la commence, markPerfStage() clôt chaque
+ * étape, markPerfGrant() note le repas accordé et endPerfSpan() publie le repas une fois sa réponse écrite.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **setPerfCountersSource()** : Indique où lire le réglage et publier les totaux.
+ *  - **openPerfCounter()** / **openPerfCounters()** : Ouvrent un compteur, puis le groupe du thread.
+ *  - **claimPerfWorker()** / **releasePerfThread()** : Prennent et rendent la case d'un thread.
+ *  - **readPerfCounters()** : Lit le groupe du thread.
+ *  - **beginPerfSpan()**, **markPerfStage()**, **markPerfGrant()**, **endPerfSpan()** : Suivent une demande.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/PerfCounters.h" pour les structures.
+ *  - "../managers/Statistics.c" pour les histogrammes.
+ *  - <linux/perf_event.h> et <sys/syscall.h> pour perf_event_open(), qui n'a pas d'enveloppe dans la libc.
+ */
+
+#ifndef PERF_COUNTERS_C
+#define PERF_COUNTERS_C
+
+#include "../entities/PerfCounters.h"
+#include "../managers/Statistics.c"
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/**
+ * @brief Réglage et totaux courants, NULL tant que setPerfCountersSource() n'a pas été appelée.
+ */
+PerfCounterState *perfCounterSource = NULL;
+
+/**
+ * @brief Groupe de compteurs et mesure en cours du thread courant.
+ */
+__thread PerfThread currentPerfThread;
+
+/**
+ * @brief Rend la case et ferme le groupe d'un thread à sa sortie.
+ */
+pthread_key_t perfThreadKey;
+
+/**
+ * @brief Type et configuration perf_event_attr de chaque compteur, indexés par PerfCounter.
+ */
+const uint32_t PERF_COUNTER_TYPES[PERF_COUNTERS] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE };
+const uint64_t PERF_COUNTER_CONFIGS[PERF_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_SW_CONTEXT_SWITCHES
+};
+
+/**
+ * @brief Rend la case d'un thread et ferme son groupe.
+ *
+ * Appelée à la sortie d'un thread (destructeur de perfThreadKey) et à la sortie d'un processus de service (atexit()).
+ *
+ * @param arg Le groupe du thread.
+ */
+void releasePerfThread(void *arg) {
+    PerfThread *thread = (PerfThread *) arg;
+
+    if (!thread || !thread->opened) {
+        return;
+    }
+
+    for (int i = 0; i < thread->numberCounters; i++) {
+        close(thread->fds[i]);
+    }
+
+    if (thread->worker) {
+        __atomic_store_n(&thread->worker->processId, 0, __ATOMIC_RELEASE);
+    }
+
+    memset(thread, 0, sizeof(PerfThread));
+}
+
+/**
+ * @brief Rend la case du thread qui termine le processus.
+ */
+void releasePerfThreadAtExit() {
+    releasePerfThread(&currentPerfThread);
+}
+
+/**
+ * @brief Indique où lire le réglage et publier les totaux des compteurs.
+ *
+ * Appelée par le processus principal avant de créer les processus de service, qui héritent du réglage, de la clé
+ * des threads et du rendu de leur case à leur sortie.
+ *
+ * @param state Le réglage et les totaux, en mémoire partagée.
+ */
+void setPerfCountersSource(PerfCounterState *state) {
+    perfCounterSource = state;
+    pthread_key_create(&perfThreadKey, releasePerfThread);
+    atexit(releasePerfThreadAtExit);
+}
+
+/**
+ * @brief Ouvre un compteur sur le thread courant.
+ *
+ * @param counter Le compteur.
+ * @param groupFd Le meneur du groupe, -1 pour ouvrir un meneur.
+ * @param userOnly Ne compter que le mode utilisateur.
+ * @return int Le descripteur, -1 en cas d'erreur (errno renseigné).
+ */
+int openPerfCounter(PerfCounter counter, int groupFd, bool userOnly) {
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_COUNTER_TYPES[counter];
+    attributes.config = PERF_COUNTER_CONFIGS[counter];
+    attributes.read_format = PERF_FORMAT_GROUP;
+    attributes.exclude_kernel = userOnly;
+    attributes.exclude_hv = 1;
+
+    return (int) syscall(SYS_perf_event_open, &attributes, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC);
+}
+
+/**
+ * @brief Prend une case de la table des threads pour le thread courant.
+ *
+ * Une case libre est prise en priorité ; sinon, celle d'un processus qui n'existe plus.
+ *
+ * @param state Les totaux.
+ * @return PerfWorker* La case, remise à zéro, ou NULL si la table est pleine.
+ */
+PerfWorker *claimPerfWorker(PerfCounterState *state) {
+    pid_t processId = getpid();
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < PERF_MAX_WORKERS; i++) {
+            PerfWorker *worker = &state->workers[i];
+            pid_t owner = __atomic_load_n(&worker->processId, __ATOMIC_ACQUIRE);
+
+            if (owner != 0 && (pass == 0 || kill(owner, 0) == 0 || errno != ESRCH)) {
+                continue;
+            }
+
+            if (!__atomic_compare_exchange_n(&worker->processId, &owner, processId, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+                continue;
+            }
+
+            worker->threadId = (pid_t) syscall(SYS_gettid);
+            worker->grants = 0;
+            memset(worker->totals, 0, sizeof(worker->totals));
+            return worker;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Ouvre le groupe de compteurs du thread courant, une fois pour toutes.
+ *
+ * Les compteurs indisponibles sont omis. Si le noyau refuse de compter en mode noyau, le groupe est rouvert en mode
+ * utilisateur seul, sans les changements de contexte.
+ *
+ * @param thread Le groupe du thread.
+ * @param state Le réglage et les totaux.
+ */
+void openPerfCounters(PerfThread *thread, PerfCounterState *state) {
+    int lastError = 0;
+
+    thread->opened = true;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool userOnly = attempt == 1;
+        bool denied = false;
+
+        thread->numberCounters = 0;
+
+        for (int counter = 0; counter < PERF_COUNTERS; counter++) {
+            if (userOnly && counter == PERF_COUNTER_CONTEXT_SWITCHES) {
+                continue;
+            }
+
+            int fd = openPerfCounter(counter, thread->numberCounters ? thread->fds[0] : -1, userOnly);
+
+            if (fd == -1) {
+                lastError = errno;
+                denied = denied || errno == EACCES || errno == EPERM;
+                continue;
+            }
+
+            thread->fds[thread->numberCounters] = fd;
+            thread->counters[thread->numberCounters] = counter;
+            thread->numberCounters += 1;
+        }
+
+        if (!denied || userOnly) {
+            if (userOnly && thread->numberCounters) {
+                __atomic_store_n(&state->userOnly, true, __ATOMIC_RELAXED);
+            }
+            break;
+        }
+
+        for (int i = 0; i < thread->numberCounters; i++) {
+            close(thread->fds[i]);
+        }
+    }
+
+    if (lastError) {
+        __atomic_store_n(&state->lastError, lastError, __ATOMIC_RELAXED);
+    }
+
+    if (thread->numberCounters == 0) {
+        __atomic_add_fetch(&state->unmeasuredThreads, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    for (int i = 0; i < thread->numberCounters; i++) {
+        __atomic_or_fetch(&state->available, 1u << thread->counters[i], __ATOMIC_RELAXED);
+    }
+
+    thread->worker = claimPerfWorker(state);
+    pthread_setspecific(perfThreadKey, thread);
+}
+
+/**
+ * @brief Lit le groupe du thread courant, d'un seul appel système.
+ *
+ * @param thread Le groupe du thread.
+ * @param values Reçoit la valeur de chaque compteur (0 pour un compteur absent du groupe).
+ * @return bool false si la lecture a échoué.
+ */
+bool readPerfCounters(PerfThread *thread, uint64_t values[PERF_COUNTERS]) {
+    uint64_t buffer[1 + PERF_COUNTERS];
+    ssize_t expected = (ssize_t) ((1 + thread->numberCounters) * sizeof(uint64_t));
+
+    if (read(thread->fds[0], buffer, sizeof(buffer)) < expected) {
+        return false;
+    }
+
+    memset(values, 0, PERF_COUNTERS * sizeof(uint64_t));
+
+    for (int i = 0; i < thread->numberCounters; i++) {
+        values[thread->counters[i]] = buffer[1 + i];
+    }
+
+    return true;
+}
+
+/**
+ * @brief Commence la mesure d'une demande : les compteurs sont lus à la fin de la réception.
+ *
+ * Sans effet si les compteurs sont désactivés, si le thread n'a aucun compteur, ou si un repas accordé attend encore
+ * l'envoi de sa réponse.
+ */
+void beginPerfSpan() {
+    PerfThread *thread = &currentPerfThread;
+    PerfCounterState *state = perfCounterSource;
+
+    if (thread->active && thread->granted) {
+        return;
+    }
+
+    thread->active = false;
+
+    if (!state || !__atomic_load_n(&state->enabled, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    if (!thread->opened) {
+        openPerfCounters(thread, state);
+    }
+
+    if (thread->numberCounters == 0 || !readPerfCounters(thread, thread->last)) {
+        return;
+    }
+
+    memset(thread->pending, 0, sizeof(thread->pending));
+    thread->granted = false;
+    thread->active = true;
+}
+
+/**
+ * @brief Clôt une étape de la demande en cours : l'écart depuis la frontière précédente lui est attribué.
+ *
+ * @param stage L'étape qui se termine.
+ */
+void markPerfStage(PerfStage stage) {
+    PerfThread *thread = &currentPerfThread;
+    uint64_t values[PERF_COUNTERS];
+
+    if (!thread->active) {
+        return;
+    }
+
+    if (!readPerfCounters(thread, values)) {
+        thread->active = false;
+        return;
+    }
+
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        thread->pending[stage][i] += values[i] - thread->last[i];
+        thread->last[i] = values[i];
+    }
+}
+
+/**
+ * @brief Clôt la prise des baguettes et note que le repas est accordé.
+ */
+void markPerfGrant() {
+    markPerfStage(PERF_STAGE_CHOPSTICKS);
+    currentPerfThread.granted = currentPerfThread.active;
+}
+
+/**
+ * @brief Termine la mesure de la demande en cours, une fois sa réponse écrite.
+ *
+ * Un repas accordé est publié dans les totaux de la table et du thread ; une demande qui n'a pas abouti est oubliée.
+ */
+void endPerfSpan() {
+    PerfThread *thread = &currentPerfThread;
+    PerfCounterState *state = perfCounterSource;
+
+    if (!thread->active || !thread->granted) {
+        thread->active = false;
+        return;
+    }
+
+    markPerfStage(PERF_STAGE_SEND);
+    thread->granted = false;
+
+    if (!thread->active) {
+        return;
+    }
+
+    thread->active = false;
+
+    uint64_t grantTotals[PERF_COUNTERS] = { 0 };
+
+    for (int stage = 0; stage < PERF_STAGES; stage++) {
+        for (int i = 0; i < PERF_COUNTERS; i++) {
+            uint64_t value = thread->pending[stage][i];
+
+            grantTotals[i] += value;
+            __atomic_fetch_add(&state->totals[stage][i], value, __ATOMIC_RELAXED);
+
+            if (thread->worker) {
+                thread->worker->totals[stage][i] += value;
+            }
+        }
+    }
+
+    for (int i = 0; i < thread->numberCounters; i++) {
+        recordHistogram(&state->grantHistograms[thread->counters[i]], grantTotals[thread->counters[i]]);
+    }
+
+    if (thread->worker) {
+        thread->worker->grants += 1;
+    }
+
+    __atomic_fetch_add(&state->grants, 1, __ATOMIC_RELAXED);
+}
+
+#endif
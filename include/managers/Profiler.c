@@ -0,0 +1,706 @@
+/**
+ * @file Profiler.c
+ * @brief Implémente le profileur par échantillonnage du serveur : minuteurs par thread, remontée des piles dans le
+ * handler de SIGPROF et écriture des profils au format replié.
+ *
+ * Le principe du profileur est décrit dans Profiler.h. Chaque processus du serveur appelle startProfiler() une fois
+ * (le processus principal au démarrage, un processus de service juste après fork()), puis chaque thread à profiler
+ * appelle registerProfilerThread() à son lancement ; un thread est désenregistré automatiquement à sa sortie. Hors
+ * du serveur (outils), startProfiler() n'est jamais appelée et l'enregistrement ne fait rien.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **profilerSignalHandler()** : Handler de SIGPROF : remonte la pile du thread interrompu dans son anneau.
+ *  - **registerProfilerThread()** : Enregistre le thread appelant et crée son minuteur.
+ *  - **unregisterProfilerThread()** : Désenregistre un thread à sa sortie, en gardant ses échantillons.
+ *  - **armProfilerTimer()** : Arme ou désarme le minuteur d'un thread.
+ *  - **hashProfilerSample()** : Empreinte d'une pile.
+ *  - **drainProfilerThread()** : Vide l'anneau d'un thread dans la table des piles du processus.
+ *  - **compareProfilerSymbols()** : Compare deux symboles par adresse.
+ *  - **loadProfilerSymbols()** : Lit la table des symboles du binaire du serveur.
+ *  - **resolveProfilerFrame()** : Retourne le nom de la fonction d'une adresse.
+ *  - **compareProfileLines()** : Compare deux lignes de profil.
+ *  - **writeProfile()** : Ajoute les piles du processus au fichier des profils.
+ *  - **profilerThread()** : Thread collecteur du processus.
+ *  - **startProfiler()** : Démarre le profileur dans le processus appelant.
+ *  - **setProfilerSignalBlocked()** : Bloque ou débloque SIGPROF pour le thread appelant.
+ *  - **requestProfilerUpdate()** : Publie un changement de réglage et réveille les collecteurs.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Profiler.h" pour les structures du profileur.
+ *  - "../utils/print_message.h" pour les avertissements.
+ *  - <signal.h>, <ucontext.h> et <time.h> pour SIGPROF, le contexte interrompu et les minuteurs.
+ *  - <elf.h>, <link.h> et <dlfcn.h> pour les symboles.
+ *  - <linux/futex.h> et <sys/syscall.h> pour l'attente des collecteurs.
+ *
+ * @note Ce fichier suppose _GNU_SOURCE (gettid(), pthread_getattr_np(), dladdr() et registres du contexte), défini
+ *       par server.c. Sur une architecture dont les registres ne sont pas connus, les piles sont vides et aucun
+ *       échantillon n'est pris.
+ */
+
+#ifndef PROFILER_C
+#define PROFILER_C
+
+#include "../entities/Profiler.h"
+#include "../utils/print_message.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <time.h>
+#include <pthread.h>
+#include <elf.h>
+#include <link.h>
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+/**
+ * @brief État du profileur dans ce processus.
+ *
+ * Hérité par les processus de service créés par fork(), puis réinitialisé par startProfiler().
+ */
+Profiler processProfiler;
+
+/**
+ * @brief Case du thread courant, NULL s'il n'est pas profilé. Lue par le handler de SIGPROF.
+ */
+__thread ProfilerThread *currentProfilerThread = NULL;
+
+/**
+ * @brief Remonte la pile du thread interrompu par ses pointeurs de cadre.
+ *
+ * Chaque cadre commence par le pointeur de cadre de l'appelant, suivi de l'adresse de retour. Un pointeur hors de
+ * la pile du thread, mal aligné ou qui ne remonte pas vers le haut de la pile arrête la remontée : une fonction
+ * sans pointeur de cadre ne peut pas faire lire hors de la pile.
+ *
+ * @param context Le contexte interrompu, reçu par le handler.
+ * @param thread La case du thread, avec les bornes de sa pile.
+ * @param sample Reçoit la pile.
+ */
+static inline void walkProfilerStack(const ucontext_t *context, const ProfilerThread *thread, ProfilerSample *sample) {
+    uintptr_t programCounter, framePointer;
+
+#if defined(__x86_64__) && defined(REG_RIP)
+    programCounter = (uintptr_t) context->uc_mcontext.gregs[REG_RIP];
+    framePointer = (uintptr_t) context->uc_mcontext.gregs[REG_RBP];
+#elif defined(__aarch64__)
+    programCounter = (uintptr_t) context->uc_mcontext.pc;
+    framePointer = (uintptr_t) context->uc_mcontext.regs[29];
+#else
+    sample->depth = 0;
+    return;
+#endif
+
+    sample->frames[0] = programCounter;
+    sample->depth = 1;
+
+    while (sample->depth < PROFILER_MAX_DEPTH
+           && framePointer >= thread->stackLow && framePointer + 2 * sizeof(uintptr_t) <= thread->stackHigh
+           && framePointer % sizeof(uintptr_t) == 0) {
+        const uintptr_t *frame = (const uintptr_t *) framePointer;
+        uintptr_t returnAddress = frame[1];
+
+        if (returnAddress == 0) {
+            break;
+        }
+
+        sample->frames[sample->depth++] = returnAddress;
+
+        // La pile grandit vers le bas : le cadre de l'appelant est toujours plus haut
+        if (frame[0] <= framePointer) {
+            break;
+        }
+
+        framePointer = frame[0];
+    }
+}
+
+/**
+ * @brief Handler de SIGPROF : écrit la pile du thread interrompu dans son anneau.
+ *
+ * Seules des lectures de la pile et des écritures dans l'anneau du thread sont faites : le handler peut interrompre
+ * n'importe quelle fonction, y compris malloc() ou un verrou de la libc.
+ *
+ * @param signum SIGPROF.
+ * @param info Informations sur le signal.
+ * @param context Le contexte interrompu (ucontext_t).
+ */
+void profilerSignalHandler(int signum, siginfo_t *info, void *context) {
+    (void) signum;
+    (void) info;
+    ProfilerThread *thread = currentProfilerThread;
+    ProfilerState *state = processProfiler.state;
+
+    if (!thread || !state || !__atomic_load_n(&state->enabled, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    uint64_t head = thread->head;
+
+    if (head - __atomic_load_n(&thread->tail, __ATOMIC_ACQUIRE) >= PROFILER_BUFFER_SAMPLES) {
+        __atomic_add_fetch(&state->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    ProfilerSample *sample = &thread->samples[head % PROFILER_BUFFER_SAMPLES];
+    walkProfilerStack((const ucontext_t *) context, thread, sample);
+
+    if (sample->depth > 0) {
+        __atomic_store_n(&thread->head, head + 1, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Arme ou désarme le minuteur d'un thread.
+ *
+ * @param thread La case du thread.
+ * @param frequency Échantillons par seconde de calcul, 0 pour désarmer.
+ */
+void armProfilerTimer(ProfilerThread *thread, uint32_t frequency) {
+    uint64_t interval = frequency ? 1000000000ULL / frequency : 0;
+    struct timespec period = { .tv_sec = (time_t) (interval / 1000000000ULL), .tv_nsec = (long) (interval % 1000000000ULL) };
+    struct itimerspec timer = { .it_interval = period, .it_value = period };
+
+    timer_settime(thread->timer, 0, &timer, NULL);
+}
+
+/**
+ * @brief Empreinte d'une pile (FNV-1a sur ses adresses).
+ *
+ * @param sample La pile.
+ * @return uint64_t L'empreinte, jamais nulle.
+ */
+uint64_t hashProfilerSample(const ProfilerSample *sample) {
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (uint32_t i = 0; i < sample->depth; i++) {
+        hash = (hash ^ sample->frames[i]) * 1099511628211ULL;
+    }
+
+    return hash ? hash : 1;
+}
+
+/**
+ * @brief Vide l'anneau d'un thread dans la table des piles du processus. Appelée sous le verrou du profileur.
+ *
+ * @param profiler Le profileur du processus.
+ * @param thread La case du thread.
+ */
+void drainProfilerThread(Profiler *profiler, ProfilerThread *thread) {
+    uint64_t head = __atomic_load_n(&thread->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = thread->tail;
+    uint64_t dropped = 0;
+
+    for (; tail < head; tail++) {
+        const ProfilerSample *sample = &thread->samples[tail % PROFILER_BUFFER_SAMPLES];
+        uint64_t hash = hashProfilerSample(sample);
+        size_t index = hash % PROFILER_MAX_STACKS;
+        size_t probes = 0;
+
+        // Adressage ouvert : la pile est cherchée à partir de sa case, jusqu'à la trouver ou trouver une case libre
+        while (probes < PROFILER_MAX_STACKS) {
+            ProfilerStack *stack = &profiler->stacks[index];
+
+            if (stack->count == 0) {
+                stack->hash = hash;
+                stack->sample = *sample;
+            }
+
+            if (stack->hash == hash && stack->sample.depth == sample->depth
+                && memcmp(stack->sample.frames, sample->frames, sample->depth * sizeof(uintptr_t)) == 0) {
+                stack->count += 1;
+                break;
+            }
+
+            index = (index + 1) % PROFILER_MAX_STACKS;
+            probes += 1;
+        }
+
+        if (probes == PROFILER_MAX_STACKS) {
+            dropped += 1;
+        }
+    }
+
+    __atomic_add_fetch(&profiler->state->samples, head - thread->tail - dropped, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&profiler->state->dropped, dropped, __ATOMIC_RELAXED);
+    __atomic_store_n(&thread->tail, tail, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Désenregistre un thread à sa sortie (destructeur de la clé du profileur).
+ *
+ * Le minuteur est supprimé et les échantillons encore dans l'anneau sont gardés dans la table des piles.
+ *
+ * @param arg La case du thread.
+ */
+void unregisterProfilerThread(void *arg) {
+    ProfilerThread *thread = (ProfilerThread *) arg;
+
+    // Un SIGPROF encore en attente ne doit plus écrire dans la case
+    currentProfilerThread = NULL;
+
+    pthread_mutex_lock(&processProfiler.lock);
+    timer_delete(thread->timer);
+    drainProfilerThread(&processProfiler, thread);
+    thread->used = false;
+    pthread_mutex_unlock(&processProfiler.lock);
+}
+
+/**
+ * @brief Enregistre le thread appelant auprès du profileur et crée son minuteur, armé si le profilage est en cours.
+ *
+ * Sans effet hors du serveur, si le thread est déjà enregistré, ou si PROFILER_MAX_THREADS threads le sont déjà.
+ */
+void registerProfilerThread() {
+    Profiler *profiler = &processProfiler;
+
+    if (!profiler->state || currentProfilerThread) {
+        return;
+    }
+
+    pthread_mutex_lock(&profiler->lock);
+
+    ProfilerThread *thread = NULL;
+
+    for (int i = 0; i < PROFILER_MAX_THREADS && !thread; i++) {
+        if (!profiler->threads[i].used) {
+            thread = &profiler->threads[i];
+        }
+    }
+
+    if (!thread) {
+        pthread_mutex_unlock(&profiler->lock);
+        return;
+    }
+
+    thread->threadId = gettid();
+    thread->head = 0;
+    thread->tail = 0;
+
+    // Bornes de la pile, pour que la remontée des cadres ne lise jamais ailleurs
+    pthread_attr_t attributes;
+    void *stackAddress = NULL;
+    size_t stackSize = 0;
+
+    if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+        pthread_attr_getstack(&attributes, &stackAddress, &stackSize);
+        pthread_attr_destroy(&attributes);
+    }
+
+    thread->stackLow = (uintptr_t) stackAddress;
+    thread->stackHigh = (uintptr_t) stackAddress + stackSize;
+
+    struct sigevent event;
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event._sigev_un._tid = thread->threadId;
+
+    if (stackSize == 0 || timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &thread->timer) == -1) {
+        pthread_mutex_unlock(&profiler->lock);
+        return;
+    }
+
+    thread->used = true;
+    currentProfilerThread = thread;
+    pthread_setspecific(profiler->threadKey, thread);
+
+    if (profiler->state->enabled) {
+        armProfilerTimer(thread, profiler->state->frequency);
+    }
+
+    pthread_mutex_unlock(&profiler->lock);
+}
+
+/**
+ * @brief Compare deux symboles par adresse (qsort).
+ */
+int compareProfilerSymbols(const void *a, const void *b) {
+    const ProfilerSymbol *first = (const ProfilerSymbol *) a;
+    const ProfilerSymbol *second = (const ProfilerSymbol *) b;
+    return (first->address > second->address) - (first->address < second->address);
+}
+
+/**
+ * @brief Lit les symboles de fonctions de la table des symboles du binaire du serveur.
+ *
+ * Le binaire est projeté en lecture seule et le reste : les noms pointent dans la projection. Un binaire sans table
+ * des symboles (strip) laisse la table vide ; ses adresses sont alors écrites `binaire+0xdécalage`.
+ *
+ * @param profiler Le profileur du processus.
+ */
+void loadProfilerSymbols(Profiler *profiler) {
+    Dl_info self;
+
+    if (dladdr((void *) loadProfilerSymbols, &self)) {
+        profiler->binaryBase = (uintptr_t) self.dli_fbase;
+    }
+
+    int fd = open("/proc/self/exe", O_RDONLY | O_CLOEXEC);
+    struct stat status;
+
+    if (fd == -1 || fstat(fd, &status) == -1 || (size_t) status.st_size < sizeof(ElfW(Ehdr))) {
+        if (fd != -1) {
+            close(fd);
+        }
+        return;
+    }
+
+    const uint8_t *image = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (image == MAP_FAILED) {
+        return;
+    }
+
+    size_t size = (size_t) status.st_size;
+    const ElfW(Ehdr) *header = (const ElfW(Ehdr) *) image;
+
+    if (memcmp(header->e_ident, ELFMAG, SELFMAG) != 0 || header->e_shoff + (size_t) header->e_shnum * sizeof(ElfW(Shdr)) > size) {
+        munmap((void *) image, size);
+        return;
+    }
+
+    profiler->positionIndependent = header->e_type == ET_DYN;
+    const ElfW(Shdr) *sections = (const ElfW(Shdr) *) (image + header->e_shoff);
+
+    for (int i = 0; i < header->e_shnum; i++) {
+        if (sections[i].sh_type != SHT_SYMTAB || sections[i].sh_link >= header->e_shnum) {
+            continue;
+        }
+
+        const ElfW(Shdr) *strings = &sections[sections[i].sh_link];
+
+        if (sections[i].sh_offset + sections[i].sh_size > size || strings->sh_offset + strings->sh_size > size) {
+            continue;
+        }
+
+        const ElfW(Sym) *symbols = (const ElfW(Sym) *) (image + sections[i].sh_offset);
+        size_t numberSymbols = sections[i].sh_size / sizeof(ElfW(Sym));
+        ProfilerSymbol *table = malloc(numberSymbols * sizeof(ProfilerSymbol));
+
+        if (!table) {
+            break;
+        }
+
+        size_t numberFunctions = 0;
+
+        for (size_t j = 0; j < numberSymbols; j++) {
+            if (ELF64_ST_TYPE(symbols[j].st_info) != STT_FUNC || symbols[j].st_value == 0 || symbols[j].st_name >= strings->sh_size) {
+                continue;
+            }
+
+            table[numberFunctions++] = (ProfilerSymbol) {
+                .address = (uintptr_t) symbols[j].st_value,
+                .size = (uintptr_t) symbols[j].st_size,
+                .name = (const char *) (image + strings->sh_offset + symbols[j].st_name)
+            };
+        }
+
+        qsort(table, numberFunctions, sizeof(ProfilerSymbol), compareProfilerSymbols);
+        profiler->symbols = table;
+        profiler->numberSymbols = numberFunctions;
+        return;
+    }
+
+    munmap((void *) image, size);
+}
+
+/**
+ * @brief Retourne le nom de la fonction contenant une adresse.
+ *
+ * @param profiler Le profileur du processus.
+ * @param address L'adresse.
+ * @param buffer Tampon pour un nom composé (`binaire+0xdécalage`).
+ * @param size La taille du tampon.
+ * @return const char* Le nom.
+ */
+const char *resolveProfilerFrame(const Profiler *profiler, uintptr_t address, char *buffer, size_t size) {
+    Dl_info info;
+
+    if (!dladdr((void *) address, &info)) {
+        snprintf(buffer, size, "0x%lx", (unsigned long) address);
+        return buffer;
+    }
+
+    if ((uintptr_t) info.dli_fbase == profiler->binaryBase && profiler->numberSymbols > 0) {
+        uintptr_t key = profiler->positionIndependent ? address - profiler->binaryBase : address;
+        size_t low = 0, high = profiler->numberSymbols;
+
+        // Dernier symbole d'adresse inférieure ou égale
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+
+            if (profiler->symbols[middle].address <= key) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        if (low > 0) {
+            const ProfilerSymbol *symbol = &profiler->symbols[low - 1];
+
+            if (key < symbol->address + (symbol->size ? symbol->size : 1)) {
+                return symbol->name;
+            }
+        }
+    }
+
+    if (info.dli_sname) {
+        return info.dli_sname;
+    }
+
+    const char *name = info.dli_fname ? strrchr(info.dli_fname, '/') : NULL;
+    snprintf(buffer, size, "%s+0x%lx", name ? name + 1 : "?", (unsigned long) (address - (uintptr_t) info.dli_fbase));
+    return buffer;
+}
+
+/**
+ * @brief Compare deux lignes de profil par pile (qsort).
+ */
+int compareProfileLines(const void *a, const void *b) {
+    return strcmp(((const ProfileLine *) a)->stack, ((const ProfileLine *) b)->stack);
+}
+
+/**
+ * @brief Ajoute les piles collectées par le processus au fichier des profils, puis les oublie.
+ *
+ * Les piles sont nommées sous le verrou, puis fusionnées hors du verrou : deux échantillons interrompus à deux
+ * instructions d'une même fonction sont deux piles dans la table, mais une seule ligne du profil. Le profil du
+ * processus est écrit d'un seul write() en fin de fichier : les profils des processus écrits en même temps ne se
+ * mélangent pas.
+ *
+ * @param profiler Le profileur du processus.
+ */
+void writeProfile(Profiler *profiler) {
+    ProfileLine *lines = malloc(PROFILER_MAX_STACKS * sizeof(ProfileLine));
+    size_t numberLines = 0;
+    char buffer[128];
+    char stack[PROFILER_MAX_DEPTH * 64];
+
+    if (!lines) {
+        return;
+    }
+
+    pthread_mutex_lock(&profiler->lock);
+
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+        if (profiler->threads[i].used) {
+            drainProfilerThread(profiler, &profiler->threads[i]);
+        }
+    }
+
+    for (size_t i = 0; i < PROFILER_MAX_STACKS; i++) {
+        ProfilerStack *entry = &profiler->stacks[i];
+
+        if (entry->count == 0) {
+            continue;
+        }
+
+        size_t length = (size_t) snprintf(stack, sizeof(stack), "%s", profiler->role);
+
+        // De la racine à la feuille ; une adresse de retour désigne l'instruction qui suit l'appel
+        for (int j = (int) entry->sample.depth - 1; j >= 0 && length < sizeof(stack); j--) {
+            uintptr_t address = entry->sample.frames[j] - (j > 0 ? 1 : 0);
+            length += (size_t) snprintf(stack + length, sizeof(stack) - length, ";%s", resolveProfilerFrame(profiler, address, buffer, sizeof(buffer)));
+        }
+
+        lines[numberLines].stack = strdup(stack);
+        lines[numberLines].count = entry->count;
+        numberLines += lines[numberLines].stack != NULL;
+        entry->count = 0;
+    }
+
+    pthread_mutex_unlock(&profiler->lock);
+
+    qsort(lines, numberLines, sizeof(ProfileLine), compareProfileLines);
+
+    char *text = NULL;
+    size_t length = 0;
+    FILE *output = open_memstream(&text, &length);
+
+    for (size_t i = 0; i < numberLines; i++) {
+        uint64_t count = lines[i].count;
+
+        while (i + 1 < numberLines && strcmp(lines[i].stack, lines[i + 1].stack) == 0) {
+            free(lines[i].stack);
+            count += lines[++i].count;
+        }
+
+        if (output) {
+            fprintf(output, "%s %lu\n", lines[i].stack, (unsigned long) count);
+        }
+
+        free(lines[i].stack);
+    }
+
+    free(lines);
+
+    if (!output) {
+        return;
+    }
+
+    fclose(output);
+
+    int fd = open(PROFILE_FILE, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+    if (fd != -1) {
+        ssize_t bytesWritten;
+        while ((bytesWritten = write(fd, text, length)) == -1 && errno == EINTR);
+        close(fd);
+    }
+
+    free(text);
+    __atomic_add_fetch(&profiler->state->dumps, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Thread collecteur du processus.
+ *
+ * Endormi sur le compteur `generation` de la mémoire partagée : indéfiniment tant que le profilage est arrêté, au
+ * plus PROFILER_DRAIN_INTERVAL_MS pendant le profilage. À chaque réveil, il applique les réglages, vide les anneaux
+ * des threads et écrit le profil demandé.
+ *
+ * @param arg Le profileur du processus.
+ * @return void* NULL.
+ */
+void *profilerThread(void *arg) {
+    Profiler *profiler = (Profiler *) arg;
+    ProfilerState *state = profiler->state;
+
+    while (1) {
+        uint32_t generation = __atomic_load_n(&state->generation, __ATOMIC_ACQUIRE);
+        bool enabled = __atomic_load_n(&state->enabled, __ATOMIC_RELAXED);
+
+        pthread_mutex_lock(&profiler->lock);
+
+        if (generation != profiler->appliedGeneration) {
+            profiler->appliedGeneration = generation;
+
+            for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+                if (profiler->threads[i].used) {
+                    armProfilerTimer(&profiler->threads[i], enabled ? state->frequency : 0);
+                }
+            }
+        }
+
+        for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+            if (profiler->threads[i].used) {
+                drainProfilerThread(profiler, &profiler->threads[i]);
+            }
+        }
+
+        uint32_t dumpRequests = __atomic_load_n(&state->dumpRequests, __ATOMIC_ACQUIRE);
+        bool dump = dumpRequests != profiler->appliedDumpRequests;
+        profiler->appliedDumpRequests = dumpRequests;
+
+        pthread_mutex_unlock(&profiler->lock);
+
+        if (dump) {
+            writeProfile(profiler);
+        }
+
+        struct timespec timeout = { .tv_sec = PROFILER_DRAIN_INTERVAL_MS / 1000, .tv_nsec = (PROFILER_DRAIN_INTERVAL_MS % 1000) * 1000000L };
+        syscall(SYS_futex, &state->generation, FUTEX_WAIT, generation, enabled ? &timeout : NULL, NULL, 0);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Bloque ou débloque SIGPROF pour le thread appelant.
+ *
+ * Le processus principal bloque SIGPROF avant exec() (mise à jour à chaud) : un signal en attente serait sinon
+ * livré au nouveau binaire avant qu'il installe son handler, et le terminerait.
+ *
+ * @param blocked true pour bloquer.
+ */
+void setProfilerSignalBlocked(bool blocked) {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPROF);
+    pthread_sigmask(blocked ? SIG_BLOCK : SIG_UNBLOCK, &signals, NULL);
+}
+
+/**
+ * @brief Démarre le profileur dans le processus appelant et enregistre le thread appelant.
+ *
+ * Appelée par le processus principal au démarrage, et par chaque processus de service juste après fork() : les
+ * cases et les piles héritées du processus principal sont alors oubliées (ses minuteurs ne sont pas hérités), seules
+ * celles qu'il a utilisées sont touchées.
+ *
+ * @param state Les réglages et compteurs, en mémoire partagée.
+ * @param role Le rôle du processus, racine de ses piles.
+ */
+void startProfiler(ProfilerState *state, const char *role) {
+    Profiler *profiler = &processProfiler;
+
+    if (!profiler->state) {
+        pthread_key_create(&profiler->threadKey, unregisterProfilerThread);
+        loadProfilerSymbols(profiler);
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = profilerSignalHandler;
+        sigemptyset(&action.sa_mask);
+        // SA_RESTART : un appel système interrompu par un échantillon reprend de lui-même quand il le peut
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigaction(SIGPROF, &action, NULL);
+    }
+
+    // Le verrou a pu être pris par un autre thread du père au moment du fork()
+    pthread_mutex_init(&profiler->lock, NULL);
+
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+        if (profiler->threads[i].used) {
+            profiler->threads[i].used = false;
+        }
+    }
+
+    for (size_t i = 0; i < PROFILER_MAX_STACKS; i++) {
+        if (profiler->stacks[i].count) {
+            profiler->stacks[i].count = 0;
+        }
+    }
+
+    currentProfilerThread = NULL;
+    profiler->role = role;
+    profiler->state = state;
+    profiler->appliedGeneration = __atomic_load_n(&state->generation, __ATOMIC_ACQUIRE);
+    profiler->appliedDumpRequests = __atomic_load_n(&state->dumpRequests, __ATOMIC_ACQUIRE);
+
+    setProfilerSignalBlocked(false);
+    registerProfilerThread();
+
+    pthread_t thread;
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+
+    if (pthread_create(&thread, &attributes, profilerThread, profiler) != 0) {
+        printMessage(WARNING, "Le thread du profileur n'a pas pu être créé, le processus %d ne sera pas profilé.\n", getpid());
+    }
+
+    pthread_attr_destroy(&attributes);
+}
+
+/**
+ * @brief Publie un changement des réglages du profileur et réveille les collecteurs de tous les processus.
+ *
+ * @param state Les réglages et compteurs, en mémoire partagée.
+ */
+void requestProfilerUpdate(ProfilerState *state) {
+    __atomic_add_fetch(&state->generation, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &state->generation, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file Protocol.c
+ * @brief Implémente les générateurs d'encodeurs et de décodeurs du protocole, et la validation des contenus.
+ *
+ * Le schéma est déclaré dans Protocol.h ; Request.c et Response.c y appliquent les générateurs de ce fichier pour
+ * produire leurs encodeurs, leur validation et leur décodeur.
+ *
+ * Un décodeur ne copie rien : il vérifie que le tampon contient un message complet, correctement aligné, dont le
+ * type est connu et le contenu valide, puis fournit un pointeur vers le message dans le tampon lui-même.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **isValidPhilosopherPayload()** : Vérifie le contenu `philosopher` d'un message.
+ *  - **isValidWatchPayload()** : Vérifie le contenu `watch` d'un message.
+ *
+ * Les générateurs définis sont :
+ *  - **PROTOCOL_ENCODER_NONE**, **PROTOCOL_ENCODER_PHILOSOPHER**, **PROTOCOL_ENCODER_WATCH** : Encodeur d'un type
+ *    de message selon son contenu.
+ *  - **PROTOCOL_VALIDATOR** : Validation d'un message, un `switch` sur son type.
+ *  - **PROTOCOL_DECODER** : Décodeur validant sans copie.
+ */
+
+#ifndef PROTOCOL_C
+#define PROTOCOL_C
+
+#include "../entities/Protocol.h"
+#include "../entities/Philosopher.h"
+#include "../entities/Watch.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Vérifie le contenu `philosopher` d'un message : identifiant positif ou nul et état connu.
+ *
+ * @param philosopher Le contenu.
+ * @return bool true si le contenu est valide.
+ */
+bool isValidPhilosopherPayload(const Philosopher *philosopher) {
+    return philosopher->id >= 0 && (int) philosopher->state >= THINKING && (int) philosopher->state <= EATING;
+}
+
+/**
+ * @brief Vérifie le contenu `watch` d'un message : étendue connue et débit positif ou nul.
+ *
+ * La place suivie est vérifiée par le serveur, qui connaît la table (voir isValidSubscription()).
+ *
+ * @param watch Le contenu.
+ * @return bool true si le contenu est valide.
+ */
+bool isValidWatchPayload(const WatchSubscription *watch) {
+    return (int) watch->scope >= WATCH_SEAT && (int) watch->scope <= WATCH_TABLE && watch->maxRate >= 0;
+}
+
+/**
+ * @brief Encodeur d'un message sans contenu : `Message function()`.
+ */
+#define PROTOCOL_ENCODER_NONE(Message, function, messageType) \
+    Message function() { \
+        Message message; \
+        memset(&message, 0, sizeof(message)); \
+        message.type = messageType; \
+        return message; \
+    }
+
+/**
+ * @brief Encodeur d'un message au contenu `philosopher` : `Message function(Philosopher philosopher)`.
+ */
+#define PROTOCOL_ENCODER_PHILOSOPHER(Message, function, messageType) \
+    Message function(Philosopher philosopher) { \
+        Message message; \
+        memset(&message, 0, sizeof(message)); \
+        message.type = messageType; \
+        message.philosopher = philosopher; \
+        return message; \
+    }
+
+/**
+ * @brief Encodeur d'un message au contenu `watch` : `Message function(WatchSubscription watch)`.
+ */
+#define PROTOCOL_ENCODER_WATCH(Message, function, messageType) \
+    Message function(WatchSubscription watch) { \
+        Message message; \
+        memset(&message, 0, sizeof(message)); \
+        message.type = messageType; \
+        message.watch = watch; \
+        return message; \
+    }
+
+#define PROTOCOL_VALID_NONE(message) true
+#define PROTOCOL_VALID_PHILOSOPHER(message) isValidPhilosopherPayload(&(message)->philosopher)
+#define PROTOCOL_VALID_WATCH(message) isValidWatchPayload(&(message)->watch)
+#define PROTOCOL_VALIDATE_CASE(type, name, payload) case type: return PROTOCOL_VALID_##payload(message);
+
+/**
+ * @brief Validation d'un message : `bool function(const Message *message)`, false pour un type inconnu.
+ */
+#define PROTOCOL_VALIDATOR(Message, function, SCHEMA) \
+    bool function(const Message *message) { \
+        switch (message->type) { \
+            SCHEMA(PROTOCOL_VALIDATE_CASE) \
+        } \
+        return false; \
+    }
+
+/**
+ * @brief Décodeur sans copie : `int function(const void *buffer, size_t length, const Message **message)`.
+ *
+ * Retourne 1 et un pointeur vers le message dans `buffer` s'il est complet et valide, 0 s'il est incomplet, -1 s'il
+ * est invalide (ou si le tampon n'est pas aligné pour le lire sur place).
+ */
+#define PROTOCOL_DECODER(Message, function, validator) \
+    int function(const void *buffer, size_t length, const Message **message) { \
+        if (length < sizeof(Message)) { \
+            return 0; \
+        } \
+        if ((uintptr_t) buffer % _Alignof(Message) != 0) { \
+            return -1; \
+        } \
+        *message = (const Message *) buffer; \
+        return validator(*message) ? 1 : -1; \
+    }
+
+#endif
@@ -1,20 +1,17 @@
 /**
  * @file Request.c
- * @brief Implémente les fonctions de création des requêtes adressées au serveur.
+ * @brief Implémente les encodeurs et le décodeur des requêtes adressées au serveur.
  *
- * Ce fichier d'implémentation fournit deux fonctions pour faciliter la gestion des requêtes :
- *  - **createRequest()** : Crée et initialise une requête de type REQUEST_CREATE, utilisée pour demander
- *    la création d'un nouveau philosophe.
- *  - **updateRequest(Philosopher philosopher)** : Crée et initialise une requête de type REQUEST_UPDATE,
- *    en intégrant la structure `Philosopher` pour mettre à jour un philosophe existant.
- *
- * Pour chaque fonction, la structure `Request` est initialisée à zéro à l'aide de `memset` afin d'assurer
- * une initialisation propre, avant d'affecter le type de la requête et, le cas échéant, la structure du philosophe.
+ * Tout est généré depuis REQUEST_SCHEMA (voir Protocol.h) avec les générateurs de Protocol.c :
+ *  - un encodeur par type de requête, nommé d'après le schéma : **createRequest()**, **updateRequest(Philosopher)**,
+ *    **watchRequest(WatchSubscription)** et **snapshotRequest()**. La requête est initialisée à zéro, puis son type
+ *    et son contenu sont affectés ;
+ *  - **isValidRequest()** : Vérifie le type et le contenu d'une requête ;
+ *  - **decodeRequest()** : Décode sans copie une requête dans un tampon de réception.
  *
  * Les inclusions nécessaires dans ce fichier sont :
  *  - "../entities/Request.h" pour la définition de la structure `Request` et de l'énumération `RequestType`.
- *  - "../entities/Philosopher.h" pour la définition de la structure `Philosopher`.
- *  - <string.h> pour l'utilisation de la fonction `memset`.
+ *  - "Protocol.c" pour les générateurs et la validation des contenus.
  *
  * Les directives de préprocesseur (#ifndef, #define, #endif) assurent que ce fichier d'implémentation est inclus
  * une seule fois lors de la compilation.
@@ -24,42 +21,15 @@
 
 #include "../entities/Request.h"
 #include "../entities/Philosopher.h"
+#include "Protocol.c"
 #include <string.h>
 
-/**
- * @brief Crée une requête de création d'un nouveau philosophe.
- *
- * Cette fonction initialise une structure `Request` à zéro et définit son type à REQUEST_CREATE.
- *
- * @return Request La requête initialisée pour créer un nouveau philosophe.
- */
-Request createRequest() {
-
-    Request request;
-    memset(&request, 0, sizeof(request));
+#define REQUEST_ENCODER(type, name, payload) PROTOCOL_ENCODER_##payload(Request, name##Request, type)
 
-    request.type = REQUEST_CREATE;
-
-    return request;
-}
-
-/**
- * @brief Crée une requête de mise à jour pour un philosophe existant.
- *
- * Cette fonction initialise une structure `Request` à zéro, définit son type à REQUEST_UPDATE,
- * et y affecte la structure `Philosopher` passée en paramètre.
- *
- * @param philosopher La structure `Philosopher` contenant les informations à mettre à jour.
- * @return Request La requête initialisée pour mettre à jour le philosophe.
- */
-Request updateRequest(Philosopher philosopher) {
-    Request request;
-    memset(&request, 0, sizeof(request));
+REQUEST_SCHEMA(REQUEST_ENCODER)
 
-    request.type = REQUEST_UPDATE;
-    request.philosopher = philosopher;
+PROTOCOL_VALIDATOR(Request, isValidRequest, REQUEST_SCHEMA)
 
-    return request;
-}
+PROTOCOL_DECODER(Request, decodeRequest, isValidRequest)
 
 #endif
@@ -0,0 +1,203 @@
+/**
+ * @file RequestSpan.c
+ * @brief Implémente les spans des requêtes : horodatage des étapes, histogrammes et exemples des repas les plus lents.
+ *
+ * Le principe des spans est décrit dans RequestSpan.h. Chaque processus publie ses spans à l'adresse donnée par
+ * setRequestSpanSource() (la mémoire partagée, héritée par les processus de service créés par fork()). Le span suit
+ * la requête en cours du thread : beginRequestSpan() le commence, markRequestSpan() horodate chaque étape franchie
+ * et endRequestSpan() le publie une fois la réponse écrite.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **setRequestSpanSource()** : Indique où publier les spans.
+ *  - **getSpanDuration()** / **getSpanStageDuration()** : Durée totale d'un span et durée d'une de ses étapes.
+ *  - **keepSpanExemplar()** : Garde un span parmi les exemples s'il est parmi les plus lents.
+ *  - **beginRequestSpan()**, **markRequestSpan()**, **endRequestSpan()** : Suivent une requête.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/RequestSpan.h" pour les structures.
+ *  - "../managers/Statistics.c" pour l'horloge et les histogrammes.
+ */
+
+#ifndef REQUEST_SPAN_C
+#define REQUEST_SPAN_C
+
+#include "../entities/RequestSpan.h"
+#include "../managers/Statistics.c"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Histogrammes et exemples courants, NULL tant que setRequestSpanSource() n'a pas été appelée.
+ */
+SpanStatistics *spanStatisticsSource = NULL;
+
+/**
+ * @brief Span en cours du thread courant.
+ */
+__thread SpanThread currentSpanThread;
+
+/**
+ * @brief Indique où publier les spans.
+ *
+ * @param statistics Les histogrammes et exemples, en mémoire partagée.
+ */
+void setRequestSpanSource(SpanStatistics *statistics) {
+    spanStatisticsSource = statistics;
+}
+
+/**
+ * @brief Retourne la durée totale d'un span, de la lecture du bloc à l'écriture de la réponse.
+ *
+ * @param span Le span.
+ * @return uint64_t La durée en nanosecondes, 0 si la réponse n'est pas écrite.
+ */
+uint64_t getSpanDuration(const RequestSpan *span) {
+    if (!span->marks[SPAN_WRITTEN] || span->marks[SPAN_WRITTEN] < span->marks[SPAN_READ]) {
+        return 0;
+    }
+
+    return span->marks[SPAN_WRITTEN] - span->marks[SPAN_READ];
+}
+
+/**
+ * @brief Retourne la durée d'une étape : depuis l'étape franchie juste avant elle.
+ *
+ * Les baguettes pouvant être prises dans un ordre ou dans l'autre, l'étape précédente est cherchée par les heures,
+ * et non par l'ordre des SpanMark.
+ *
+ * @param span Le span.
+ * @param mark L'étape (au moins SPAN_DECODED).
+ * @return uint64_t La durée en nanosecondes, 0 si l'étape n'a pas été franchie.
+ */
+uint64_t getSpanStageDuration(const RequestSpan *span, SpanMark mark) {
+    uint64_t end = span->marks[mark];
+    uint64_t start = 0;
+
+    if (!end) {
+        return 0;
+    }
+
+    for (int i = 0; i < SPAN_MARKS; i++) {
+        uint64_t time = span->marks[i];
+
+        if (i != (int) mark && time && (time < end || (time == end && i < (int) mark)) && time > start) {
+            start = time;
+        }
+    }
+
+    return start ? end - start : 0;
+}
+
+/**
+ * @brief Garde un span parmi les exemples s'il est plus lent que le plus rapide d'entre eux.
+ *
+ * Le remplacement n'attend jamais : si un autre processus remplace déjà un exemple, le span est abandonné.
+ *
+ * @param statistics Les histogrammes et exemples.
+ * @param span Le span, dont la réponse est écrite.
+ * @param duration Sa durée totale.
+ */
+void keepSpanExemplar(SpanStatistics *statistics, const RequestSpan *span, uint64_t duration) {
+    if (duration <= __atomic_load_n(&statistics->exemplarThreshold, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    if (__atomic_exchange_n(&statistics->exemplarLock, 1, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    int fastest = 0;
+
+    for (int i = 1; i < SPAN_EXEMPLARS; i++) {
+        if (getSpanDuration(&statistics->exemplars[i]) < getSpanDuration(&statistics->exemplars[fastest])) {
+            fastest = i;
+        }
+    }
+
+    if (duration > getSpanDuration(&statistics->exemplars[fastest])) {
+        statistics->exemplars[fastest] = *span;
+    }
+
+    uint64_t threshold = UINT64_MAX;
+
+    for (int i = 0; i < SPAN_EXEMPLARS; i++) {
+        uint64_t exemplarDuration = getSpanDuration(&statistics->exemplars[i]);
+        threshold = exemplarDuration < threshold ? exemplarDuration : threshold;
+    }
+
+    __atomic_store_n(&statistics->exemplarThreshold, threshold, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics->exemplarLock, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Commence le span d'une requête.
+ *
+ * Sans effet si un repas accordé attend encore l'écriture de sa réponse : son span continue.
+ *
+ * @param readComplete L'heure de lecture du bloc qui contient la requête.
+ */
+void beginRequestSpan(uint64_t readComplete) {
+    SpanThread *thread = &currentSpanThread;
+
+    if (thread->active && thread->span.marks[SPAN_LEFT_ACQUIRED] && thread->span.marks[SPAN_RIGHT_ACQUIRED]) {
+        return;
+    }
+
+    memset(&thread->span, 0, sizeof(RequestSpan));
+    thread->span.marks[SPAN_READ] = readComplete;
+    thread->span.processId = getpid();
+    thread->active = true;
+}
+
+/**
+ * @brief Horodate une étape franchie par la requête en cours.
+ *
+ * @param mark L'étape.
+ */
+void markRequestSpan(SpanMark mark) {
+    SpanThread *thread = &currentSpanThread;
+
+    if (thread->active) {
+        thread->span.marks[mark] = getMonotonicTime();
+    }
+}
+
+/**
+ * @brief Termine le span de la requête en cours, une fois sa réponse écrite.
+ *
+ * Le span d'un repas accordé (les deux baguettes prises) est publié ; celui d'une autre requête est oublié.
+ *
+ * @param seatId Le philosophe de la connexion.
+ */
+void endRequestSpan(int seatId) {
+    SpanThread *thread = &currentSpanThread;
+    SpanStatistics *statistics = spanStatisticsSource;
+    RequestSpan *span = &thread->span;
+
+    if (!thread->active) {
+        return;
+    }
+
+    thread->active = false;
+
+    if (!statistics || !span->marks[SPAN_LEFT_ACQUIRED] || !span->marks[SPAN_RIGHT_ACQUIRED]) {
+        return;
+    }
+
+    span->marks[SPAN_WRITTEN] = getMonotonicTime();
+    span->seatId = seatId;
+
+    for (int mark = SPAN_DECODED; mark < SPAN_MARKS; mark++) {
+        recordHistogram(&statistics->stageHistograms[mark - 1], getSpanStageDuration(span, mark));
+    }
+
+    uint64_t duration = getSpanDuration(span);
+    recordHistogram(&statistics->totalHistogram, duration);
+    __atomic_fetch_add(&statistics->spans, 1, __ATOMIC_RELAXED);
+
+    keepSpanExemplar(statistics, span, duration);
+}
+
+#endif
@@ -1,24 +1,17 @@
 /**
  * @file Response.c
- * @brief Implémente les fonctions de création des réponses envoyées par le serveur.
+ * @brief Implémente les encodeurs et le décodeur des réponses envoyées par le serveur.
  *
- * Ce fichier d'implémentation fournit deux fonctions permettant de générer des réponses en fonction des informations
- * relatives à un philosophe. Ces réponses sont ensuite envoyées par le serveur au client pour indiquer l'état ou
- * les actions effectuées.
- *
- * Les fonctions définies sont :
- *  - **createResponse(Philosopher philosopher)** : Crée une réponse de type RESPONSE_CREATE, initialisée à zéro,
- *    puis enregistre les informations du philosophe.
- *  - **updateResponse(Philosopher philosopher)** : Crée une réponse de type RESPONSE_UPDATE, initialisée à zéro,
- *    puis enregistre les informations mises à jour du philosophe.
- *
- * Dans chaque fonction, la structure `Response` est initialisée à zéro à l'aide de `memset` afin d'assurer
- * une initialisation propre, avant d'affecter les valeurs correspondantes.
+ * Tout est généré depuis RESPONSE_SCHEMA (voir Protocol.h) avec les générateurs de Protocol.c :
+ *  - un encodeur par type de réponse, nommé d'après le schéma : **createResponse(Philosopher)**,
+ *    **updateResponse(Philosopher)**, **refusedResponse()**, **watchResponse()** et **snapshotResponse()**. La
+ *    réponse est initialisée à zéro, puis son type et son contenu sont affectés ;
+ *  - **isValidResponse()** : Vérifie le type et le contenu d'une réponse ;
+ *  - **decodeResponse()** : Décode sans copie une réponse dans un tampon de réception.
  *
  * Les inclusions nécessaires dans ce fichier sont :
  *  - "../entities/Response.h" pour la définition de la structure `Response` et de l'énumération `ResponseType`.
- *  - "../entities/Philosopher.h" pour la définition de la structure `Philosopher`.
- *  - <string.h> pour l'utilisation de la fonction `memset`.
+ *  - "Protocol.c" pour les générateurs et la validation des contenus.
  *
  * Les directives de préprocesseur (#ifndef, #define, #endif) garantissent que ce fichier est inclus une seule fois lors
  * de la compilation.
@@ -29,42 +22,15 @@
 
 #include "../entities/Response.h"
 #include "../entities/Philosopher.h"
+#include "Protocol.c"
 #include <string.h>
 
-/**
- * @brief Crée une réponse de type RESPONSE_CREATE.
- *
- * Cette fonction initialise une structure `Response` à zéro avec `memset`, définit le type de réponse
- * à RESPONSE_CREATE et y copie la structure `Philosopher` passée en paramètre.
- *
- * @param philosopher La structure `Philosopher` contenant les informations du philosophe.
- * @return Response La réponse initialisée de type RESPONSE_CREATE.
- */
-Response createResponse(Philosopher philosopher) {
-    Response response;
-    memset(&response, 0, sizeof(response));
-    
-    response.type = RESPONSE_CREATE;
-    response.philosopher = philosopher;
-    return response;
-}
+#define RESPONSE_ENCODER(type, name, payload) PROTOCOL_ENCODER_##payload(Response, name##Response, type)
 
-/**
- * @brief Crée une réponse de type RESPONSE_UPDATE.
- *
- * Cette fonction initialise une structure `Response` à zéro avec `memset`, définit le type de réponse
- * à RESPONSE_UPDATE et y copie la structure `Philosopher` passée en paramètre.
- *
- * @param philosopher La structure `Philosopher` contenant les informations mises à jour du philosophe.
- * @return Response La réponse initialisée de type RESPONSE_UPDATE.
- */
-Response updateResponse(Philosopher philosopher) {
-    Response response;
-    memset(&response, 0, sizeof(response));
+RESPONSE_SCHEMA(RESPONSE_ENCODER)
+
+PROTOCOL_VALIDATOR(Response, isValidResponse, RESPONSE_SCHEMA)
 
-    response.type = RESPONSE_UPDATE;
-    response.philosopher = philosopher;
-    return response;
-}
+PROTOCOL_DECODER(Response, decodeResponse, isValidResponse)
 
 #endif
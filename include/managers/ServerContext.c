@@ -3,8 +3,10 @@
  * @brief Implémente les fonctions de gestion du contexte serveur.
  *
  * Ce fichier d'implémentation fournit deux fonctions essentielles pour la gestion des ressources du serveur :
- *  - **initServerContext()** : Initialise une structure `ServerContext` en mettant à zéro ses champs et en
- *    définissant des valeurs initiales par défaut.
+ *  - **initServerContext()** : Initialise une structure `ServerContext` en définissant des valeurs initiales par
+ *    défaut.
+ *  - **removeClient(ServerContext *serverContext, pid_t pid)** : Oublie un processus de service terminé et ferme
+ *    la copie de son socket de service détenue par le processus principal.
  *  - **cleanup(ServerContext *serverContext)** : Libère et nettoie toutes les ressources utilisées par le serveur,
  *    incluant les sockets, la mémoire partagée, les sémaphores, et la file de messages IPC pour les logs.
  *
@@ -29,29 +31,72 @@
 #include <sys/msg.h>
 #include <signal.h>
 #include <string.h>
+#include <stdbool.h>
 
 /**
  * @brief Initialise le contexte serveur.
  *
- * Cette fonction crée et initialise une structure `ServerContext` en mettant à zéro l'ensemble de ses champs à
- * l'aide de `memset`. Les valeurs initiales suivantes sont définies :
+ * Les valeurs initiales suivantes sont définies :
  *  - `serverSocket` est initialisé à -1 car socket() retourne -1 en cas d'erreur
  *  - `sharedResourcesMemoryId` est initialisé à -1 car shmget() retourne -1 en cas d'erreur
  *  - `numberServiceSockets` et `numberClients` sont initialisés à 0.
  *
- * @return ServerContext Le contexte serveur initialisé.
+ * Les tableaux indexés par processus de service (MAX_SERVICE_PROCESSES entrées) ne sont pas mis à zéro : seules
+ * leurs entrées inférieures aux compteurs sont lues, et le contexte, alloué statiquement, n'occupe ainsi de mémoire
+ * qu'à mesure que des clients arrivent, quelle que soit la taille de la table.
+ *
+ * @param serverContext Pointeur vers le contexte serveur à initialiser.
  */
-ServerContext initServerContext() {
-    ServerContext serverContext;
-    memset(&serverContext, 0, sizeof(ServerContext));
-    
-    serverContext.serverSocket = -1;
-    serverContext.sharedResourcesMemoryId = -1;
-    serverContext.numberServiceSockets = 0;
-    serverContext.numberClients = 0;
-
-    return serverContext;
-    
+void initServerContext(ServerContext *serverContext) {
+    serverContext->serverSocket = -1;
+    serverContext->sharedResourcesMemoryId = -1;
+    serverContext->sharedResources = NULL;
+    serverContext->numberServiceSockets = 0;
+    serverContext->numberClients = 0;
+    serverContext->controlSocket = -1;
+    serverContext->signalFd = -1;
+    serverContext->numberControlConnections = 0;
+}
+
+/**
+ * @brief Oublie un processus de service terminé.
+ *
+ * Les tableaux des PID, des threads de logs et des sockets de service sont remplis en parallèle : l'entrée du processus est remplacée
+ * par la dernière de chaque tableau. La copie du socket de service détenue par le processus principal est fermée,
+ * afin que le client voie la connexion se terminer, et le thread de logs du processus s'arrête une fois ses derniers
+ * messages écrits.
+ *
+ * @param serverContext Pointeur vers la structure `ServerContext`.
+ * @param pid Le PID du processus de service terminé.
+ * @return bool true si le processus était connu.
+ */
+bool removeClient(ServerContext *serverContext, pid_t pid) {
+    for (size_t i = 0; i < serverContext->numberClients; i++) {
+        if (serverContext->clientsProcessIds[i] != pid) {
+            continue;
+        }
+
+        close(serverContext->serviceSockets[i]);
+
+        // Un message vide, reçu après tous ceux du processus terminé, met fin à son thread de logs
+        Log endOfLogs = { .type = pid };
+
+        if (msgsnd(serverContext->sharedResources->logsQueueId, &endOfLogs, 0, IPC_NOWAIT) == -1) {
+            pthread_cancel(serverContext->clientsLogsThreads[i]);
+        }
+
+        pthread_join(serverContext->clientsLogsThreads[i], NULL);
+
+        serverContext->numberClients -= 1;
+        serverContext->numberServiceSockets -= 1;
+        serverContext->clientsProcessIds[i] = serverContext->clientsProcessIds[serverContext->numberClients];
+        serverContext->clientsLogsThreads[i] = serverContext->clientsLogsThreads[serverContext->numberClients];
+        serverContext->serviceSockets[i] = serverContext->serviceSockets[serverContext->numberServiceSockets];
+
+        return true;
+    }
+
+    return false;
 }
 
 /**
@@ -62,9 +107,10 @@ ServerContext initServerContext() {
  *  - Termine tous les processus de service en envoyant un signal SIGKILL à chacun des PID stockés.
  *  - Ferme le socket principal du serveur s'il est ouvert.
  *  - Ferme tous les sockets de service.
+ *  - Ferme le socket de contrôle (et supprime son fichier) ainsi que le descripteur des signaux.
  *  - Supprime la file de messages IPC utilisée pour les logs.
- *  - Détruit les sémaphores utilisés pour la synchronisation dans la mémoire partagée, y compris ceux des baguettes.
- *  - Détache la mémoire partagée et libère le segment de mémoire.
+ *  - Détruit les sémaphores globaux de la mémoire partagée ; ceux des baguettes sont abandonnés avec le segment.
+ *  - Détache la mémoire partagée et libère le segment de mémoire, d'un seul appel quelle que soit sa taille.
  *
  * @param serverContext Pointeur vers la structure `ServerContext` contenant les ressources à nettoyer.
  */
@@ -89,6 +135,21 @@ void cleanup(ServerContext *serverContext) {
         printMessage(SUCCESS, "Socket de service (%d) fermé correctement.\n", serverContext->serviceSockets[i]);
     }
 
+    // Ferme le socket de contrôle et les connexions de contrôle en cours
+    for (int i = 0; i < serverContext->numberControlConnections; i++) {
+        close(serverContext->controlConnections[i].socket);
+    }
+
+    if (serverContext->controlSocket != -1) {
+        close(serverContext->controlSocket);
+        unlink(CONTROL_SOCKET_PATH);
+        printMessage(SUCCESS, "Socket de contrôle (%d) fermé correctement.\n", serverContext->controlSocket);
+    }
+
+    if (serverContext->signalFd != -1) {
+        close(serverContext->signalFd);
+    }
+
     // Supprime la file de message IPC pour des logs
     if (serverContext->sharedResources->logsQueueId) {
         msgctl(serverContext->sharedResources->logsQueueId, IPC_RMID, NULL);
@@ -99,9 +160,8 @@ void cleanup(ServerContext *serverContext) {
     sem_destroy(&serverContext->sharedResources->maxAllowedEating);
     sem_destroy(&serverContext->sharedResources->philosopherCreationProcess);
 
-    for (int i = 0; i < serverContext->sharedResources->numberChopsticks; i++) {
-        sem_destroy(&serverContext->sharedResources->chopsticks[i].usage);
-    }
+    // Les sémaphores des baguettes ne tiennent aucune ressource hors du segment : ils disparaissent avec lui, sans
+    // parcours des places, quelle que soit la taille de la table
     printMessage(SUCCESS, "Sémaphores détruits correctement.\n");
 
     // Détache la mémoire partagée
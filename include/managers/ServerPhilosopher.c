@@ -9,16 +9,40 @@
  *
  * Les fonctions implémentées dans ce fichier sont :
  *  - **getPhilosopherFromId** : Recherche un philosophe dans le tableau à partir de son identifiant.
+ *  - **pinPhilosopher** / **unpinPhilosopher** : Tiennent la place d'un philosophe, que le compactage ne peut alors
+ *    pas déplacer, puis la rendent.
+ *  - **copyPhilosopher** : Copie l'état d'un philosophe.
  *  - **definePhilosopherRightChopstick** : Attribue la baguette droite pour un nouveau philosophe, en réattribuant
  *    la baguette de l'avant-dernier philosophe si nécessaire.
  *  - **createPhilosopher** : Crée et initialise un philosophe côté serveur, attribue sa baguette gauche et,
  *    pour les philosophes ultérieurs, la baguette droite via la fonction dédiée. Met également à jour le compteur
  *    limitant le nombre de philosophes pouvant manger simultanément.
+ *  - **getFirstSeatedPhilosopher** / **getLastSeatedPhilosopher** : Retournent le premier et le dernier philosophe
+ *    encore à table (les places des philosophes évincés ne sont pas réutilisées).
+ *  - **getPreviousPhilosopher** : Retourne le voisin de gauche d'un philosophe, celui dont la baguette droite est la
+ *    baguette gauche du philosophe.
  *  - **updatePhilosopher** : Met à jour l'état d'un philosophe existant en gérant la libération ou l'acquisition
- *    des baguettes en fonction de son nouvel état, et synchronise l'accès au compteur global.
+ *    des baguettes en fonction de son nouvel état et de la politique d'arbitrage courante.
+ *  - **leaveTable** : Retire de l'anneau un philosophe évincé et referme l'anneau entre ses deux voisins.
+ *
+ * Les places peuvent être déplacées par le compactage et la migration (voir Compaction.h et Migration.h) : un
+ * philosophe est désigné par son identifiant, et un pointeur vers sa place n'est gardé que le temps d'une opération,
+ * entre pinPhilosopher() et unpinPhilosopher().
+ *  - **notifyPhilosopherChange** : Signale aux abonnés un changement d'état d'un philosophe.
+ *
+ * Toute modification de l'anneau (arrivée ou départ d'un philosophe) se fait sous le verrou `policyLock` pris en
+ * écriture : aucune prise de baguettes n'est alors en cours, un philosophe ne peut donc pas attendre une baguette
+ * qui n'est plus la sienne.
  *
  * Ce module utilise les mécanismes IPC (sémaphores et files de messages) pour synchroniser l'accès aux ressources partagées.
  *
+ * Chaque repas accordé et chaque libération de baguettes sont consignés dans le registre des repas (voir Ledger.h).
+ * Avec la politique `sequenced`, les baguettes ne sont prises et rendues que par le cœur de la table (voir
+ * TableCore.h) : un philosophe y publie ses demandes et fins de repas, puis attend le cœur ; ses arrivées et départs
+ * y sont aussi publiés.
+ * Les étapes d'une demande de repas (place, admission, baguettes) sont closes auprès des compteurs matériels du
+ * thread (voir PerfCounters.h) et horodatées dans le span de la requête en cours (voir RequestSpan.h).
+ *
  * @note L'inclusion de divers fichiers d'entités et de gestion (Chopstick, SharedResources, Request, Response, Logs)
  * permet d'assurer une cohérence dans la gestion des ressources et des communications côté serveur.
  */
@@ -34,26 +58,190 @@
 #include "../managers/Request.c"
 #include "../managers/Response.c"
 #include "../managers/Logs.c"
+#include "../managers/Statistics.c"
+#include "../managers/Ledger.c"
+#include "../managers/PerfCounters.c"
+#include "../managers/RequestSpan.c"
+#include "../managers/TableEvents.c"
 #include <signal.h>
 #include <errno.h>
 #include <string.h>
 #include <semaphore.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sched.h>
+#include <unistd.h>
+
 
+/**
+ * @brief Signale aux abonnés (voir Watch.h) un changement d'état d'un philosophe.
+ *
+ * Appelée après la modification : un abonné qui lit la nouvelle version lit aussi le nouvel état. Seuls deux
+ * compteurs sont incrémentés, l'envoi aux abonnés est fait par leurs propres processus.
+ *
+ * @param serverPhilosopher Le philosophe modifié.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ */
+void notifyPhilosopherChange(ServerPhilosopher *serverPhilosopher, SharedResources *sharedResources) {
+    __atomic_add_fetch(&serverPhilosopher->version, 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&sharedResources->tableVersion, 1, __ATOMIC_RELEASE);
+}
 
 /**
  * @brief Recherche un philosophe dans le tableau à partir de son identifiant.
  *
- * Cette fonction parcourt le tableau des philosophes côté serveur et retourne un pointeur vers
- * le philosophe dont l'identifiant correspond à celui passé en paramètre.
+ * La place du philosophe est lue dans la table de renvoi `seatSlots` : la recherche est un accès direct, qui ne
+ * parcourt pas les places. Le compactage et la migration pouvant déplacer la place à tout moment, le pointeur retourné
+ * ne sert qu'aux lectures approchées ; pour modifier le philosophe, utiliser pinPhilosopher().
  *
  * @param id L'identifiant du philosophe recherché.
- * @param philosophers Tableau des philosophes côté serveur.
+ * @param sharedResources Pointeur vers les ressources partagées.
  * @return ServerPhilosopher* Pointeur vers le philosophe correspondant ou NULL s'il n'est pas trouvé.
  */
-ServerPhilosopher *getPhilosopherFromId(int id, ServerPhilosopher *philosophers) {
-    for (int i = 0; i < MAX_PHILOSOPHERS; i++) {
-        if (philosophers[i].base.id == id) {
-            return &philosophers[i];
+ServerPhilosopher *getPhilosopherFromId(int id, SharedResources *sharedResources) {
+    if (id < 1 || id > MAX_PHILOSOPHERS) {
+        return NULL;
+    }
+
+    while (1) {
+        int slot = __atomic_load_n(&sharedResources->seatSlots[id - 1], __ATOMIC_ACQUIRE);
+
+        if (slot < 1 || slot > MAX_PHILOSOPHERS) {
+            return NULL;
+        }
+
+        if (sharedResources->philosophers[slot - 1].base.id == id) {
+            return &sharedResources->philosophers[slot - 1];
+        }
+
+        // La place ne contient pas le philosophe : il est en cours de déplacement (époque impaire, voir
+        // Compaction.h) ou a été déplacé depuis la lecture de la table de renvoi
+        if (__atomic_load_n(&sharedResources->compaction.epoch, __ATOMIC_ACQUIRE) % 2 == 1) {
+            sched_yield();
+        } else if (__atomic_load_n(&sharedResources->seatSlots[id - 1], __ATOMIC_ACQUIRE) == slot) {
+            return NULL;
+        }
+    }
+}
+
+/**
+ * @brief Rend la place d'un philosophe tenue par pinPhilosopher().
+ *
+ * @param philosopher Le philosophe.
+ */
+void unpinPhilosopher(ServerPhilosopher *philosopher) {
+    __atomic_sub_fetch(&philosopher->pins, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Tient la place d'un philosophe : le compactage ne la déplace ni ne l'efface avant unpinPhilosopher().
+ *
+ * Si la place est en cours de déplacement, l'appel attend la fin du déplacement et tient la nouvelle place. Une
+ * place peut être lue dans la table de renvoi juste avant d'être déplacée : la table est relue une fois la place
+ * tenue, et la prise recommencée si elle a changé.
+ *
+ * @param id L'identifiant du philosophe.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return ServerPhilosopher* Le philosophe, à rendre avec unpinPhilosopher(), ou NULL s'il n'existe pas.
+ */
+ServerPhilosopher *pinPhilosopher(int id, SharedResources *sharedResources) {
+    while (1) {
+        ServerPhilosopher *philosopher = getPhilosopherFromId(id, sharedResources);
+
+        if (!philosopher) {
+            return NULL;
+        }
+
+        uint32_t pins = __atomic_load_n(&philosopher->pins, __ATOMIC_ACQUIRE);
+
+        if (pins == SEAT_MOVING) {
+            sched_yield();
+            continue;
+        }
+
+        if (!__atomic_compare_exchange_n(&philosopher->pins, &pins, pins + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+
+        if (getPhilosopherFromId(id, sharedResources) == philosopher) {
+            return philosopher;
+        }
+
+        unpinPhilosopher(philosopher);
+    }
+}
+
+/**
+ * @brief Copie l'état d'un philosophe, sans risquer de lire une place en plein déplacement.
+ *
+ * @param id L'identifiant du philosophe.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @param copy Reçoit la copie.
+ * @return bool false si le philosophe n'existe pas (ou que sa place a été effacée).
+ */
+bool copyPhilosopher(int id, SharedResources *sharedResources, ServerPhilosopher *copy) {
+    ServerPhilosopher *philosopher = pinPhilosopher(id, sharedResources);
+
+    if (!philosopher) {
+        return false;
+    }
+
+    *copy = *philosopher;
+    unpinPhilosopher(philosopher);
+    return true;
+}
+
+/**
+ * @brief Retourne le premier philosophe encore à table.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return ServerPhilosopher* Le philosophe de plus petite place encore à table, ou NULL si la table est vide.
+ */
+ServerPhilosopher *getFirstSeatedPhilosopher(SharedResources *sharedResources) {
+    for (int i = 0; i < sharedResources->numberPhilosophers; i++) {
+        if (!sharedResources->philosophers[i].departed) {
+            return &sharedResources->philosophers[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Retourne le dernier philosophe encore à table.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return ServerPhilosopher* Le philosophe de plus grande place encore à table, ou NULL si la table est vide.
+ */
+ServerPhilosopher *getLastSeatedPhilosopher(SharedResources *sharedResources) {
+    for (int i = sharedResources->numberPhilosophers - 1; i >= 0; i--) {
+        if (!sharedResources->philosophers[i].departed) {
+            return &sharedResources->philosophers[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Retourne le voisin de gauche d'un philosophe.
+ *
+ * Le voisin de gauche est le philosophe encore à table dont la baguette droite est la baguette gauche du philosophe.
+ *
+ * @param philosopher Le philosophe.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return ServerPhilosopher* Le voisin de gauche, ou NULL si le philosophe est seul à table.
+ */
+ServerPhilosopher *getPreviousPhilosopher(ServerPhilosopher *philosopher, SharedResources *sharedResources) {
+    int numberPhilosophers = sharedResources->numberPhilosophers;
+    int slot = philosopher - sharedResources->philosophers;
+
+    // Les places sont rangées dans l'ordre de l'anneau : seules les places quittées depuis le dernier compactage
+    // séparent un philosophe de son voisin
+    for (int step = 1; step < numberPhilosophers; step++) {
+        ServerPhilosopher *candidate = &sharedResources->philosophers[(slot - step + numberPhilosophers) % numberPhilosophers];
+
+        if (!candidate->departed) {
+            return candidate->rightChopstick == philosopher->leftChopstick ? candidate : NULL;
         }
     }
     return NULL;
@@ -62,36 +250,38 @@ ServerPhilosopher *getPhilosopherFromId(int id, ServerPhilosopher *philosophers)
 /**
  * @brief Attribue la baguette droite à un nouveau philosophe.
  *
- * Cette fonction, de nature bloquante, gère l'attribution de la baguette droite pour un philosophe nouvellement créé.
- * Pour le premier philosophe, aucune attribution n'est faite. Pour les philosophes suivants, la première baguette est
- * assignée à droite du nouveau philosophe. De plus, pour le deuxième philosophe, la baguette gauche du nouveau philosophe
- * est affectée à droite du premier. Pour les philosophes suivants, la fonction réattribue la baguette droite de l'avant-dernier
- * philosophe à la nouvelle baguette créée, en s'assurant d'une synchronisation via un sémaphore.
+ * Cette fonction, de nature bloquante, insère le nouveau philosophe dans l'anneau entre le dernier et le premier
+ * philosophe encore à table : la baguette gauche du premier est assignée à droite du nouveau philosophe, et la baguette
+ * gauche du nouveau philosophe devient la baguette droite du dernier. Si le dernier était seul à table, il n'avait
+ * pas de baguette à droite ; sinon, la réattribution attend que son ancienne baguette droite soit libre, via son
+ * sémaphore.
  *
  * @param philosopher Pointeur vers le philosophe dont la baguette droite doit être définie.
  * @param sharedResources Pointeur vers les ressources partagées contenant les baguettes et les philosophes.
+ *
+ * @note L'appelant doit détenir le verrou `policyLock` en écriture.
  */
 void definePhilosopherRightChopstick(ServerPhilosopher *philosopher, SharedResources *sharedResources) {
-    int lastPhilosopherId =  sharedResources->numberPhilosophers;
-    
-    Chopstick *firstChopstick = &sharedResources->chopsticks[0];
-    logServerState(sharedResources->logsQueueId, "Assignation de la baguette 1 (adresse %p) à droite du philosophe %d...\n", firstChopstick , philosopher->base.id);
+    ServerPhilosopher *firstPhilosopher = getFirstSeatedPhilosopher(sharedResources);
+    ServerPhilosopher *lastPhilosopher = getLastSeatedPhilosopher(sharedResources);
+
+    Chopstick *firstChopstick = firstPhilosopher->leftChopstick;
+    logServerState(sharedResources->logsQueueId, "Assignation de la baguette %d (adresse %p) à droite du philosophe %d...\n", firstChopstick->id, firstChopstick, philosopher->base.id);
     philosopher->rightChopstick = firstChopstick;
 
     // Attribution de la nouvelle baguette à droite de l'avant dernier philosophe, on vérifiant l'accès de son ancienne baguette pour éviter un déplacement en mémoire pendant l'utilisation
-    logServerState(sharedResources->logsQueueId, "Assignation de la baguette %d (adresse %p) à droite de l'avant denier philosophe %d...\n",  philosopher->leftChopstick->id, philosopher->leftChopstick, sharedResources->philosophers[lastPhilosopherId - 1].base.id);
+    logServerState(sharedResources->logsQueueId, "Assignation de la baguette %d (adresse %p) à droite de l'avant denier philosophe %d...\n",  philosopher->leftChopstick->id, philosopher->leftChopstick, lastPhilosopher->base.id);
 
-    // Quand c'est le deuxième philosophe créé, le premier n'a pas de baguette à droite donc pas de sémaphore a tester
-    if (philosopher->base.id == 2) {
-        sharedResources->philosophers[0].rightChopstick = philosopher->leftChopstick;
+    // Quand le dernier philosophe est seul à table, il n'a pas de baguette à droite donc pas de sémaphore a tester
+    if (lastPhilosopher->rightChopstick == NULL) {
+        lastPhilosopher->rightChopstick = philosopher->leftChopstick;
     }
 
-    else if (philosopher->base.id > 2) {
-        Chopstick *previousPhlosopherOldRightChopstick = sharedResources->philosophers[lastPhilosopherId - 1].rightChopstick;
+    else {
+        Chopstick *previousPhlosopherOldRightChopstick = lastPhilosopher->rightChopstick;
         sem_wait(&previousPhlosopherOldRightChopstick->usage);
 
-
-        sharedResources->philosophers[lastPhilosopherId - 1].rightChopstick = philosopher->leftChopstick;
+        lastPhilosopher->rightChopstick = philosopher->leftChopstick;
 
         sem_post(&previousPhlosopherOldRightChopstick->usage);
     }
@@ -101,41 +291,67 @@ void definePhilosopherRightChopstick(ServerPhilosopher *philosopher, SharedResou
  * @brief Crée un philosophe côté serveur.
  *
  * Cette fonction synchronise la création d'un nouveau philosophe grâce à un sémaphore, initialise le philosophe,
- * attribue sa baguette gauche via la fonction createChopstick, et, si ce n'est pas le premier philosophe, définit
+ * attribue sa baguette gauche via la fonction createChopstick, et, si ce n'est pas le premier philosophe à table, définit
  * sa baguette droite en appelant definePhilosopherRightChopstick. Le philosophe est ensuite ajouté à la mémoire partagée,
- * et le compteur de philosophes est incrémenté. Si le nombre total de philosophes devient pair, le compteur de philosophes pouvant manger
- * est incrémenté.
+ * et les compteurs de philosophes sont incrémentés. Si le nombre de philosophes à table devient pair, le compteur de
+ * philosophes pouvant manger est incrémenté.
+ *
+ * La création est refusée lorsque la table a atteint sa capacité (réglable depuis le socket de contrôle), que
+ * toutes les places sont utilisées (en attendant le compactage) ou que tous les identifiants ont été attribués.
  *
  * @param sharedResources Pointeur vers la structure des ressources partagées.
- * @return ServerPhilosopher Le philosophe créé et ajouté aux ressources partagées.
+ * @return ServerPhilosopher Le philosophe créé et ajouté aux ressources partagées, d'identifiant 0 si la création est refusée.
  */
 ServerPhilosopher createPhilosopher(SharedResources *sharedResources) {
     sem_wait(&sharedResources->philosopherCreationProcess);
 
-    // Création d'un philosophe
-    int lastPhilosopherId =  sharedResources->numberPhilosophers;
+    // Création d'un philosophe, à la suite des places utilisées
+    int slot = sharedResources->numberPhilosophers;
+    int lastPhilosopherId = sharedResources->lastPhilosopherId;
 
     ServerPhilosopher philosopher;
     memset(&philosopher, 0, sizeof(philosopher));
 
+    if (sharedResources->numberSeated >= sharedResources->capacity || slot >= MAX_PHILOSOPHERS || lastPhilosopherId >= MAX_PHILOSOPHERS) {
+        logServerState(sharedResources->logsQueueId, "Création d'un philosophe refusée : table pleine (%d/%d)\n", sharedResources->numberSeated, sharedResources->capacity);
+        sem_post(&sharedResources->philosopherCreationProcess);
+        return philosopher;
+    }
+
     philosopher.base.id = lastPhilosopherId + 1;
 
     logServerState(sharedResources->logsQueueId, "Création du philosophe %d...\n", philosopher.base.id);
 
     // Création et Attribution de la baguette à sa gauche
-    philosopher.leftChopstick = createChopstick(philosopher.base.id, sharedResources);;
-    
-    if (lastPhilosopherId > 0) {
+    philosopher.leftChopstick = createChopstick(philosopher.base.id, slot, sharedResources);
+
+    // Modification de l'anneau : aucune prise de baguettes ne doit être en cours
+    pthread_rwlock_wrlock(&sharedResources->policyLock);
+
+    if (sharedResources->numberSeated > 0) {
         definePhilosopherRightChopstick(&philosopher, sharedResources);
     }
 
-    // Ajout dans la mémoire partagée
-    sharedResources->philosophers[lastPhilosopherId] = philosopher;
+    // Ajout dans la mémoire partagée, sans écrire `pins` : une prise périmée (voir pinPhilosopher()) peut encore
+    // l'incrémenter puis le décrémenter
+    memcpy(&sharedResources->philosophers[slot], &philosopher, offsetof(ServerPhilosopher, pins));
     sharedResources->numberPhilosophers += 1;
+    sharedResources->numberSeated += 1;
+    sharedResources->lastPhilosopherId = philosopher.base.id;
+    __atomic_store_n(&sharedResources->seatSlots[philosopher.base.id - 1], slot + 1, __ATOMIC_RELEASE);
+    notifyPhilosopherChange(&sharedResources->philosophers[slot], sharedResources);
+
+    bool sequenced = sharedResources->policy == POLICY_SEQUENCED;
+
+    pthread_rwlock_unlock(&sharedResources->policyLock);
+
+    if (sequenced) {
+        publishTableEvent(&sharedResources->tableCore, TABLE_EVENT_JOIN, philosopher.base.id);
+    }
 
     // Incrémentation du nombre de philosophes qui peuvent manger en même 
     // Uniquement si le nouveau nombre de philosophes est un multiple de 2 (un philosophe sur deux peut manger)
-    if (sharedResources->numberPhilosophers % 2 == 0) {
+    if (sharedResources->numberSeated % 2 == 0) {
         sem_post(&sharedResources->maxAllowedEating);
     }
 
@@ -145,108 +361,379 @@ ServerPhilosopher createPhilosopher(SharedResources *sharedResources) {
 }
 
 /**
- * @brief Met à jour l'état d'un philosophe côté serveur.
+ * @brief Prend une baguette pour un philosophe.
  *
- * Cette fonction met à jour la structure d'un philosophe existant dans la mémoire partagée en fonction du nouvel état
- * (THINKING, EATING ou HUNGRY) reçu. En cas de transition de EATING à THINKING, elle libère les baguettes associées
- * et incrémente le compteur principal. Pour l'état HUNGRY, la fonction tente d'acquérir les ressources nécessaires (baguettes
- * et compteur) en tentant d'accéder aux sémaphores en deux fois: d'abord en non-bloquant, pour logguer l'attente si besoin, puis on bloque.
+ * La prise se fait en deux fois : d'abord en non-bloquant, pour logguer l'attente si besoin, puis on bloque.
  *
- * @param philosopher La structure `Philosopher` contenant le nouvel état du philosophe.
- * @param serviceSocket Socket de service associé (non utilisé directement dans cette fonction).
+ * @param serverPhilosopher Le philosophe.
+ * @param chopstick La baguette à prendre.
+ * @param side Le côté de la baguette ("gauche" ou "droite"), pour les logs.
  * @param sharedResources Pointeur vers la structure des ressources partagées.
- * @return ServerPhilosopher* Pointeur vers le philosophe mis à jour si une réponse doit être renvoyée au client,
- *         ou NULL si aucune mise à jour à notifier n'est nécessaire.
  */
-ServerPhilosopher *updatePhilosopher(Philosopher philosopher, SharedResources *sharedResources) {
-    ServerPhilosopher *serverPhilosopher = getPhilosopherFromId(philosopher.id, sharedResources->philosophers);
+void acquireChopstick(ServerPhilosopher *serverPhilosopher, Chopstick *chopstick, const char *side, SharedResources *sharedResources) {
+    int id = serverPhilosopher->base.id;
 
-    if (!serverPhilosopher) {
-        logClientInfo(sharedResources->logsQueueId, "Erreur, le philosophe à mettre à jour est introuvable dans la mémoire partagée.\n");
-        return NULL;
-    }   
+    if (sem_trywait(&chopstick->usage) == -1 && (errno == EAGAIN)) {
+        char message[LOG_BUFFER_SIZE];
+        snprintf(message, sizeof(message), "En attente de la baguette %s...\n", side);
 
-    if (philosopher.state == THINKING) {
+        logServerState(sharedResources->logsQueueId, "Le philosophe %d attend que la baguette %d à sa %s se libère\n", id, chopstick->id, side);
+        logClientInfo(sharedResources->logsQueueId, message);
+        sem_wait(&chopstick->usage);
+    }
 
-        // S'il est passé de EATING a THINKING, libération des baguettes et incrémentation du compteur principal
-        if (serverPhilosopher->base.state == EATING) {
-            
-            sem_post(&serverPhilosopher->leftChopstick->usage);
-            logClientInfo(sharedResources->logsQueueId, "Baguette gauche libérée\n");
-            logServerState(sharedResources->logsQueueId, "Le philosophe %d libère la baguette %d à sa gauche\n", philosopher.id, serverPhilosopher->leftChopstick->id);
+    markRequestSpan(chopstick == serverPhilosopher->leftChopstick ? SPAN_LEFT_ACQUIRED : SPAN_RIGHT_ACQUIRED);
+    chopstick->holderId = id;
+    logServerState(sharedResources->logsQueueId, "Le philosophe %d prend la baguette %d à sa %s\n", id, chopstick->id, side);
+}
+
+/**
+ * @brief Rend la place au compteur d'un philosophe qui a fini de manger, s'il en a pris une.
+ *
+ * @param serverPhilosopher Le philosophe.
+ * @param sharedResources Pointeur vers la structure des ressources partagées.
+ */
+void releaseAdmission(ServerPhilosopher *serverPhilosopher, SharedResources *sharedResources) {
+    if (serverPhilosopher->heldAdmission) {
+        serverPhilosopher->heldAdmission = false;
+        sem_post(&sharedResources->maxAllowedEating);
+        logClientInfo(sharedResources->logsQueueId, "Compteur libéré\n");
+        logServerState(sharedResources->logsQueueId, "Le philosophe %d libère le compteur\n\n", serverPhilosopher->base.id);
+    }
+}
+
+/**
+ * @brief Libère les baguettes d'un philosophe qui a fini de manger, et sa place au compteur s'il en a pris une.
+ *
+ * Avec la politique `sequenced`, la fin du repas est publiée au cœur de la table, qui rend les baguettes (voir
+ * TableCore.h) ; l'appel attend qu'il l'ait appliquée.
+ *
+ * @param serverPhilosopher Le philosophe.
+ * @param sharedResources Pointeur vers la structure des ressources partagées.
+ */
+void releaseChopsticks(ServerPhilosopher *serverPhilosopher, SharedResources *sharedResources) {
+    int id = serverPhilosopher->base.id;
+
+    if (sharedResources->policy == POLICY_SEQUENCED) {
+        TableCore *core = &sharedResources->tableCore;
+        waitTableEventApplied(core, publishTableEvent(core, TABLE_EVENT_RELEASE, id));
+        logClientInfo(sharedResources->logsQueueId, "Baguettes rendues à la table\n");
+        releaseAdmission(serverPhilosopher, sharedResources);
+        return;
+    }
+
+    // Une fois rendue, la baguette droite appartient à la place voisine, que le compactage peut alors déplacer
+    Chopstick *rightChopstick = serverPhilosopher->rightChopstick;
+    int leftChopstickId = serverPhilosopher->leftChopstick->id;
+    int rightChopstickId = rightChopstick->id;
+
+    // Consigné avant que les baguettes soient rendues : dans le registre, la libération précède le repas suivant
+    appendLedgerRecord(&sharedResources->ledger, LEDGER_RELEASE, id, leftChopstickId, rightChopstickId);
+
+    serverPhilosopher->leftChopstick->holderId = 0;
+    sem_post(&serverPhilosopher->leftChopstick->usage);
+    logClientInfo(sharedResources->logsQueueId, "Baguette gauche libérée\n");
+    logServerState(sharedResources->logsQueueId, "Le philosophe %d libère la baguette %d à sa gauche\n", id, leftChopstickId);
+
+    rightChopstick->holderId = 0;
+    sem_post(&rightChopstick->usage);
+    logClientInfo(sharedResources->logsQueueId, "Baguette droite libérée\n");
+    logServerState(sharedResources->logsQueueId, "Le philosophe %d libère la baguette %d à sa droite\n", id, rightChopstickId);
+
+    releaseAdmission(serverPhilosopher, sharedResources);
+}
+
+/**
+ * @brief Attend qu'un philosophe affamé puisse être servi, puis prend le verrou de la politique en lecture.
+ *
+ * Un philosophe mis à l'écart (drain) ou seul à table (sans baguette droite) patiente sans rien prendre, jusqu'à
+ * être repris, rejoint par un voisin ou évincé.
+ *
+ * @param serverPhilosopher Le philosophe.
+ * @param sharedResources Pointeur vers la structure des ressources partagées.
+ * @return bool true si le philosophe peut être servi (le verrou est alors pris), false s'il a été évincé.
+ */
+bool waitUntilServable(ServerPhilosopher *serverPhilosopher, SharedResources *sharedResources) {
+    bool logged = false;
 
-            sem_post(&serverPhilosopher->rightChopstick->usage);
-            logClientInfo(sharedResources->logsQueueId, "Baguette droite libérée\n");
-            logServerState(sharedResources->logsQueueId, "Le philosophe %d libère la baguette %d à sa droite\n", philosopher.id, serverPhilosopher->rightChopstick->id);
+    while (!serverPhilosopher->evicted) {
 
+        if (!serverPhilosopher->draining) {
+            pthread_rwlock_rdlock(&sharedResources->policyLock);
 
-            sem_post(&sharedResources->maxAllowedEating);
-            logClientInfo(sharedResources->logsQueueId, "Compteur libéré\n");
-            logServerState(sharedResources->logsQueueId, "Le philosophe %d libère le compteur\n\n", philosopher.id);
+            if (serverPhilosopher->rightChopstick != NULL) {
+                return true;
+            }
+
+            pthread_rwlock_unlock(&sharedResources->policyLock);
+        }
 
+        if (!logged) {
+            logServerState(sharedResources->logsQueueId, "Le philosophe %d est mis en attente (%s)\n", serverPhilosopher->base.id, serverPhilosopher->draining ? "drain" : "seul à table");
+            logClientInfo(sharedResources->logsQueueId, "Mis en attente par le serveur...\n");
+            logged = true;
+        }
+
+        usleep(100000);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Met à jour l'état d'un philosophe dont la place est tenue.
+ *
+ * Cette fonction met à jour la structure d'un philosophe existant dans la mémoire partagée en fonction du nouvel état
+ * (THINKING, EATING ou HUNGRY) reçu. En cas de transition de EATING à THINKING, elle libère les baguettes associées
+ * et, s'il a été pris, le compteur principal. Pour l'état HUNGRY, la fonction acquiert les ressources nécessaires
+ * selon la politique d'arbitrage courante :
+ *  - POLICY_COUNTER : le compteur, puis la baguette gauche, puis la baguette droite ;
+ *  - POLICY_ORDERED : la baguette de plus petit identifiant, puis l'autre ;
+ *  - POLICY_SEQUENCED : la demande est publiée au cœur de la table, qui accorde les deux baguettes ensemble.
+ *
+ * @param serverPhilosopher Le philosophe à mettre à jour, tenu par l'appelant (voir pinPhilosopher()).
+ * @param philosopher La structure `Philosopher` contenant le nouvel état du philosophe.
+ * @param sharedResources Pointeur vers la structure des ressources partagées.
+ * @return bool true si une réponse doit être renvoyée au client (repas accordé).
+ */
+bool updatePinnedPhilosopher(ServerPhilosopher *serverPhilosopher, Philosopher philosopher, SharedResources *sharedResources) {
+    if (philosopher.state == THINKING) {
+
+        // S'il est passé de EATING a THINKING, libération des baguettes et du compteur principal
+        if (serverPhilosopher->base.state == EATING) {
+            releaseChopsticks(serverPhilosopher, sharedResources);
         }
 
         serverPhilosopher->base = philosopher;
+        notifyPhilosopherChange(serverPhilosopher, sharedResources);
         logClientAction(sharedResources->logsQueueId, serverPhilosopher->base);
-        return NULL;
+        return false;
     }
     
     if (philosopher.state == EATING) {
         serverPhilosopher->base = philosopher;
+        notifyPhilosopherChange(serverPhilosopher, sharedResources);
         logClientAction(sharedResources->logsQueueId, serverPhilosopher->base);
-        return NULL;
+        return false;
     }
     
 
     if (philosopher.state == HUNGRY) {
 
         serverPhilosopher->base = philosopher;
+        serverPhilosopher->hungrySince = getMonotonicTime();
+        notifyPhilosopherChange(serverPhilosopher, sharedResources);
+
+        if (!waitUntilServable(serverPhilosopher, sharedResources)) {
+            return false;
+        }
+
+        ArbitrationPolicy policy = sharedResources->policy;
+
+        if (policy == POLICY_COUNTER) {
+
+            // On vérifie le compteur principal
+            // Si ça ne passe pas on log que le philosophe patiente et il est mis en attente
+            if (sem_trywait(&sharedResources->maxAllowedEating) == -1 && (errno == EAGAIN)) {
+                logServerState(sharedResources->logsQueueId, "Le philosophe %d attend que le compteur se libère\n", philosopher.id);
+                logClientInfo(sharedResources->logsQueueId, "En attente de pouvoir manger... \n");
+                sem_wait(&sharedResources->maxAllowedEating);
+            }
 
-        // On vérifie le compteur principal
-        // Si ça ne passe pas on log que le philosophe patiente et il est mis en attente
-     
-        if (sem_trywait(&sharedResources->maxAllowedEating) == -1 && (errno == EAGAIN)) {
-            logServerState(sharedResources->logsQueueId, "Le philosophe %d attend que le compteur se libère\n", philosopher.id);
-            logClientInfo(sharedResources->logsQueueId, "En attente de pouvoir manger... \n");
-            sem_wait(&sharedResources->maxAllowedEating);
-        }
-        
-        int allowedEating;
-        sem_getvalue(&sharedResources->maxAllowedEating, &allowedEating);
-        logServerState(sharedResources->logsQueueId, "Le philosophe %d s'ajoute au compteur (dispo restante : %d)\n", philosopher.id, allowedEating);
-        
-        // Une fois le premier sémaphore pris, on vérifie les deux baguettes
-
-        // On vérifie une première baguette (non bloquant)
-        // Si ça ne passe on log que le philosophe patiente et il est mis en attente
-        if (sem_trywait(&serverPhilosopher->leftChopstick->usage) == -1 && (errno == EAGAIN)) {
-            logServerState(sharedResources->logsQueueId, "Le philosophe %d attend que la baguette %d à sa gauche se libère\n", philosopher.id, serverPhilosopher->leftChopstick->id);
-            logClientInfo(sharedResources->logsQueueId, "En attente de la baguette gauche...\n");
-            sem_wait(&serverPhilosopher->leftChopstick->usage);
-        }
-        
-      
-        logServerState(sharedResources->logsQueueId, "Le philosophe %d prend la baguette %d à sa gauche\n", philosopher.id, serverPhilosopher->leftChopstick->id);
-
-
-        // On vérifie la seconde baguette (non bloquant)
-        // Si ça ne passe on log que le philosophe patiente et il est mis en attente
-        if (sem_trywait(&serverPhilosopher->rightChopstick->usage) == -1 && (errno == EAGAIN)) {
-            logServerState(sharedResources->logsQueueId, "Le philosophe %d attend que la baguette %d à sa droite se libère\n", philosopher.id, serverPhilosopher->rightChopstick->id);
-            logClientInfo(sharedResources->logsQueueId, "En attente de la baguette droite...\n");
-            sem_wait(&serverPhilosopher->rightChopstick->usage);
-        }
-        
-        logServerState(sharedResources->logsQueueId, "Le philosophe %d prend la baguette %d à sa droite\n", philosopher.id, serverPhilosopher->rightChopstick->id);
+            serverPhilosopher->heldAdmission = true;
+
+            int allowedEating;
+            sem_getvalue(&sharedResources->maxAllowedEating, &allowedEating);
+            logServerState(sharedResources->logsQueueId, "Le philosophe %d s'ajoute au compteur (dispo restante : %d)\n", philosopher.id, allowedEating);
+            markPerfStage(PERF_STAGE_ADMISSION);
+            markRequestSpan(SPAN_ADMITTED);
+
+            // Une fois le premier sémaphore pris, on vérifie les deux baguettes, gauche puis droite
+            acquireChopstick(serverPhilosopher, serverPhilosopher->leftChopstick, "gauche", sharedResources);
+            acquireChopstick(serverPhilosopher, serverPhilosopher->rightChopstick, "droite", sharedResources);
+        }
+
+        else if (policy == POLICY_SEQUENCED) {
+            uint32_t seen = __atomic_load_n(&serverPhilosopher->coreGrants, __ATOMIC_ACQUIRE);
+            publishTableEvent(&sharedResources->tableCore, TABLE_EVENT_HUNGRY, philosopher.id);
+            markPerfStage(PERF_STAGE_ADMISSION);
+            markRequestSpan(SPAN_ADMITTED);
+
+            // Le cœur accorde les deux baguettes ensemble, une fois le repas consigné dans le registre
+            waitTableGrant(&sharedResources->tableCore, serverPhilosopher, seen);
+            markRequestSpan(SPAN_LEFT_ACQUIRED);
+            markRequestSpan(SPAN_RIGHT_ACQUIRED);
+        }
+
+        else {
+            markPerfStage(PERF_STAGE_ADMISSION);
+            markRequestSpan(SPAN_ADMITTED);
+
+            // Hiérarchie des ressources : la baguette de plus petit identifiant d'abord
+            if (serverPhilosopher->leftChopstick->id < serverPhilosopher->rightChopstick->id) {
+                acquireChopstick(serverPhilosopher, serverPhilosopher->leftChopstick, "gauche", sharedResources);
+                acquireChopstick(serverPhilosopher, serverPhilosopher->rightChopstick, "droite", sharedResources);
+            } else {
+                acquireChopstick(serverPhilosopher, serverPhilosopher->rightChopstick, "droite", sharedResources);
+                acquireChopstick(serverPhilosopher, serverPhilosopher->leftChopstick, "gauche", sharedResources);
+            }
+        }
+
+        markPerfGrant();
+        pthread_rwlock_unlock(&sharedResources->policyLock);
 
         // Ensuite on peut passer à l'état EATING et envoyer la réponse au client qui attend une réponse
         serverPhilosopher->base.state = EATING;
         serverPhilosopher->base.stateTimer = 0;
+        recordGrant(serverPhilosopher, &sharedResources->statistics);
+        uint64_t sequence = policy == POLICY_SEQUENCED
+            ? serverPhilosopher->grantLedgerSequence
+            : appendLedgerRecord(&sharedResources->ledger, LEDGER_GRANT, philosopher.id, serverPhilosopher->leftChopstick->id, serverPhilosopher->rightChopstick->id);
+        notifyPhilosopherChange(serverPhilosopher, sharedResources);
+
+        // Durabilité facultative : le repas n'est annoncé au client qu'une fois consigné sur disque
+        if (sharedResources->ledger.syncGrants) {
+            waitLedgerDurable(&sharedResources->ledger, sequence);
+        }
 
-        return serverPhilosopher;
+        return true;
     }
 
-    return NULL;
+    return false;
+}
+
+/**
+ * @brief Met à jour l'état d'un philosophe côté serveur.
+ *
+ * La place du philosophe est tenue pendant toute la mise à jour, attente de ses baguettes comprise : le compactage
+ * ne peut pas la déplacer (voir updatePinnedPhilosopher()).
+ *
+ * @param philosopher La structure `Philosopher` contenant le nouvel état du philosophe.
+ * @param sharedResources Pointeur vers la structure des ressources partagées.
+ * @param updated Reçoit l'état du philosophe si une réponse doit être renvoyée au client ; peut être NULL.
+ * @return bool true si une réponse doit être renvoyée au client (repas accordé).
+ */
+bool updatePhilosopher(Philosopher philosopher, SharedResources *sharedResources, Philosopher *updated) {
+    ServerPhilosopher *serverPhilosopher = pinPhilosopher(philosopher.id, sharedResources);
+    markPerfStage(PERF_STAGE_LOOKUP);
+    markRequestSpan(SPAN_SEAT_FOUND);
+
+    if (!serverPhilosopher) {
+        logClientInfo(sharedResources->logsQueueId, "Erreur, le philosophe à mettre à jour est introuvable dans la mémoire partagée.\n");
+        return false;
+    }
+
+    bool respond = updatePinnedPhilosopher(serverPhilosopher, philosopher, sharedResources);
+
+    if (respond && updated) {
+        *updated = serverPhilosopher->base;
+    }
+
+    unpinPhilosopher(serverPhilosopher);
+    return respond;
+}
+
+/**
+ * @brief Retire un philosophe évincé de la table.
+ *
+ * Le philosophe libère d'abord ce qu'il tient, puis l'anneau est refermé : la baguette droite du philosophe devient
+ * la baguette droite de son voisin de gauche, une fois l'ancienne (la baguette gauche du philosophe) libérée. Si le
+ * voisin se retrouve seul, il n'a plus de baguette droite et patientera jusqu'à l'arrivée d'un autre philosophe.
+ * Enfin, si le nombre de philosophes à table devient impair, une place du compteur est retirée.
+ *
+ * Aucune attente bloquante n'a lieu sous le verrou de la politique ou le sémaphore de création : si le voisin de
+ * gauche mange avec l'ancienne baguette, les deux sont rendus et le retrait est retenté un peu plus tard ; si aucune
+ * place du compteur n'est libre, elle est attendue une fois les deux rendus.
+ *
+ * Le philosophe est seulement marqué comme parti : sa place et sa baguette seront effacées par le compactage (voir
+ * Compaction.h). Un philosophe déjà parti ou introuvable est ignoré.
+ *
+ * @param id L'identifiant du philosophe à retirer.
+ * @param sharedResources Pointeur vers la structure des ressources partagées.
+ */
+void leaveTable(int id, SharedResources *sharedResources) {
+    ServerPhilosopher *serverPhilosopher = pinPhilosopher(id, sharedResources);
+
+    if (!serverPhilosopher) {
+        return;
+    }
+
+    bool released = false;
+    ServerPhilosopher *previousPhilosopher;
+    Chopstick *previousPhilosopherOldRightChopstick = NULL;
+
+    while (1) {
+        sem_wait(&sharedResources->philosopherCreationProcess);
+
+        if (serverPhilosopher->departed) {
+            sem_post(&sharedResources->philosopherCreationProcess);
+            unpinPhilosopher(serverPhilosopher);
+            return;
+        }
+
+        if (serverPhilosopher->base.state == EATING && !released) {
+            releaseChopsticks(serverPhilosopher, sharedResources);
+            released = true;
+        }
+
+        // Modification de l'anneau : aucune prise de baguettes ne doit être en cours
+        pthread_rwlock_wrlock(&sharedResources->policyLock);
+
+        previousPhilosopher = getPreviousPhilosopher(serverPhilosopher, sharedResources);
+        previousPhilosopherOldRightChopstick = previousPhilosopher ? previousPhilosopher->rightChopstick : NULL;
+
+        if (!previousPhilosopherOldRightChopstick || sem_trywait(&previousPhilosopherOldRightChopstick->usage) == 0) {
+            break;
+        }
+
+        // Le voisin mange avec la baguette à détacher : les verrous sont rendus, la table continue pendant son repas
+        pthread_rwlock_unlock(&sharedResources->policyLock);
+        sem_post(&sharedResources->philosopherCreationProcess);
+        usleep(1000);
+    }
+
+    if (previousPhilosopherOldRightChopstick) {
+
+        bool aloneAfter = previousPhilosopher->leftChopstick == serverPhilosopher->rightChopstick;
+        previousPhilosopher->rightChopstick = aloneAfter ? NULL : serverPhilosopher->rightChopstick;
+
+        sem_post(&previousPhilosopherOldRightChopstick->usage);
+
+        logServerState(
+            sharedResources->logsQueueId,
+            "Le philosophe %d quitte la table, le philosophe %d prend la baguette %d à sa droite\n",
+            serverPhilosopher->base.id,
+            previousPhilosopher->base.id,
+            aloneAfter ? 0 : serverPhilosopher->rightChopstick->id
+        );
+    } else {
+        logServerState(sharedResources->logsQueueId, "Le philosophe %d quitte la table\n", serverPhilosopher->base.id);
+    }
+
+    serverPhilosopher->departed = true;
+    serverPhilosopher->departedAt = getMonotonicTime();
+    serverPhilosopher->hungrySince = 0;
+    sharedResources->numberSeated -= 1;
+    notifyPhilosopherChange(serverPhilosopher, sharedResources);
+
+    bool sequenced = sharedResources->policy == POLICY_SEQUENCED;
+
+    pthread_rwlock_unlock(&sharedResources->policyLock);
+
+    if (sequenced) {
+        publishTableEvent(&sharedResources->tableCore, TABLE_EVENT_LEAVE, serverPhilosopher->base.id);
+    }
+
+    // Un philosophe sur deux peut manger : retrait d'une place si le nombre de philosophes devient impair. Si toutes
+    // sont prises, elle est retirée après avoir rendu le sémaphore de création, à la fin d'un repas
+    bool admissionPending = sharedResources->numberSeated % 2 == 1 && sem_trywait(&sharedResources->maxAllowedEating) == -1;
+
+    sem_post(&sharedResources->philosopherCreationProcess);
+    unpinPhilosopher(serverPhilosopher);
+
+    if (admissionPending) {
+        while (sem_wait(&sharedResources->maxAllowedEating) == -1 && errno == EINTR);
+    }
 }
 
-#endif
\ No newline at end of file
+#endif
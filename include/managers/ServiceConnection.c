@@ -0,0 +1,177 @@
+/**
+ * @file ServiceConnection.c
+ * @brief Implémente la lecture par lots des requêtes et l'envoi groupé des réponses d'une connexion client.
+ *
+ * Le fonctionnement des tampons est décrit dans ServiceConnection.h. Une requête peut arriver en plusieurs
+ * morceaux : seules les requêtes complètes sont décodées, le reste est conservé jusqu'à la lecture suivante.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **initServiceConnection()** : Initialise une connexion et ses tampons.
+ *  - **fillConnectionInput()** : Lit dans le tampon d'entrée tout ce que le socket peut fournir.
+ *  - **nextRequest()** : Décode sans copie la prochaine requête complète du tampon d'entrée.
+ *  - **flushResponses()** : Envoie les réponses en attente, suivies d'éventuelles données supplémentaires.
+ *  - **queueOutput()** : Ajoute des données au tampon de sortie.
+ *  - **queueResponse()** : Ajoute une réponse au tampon de sortie.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/ServiceConnection.h" pour la définition de la connexion.
+ *  - "Request.c" pour le décodage des requêtes.
+ *  - <sys/uio.h> pour writev(), <unistd.h> pour read(), <string.h> et <errno.h>.
+ */
+
+#ifndef SERVICE_CONNECTION_C
+#define SERVICE_CONNECTION_C
+
+#include "../entities/ServiceConnection.h"
+#include "Request.c"
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+/**
+ * @brief Initialise une connexion et ses tampons.
+ *
+ * @param connection La connexion.
+ * @param socket Le socket de service.
+ */
+void initServiceConnection(ServiceConnection *connection, int socket) {
+    connection->socket = socket;
+    connection->inputStart = 0;
+    connection->inputLength = 0;
+    connection->outputLength = 0;
+}
+
+/**
+ * @brief Lit dans le tampon d'entrée tout ce que le socket peut fournir, en un seul appel.
+ *
+ * Le morceau de requête incomplète éventuellement restant est d'abord ramené au début du tampon.
+ *
+ * @param connection La connexion.
+ * @return ssize_t Le nombre d'octets lus, 0 si le client a coupé la connexion, -1 en cas d'erreur.
+ */
+ssize_t fillConnectionInput(ServiceConnection *connection) {
+    size_t remaining = connection->inputLength - connection->inputStart;
+    memmove(connection->input, connection->input + connection->inputStart, remaining);
+    connection->inputStart = 0;
+    connection->inputLength = remaining;
+
+    ssize_t bytesReceived;
+
+    do {
+        bytesReceived = read(connection->socket, connection->input + remaining, sizeof(connection->input) - remaining);
+    } while (bytesReceived == -1 && errno == EINTR);
+
+    if (bytesReceived > 0) {
+        connection->inputLength += bytesReceived;
+    }
+
+    return bytesReceived;
+}
+
+/**
+ * @brief Décode la prochaine requête complète du tampon d'entrée.
+ *
+ * La requête n'est pas copiée : elle reste valable dans le tampon jusqu'au prochain appel à fillConnectionInput().
+ *
+ * @param connection La connexion.
+ * @param request Reçoit un pointeur vers la requête, dans le tampon d'entrée.
+ * @return int 1 si une requête valide a été décodée, 0 si le tampon ne contient plus de requête complète, -1 si la
+ * requête est invalide (type inconnu ou contenu incohérent).
+ */
+int nextRequest(ServiceConnection *connection, const Request **request) {
+    int decoded = decodeRequest(connection->input + connection->inputStart, connection->inputLength - connection->inputStart, request);
+
+    if (decoded == 1) {
+        connection->inputStart += sizeof(Request);
+    }
+
+    return decoded;
+}
+
+/**
+ * @brief Envoie les réponses en attente, suivies d'éventuelles données supplémentaires, en un seul writev().
+ *
+ * writev() peut n'écrire qu'une partie des données (socket plein) : l'envoi reprend alors là où il s'est arrêté.
+ *
+ * @param connection La connexion.
+ * @param extra Données à envoyer après les réponses (un instantané par exemple), ou NULL.
+ * @param extraSize Taille des données supplémentaires.
+ * @return bool false si le client a coupé la connexion ou en cas d'erreur d'envoi.
+ */
+bool flushResponses(ServiceConnection *connection, const void *extra, size_t extraSize) {
+    struct iovec message[2] = {
+        { .iov_base = connection->output, .iov_len = connection->outputLength },
+        { .iov_base = (void *) extra, .iov_len = extra ? extraSize : 0 }
+    };
+
+    connection->outputLength = 0;
+
+    int index = message[0].iov_len == 0;
+
+    while (index < 2 && message[index].iov_len > 0) {
+        ssize_t bytesSent = writev(connection->socket, &message[index], 2 - index);
+
+        if (bytesSent == -1 && errno == EINTR) {
+            continue;
+        }
+
+        if (bytesSent <= 0) {
+            return false;
+        }
+
+        while (index < 2 && (size_t) bytesSent >= message[index].iov_len) {
+            bytesSent -= message[index].iov_len;
+            index++;
+        }
+
+        if (index < 2) {
+            message[index].iov_base = (char *) message[index].iov_base + bytesSent;
+            message[index].iov_len -= bytesSent;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Ajoute des données au tampon de sortie ; elles seront envoyées à la fin du lot.
+ *
+ * Si le tampon ne peut pas les contenir, il est vidé d'abord ; des données plus grandes que le tampon sont envoyées
+ * aussitôt, dans le même writev() que les réponses qui les précèdent.
+ *
+ * @param connection La connexion.
+ * @param data Les données.
+ * @param size Taille des données.
+ * @return bool false si le client a coupé la connexion ou en cas d'erreur d'envoi.
+ */
+bool queueOutput(ServiceConnection *connection, const void *data, size_t size) {
+    if (connection->outputLength + size > sizeof(connection->output)) {
+        if (size > sizeof(connection->output)) {
+            return flushResponses(connection, data, size);
+        }
+
+        if (!flushResponses(connection, NULL, 0)) {
+            return false;
+        }
+    }
+
+    memcpy(connection->output + connection->outputLength, data, size);
+    connection->outputLength += size;
+
+    return true;
+}
+
+/**
+ * @brief Ajoute une réponse au tampon de sortie ; elle sera envoyée à la fin du lot.
+ *
+ * @param connection La connexion.
+ * @param response La réponse.
+ * @return bool false si le tampon était plein et n'a pas pu être vidé.
+ */
+bool queueResponse(ServiceConnection *connection, Response response) {
+    return queueOutput(connection, &response, sizeof(response));
+}
+
+#endif
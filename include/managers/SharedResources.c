@@ -3,7 +3,10 @@
  * @brief Implémente la fonction d'attachement et d'initialisation des ressources partagées.
  *
  * Ce fichier d'implémentation fournit la fonction `attachSharedResources` qui permet d'attacher un segment
- * de mémoire partagée contenant la structure `SharedResources` et d'initialiser ses champs aux valeurs par défaut.
+ * de mémoire partagée contenant la structure `SharedResources` et d'initialiser ses champs aux valeurs par défaut,
+ * ainsi que la fonction `getSharedResourcesKey` qui retourne la clé nommée du segment. La fonction
+ * `reattachSharedResources` reprend quant à elle le segment d'un serveur en fonctionnement, sans l'initialiser, et
+ * `preallocateSharedResources` initialise à l'avance toutes les places de la table.
  *
  * La fonction effectue les opérations suivantes :
  *  - Attache le segment de mémoire partagée identifié par `sharedResourcesMemoryId` en utilisant `shmat`.
@@ -11,13 +14,24 @@
  *  - Initialise le sémaphore `philosopherCreationProcess` à 1, afin de sécuriser la création concurrente des philosophes.
  *  - Réinitialise les compteurs de philosophes (`numberPhilosophers`) et de baguettes (`numberChopsticks`) à 0.
  *  - Initialise l'identifiant de la file de logs (`logsQueueId`) à 0.
+ *  - Remet à zéro les statistiques de la table et les durées des étapes des repas (voir RequestSpan.h).
+ *  - Initialise les réglages modifiables à chaud (capacité, politique d'arbitrage et son verrou, niveau de logs).
+ *  - Étalonne l'horloge à haute résolution (voir Clock.h).
+ *  - Arrête le profileur, à sa fréquence par défaut (voir Profiler.h), et les compteurs matériels (voir PerfCounters.h).
+ *
+ * Les tableaux des philosophes et des baguettes ne sont pas parcourus : le segment, créé à zéro, n'est réellement
+ * alloué qu'au fil des pages touchées par les philosophes qui arrivent. Le démarrage ne dépend donc pas de
+ * MAX_PHILOSOPHERS.
  *
  * Les inclusions nécessaires dans ce fichier sont :
  *  - "../entities/SharedResources.h" pour la définition de la structure `SharedResources`.
+ *  - "../managers/Clock.c" pour l'étalonnage de l'horloge.
  *  - <stdlib.h> pour les fonctions de la bibliothèque standard.
  *  - <math.h> pour les fonctions mathématiques (bien que non utilisées directement dans cette fonction).
  *  - <sys/shm.h> pour la gestion de la mémoire partagée.
  *  - <string.h> pour les opérations sur la mémoire.
+ *  - <sys/ipc.h> pour la génération de la clé avec `ftok`.
+ *  - <pthread.h> et <unistd.h> pour les threads de préallocation et le nombre de cœurs.
  *
  */
 
@@ -25,10 +39,27 @@
 #define SHAREDRESOURCES_C
 
 #include "../entities/SharedResources.h"
+#include "../managers/Clock.c"
 #include <stdlib.h>
 #include <math.h>
 #include <sys/shm.h>
 #include <string.h>
+#include <sys/ipc.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <stdbool.h>
+
+/**
+ * @brief Retourne la clé nommée du segment de mémoire partagée.
+ *
+ * La clé est dérivée du dossier des logs : le serveur et les outils d'observation lancés depuis le dossier src
+ * obtiennent ainsi la même clé sans avoir à se communiquer l'identifiant du segment.
+ *
+ * @return key_t La clé du segment, ou -1 si le dossier des logs est introuvable.
+ */
+key_t getSharedResourcesKey() {
+    return ftok(SHARED_RESOURCES_KEY_PATH, SHARED_RESOURCES_KEY_ID);
+}
 
 /**
  * @brief Attache et initialise les ressources partagées.
@@ -50,9 +81,168 @@ SharedResources *attachSharedResources(int sharedResourcesMemoryId) {
     sem_init(&sharedResources->philosopherCreationProcess, 1, 1);
     sharedResources->numberPhilosophers = 0;
     sharedResources->numberChopsticks = 0;
+    sharedResources->lastPhilosopherId = 0;
+    memset(&sharedResources->compaction, 0, sizeof(CompactionStats));
+    memset(&sharedResources->migration, 0, sizeof(MigrationState));
+    sharedResources->migration.enabled = true;
+    memset(&sharedResources->workerPool, 0, sizeof(WorkerPoolState));
+    sharedResources->workerPool.minWorkers = WORKER_POOL_DEFAULT_MIN;
+    sharedResources->workerPool.maxWorkers = WORKER_POOL_DEFAULT_MAX;
+    sharedResources->workerPool.idleTimeoutMs = WORKER_POOL_DEFAULT_IDLE_TIMEOUT_MS;
+    sharedResources->workerPool.growLatencyMs = WORKER_POOL_DEFAULT_GROW_LATENCY_MS;
     sharedResources->logsQueueId = 0;
+    memset(&sharedResources->statistics, 0, sizeof(TableStatistics));
+    sharedResources->numberSeated = 0;
+    sharedResources->capacity = MAX_PHILOSOPHERS;
+    sharedResources->policy = POLICY_COUNTER;
+    sharedResources->logLevel = LOG_LEVEL_ALL;
+    calibrateClock(&sharedResources->clock);
+    memset(&sharedResources->profiler, 0, sizeof(ProfilerState));
+    sharedResources->profiler.frequency = PROFILER_DEFAULT_FREQUENCY;
+    memset(&sharedResources->perf, 0, sizeof(PerfCounterState));
+    memset(&sharedResources->spans, 0, sizeof(SpanStatistics));
+    memset(&sharedResources->tableCore, 0, sizeof(TableCore));
+    sharedResources->tableCore.cpu = -1;
+    sharedResources->structureSize = sizeof(SharedResources);
+
+    // Verrou partagé entre processus, qui donne la priorité au changement de politique sur les nouvelles prises
+    pthread_rwlockattr_t policyLockAttributes;
+    pthread_rwlockattr_init(&policyLockAttributes);
+    pthread_rwlockattr_setpshared(&policyLockAttributes, PTHREAD_PROCESS_SHARED);
+#ifdef _GNU_SOURCE
+    pthread_rwlockattr_setkind_np(&policyLockAttributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    pthread_rwlock_init(&sharedResources->policyLock, &policyLockAttributes);
+    pthread_rwlockattr_destroy(&policyLockAttributes);
     
     return sharedResources;
 }
 
+/**
+ * @brief Attache les ressources partagées d'un serveur déjà en fonctionnement, sans les initialiser.
+ *
+ * Utilisée par un nouveau binaire du serveur lors d'une mise à jour à chaud : le segment est retrouvé par sa clé
+ * nommée, et l'état de la table (philosophes, baguettes, sémaphores, statistiques) est repris tel quel.
+ *
+ * Le segment est attaché à l'adresse qu'il avait dans l'ancien binaire : les places pointent vers leurs baguettes,
+ * et ces pointeurs sont partagés avec les processus de service forkés avant la mise à jour.
+ *
+ * @param sharedResourcesMemoryId Reçoit l'identifiant du segment.
+ * @param address L'adresse du segment dans l'ancien binaire.
+ * @return SharedResources* Pointeur vers les ressources attachées, ou NULL si le segment est introuvable, ne peut pas
+ *         être attaché à la même adresse, ou a été créé par un serveur dont la structure diffère.
+ */
+SharedResources *reattachSharedResources(int *sharedResourcesMemoryId, void *address) {
+    *sharedResourcesMemoryId = shmget(getSharedResourcesKey(), 0, 0);
+
+    if (*sharedResourcesMemoryId == -1) {
+        return NULL;
+    }
+
+    SharedResources *sharedResources = (SharedResources *) shmat(*sharedResourcesMemoryId, address, 0);
+
+    if (sharedResources == (void *) -1) {
+        return NULL;
+    }
+
+    if (sharedResources != address) {
+        shmdt(sharedResources);
+        return NULL;
+    }
+
+    if (sharedResources->structureSize != sizeof(SharedResources)) {
+        shmdt(sharedResources);
+        return NULL;
+    }
+
+    return sharedResources;
+}
+
+/**
+ * @brief Tranche de places initialisée par un thread de préallocation.
+ */
+typedef struct {
+    SharedResources *sharedResources; /**< Les ressources partagées */
+    int first;                        /**< Index de la première place */
+    int last;                         /**< Index suivant la dernière place */
+} PreallocationRange;
+
+/**
+ * @brief Routine d'un thread de préallocation : initialise les baguettes d'une tranche et touche ses places.
+ *
+ * @param arg Pointeur vers la `PreallocationRange`.
+ * @return void* Toujours NULL.
+ */
+void *preallocateSeats(void *arg) {
+    PreallocationRange *range = (PreallocationRange *) arg;
+    SharedResources *sharedResources = range->sharedResources;
+
+    for (int i = range->first; i < range->last; i++) {
+        Chopstick *chopstick = &sharedResources->chopsticks[i];
+
+        chopstick->holderId = 0;
+        sem_init(&chopstick->usage, 1, 1);
+        chopstick->id = i + 1;
+    }
+
+    memset(&sharedResources->philosophers[range->first], 0, (range->last - range->first) * sizeof(ServerPhilosopher));
+
+    return NULL;
+}
+
+/**
+ * @brief Initialise à l'avance toutes les places de la table.
+ *
+ * Les baguettes reçoivent leur identifiant et leur sémaphore, et les pages des philosophes sont touchées, par
+ * tranches réparties entre un thread par cœur (au plus PREALLOCATE_MAX_THREADS, et pas plus d'un thread par
+ * PREALLOCATE_MIN_SEATS_PER_THREAD places). createChopstick() reconnaît ensuite une baguette déjà initialisée à son
+ * identifiant non nul. Une tranche qui n'a pas pu être confiée à un thread est initialisée par le thread appelant.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées, tout juste attachées.
+ * @return int Le nombre de threads utilisés.
+ */
+int preallocateSharedResources(SharedResources *sharedResources) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int numberThreads = MAX_PHILOSOPHERS / PREALLOCATE_MIN_SEATS_PER_THREAD;
+
+    if (numberThreads > cores) {
+        numberThreads = (int) cores;
+    }
+    if (numberThreads > PREALLOCATE_MAX_THREADS) {
+        numberThreads = PREALLOCATE_MAX_THREADS;
+    }
+    if (numberThreads < 1) {
+        numberThreads = 1;
+    }
+
+    pthread_t threads[PREALLOCATE_MAX_THREADS];
+    bool started[PREALLOCATE_MAX_THREADS];
+    PreallocationRange ranges[PREALLOCATE_MAX_THREADS];
+
+    for (int i = 0; i < numberThreads; i++) {
+        ranges[i] = (PreallocationRange) {
+            .sharedResources = sharedResources,
+            .first = (int) ((long long) MAX_PHILOSOPHERS * i / numberThreads),
+            .last = (int) ((long long) MAX_PHILOSOPHERS * (i + 1) / numberThreads)
+        };
+
+        // La première tranche revient au thread appelant
+        started[i] = i > 0 && pthread_create(&threads[i], NULL, preallocateSeats, &ranges[i]) == 0;
+    }
+
+    for (int i = 0; i < numberThreads; i++) {
+        if (!started[i]) {
+            preallocateSeats(&ranges[i]);
+        }
+    }
+
+    for (int i = 1; i < numberThreads; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    return numberThreads;
+}
+
 #endif
\ No newline at end of file
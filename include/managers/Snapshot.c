@@ -0,0 +1,237 @@
+/**
+ * @file Snapshot.c
+ * @brief Implémente la prise et le décodage des instantanés de la table.
+ *
+ * Le format des instantanés est décrit dans Snapshot.h. La prise se fait en deux temps : une copie brute des
+ * valeurs, courte, validée par le numéro de version de la table, puis le codage compact de cette copie, qui ne
+ * touche plus la mémoire partagée.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **getSnapshotMaxSize()** : Taille maximale d'un instantané codé.
+ *  - **takeSnapshot()** : Prend et code un instantané de la table.
+ *  - **getSnapshotChopstickBase()** : Référence du codage de l'identifiant d'une baguette.
+ *  - **decodeSnapshot()** : Décode le corps d'un instantané.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Snapshot.h", "../entities/Watch.h" et "../entities/SharedResources.h" pour le format et la table.
+ *  - "../utils/varint.h" pour le codage des entiers.
+ *  - "Arena.c" pour l'arène dans laquelle l'instantané est copié et codé.
+ *  - <semaphore.h> pour la lecture du compteur.
+ */
+
+#ifndef SNAPSHOT_C
+#define SNAPSHOT_C
+
+#include "../maxmin_philosophers.h"
+#include "../entities/Snapshot.h"
+#include "../entities/Watch.h"
+#include "../entities/SharedResources.h"
+#include "../utils/varint.h"
+#include "Arena.c"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <semaphore.h>
+
+/**
+ * @brief Retourne la taille maximale d'un instantané codé, en-tête compris.
+ *
+ * @param numberSeats Nombre de places.
+ * @param numberChopsticks Nombre de baguettes.
+ * @return size_t La taille maximale en octets.
+ */
+size_t getSnapshotMaxSize(int numberSeats, int numberChopsticks) {
+    return sizeof(SnapshotHeader) + (numberSeats + 3) / 4 + (size_t) (numberSeats + numberChopsticks) * 2 * VARINT_MAX_SIZE;
+}
+
+/**
+ * @brief Retourne la valeur dont l'identifiant d'une baguette est codé par écart : l'identifiant de la place de même
+ * rang, ou celui de la baguette précédente au-delà des places.
+ *
+ * @param ids Identifiants des places.
+ * @param chopstickIds Identifiants des baguettes précédentes.
+ * @param numberSeats Nombre de places.
+ * @param index Rang de la baguette.
+ * @return int La valeur de référence.
+ */
+int getSnapshotChopstickBase(const int *ids, const int *chopstickIds, int numberSeats, int index) {
+    if (index < numberSeats) {
+        return ids[index];
+    }
+    return index > 0 ? chopstickIds[index - 1] : 0;
+}
+
+/**
+ * @brief Prend un instantané de la table et le code.
+ *
+ * La copie brute et l'instantané sont pris dans une arène. La copie est rendue dès l'instantané codé : il est
+ * ramené à la position de l'arène relevée à l'entrée, et seul l'instantané reste distribué. L'appelant le rend à
+ * son tour (resetArena() avec cette position) une fois envoyé ou copié.
+ *
+ * Un compactage (voir Compaction.h) ou un échange de places (voir Migration.h) incrémente la version de la table et
+ * l'époque des déplacements avant et après ses déplacements : une copie qui le chevauche, ou qui commence pendant
+ * (époque impaire), n'est pas validée.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @param arena L'arène dans laquelle coder l'instantané.
+ * @param size Reçoit la taille de l'instantané (en-tête compris).
+ * @return uint8_t* L'instantané, ou NULL si l'arène est absente ou pleine (elle est alors laissée comme à l'entrée).
+ */
+uint8_t *takeSnapshot(SharedResources *sharedResources, Arena *arena, size_t *size) {
+    size_t mark = arena ? arena->used : 0;
+    uint8_t *states = arena ? arenaAlloc(arena, MAX_PHILOSOPHERS) : NULL;
+    int *timers = arena ? arenaAlloc(arena, sizeof(int) * MAX_PHILOSOPHERS) : NULL;
+    int *holders = arena ? arenaAlloc(arena, sizeof(int) * MAX_PHILOSOPHERS) : NULL;
+    int *ids = arena ? arenaAlloc(arena, sizeof(int) * MAX_PHILOSOPHERS) : NULL;
+    int *chopstickIds = arena ? arenaAlloc(arena, sizeof(int) * MAX_PHILOSOPHERS) : NULL;
+    int numberSeats = 0;
+    int numberChopsticks = 0;
+    uint64_t version = 0;
+    uint64_t epoch = 0;
+    bool consistent = false;
+
+    if (!states || !timers || !holders || !ids || !chopstickIds) {
+        if (arena) {
+            resetArena(arena, mark);
+        }
+
+        return NULL;
+    }
+
+    for (int attempt = 0; attempt < SNAPSHOT_MAX_ATTEMPTS && !consistent; attempt++) {
+        epoch = __atomic_load_n(&sharedResources->compaction.epoch, __ATOMIC_ACQUIRE);
+        version = __atomic_load_n(&sharedResources->tableVersion, __ATOMIC_ACQUIRE);
+        numberSeats = sharedResources->numberPhilosophers;
+        numberChopsticks = sharedResources->numberChopsticks;
+
+        for (int i = 0; i < numberSeats; i++) {
+            ServerPhilosopher *philosopher = &sharedResources->philosophers[i];
+            states[i] = philosopher->departed ? WATCH_STATE_DEPARTED : philosopher->base.state;
+            timers[i] = philosopher->base.stateTimer;
+            ids[i] = philosopher->base.id;
+        }
+
+        for (int i = 0; i < numberChopsticks; i++) {
+            holders[i] = sharedResources->chopsticks[i].holderId;
+            chopstickIds[i] = sharedResources->chopsticks[i].id;
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        consistent = epoch % 2 == 0
+            && __atomic_load_n(&sharedResources->tableVersion, __ATOMIC_RELAXED) == version
+            && __atomic_load_n(&sharedResources->compaction.epoch, __ATOMIC_RELAXED) == epoch;
+    }
+
+    uint8_t *snapshot = arenaAlloc(arena, getSnapshotMaxSize(numberSeats, numberChopsticks));
+
+    if (!snapshot) {
+        resetArena(arena, mark);
+        return NULL;
+    }
+
+    SnapshotHeader *header = (SnapshotHeader *) snapshot;
+    uint8_t *body = snapshot + sizeof(SnapshotHeader);
+    size_t length = (numberSeats + 3) / 4;
+    memset(body, 0, length);
+
+    for (int i = 0; i < numberSeats; i++) {
+        body[i / 4] |= (states[i] & 3) << (2 * (i % 4));
+    }
+
+    for (int i = 0; i < numberSeats; i++) {
+        length += writeVarint(body + length, zigzagEncode(ids[i] - (i > 0 ? ids[i - 1] : 0)));
+    }
+
+    for (int i = 0; i < numberChopsticks; i++) {
+        length += writeVarint(body + length, zigzagEncode(chopstickIds[i] - getSnapshotChopstickBase(ids, chopstickIds, numberSeats, i)));
+    }
+
+    for (int i = 0; i < numberSeats; i++) {
+        length += writeVarint(body + length, zigzagEncode(timers[i]));
+    }
+
+    for (int i = 0; i < numberChopsticks; i++) {
+        uint64_t holder = holders[i] == 0 ? 0 : zigzagEncode(holders[i] - chopstickIds[i]) + 1;
+        length += writeVarint(body + length, holder);
+    }
+
+    int admissionAvailable;
+    sem_getvalue(&sharedResources->maxAllowedEating, &admissionAvailable);
+
+    *header = (SnapshotHeader) {
+        .tableVersion = version,
+        .length = length,
+        .numberSeats = numberSeats,
+        .numberChopsticks = numberChopsticks,
+        .admissionAvailable = admissionAvailable,
+        .policy = sharedResources->policy,
+        .consistent = consistent,
+        .reserved = 0
+    };
+
+    *size = sizeof(SnapshotHeader) + length;
+
+    // La copie brute n'est plus utile : l'instantané prend sa place
+    memmove(arena->base + mark, snapshot, *size);
+    resetArena(arena, mark + alignArenaSize(*size));
+    return arena->base + mark;
+}
+
+/**
+ * @brief Décode le corps d'un instantané.
+ *
+ * @param header L'en-tête de l'instantané.
+ * @param body Le corps, de header->length octets.
+ * @param ids Reçoit l'identifiant de chaque place (header->numberSeats valeurs).
+ * @param chopstickIds Reçoit l'identifiant de chaque baguette (header->numberChopsticks valeurs).
+ * @param states Reçoit l'état de chaque place (header->numberSeats valeurs).
+ * @param timers Reçoit le timer de chaque place (header->numberSeats valeurs).
+ * @param holders Reçoit le détenteur de chaque baguette, 0 si elle est libre (header->numberChopsticks valeurs).
+ * @return bool false si le corps est tronqué ou invalide.
+ */
+bool decodeSnapshot(const SnapshotHeader *header, const uint8_t *body, int *ids, int *chopstickIds, uint8_t *states, int *timers, int *holders) {
+    size_t offset = (header->numberSeats + 3) / 4;
+
+    if (offset > header->length) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header->numberSeats; i++) {
+        states[i] = (body[i / 4] >> (2 * (i % 4))) & 3;
+    }
+
+    uint64_t value;
+
+    for (uint32_t i = 0; i < header->numberSeats; i++) {
+        if (!readVarint(body, header->length, &offset, &value)) {
+            return false;
+        }
+        ids[i] = (int) ((i > 0 ? ids[i - 1] : 0) + zigzagDecode(value));
+    }
+
+    for (uint32_t i = 0; i < header->numberChopsticks; i++) {
+        if (!readVarint(body, header->length, &offset, &value)) {
+            return false;
+        }
+        chopstickIds[i] = (int) (getSnapshotChopstickBase(ids, chopstickIds, header->numberSeats, i) + zigzagDecode(value));
+    }
+
+    for (uint32_t i = 0; i < header->numberSeats; i++) {
+        if (!readVarint(body, header->length, &offset, &value)) {
+            return false;
+        }
+        timers[i] = (int) zigzagDecode(value);
+    }
+
+    for (uint32_t i = 0; i < header->numberChopsticks; i++) {
+        if (!readVarint(body, header->length, &offset, &value)) {
+            return false;
+        }
+        holders[i] = value == 0 ? 0 : (int) (chopstickIds[i] + zigzagDecode(value - 1));
+    }
+
+    return offset == header->length;
+}
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file Statistics.c
+ * @brief Implémente la mesure du temps et la tenue des statistiques de la table.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **getMonotonicTime()** : Retourne l'heure monotone en nanosecondes, comparable entre tous les processus.
+ *  - **getHistogramBucket()** : Retourne la classe d'un histogramme correspondant à une valeur.
+ *  - **recordHistogram()** : Comptabilise une valeur dans un histogramme partagé.
+ *  - **getHistogramPercentile()** : Estime un percentile à partir d'un histogramme.
+ *  - **recordGrant()** : Comptabilise un repas accordé et son temps d'attente.
+ *
+ * Les compteurs partagés entre processus sont incrémentés avec les opérations atomiques de GCC, ce qui évite
+ * d'ajouter un sémaphore sur le chemin d'attribution des repas.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Statistics.h" pour la définition des structures de statistiques.
+ *  - "../entities/ServerPhilosopher.h" pour la définition de la structure `ServerPhilosopher`.
+ *  - "../managers/Clock.c" pour l'horloge à haute résolution.
+ */
+
+#ifndef STATISTICS_C
+#define STATISTICS_C
+
+#include "../entities/Statistics.h"
+#include "../entities/ServerPhilosopher.h"
+#include "../managers/Clock.c"
+
+/**
+ * @brief Retourne l'heure monotone en nanosecondes.
+ *
+ * L'heure est lue par l'horloge à haute résolution (voir Clock.h), dans la base de temps de CLOCK_MONOTONIC,
+ * commune à tous les processus de la machine : les valeurs écrites en mémoire partagée par un processus de service
+ * peuvent être comparées à celles lues par un autre processus.
+ *
+ * @return uint64_t L'heure monotone en nanosecondes.
+ */
+uint64_t getMonotonicTime() {
+    return getTimestamp();
+}
+
+/**
+ * @brief Retourne la classe d'un histogramme correspondant à une valeur.
+ *
+ * @param value La valeur à classer.
+ * @return int La classe : 0 pour une valeur nulle, sinon le nombre de bits significatifs de la valeur (les
+ * valeurs supérieures à 2^62 sont regroupées dans la dernière classe).
+ */
+int getHistogramBucket(uint64_t value) {
+    if (value == 0) {
+        return 0;
+    }
+
+    int bucket = 64 - __builtin_clzll(value);
+    return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+}
+
+/**
+ * @brief Comptabilise une valeur dans un histogramme partagé entre processus.
+ *
+ * @param histogram L'histogramme.
+ * @param value La valeur à comptabiliser.
+ */
+void recordHistogram(Histogram *histogram, uint64_t value) {
+    __atomic_fetch_add(&histogram->buckets[getHistogramBucket(value)], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Estime un percentile à partir d'un histogramme.
+ *
+ * La valeur retournée est la borne supérieure de la classe contenant le percentile demandé : l'estimation est
+ * donc précise à un facteur 2 près, ce qui suffit pour suivre l'évolution des temps d'attente.
+ *
+ * @param histogram L'histogramme.
+ * @param percentile Le percentile recherché, entre 0 et 100.
+ * @return uint64_t La borne supérieure de la classe du percentile, 0 si l'histogramme est vide.
+ */
+uint64_t getHistogramPercentile(const Histogram *histogram, double percentile) {
+    uint64_t total = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        total += histogram->buckets[i];
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t) (percentile / 100.0 * total);
+    uint64_t seen = 0;
+
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen > rank) {
+            return i == 0 ? 0 : (1ULL << i) - 1;
+        }
+    }
+
+    return UINT64_MAX;
+}
+
+/**
+ * @brief Comptabilise un repas accordé à un philosophe.
+ *
+ * Le temps d'attente est mesuré depuis la réception de sa demande (champ `hungrySince`), puis la demande est
+ * marquée comme satisfaite.
+ *
+ * @param philosopher Le philosophe servi.
+ * @param statistics Les statistiques de la table.
+ */
+void recordGrant(ServerPhilosopher *philosopher, TableStatistics *statistics) {
+    uint64_t now = getMonotonicTime();
+    uint64_t wait = philosopher->hungrySince ? now - philosopher->hungrySince : 0;
+
+    philosopher->meals += 1;
+    philosopher->hungrySince = 0;
+
+    // Moyenne glissante : chaque repas compte pour un huitième
+    philosopher->waitLoad = philosopher->waitLoad - philosopher->waitLoad / 8 + wait / 1000 / 8;
+
+    __atomic_fetch_add(&statistics->meals, 1, __ATOMIC_RELAXED);
+    recordHistogram(&statistics->waitHistogram, wait / 1000);
+}
+
+#endif
@@ -0,0 +1,384 @@
+/**
+ * @file TableCore.c
+ * @brief Implémente le cœur de la table (politique `sequenced`) : application des événements et consommateurs.
+ *
+ * Le principe du cœur est décrit dans TableCore.h ; la publication des événements est dans TableEvents.c. Les
+ * fonctions de ce fichier sont appelées par les threads du processus principal (voir server.c) : un thread pour le
+ * cœur, un par consommateur.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **grantTableMeal()** : Accorde un repas à un philosophe affamé si ses deux baguettes sont libres.
+ *  - **isHoldingCoreChopsticks()** : Indique si le repas d'un philosophe lui a été accordé.
+ *  - **grantWaitingPhilosophers()** : Parcourt la file des affamés et accorde les repas qu'une fin de repas permet.
+ *  - **applyTableEvent()** : Applique un événement.
+ *  - **applyTableEvents()** : Applique par lot les événements publiés (thread du cœur).
+ *  - **consumeTableEvent()** : Traite un événement appliqué pour un consommateur.
+ *  - **consumeTableEvents()** : Traite par lot les événements appliqués (threads des consommateurs).
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "ServerPhilosopher.c" pour les places et les baguettes.
+ *  - "TableEvents.c" pour les futex de l'anneau.
+ */
+
+#ifndef TABLE_CORE_C
+#define TABLE_CORE_C
+
+#include "../entities/TableCore.h"
+#include "../entities/SharedResources.h"
+#include "ServerPhilosopher.c"
+#include "TableEvents.c"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <semaphore.h>
+
+/**
+ * @brief Accorde un repas à un philosophe affamé si ses deux baguettes sont libres, sans jamais attendre.
+ *
+ * Le philosophe tient le verrou de la politique en lecture depuis sa demande : ses baguettes ne changent pas.
+ *
+ * @param event La case de l'événement qui permet le repas, qui le note.
+ * @param philosopherId Le philosophe.
+ * @param releasedLeft Baguette rendue par l'événement, 0 pour ne pas filtrer les philosophes.
+ * @param releasedRight Autre baguette rendue par l'événement.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return bool true si le repas est accordé.
+ */
+bool grantTableMeal(TableEvent *event, int philosopherId, int releasedLeft, int releasedRight, SharedResources *sharedResources) {
+    ServerPhilosopher *seat = pinPhilosopher(philosopherId, sharedResources);
+
+    if (!seat) {
+        return false;
+    }
+
+    if (!seat->rightChopstick) {
+        unpinPhilosopher(seat);
+        return false;
+    }
+
+    Chopstick *leftChopstick = seat->leftChopstick;
+    Chopstick *rightChopstick = seat->rightChopstick;
+
+    // Après une fin de repas, seuls les voisins du philosophe qui a mangé peuvent être servis
+    if (releasedLeft && leftChopstick->id != releasedLeft && leftChopstick->id != releasedRight
+        && rightChopstick->id != releasedLeft && rightChopstick->id != releasedRight) {
+        unpinPhilosopher(seat);
+        return false;
+    }
+
+    if (sem_trywait(&leftChopstick->usage) == -1) {
+        unpinPhilosopher(seat);
+        return false;
+    }
+
+    if (sem_trywait(&rightChopstick->usage) == -1) {
+        sem_post(&leftChopstick->usage);
+        unpinPhilosopher(seat);
+        return false;
+    }
+
+    leftChopstick->holderId = philosopherId;
+    rightChopstick->holderId = philosopherId;
+
+    for (int i = 0; i < TABLE_EVENT_MAX_GRANTS; i++) {
+        if (!event->grants[i].philosopherId) {
+            event->grants[i] = (TableGrant) {
+                .philosopherId = philosopherId,
+                .leftChopstick = (uint32_t) leftChopstick->id,
+                .rightChopstick = (uint32_t) rightChopstick->id,
+                .ledgerSequence = UINT64_MAX
+            };
+            break;
+        }
+    }
+
+    unpinPhilosopher(seat);
+    return true;
+}
+
+/**
+ * @brief Indique si un philosophe tient sa baguette gauche, c'est-à-dire si son repas lui a été accordé.
+ *
+ * @param philosopherId Le philosophe.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return bool true si le philosophe tient sa baguette gauche (ou n'existe plus).
+ */
+bool isHoldingCoreChopsticks(int philosopherId, SharedResources *sharedResources) {
+    ServerPhilosopher *seat = pinPhilosopher(philosopherId, sharedResources);
+
+    if (!seat) {
+        return true;
+    }
+
+    bool holding = seat->leftChopstick->holderId == philosopherId;
+    unpinPhilosopher(seat);
+    return holding;
+}
+
+/**
+ * @brief Retire un philosophe de la file des affamés, en gardant l'ordre des autres.
+ *
+ * @param core Le cœur de la table.
+ * @param index Sa position dans la file.
+ */
+void removeWaitingPhilosopher(TableCore *core, int index) {
+    memmove(&core->waiting[index], &core->waiting[index + 1], (core->numberWaiting - index - 1) * sizeof(int32_t));
+    core->numberWaiting -= 1;
+}
+
+/**
+ * @brief Parcourt la file des affamés dans l'ordre d'arrivée et accorde les repas permis par une fin de repas.
+ *
+ * @param event La case de la fin de repas.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return int Le nombre de repas accordés.
+ */
+int grantWaitingPhilosophers(TableEvent *event, SharedResources *sharedResources) {
+    TableCore *core = &sharedResources->tableCore;
+    int granted = 0;
+
+    for (int i = 0; i < core->numberWaiting && granted < TABLE_EVENT_MAX_GRANTS;) {
+        if (grantTableMeal(event, core->waiting[i], event->releasedLeftChopstick, event->releasedRightChopstick, sharedResources)) {
+            removeWaitingPhilosopher(core, i);
+            granted++;
+        } else {
+            i++;
+        }
+    }
+
+    return granted;
+}
+
+/**
+ * @brief Applique un événement publié.
+ *
+ * @param event La case de l'événement.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return int Le nombre de repas accordés.
+ */
+int applyTableEvent(TableEvent *event, SharedResources *sharedResources) {
+    TableCore *core = &sharedResources->tableCore;
+    int id = event->philosopherId;
+
+    if (event->type == TABLE_EVENT_HUNGRY) {
+        if (grantTableMeal(event, id, 0, 0, sharedResources)) {
+            return 1;
+        }
+
+        if (core->numberWaiting < MAX_PHILOSOPHERS) {
+            core->waiting[core->numberWaiting++] = id;
+        }
+
+        return 0;
+    }
+
+    if (event->type == TABLE_EVENT_RETRY) {
+        for (int i = 0; i < core->numberWaiting; i++) {
+            if (core->waiting[i] == id) {
+                if (!grantTableMeal(event, id, 0, 0, sharedResources)) {
+                    return 0;
+                }
+
+                removeWaitingPhilosopher(core, i);
+                return 1;
+            }
+        }
+
+        // Absent de la file : sa demande a été perdue (case sautée), sauf si son repas vient d'être accordé et que le
+        // consommateur des réponses ne l'a pas encore réveillé ; les événements étant appliqués dans l'ordre, le
+        // philosophe tient alors encore ses baguettes
+        if (isHoldingCoreChopsticks(id, sharedResources)) {
+            return 0;
+        }
+
+        if (grantTableMeal(event, id, 0, 0, sharedResources)) {
+            return 1;
+        }
+
+        if (core->numberWaiting < MAX_PHILOSOPHERS) {
+            core->waiting[core->numberWaiting++] = id;
+        }
+
+        return 0;
+    }
+
+    if (event->type == TABLE_EVENT_RELEASE) {
+        ServerPhilosopher *seat = pinPhilosopher(id, sharedResources);
+
+        if (!seat) {
+            return 0;
+        }
+
+        // Le philosophe attend que l'événement soit appliqué : sa place et ses baguettes ne bougent pas
+        Chopstick *leftChopstick = seat->leftChopstick;
+        Chopstick *rightChopstick = seat->rightChopstick;
+        event->releasedLeftChopstick = (uint32_t) leftChopstick->id;
+        event->releasedRightChopstick = (uint32_t) rightChopstick->id;
+
+        leftChopstick->holderId = 0;
+        sem_post(&leftChopstick->usage);
+        rightChopstick->holderId = 0;
+        sem_post(&rightChopstick->usage);
+        unpinPhilosopher(seat);
+
+        return grantWaitingPhilosophers(event, sharedResources);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Applique par lot les événements publiés depuis le lot précédent (thread du cœur, seul écrivain de la file).
+ *
+ * Une case réservée mais pas encore publiée arrête le lot ; si elle ne l'est toujours pas au bout de
+ * TABLE_EVENT_HOLE_TIMEOUT_MS, son producteur est tenu pour mort et la séquence est sautée. Le délai ne court pas
+ * tant que l'anneau est plein : le producteur attend alors qu'un consommateur libère sa case, que les consommateurs
+ * en retard n'ont pas encore lue.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return uint32_t Le nombre d'événements appliqués.
+ */
+uint32_t applyTableEvents(SharedResources *sharedResources) {
+    TableCore *core = &sharedResources->tableCore;
+    uint64_t sequence = core->appliedSequence;
+    uint64_t published = __atomic_load_n(&core->nextSequence, __ATOMIC_ACQUIRE);
+    uint32_t batch = 0;
+    int grants = 0;
+
+    while (sequence < published) {
+        TableEvent *event = &core->slots[sequence % TABLE_EVENT_RING_SIZE];
+
+        if (__atomic_load_n(&event->stamp, __ATOMIC_ACQUIRE) != sequence + 1) {
+            uint64_t now = getMonotonicTime();
+
+            // Un producteur qui attend une case libre (consommateur en retard) est vivant : l'attente ne compte pas
+            if (core->stalledSequence != sequence + 1 || sequence - getTableConsumedSequence(core) >= TABLE_EVENT_RING_SIZE) {
+                core->stalledSequence = sequence + 1;
+                core->stalledSince = now;
+                break;
+            }
+
+            if (now - core->stalledSince < (uint64_t) TABLE_EVENT_HOLE_TIMEOUT_MS * 1000000) {
+                break;
+            }
+
+            event->type = TABLE_EVENT_HOLE;
+            event->philosopherId = 0;
+            event->timestamp = getTimestamp();
+            memset(event->grants, 0, sizeof(event->grants));
+            __atomic_store_n(&event->stamp, sequence + 1, __ATOMIC_RELEASE);
+            core->holes += 1;
+        }
+
+        grants += applyTableEvent(event, sharedResources);
+        sequence++;
+        batch++;
+    }
+
+    if (batch) {
+        core->appliedEvents += batch;
+        core->batches += 1;
+        core->largestBatch = batch > core->largestBatch ? batch : core->largestBatch;
+        core->grants += grants;
+        __atomic_store_n(&core->appliedSequence, sequence, __ATOMIC_RELEASE);
+        ledgerFutexWake(&core->appliedFutex);
+    }
+
+    return batch;
+}
+
+/**
+ * @brief Traite un événement appliqué pour un consommateur.
+ *
+ * @param consumer Le consommateur.
+ * @param sequence La séquence de l'événement.
+ * @param event La case de l'événement.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ */
+void consumeTableEvent(TableConsumer consumer, uint64_t sequence, TableEvent *event, SharedResources *sharedResources) {
+    int logsQueueId = sharedResources->logsQueueId;
+    int id = event->philosopherId;
+
+    if (consumer == TABLE_CONSUMER_LOGS) {
+        switch (event->type) {
+            case TABLE_EVENT_HOLE:
+                logServerState(logsQueueId, "[cœur %lu] Événement jamais publié, sauté\n", sequence);
+                break;
+            case TABLE_EVENT_JOIN:
+                logServerState(logsQueueId, "[cœur %lu] Le philosophe %d s'attable\n", sequence, id);
+                break;
+            case TABLE_EVENT_LEAVE:
+                logServerState(logsQueueId, "[cœur %lu] Le philosophe %d quitte la table\n", sequence, id);
+                break;
+            case TABLE_EVENT_HUNGRY:
+                logServerState(logsQueueId, "[cœur %lu] Le philosophe %d demande à manger\n", sequence, id);
+                break;
+            case TABLE_EVENT_RETRY:
+                // Une relance n'est consignée que par le repas qu'elle permet
+                break;
+            case TABLE_EVENT_RELEASE:
+                logServerState(logsQueueId, "[cœur %lu] Le philosophe %d rend les baguettes %d et %d\n", sequence, id, event->releasedLeftChopstick, event->releasedRightChopstick);
+                break;
+        }
+    }
+
+    if (consumer == TABLE_CONSUMER_LEDGER && event->type == TABLE_EVENT_RELEASE) {
+        appendLedgerRecord(&sharedResources->ledger, LEDGER_RELEASE, id, event->releasedLeftChopstick, event->releasedRightChopstick);
+    }
+
+    for (int i = 0; i < TABLE_EVENT_MAX_GRANTS && event->grants[i].philosopherId; i++) {
+        TableGrant *grant = &event->grants[i];
+
+        if (consumer == TABLE_CONSUMER_LOGS) {
+            logServerState(logsQueueId, "[cœur %lu] Le philosophe %d prend les baguettes %d et %d\n", sequence, grant->philosopherId, grant->leftChopstick, grant->rightChopstick);
+        }
+
+        // Dans le registre, la libération précède les repas qu'elle permet
+        if (consumer == TABLE_CONSUMER_LEDGER) {
+            grant->ledgerSequence = appendLedgerRecord(&sharedResources->ledger, LEDGER_GRANT, grant->philosopherId, grant->leftChopstick, grant->rightChopstick);
+        }
+
+        if (consumer == TABLE_CONSUMER_RESPONSES) {
+            ServerPhilosopher *seat = pinPhilosopher(grant->philosopherId, sharedResources);
+
+            if (seat) {
+                seat->grantLedgerSequence = grant->ledgerSequence;
+                ledgerFutexWake(&seat->coreGrants);
+                unpinPhilosopher(seat);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Traite par lot les événements que le consommateur précédent a laissés (thread d'un consommateur).
+ *
+ * Les logs et le registre suivent le cœur, les réponses suivent le registre : un philosophe n'est réveillé qu'une
+ * fois son repas déposé dans le registre.
+ *
+ * @param consumer Le consommateur.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return uint32_t Le nombre d'événements traités.
+ */
+uint32_t consumeTableEvents(TableConsumer consumer, SharedResources *sharedResources) {
+    TableCore *core = &sharedResources->tableCore;
+    uint64_t sequence = core->consumedSequences[consumer];
+    uint64_t available = consumer == TABLE_CONSUMER_RESPONSES
+        ? __atomic_load_n(&core->consumedSequences[TABLE_CONSUMER_LEDGER], __ATOMIC_ACQUIRE)
+        : __atomic_load_n(&core->appliedSequence, __ATOMIC_ACQUIRE);
+    uint32_t batch = 0;
+
+    for (; sequence < available; sequence++, batch++) {
+        consumeTableEvent(consumer, sequence, &core->slots[sequence % TABLE_EVENT_RING_SIZE], sharedResources);
+    }
+
+    if (batch) {
+        __atomic_store_n(&core->consumedSequences[consumer], sequence, __ATOMIC_RELEASE);
+        ledgerFutexWake(&core->consumedFutex);
+    }
+
+    return batch;
+}
+
+#endif
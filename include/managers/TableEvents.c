@@ -0,0 +1,132 @@
+/**
+ * @file TableEvents.c
+ * @brief Implémente la publication des événements de la table dans l'anneau du cœur (politique `sequenced`).
+ *
+ * Le principe du cœur est décrit dans TableCore.h. Ce fichier regroupe le côté des producteurs : les processus de
+ * service et les threads du service datagramme publient leurs événements, puis attendent que le cœur les ait
+ * appliqués, ou qu'il leur ait accordé un repas. Le cœur et ses consommateurs sont dans TableCore.c.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **publishTableEvent()** : Publie un événement dans l'anneau.
+ *  - **waitTableEventApplied()** : Attend que le cœur ait appliqué un événement.
+ *  - **waitTableGrant()** : Attend le repas d'un philosophe affamé, en relançant le cœur s'il tarde.
+ *
+ * Comme pour le registre des repas, les attentes passent par des futex sur des compteurs de la mémoire partagée et
+ * sont bornées dans le temps : un réveil manqué ne bloque jamais un processus de service.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/TableCore.h" pour l'anneau.
+ *  - "../entities/ServerPhilosopher.h" pour le compteur des repas accordés d'une place.
+ *  - "Ledger.c" pour les futex.
+ *  - "Clock.c" pour l'horodatage des événements.
+ */
+
+#ifndef TABLE_EVENTS_C
+#define TABLE_EVENTS_C
+
+#include "../entities/TableCore.h"
+#include "../entities/ServerPhilosopher.h"
+#include "Ledger.c"
+#include "Clock.c"
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Retourne la séquence du consommateur le plus en retard : les cases précédentes peuvent être réutilisées.
+ *
+ * @param core Le cœur de la table.
+ * @return uint64_t La plus petite séquence traitée par les consommateurs.
+ */
+uint64_t getTableConsumedSequence(TableCore *core) {
+    uint64_t consumed = UINT64_MAX;
+
+    for (int consumer = 0; consumer < TABLE_CONSUMERS; consumer++) {
+        uint64_t sequence = __atomic_load_n(&core->consumedSequences[consumer], __ATOMIC_ACQUIRE);
+        consumed = sequence < consumed ? sequence : consumed;
+    }
+
+    return consumed;
+}
+
+/**
+ * @brief Publie un événement dans l'anneau du cœur.
+ *
+ * Sans verrou : la séquence est réservée par incrément atomique, puis la case est écrite et publiée. Si l'anneau est
+ * plein (un consommateur a TABLE_EVENT_RING_SIZE événements de retard), l'appelant attend qu'une case se libère ;
+ * le cœur sait qu'il est vivant et ne saute pas sa séquence tant qu'il attend.
+ *
+ * @param core Le cœur de la table.
+ * @param type Le type d'événement.
+ * @param philosopherId Le philosophe concerné.
+ * @return uint64_t La séquence de l'événement, à passer à waitTableEventApplied().
+ */
+uint64_t publishTableEvent(TableCore *core, TableEventType type, int philosopherId) {
+    uint64_t sequence = __atomic_fetch_add(&core->nextSequence, 1, __ATOMIC_RELAXED);
+
+    while (sequence - getTableConsumedSequence(core) >= TABLE_EVENT_RING_SIZE) {
+        uint32_t consumed = __atomic_load_n(&core->consumedFutex, __ATOMIC_ACQUIRE);
+
+        if (sequence - getTableConsumedSequence(core) < TABLE_EVENT_RING_SIZE) {
+            break;
+        }
+
+        ledgerFutexWait(&core->consumedFutex, consumed, 10);
+    }
+
+    TableEvent *event = &core->slots[sequence % TABLE_EVENT_RING_SIZE];
+    event->type = (uint16_t) type;
+    event->philosopherId = philosopherId;
+    event->timestamp = getTimestamp();
+    event->releasedLeftChopstick = 0;
+    event->releasedRightChopstick = 0;
+    memset(event->grants, 0, sizeof(event->grants));
+
+    __atomic_store_n(&event->stamp, sequence + 1, __ATOMIC_RELEASE);
+    ledgerFutexWake(&core->publishedFutex);
+    return sequence;
+}
+
+/**
+ * @brief Attend que le cœur ait appliqué un événement.
+ *
+ * @param core Le cœur de la table.
+ * @param sequence La séquence de l'événement.
+ */
+void waitTableEventApplied(TableCore *core, uint64_t sequence) {
+    while (__atomic_load_n(&core->appliedSequence, __ATOMIC_ACQUIRE) <= sequence) {
+        uint32_t applied = __atomic_load_n(&core->appliedFutex, __ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&core->appliedSequence, __ATOMIC_ACQUIRE) > sequence) {
+            break;
+        }
+
+        ledgerFutexWait(&core->appliedFutex, applied, TABLE_CORE_WAIT_MS);
+    }
+}
+
+/**
+ * @brief Attend le repas d'un philosophe affamé, accordé par le cœur et annoncé par le consommateur des réponses.
+ *
+ * Une baguette rendue hors du cœur (par un repas commencé avant le passage à la politique `sequenced`) ne le fait
+ * pas réexaminer la file : toutes les TABLE_GRANT_RETRY_MS, le philosophe le relance (TABLE_EVENT_RETRY). La relance
+ * remet aussi dans la file une demande perdue avec une case sautée par le cœur.
+ *
+ * @param core Le cœur de la table.
+ * @param serverPhilosopher Le philosophe, tenu par l'appelant (voir pinPhilosopher()).
+ * @param seen La valeur de son compteur `coreGrants` lue avant la publication de sa demande.
+ */
+void waitTableGrant(TableCore *core, ServerPhilosopher *serverPhilosopher, uint32_t seen) {
+    uint64_t lastRetry = getMonotonicTime();
+
+    while (__atomic_load_n(&serverPhilosopher->coreGrants, __ATOMIC_ACQUIRE) == seen) {
+        ledgerFutexWait(&serverPhilosopher->coreGrants, seen, TABLE_CORE_WAIT_MS);
+
+        if (getMonotonicTime() - lastRetry >= (uint64_t) TABLE_GRANT_RETRY_MS * 1000000
+            && __atomic_load_n(&serverPhilosopher->coreGrants, __ATOMIC_ACQUIRE) == seen) {
+            publishTableEvent(core, TABLE_EVENT_RETRY, serverPhilosopher->base.id);
+            lastRetry = getMonotonicTime();
+        }
+    }
+}
+
+#endif
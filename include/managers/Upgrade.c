@@ -0,0 +1,201 @@
+/**
+ * @file Upgrade.c
+ * @brief Implémente la transmission de l'état du serveur lors d'une mise à jour à chaud.
+ *
+ * Le format de l'état transmis est décrit dans Upgrade.h. L'état est écrit dans un tube avant exec() ; le tube étant
+ * vidé par le nouveau binaire seulement après exec(), l'état doit tenir dans sa capacité (64 Kio sous Linux, soit
+ * bien plus que MAX_SERVICE_PROCESSES lignes de clients).
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **setDescriptorInheritable()** : Rend un descripteur héritable (ou non) par exec().
+ *  - **writeUpgradeState()** : Écrit l'état du processus principal dans un tube.
+ *  - **readUpgradeState()** : Relit l'état transmis par l'ancien binaire.
+ *  - **execUpgrade()** : Remplace le binaire du processus principal.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Upgrade.h" et "../entities/ServerContext.h" pour le format de l'état et le contexte du serveur.
+ *  - <stdio.h>, <string.h>, <stdbool.h>, <unistd.h> et <fcntl.h>.
+ */
+
+#ifndef UPGRADE_C
+#define UPGRADE_C
+
+#include "../entities/Upgrade.h"
+#include "../entities/ServerContext.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+extern char **environ;
+
+/**
+ * @brief Rend un descripteur héritable (ou non) par exec().
+ *
+ * @param fd Le descripteur.
+ * @param inheritable true pour qu'il reste ouvert après exec().
+ * @return bool true si le réglage a été appliqué.
+ */
+bool setDescriptorInheritable(int fd, bool inheritable) {
+    int flags = fcntl(fd, F_GETFD);
+
+    if (flags == -1) {
+        return false;
+    }
+
+    flags = inheritable ? flags & ~FD_CLOEXEC : flags | FD_CLOEXEC;
+    return fcntl(fd, F_SETFD, flags) != -1;
+}
+
+/**
+ * @brief Écrit l'état du processus principal dans un tube, pour le nouveau binaire.
+ *
+ * @param serverContext Le contexte du serveur.
+ * @param previousBinary Descripteur de l'ancien binaire ouvert en lecture, -1 s'il n'y en a pas.
+ * @return int L'extrémité en lecture du tube (héritable), ou -1 en cas d'erreur.
+ */
+int writeUpgradeState(const ServerContext *serverContext, int previousBinary) {
+    int descriptors[2];
+
+    if (pipe(descriptors) == -1) {
+        return -1;
+    }
+
+    FILE *state = fdopen(descriptors[1], "w");
+
+    if (!state) {
+        close(descriptors[0]);
+        close(descriptors[1]);
+        return -1;
+    }
+
+    fprintf(state, "server %d\n", serverContext->serverSocket);
+    fprintf(state, "control %d\n", serverContext->controlSocket);
+    fprintf(state, "binary %d\n", previousBinary);
+    fprintf(state, UPGRADE_EXECUTABLE_PREFIX "%s\n", serverContext->executablePath);
+    fprintf(state, "segment %p\n", (void *) serverContext->sharedResources);
+
+    for (size_t i = 0; i < serverContext->numberClients; i++) {
+        fprintf(state, "client %d %d\n", serverContext->clientsProcessIds[i], serverContext->serviceSockets[i]);
+    }
+
+    if (serverContext->datagramProcessId != 0) {
+        fprintf(state, "datagram %d\n", serverContext->datagramProcessId);
+    }
+
+    if (fclose(state) != 0) {
+        close(descriptors[0]);
+        return -1;
+    }
+
+    return descriptors[0];
+}
+
+/**
+ * @brief Relit l'état transmis par l'ancien binaire et le reporte dans le contexte du serveur.
+ *
+ * Le tube est fermé après lecture. Les descripteurs repris sont rendus non héritables, comme s'ils avaient été
+ * ouverts par ce binaire.
+ *
+ * @param stateFd L'extrémité en lecture du tube.
+ * @param serverContext Le contexte du serveur, initialisé par initServerContext(). Son champ `sharedResources`
+ *        reçoit l'adresse du segment dans l'ancien binaire, à laquelle le segment doit être attaché.
+ * @param previousBinary Reçoit le descripteur de l'ancien binaire, -1 s'il n'a pas été transmis.
+ * @return bool true si l'état est complet (au moins un socket d'écoute valide et l'adresse du segment) et qu'aucune ligne n'a été tronquée :
+ * un chemin de binaire tronqué ferait relancer un autre binaire.
+ */
+bool readUpgradeState(int stateFd, ServerContext *serverContext, int *previousBinary) {
+    FILE *state = fdopen(stateFd, "r");
+    *previousBinary = -1;
+
+    if (!state) {
+        close(stateFd);
+        return false;
+    }
+
+    char line[UPGRADE_LINE_SIZE];
+    size_t prefixLength = strlen(UPGRADE_EXECUTABLE_PREFIX);
+    bool truncated = false;
+
+    while (fgets(line, sizeof(line), state)) {
+        size_t length = strcspn(line, "\n");
+
+        if (line[length] != '\n' && !feof(state)) {
+            truncated = true;
+        }
+
+        line[length] = '\0';
+
+        int pid, fd;
+        void *segment;
+
+        if (sscanf(line, "server %d", &fd) == 1) {
+            serverContext->serverSocket = fd;
+        } else if (sscanf(line, "control %d", &fd) == 1) {
+            serverContext->controlSocket = fd;
+        } else if (sscanf(line, "binary %d", &fd) == 1) {
+            *previousBinary = fd;
+        } else if (sscanf(line, "segment %p", &segment) == 1) {
+            serverContext->sharedResources = (SharedResources *) segment;
+        } else if (strncmp(line, UPGRADE_EXECUTABLE_PREFIX, prefixLength) == 0) {
+            int written = snprintf(serverContext->executablePath, sizeof(serverContext->executablePath), "%s",
+                                   line + prefixLength);
+
+            if (written < 0 || (size_t) written >= sizeof(serverContext->executablePath)) {
+                truncated = true;
+            }
+        } else if (sscanf(line, "datagram %d", &pid) == 1) {
+            serverContext->datagramProcessId = pid;
+        } else if (sscanf(line, "client %d %d", &pid, &fd) == 2 && serverContext->numberClients < MAX_SERVICE_PROCESSES) {
+            serverContext->clientsProcessIds[serverContext->numberClients] = pid;
+            serverContext->serviceSockets[serverContext->numberServiceSockets] = fd;
+            serverContext->numberClients += 1;
+            serverContext->numberServiceSockets += 1;
+        }
+    }
+
+    fclose(state);
+
+    if (serverContext->controlSocket != -1) {
+        setDescriptorInheritable(serverContext->controlSocket, false);
+    }
+
+    if (*previousBinary != -1) {
+        setDescriptorInheritable(*previousBinary, false);
+    }
+
+    if (truncated) {
+        return false;
+    }
+
+    return serverContext->sharedResources != NULL && serverContext->serverSocket != -1 && fcntl(serverContext->serverSocket, F_GETFD) != -1;
+}
+
+/**
+ * @brief Remplace le binaire du processus principal.
+ *
+ * Le nouveau binaire est lancé avec les arguments `UPGRADE_ARGUMENT <stateFd>`. Il est désigné soit par un chemin,
+ * soit par un descripteur ouvert en lecture (utilisé pour revenir à l'ancien binaire, même supprimé ou remplacé
+ * sur le disque entre-temps).
+ *
+ * @param path Chemin du binaire, utilisé si binary vaut -1 (et comme argv[0] dans tous les cas).
+ * @param binary Descripteur du binaire, ou -1.
+ * @param stateFd Extrémité en lecture du tube contenant l'état.
+ *
+ * @note Ne retourne qu'en cas d'échec.
+ */
+void execUpgrade(const char *path, int binary, int stateFd) {
+    char descriptor[16];
+    snprintf(descriptor, sizeof(descriptor), "%d", stateFd);
+
+    char *arguments[] = { (char *) path, UPGRADE_ARGUMENT, descriptor, NULL };
+
+    if (binary != -1) {
+        fexecve(binary, arguments, environ);
+    } else {
+        execv(path, arguments);
+    }
+}
+
+#endif
@@ -0,0 +1,255 @@
+/**
+ * @file Watch.c
+ * @brief Implémente l'envoi des changements d'état de la table aux abonnés.
+ *
+ * Le fonctionnement des abonnements est décrit dans Watch.h. Une fois l'abonnement accepté, le processus de service
+ * de la connexion ne sert plus que cet abonné : il compare régulièrement les versions des places suivies à celles
+ * déjà envoyées, et envoie un lot des places modifiées. Les abonnés ne prennent aucun sémaphore ni verrou de la
+ * table : les places sont lues sans verrou, comme le fait le tableau de bord.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **isValidSubscription()** : Vérifie qu'un abonnement désigne une place existante.
+ *  - **getNextPhilosopher()** : Retourne le voisin de droite d'un philosophe.
+ *  - **getWatchedSeats()** : Détermine les places suivies par un abonnement à une place ou à ses voisins.
+ *  - **sendWatchBatch()** : Envoie un lot sans bloquer sur un abonné trop lent.
+ *  - **watchTable()** : Boucle d'envoi des lots à un abonné.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/Watch.h" et "../entities/SharedResources.h" pour les structures des abonnements et de la table.
+ *  - "../managers/ServerPhilosopher.c" pour la recherche des philosophes et de leurs voisins.
+ *  - <poll.h> et <sys/socket.h> pour l'attente entre deux lots et l'envoi non bloquant.
+ */
+
+#ifndef WATCH_C
+#define WATCH_C
+
+#include "../maxmin_philosophers.h"
+#include "../entities/Watch.h"
+#include "../entities/SharedResources.h"
+#include "../managers/ServerPhilosopher.c"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+/**
+ * @brief Vérifie qu'un abonnement désigne une étendue connue et, sauf pour la table, une place existante.
+ *
+ * @param subscription L'abonnement demandé.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return bool true si l'abonnement peut être accepté.
+ */
+bool isValidSubscription(WatchSubscription subscription, SharedResources *sharedResources) {
+    if (subscription.maxRate < 0) {
+        return false;
+    }
+
+    if (subscription.scope == WATCH_TABLE) {
+        return true;
+    }
+
+    return (subscription.scope == WATCH_SEAT || subscription.scope == WATCH_NEIGHBOURS)
+        && getPhilosopherFromId(subscription.seat, sharedResources) != NULL;
+}
+
+/**
+ * @brief Retourne le voisin de droite d'un philosophe.
+ *
+ * Le voisin de droite est le philosophe encore à table dont la baguette gauche est la baguette droite du philosophe.
+ * Une baguette est rangée à la place de son philosophe : le voisin se trouve sans parcourir les places.
+ *
+ * @param philosopher Le philosophe.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return ServerPhilosopher* Le voisin de droite, ou NULL si le philosophe est seul à table.
+ */
+ServerPhilosopher *getNextPhilosopher(ServerPhilosopher *philosopher, SharedResources *sharedResources) {
+    Chopstick *rightChopstick = philosopher->rightChopstick;
+
+    if (rightChopstick < sharedResources->chopsticks || rightChopstick >= sharedResources->chopsticks + MAX_PHILOSOPHERS) {
+        return NULL;
+    }
+
+    ServerPhilosopher *candidate = &sharedResources->philosophers[rightChopstick - sharedResources->chopsticks];
+
+    return candidate != philosopher && !candidate->departed && candidate->leftChopstick == rightChopstick ? candidate : NULL;
+}
+
+/**
+ * @brief Détermine les philosophes suivis par un abonnement à une place ou à ses voisins.
+ *
+ * Les voisins sont recalculés à chaque appel : l'anneau change lorsqu'un philosophe arrive ou quitte la table.
+ *
+ * @param subscription L'abonnement, d'étendue WATCH_SEAT ou WATCH_NEIGHBOURS.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @param watched Reçoit les places suivies (au plus 3).
+ * @return int Le nombre de places suivies, 0 si la place de l'abonnement a été effacée.
+ */
+int getWatchedSeats(WatchSubscription subscription, SharedResources *sharedResources, ServerPhilosopher *watched[3]) {
+    ServerPhilosopher *philosopher = getPhilosopherFromId(subscription.seat, sharedResources);
+    int count = 0;
+
+    if (!philosopher) {
+        return 0;
+    }
+
+    watched[count++] = philosopher;
+
+    if (subscription.scope == WATCH_NEIGHBOURS && !philosopher->departed) {
+        ServerPhilosopher *previous = getPreviousPhilosopher(philosopher, sharedResources);
+        ServerPhilosopher *next = getNextPhilosopher(philosopher, sharedResources);
+
+        if (previous) {
+            watched[count++] = previous;
+        }
+
+        if (next && next != previous) {
+            watched[count++] = next;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Envoie un lot à un abonné sans bloquer sur un abonné trop lent.
+ *
+ * Si le tampon du socket est plein, le lot n'est pas envoyé : les places restent à envoyer et partiront, dans leur
+ * dernier état, avec le lot suivant. Un lot commencé est toujours terminé, pour ne pas désynchroniser l'abonné.
+ *
+ * @param serviceSocket Le socket de l'abonné.
+ * @param batch Le lot (en-tête suivi des places).
+ * @param size Taille du lot en octets.
+ * @return int 1 si le lot a été envoyé, 0 s'il a été reporté, -1 si l'abonné a coupé la connexion.
+ */
+int sendWatchBatch(int serviceSocket, const char *batch, size_t size) {
+    ssize_t bytesSent = send(serviceSocket, batch, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+    if (bytesSent == -1) {
+        return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    }
+
+    size_t totalSent = bytesSent;
+
+    while (totalSent < size) {
+        bytesSent = send(serviceSocket, batch + totalSent, size - totalSent, MSG_NOSIGNAL);
+
+        if (bytesSent == -1) {
+            return -1;
+        }
+
+        totalSent += bytesSent;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Envoie les changements d'état de la table à un abonné, jusqu'à ce qu'il coupe la connexion.
+ *
+ * Entre deux lots, le processus attend la période de l'abonnement en surveillant le socket, pour détecter la
+ * déconnexion de l'abonné. Les données reçues de l'abonné sont ignorées.
+ *
+ * @param serviceSocket Le socket de l'abonné.
+ * @param subscription L'abonnement, déjà validé par isValidSubscription().
+ * @param sharedResources Pointeur vers les ressources partagées.
+ */
+void watchTable(int serviceSocket, WatchSubscription subscription, SharedResources *sharedResources) {
+    int rate = subscription.maxRate == 0 ? WATCH_DEFAULT_RATE : subscription.maxRate;
+    rate = rate > WATCH_MAX_RATE ? WATCH_MAX_RATE : rate;
+
+    // Une version jamais atteinte force l'envoi de toutes les places suivies dans le premier lot. Les versions sont
+    // rangées par identifiant : le compactage peut déplacer une place, sans changer sa version
+    uint64_t sentVersions[MAX_PHILOSOPHERS];
+    memset(sentVersions, 0xff, sizeof(sentVersions));
+    uint64_t sentTableVersion = UINT64_MAX;
+    uint32_t sequence = 0;
+
+    char batch[sizeof(WatchBatchHeader) + sizeof(WatchEntry) * MAX_PHILOSOPHERS];
+    int batchIds[MAX_PHILOSOPHERS];
+    uint64_t batchVersions[MAX_PHILOSOPHERS];
+
+    while (1) {
+        uint64_t tableVersion = __atomic_load_n(&sharedResources->tableVersion, __ATOMIC_ACQUIRE);
+
+        if (tableVersion != sentTableVersion) {
+            // Places suivies : toutes les places utilisées pour la table, sinon celles de getWatchedSeats()
+            ServerPhilosopher *watched[3];
+            int numberWatched = subscription.scope == WATCH_TABLE
+                ? sharedResources->numberPhilosophers
+                : getWatchedSeats(subscription, sharedResources, watched);
+
+            WatchBatchHeader *header = (WatchBatchHeader *) batch;
+            WatchEntry *entries = (WatchEntry *) (batch + sizeof(WatchBatchHeader));
+            uint64_t coalesced = 0;
+            int count = 0;
+
+            for (int i = 0; i < numberWatched; i++) {
+                ServerPhilosopher *philosopher = subscription.scope == WATCH_TABLE ? &sharedResources->philosophers[i] : watched[i];
+                int id = philosopher->base.id;
+
+                if (id < 1 || id > MAX_PHILOSOPHERS) {
+                    continue;
+                }
+
+                // La version est lue avant l'état : un état plus récent que la version sera renvoyé au lot suivant
+                uint64_t version = __atomic_load_n(&philosopher->version, __ATOMIC_ACQUIRE);
+
+                if (version == sentVersions[id - 1]) {
+                    continue;
+                }
+
+                coalesced += sentVersions[id - 1] == UINT64_MAX ? 1 : version - sentVersions[id - 1];
+                batchIds[count] = id;
+                batchVersions[count] = version;
+
+                entries[count++] = (WatchEntry) {
+                    .id = philosopher->base.id,
+                    .state = philosopher->departed ? WATCH_STATE_DEPARTED : philosopher->base.state,
+                    .flags = (philosopher->draining ? WATCH_FLAG_DRAINING : 0) | (philosopher->evicted ? WATCH_FLAG_EVICTED : 0),
+                    .meals = (uint32_t) philosopher->meals
+                };
+            }
+
+            int sent = 1;
+
+            if (count > 0) {
+                *header = (WatchBatchHeader) {
+                    .sequence = sequence,
+                    .count = count,
+                    .coalesced = coalesced > UINT16_MAX ? UINT16_MAX : coalesced
+                };
+
+                sent = sendWatchBatch(serviceSocket, batch, sizeof(WatchBatchHeader) + sizeof(WatchEntry) * count);
+            }
+
+            if (sent == -1) {
+                logClientInfo(sharedResources->logsQueueId, "L'abonné a coupé la connexion.\n");
+                return;
+            }
+
+            if (sent == 1) {
+                for (int i = 0; i < count; i++) {
+                    sentVersions[batchIds[i] - 1] = batchVersions[i];
+                }
+                sentTableVersion = tableVersion;
+                sequence += count > 0;
+            }
+        }
+
+        struct pollfd event = { .fd = serviceSocket, .events = POLLIN };
+
+        if (poll(&event, 1, 1000 / rate) > 0) {
+            char ignored[64];
+            ssize_t bytesReceived = recv(serviceSocket, ignored, sizeof(ignored), MSG_DONTWAIT);
+
+            if (bytesReceived == 0 || (bytesReceived == -1 && errno != EAGAIN && errno != EINTR)) {
+                logClientInfo(sharedResources->logsQueueId, "L'abonné a coupé la connexion.\n");
+                return;
+            }
+        }
+    }
+}
+
+#endif
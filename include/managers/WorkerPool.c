@@ -0,0 +1,243 @@
+/**
+ * @file WorkerPool.c
+ * @brief Implémente la réserve élastique de threads du service datagramme.
+ *
+ * Le principe de la réserve est décrit dans WorkerPool.h. Les threads sont détachés : un thread qui s'arrête
+ * décompte lui-même sa sortie, sous le verrou de la réserve. Le nombre de threads est réservé avant leur création,
+ * pour qu'une rafale de dépôts ne dépasse pas `maxWorkers`.
+ *
+ * Les fonctions définies dans ce fichier sont :
+ *  - **initWorkerPool()** : Initialise la réserve et lance ses `minWorkers` premiers threads.
+ *  - **spawnWorker()** : Ajoute un thread à la réserve.
+ *  - **workerThread()** : Routine d'un thread : exécute les opérations de la file, s'arrête après une inactivité.
+ *  - **submitWork()** : Dépose une opération, en ajoutant un thread si aucun n'est libre.
+ *  - **growWorkerPool()** : Applique les réglages, et ajoute un thread si la plus ancienne opération attend trop.
+ *
+ * Les inclusions nécessaires dans ce fichier sont :
+ *  - "../entities/WorkerPool.h" pour la réserve et ses réglages.
+ *  - "../managers/Statistics.c" pour l'heure monotone et l'histogramme des attentes.
+ *  - "../managers/Profiler.c" pour profiler les threads de la réserve.
+ *  - <pthread.h>, <errno.h> et <time.h>.
+ */
+
+#ifndef WORKER_POOL_C
+#define WORKER_POOL_C
+
+#include "../maxmin_philosophers.h"
+#include "../entities/WorkerPool.h"
+#include "../managers/Statistics.c"
+#include "../managers/Profiler.c"
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+void *workerThread(void *arg);
+
+/**
+ * @brief Ajoute un thread à la réserve. Appelée sous le verrou de la réserve.
+ *
+ * @param pool La réserve.
+ * @return bool false si le maximum est atteint ou si le thread n'a pas pu être créé.
+ */
+bool spawnWorker(WorkerPool *pool) {
+    WorkerPoolState *state = pool->state;
+
+    if (state->workers >= state->maxWorkers) {
+        return false;
+    }
+
+    pthread_t thread;
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+
+    // Réservé avant la création : le thread peut se décompter avant le retour de pthread_create()
+    state->workers += 1;
+    int result = pthread_create(&thread, &attributes, workerThread, pool);
+    pthread_attr_destroy(&attributes);
+
+    if (result != 0) {
+        state->workers -= 1;
+        return false;
+    }
+
+    state->spawned += 1;
+
+    if (state->workers > state->peakWorkers) {
+        state->peakWorkers = state->workers;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Initialise la réserve et lance ses `minWorkers` premiers threads.
+ *
+ * @param pool La réserve, non initialisée.
+ * @param state Les réglages et compteurs, en mémoire partagée.
+ * @param run La fonction exécutant une opération.
+ * @param context Premier argument de `run`.
+ */
+void initWorkerPool(WorkerPool *pool, WorkerPoolState *state, void (*run)(void *context, int item), void *context) {
+    pthread_condattr_t conditionAttributes;
+    pthread_condattr_init(&conditionAttributes);
+    pthread_condattr_setclock(&conditionAttributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&pool->available, &conditionAttributes);
+    pthread_condattr_destroy(&conditionAttributes);
+    pthread_mutex_init(&pool->lock, NULL);
+
+    pool->head = 0;
+    pool->run = run;
+    pool->context = context;
+    pool->state = state;
+    pool->appliedMinWorkers = state->minWorkers;
+    pool->appliedMaxWorkers = state->maxWorkers;
+
+    // Les compteurs de threads sont ceux de ce processus : un service relancé repart de zéro
+    state->workers = 0;
+    state->idleWorkers = 0;
+    state->queued = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (state->workers < state->minWorkers && spawnWorker(pool));
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief Routine d'un thread de la réserve.
+ *
+ * Le thread exécute les opérations de la file dans leur ordre de dépôt. Sans opération, il attend sur la variable
+ * de condition : indéfiniment si la réserve est à son minimum, sinon au plus `idleTimeoutMs`, après quoi il
+ * s'arrête. Il s'arrête aussi, sans attendre, si la réserve dépasse un maximum abaissé entre-temps.
+ *
+ * @param arg Pointeur vers la réserve.
+ * @return void* NULL.
+ */
+void *workerThread(void *arg) {
+    WorkerPool *pool = (WorkerPool *) arg;
+    WorkerPoolState *state = pool->state;
+
+    registerProfilerThread();
+    pthread_mutex_lock(&pool->lock);
+
+    while (1) {
+        if (state->queued == 0) {
+            bool timedOut = false;
+            uint64_t deadline = getMonotonicTime() + (uint64_t) state->idleTimeoutMs * 1000000;
+            struct timespec timeout = { .tv_sec = deadline / 1000000000, .tv_nsec = deadline % 1000000000 };
+
+            state->idleWorkers += 1;
+
+            while (state->queued == 0 && !timedOut && state->workers <= state->maxWorkers) {
+                if (state->workers > state->minWorkers) {
+                    timedOut = pthread_cond_timedwait(&pool->available, &pool->lock, &timeout) == ETIMEDOUT;
+                } else {
+                    pthread_cond_wait(&pool->available, &pool->lock);
+                }
+            }
+
+            state->idleWorkers -= 1;
+
+            if (state->queued == 0 && (state->workers > state->maxWorkers || (timedOut && state->workers > state->minWorkers))) {
+                break;
+            }
+
+            if (state->queued == 0) {
+                continue;
+            }
+        }
+
+        int item = pool->items[pool->head];
+        uint64_t queuedAt = pool->queuedAt[pool->head];
+        pool->head = (pool->head + 1) % MAX_PHILOSOPHERS;
+        state->queued -= 1;
+        pthread_mutex_unlock(&pool->lock);
+
+        recordHistogram(&state->queueWaits, (getMonotonicTime() - queuedAt) / 1000);
+        __atomic_add_fetch(&state->jobs, 1, __ATOMIC_RELAXED);
+        pool->run(pool->context, item);
+
+        pthread_mutex_lock(&pool->lock);
+    }
+
+    state->workers -= 1;
+    state->retired += 1;
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Dépose une opération dans la file de la réserve.
+ *
+ * Un thread est ajouté si les opérations en attente sont plus nombreuses que les threads libres : une rafale obtient
+ * autant de threads qu'elle compte d'opérations, dans la limite de `maxWorkers`.
+ *
+ * @param pool La réserve.
+ * @param item L'opération ; une même opération n'est jamais déposée deux fois en même temps.
+ * @return bool false si la réserve n'a aucun thread et ne peut pas en créer : l'opération n'est pas déposée.
+ */
+bool submitWork(WorkerPool *pool, int item) {
+    WorkerPoolState *state = pool->state;
+
+    pthread_mutex_lock(&pool->lock);
+
+    int tail = (pool->head + state->queued) % MAX_PHILOSOPHERS;
+    pool->items[tail] = item;
+    pool->queuedAt[tail] = getMonotonicTime();
+    state->queued += 1;
+
+    if (state->queued > state->idleWorkers) {
+        spawnWorker(pool);
+    }
+
+    if (state->workers == 0) {
+        state->queued -= 1;
+        pthread_mutex_unlock(&pool->lock);
+        return false;
+    }
+
+    pthread_cond_signal(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+
+    return true;
+}
+
+/**
+ * @brief Applique les réglages de la réserve, et lui ajoute un thread si la plus ancienne opération de la file
+ * attend depuis plus de `growLatencyMs`.
+ *
+ * Appelée à chaque tour de la boucle principale du service : elle réveille les threads libres quand la commande de
+ * contrôle `pool` a changé les réglages (un thread qui attendait sans délai au minimum peut désormais s'arrêter),
+ * complète la réserve jusqu'à son minimum, et rattrape les créations de threads échouées ou bloquées par un maximum
+ * relevé depuis.
+ *
+ * @param pool La réserve.
+ * @return int Le nombre d'opérations en attente.
+ */
+int growWorkerPool(WorkerPool *pool) {
+    WorkerPoolState *state = pool->state;
+
+    pthread_mutex_lock(&pool->lock);
+
+    if (state->minWorkers != pool->appliedMinWorkers || state->maxWorkers != pool->appliedMaxWorkers) {
+        pool->appliedMinWorkers = state->minWorkers;
+        pool->appliedMaxWorkers = state->maxWorkers;
+        pthread_cond_broadcast(&pool->available);
+    }
+
+    while (state->workers < state->minWorkers && spawnWorker(pool));
+
+    if (state->queued > 0 && getMonotonicTime() - pool->queuedAt[pool->head] >= (uint64_t) state->growLatencyMs * 1000000) {
+        spawnWorker(pool);
+    }
+
+    int queued = state->queued;
+    pthread_mutex_unlock(&pool->lock);
+
+    return queued;
+}
+
+#endif
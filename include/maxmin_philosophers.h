@@ -8,7 +8,8 @@
  * Les macros définies sont :
  *  - **MIN_PHILOSOPHERS** : Le nombre minimum de philosophes requis pour démarrer le système (2).
  *  - **MAX_PHILOSOPHERS** : Le nombre maximum de philosophes autorisés dans le système. 
- *    Cette valeur est arbitraire mais doit être inférieure ou égale à la macro FOPEN_MAX.
+ *    Cette valeur est arbitraire mais doit être inférieure ou égale à la macro FOPEN_MAX. Elle peut être redéfinie à
+ *    la compilation (`-DMAX_PHILOSOPHERS=n`), comme le fait l'outil `loadbench` pour chaque taille de table mesurée.
  *  - **MIN_STATE_TIME** : Le temps minimum (en secondes) qu'un philosophe doit passer dans un état donné.
  *  - **MAX_STATE_TIME** : Le temps maximum (en secondes) qu'un philosophe peut passer dans un état donné.
  *
@@ -29,9 +30,11 @@
 /**
  * @brief Nombre maximum de philosophes autorisés.
  *
- * Valeur arbitraire mais doit être inférieure ou égale à la macro FOPEN_MAX.
+ * Valeur arbitraire mais doit être inférieure ou égale à la macro FOPEN_MAX. Redéfinissable à la compilation.
  */
+#ifndef MAX_PHILOSOPHERS
 #define MAX_PHILOSOPHERS 7
+#endif
 
 /**
  * @brief Temps minimum dans un état en secondes.
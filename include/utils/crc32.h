@@ -0,0 +1,58 @@
+/**
+ * @file crc32.h
+ * @brief Définit le calcul de la somme de contrôle CRC-32 utilisée par les enregistrements sur disque.
+ *
+ * Il s'agit du CRC-32 usuel (polynôme 0xEDB88320 en ordre réfléchi, celui de zlib et d'Ethernet), calculé octet
+ * par octet à l'aide d'une table de 256 entrées construite à la première utilisation.
+ *
+ * Les fonctions définies sont :
+ *  - **crc32()** : Calcule le CRC-32 d'un tampon.
+ *
+ * Les inclusions nécessaires sont <stdint.h> et <stddef.h>.
+ */
+
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Calcule le CRC-32 d'un tampon.
+ *
+ * La table est construite sans verrou : deux threads qui la construiraient en même temps y écriraient les mêmes
+ * valeurs.
+ *
+ * @param data Le tampon.
+ * @param size Taille du tampon.
+ * @return uint32_t La somme de contrôle.
+ */
+uint32_t crc32(const void *data, size_t size) {
+    static uint32_t table[256];
+    static volatile int tableReady = 0;
+
+    if (!tableReady) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i;
+
+            for (int bit = 0; bit < 8; bit++) {
+                value = (value & 1) ? (value >> 1) ^ 0xEDB88320U : value >> 1;
+            }
+
+            table[i] = value;
+        }
+
+        __atomic_store_n(&tableReady, 1, __ATOMIC_RELEASE);
+    }
+
+    const uint8_t *bytes = data;
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+
+    return crc ^ 0xFFFFFFFFU;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file dates.h
+ * @brief Définit la conversion des heures saisies par l'utilisateur dans les outils en ligne de commande.
+ *
+ * Ce fichier d'en-tête fournit la fonction **parseQueryTime()**, utilisée par les outils `logquery` et `metrics`
+ * pour interpréter les bornes de leurs requêtes. Les formats acceptés sont "HH:MM[:SS]" (jour courant),
+ * "AAAA-MM-JJ HH:MM[:SS]", "AAAA-MM-JJTHH:MM[:SS]" ou "@secondes" (epoch).
+ *
+ * Les inclusions nécessaires sont <stdio.h>, <stdlib.h>, <stdint.h>, <stdbool.h> et <time.h>.
+ */
+
+#ifndef DATES_H
+#define DATES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * @brief Convertit une heure saisie par l'utilisateur en horodatage.
+ *
+ * @param text L'heure saisie.
+ * @param isEnd true pour une borne de fin : sans les secondes, la minute entière est couverte.
+ * @param timestamp Horodatage résultant en nanosecondes depuis l'epoch.
+ * @return bool true si le format est reconnu.
+ */
+bool parseQueryTime(const char *text, bool isEnd, uint64_t *timestamp) {
+    if (text[0] == '@') {
+        char *end;
+        unsigned long long seconds = strtoull(text + 1, &end, 10);
+        if (*end != '\0') {
+            return false;
+        }
+        *timestamp = seconds * 1000000000ULL + (isEnd ? 999999999ULL : 0);
+        return true;
+    }
+
+    struct tm date;
+    time_t now = time(NULL);
+    localtime_r(&now, &date);
+
+    int year, month, day, hour, minute, second = 0;
+    int fields = sscanf(text, "%d-%d-%d%*1[ T]%d:%d:%d", &year, &month, &day, &hour, &minute, &second);
+
+    if (fields >= 5) {
+        date.tm_year = year - 1900;
+        date.tm_mon = month - 1;
+        date.tm_mday = day;
+    } else {
+        second = 0;
+        fields = sscanf(text, "%d:%d:%d", &hour, &minute, &second);
+        if (fields < 2) {
+            return false;
+        }
+        fields += 3;
+    }
+
+    date.tm_hour = hour;
+    date.tm_min = minute;
+    date.tm_sec = second;
+    date.tm_isdst = -1;
+
+    time_t seconds = mktime(&date);
+    if (seconds == -1) {
+        return false;
+    }
+
+    *timestamp = (uint64_t) seconds * 1000000000ULL;
+    if (isEnd) {
+        *timestamp += (fields == 6 ? 1ULL : 60ULL) * 1000000000ULL - 1;
+    }
+
+    return true;
+}
+
+#endif
@@ -4,12 +4,11 @@
  *
  * Ce fichier d'en-tête fournit deux fonctions principales :
  *  - **emptyStdBuffer()** : Vide le tampon de l'entrée standard (clavier) en consommant tous les caractères restants.
- *  - **getFilePath(char *filename)** : Construit et retourne le chemin absolu d'un fichier en se basant sur le répertoire courant.
+ *  - **getFilePath(const char *filename, char *path, size_t size)** : Construit le chemin absolu d'un fichier en se
+ *    basant sur le répertoire courant, dans un tampon fourni par l'appelant.
  *
- * Les fonctions utilisent les bibliothèques standards <stdio.h>, <string.h>, <unistd.h> et <stdlib.h>.
- *
- * @note La fonction getFilePath() alloue dynamiquement la mémoire pour le chemin complet. Il est impératif de libérer
- *       cette mémoire après utilisation afin d'éviter les fuites.
+ * Les fonctions utilisent les bibliothèques standards <stdio.h>, <string.h>, <unistd.h>, <stdlib.h>, <stdbool.h>
+ * et <limits.h>.
  */
 
 #ifndef FILES_H
@@ -19,6 +18,8 @@
 #include <string.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <limits.h>
 
 /**
  * @brief Vide le tampon de l'entrée standard.
@@ -33,43 +34,29 @@ void emptyStdBuffer() {
 }
 
 /**
- * @brief Construit et retourne le chemin absolu d'un fichier.
+ * @brief Construit le chemin absolu d'un fichier dans un tampon fourni par l'appelant.
  *
- * Cette fonction récupère le répertoire courant à l'aide de getcwd(), puis concatène ce répertoire avec le nom du fichier
- * passé en paramètre pour construire le chemin absolu du fichier. La mémoire allouée pour le chemin complet est dynamique
- * et doit être libérée par l'appelant.
+ * Le répertoire courant est lu une seule fois, à la première construction, puis conservé : les chemins sont
+ * construits sans appel système ni allocation (le serveur ne change jamais de répertoire courant).
  *
  * @param filename Chaîne de caractères représentant le nom du fichier.
- * @return char* Pointeur vers une chaîne de caractères contenant le chemin absolu du fichier, ou NULL en cas d'erreur.
+ * @param path Tampon recevant le chemin absolu du fichier.
+ * @param size Taille du tampon.
+ * @return bool false si le répertoire courant est illisible ou si le chemin ne tient pas dans le tampon.
  *
- * @note En cas d'échec de getcwd() ou de malloc(), la fonction affiche un message d'erreur via perror() et retourne NULL.
+ * @note En cas d'échec de getcwd(), la fonction affiche un message d'erreur via perror().
  */
-char *getFilePath(char *filename) {
-
-    char *cwd = getcwd(NULL, 0);
+bool getFilePath(const char *filename, char *path, size_t size) {
+    static char cwd[PATH_MAX];
 
-    if (cwd == NULL) {
+    if (cwd[0] == '\0' && getcwd(cwd, sizeof(cwd)) == NULL) {
         perror("getcwd");
-        return NULL;
+        return false;
     }
 
-    // Calcule la taille nécessaire :
-    //   longueur de cwd + 1 caractère pour '/' + longueur de filename + 1 caractère pour '\0'
-    size_t len = strlen(cwd) + 1 + strlen(filename) + 1;
-    char *fullPath = malloc(len);
-    if (fullPath == NULL) {
-        perror("malloc");
-        free(cwd);
-        return NULL;
-    }
-
-    // Construit la chaîne finale
-    snprintf(fullPath, len, "%s/%s", cwd, filename);
-
-    // Libère le buffer alloué par getcwd
-    free(cwd);
+    int length = snprintf(path, size, "%s/%s", cwd, filename);
 
-    return fullPath;
+    return length >= 0 && (size_t) length < size;
 }
 
 #endif
\ No newline at end of file
@@ -4,10 +4,12 @@
  *
  * Ce fichier d'en-tête permet la création et la configuration des sockets pour établir une communication
  * réseau en utilisant le protocole TCP/IP. Il définit des macros pour le port, l'adresse IP, la famille de socket,
- * le type de socket ainsi que le nombre maximum de tentatives pour les opérations de lecture et d'écriture sur un socket.
+ * le type de socket, l'option du client pour changer de port (PORT_OPTION, pour passer par le proxy de dégradation
+ * réseau par exemple) ainsi que le nombre maximum de tentatives pour les opérations de lecture et d'écriture sur un socket.
  *
  * Les fonctions et structures fournies dans ce fichier sont :
  *  - **getSocket()** : Crée et retourne un socket.
+ *  - **getDatagramSocket()** : Crée et retourne un socket UDP, pour le mode datagramme.
  *  - **getServerAddress()** : Retourne la structure in_addr correspondant à l'adresse IP du serveur.
  *  - **getSocketAddress()** : Retourne une structure sockaddr_in configurée avec l'adresse IP et le port du serveur.
  *  - **Socket** : Structure encapsulant un socket et son adresse associée.
@@ -25,9 +27,11 @@
 #include <unistd.h>
 
 #define PORT 9002
+#define PORT_OPTION "-p"
 #define ADDRESS "127.0.0.1"
 #define SOCKET_FAMILY AF_INET
 #define SOCKET_TYPE SOCK_STREAM
+#define DATAGRAM_SOCKET_TYPE SOCK_DGRAM
 #define MAX_ATTEMPTS 5
 
 /**
@@ -53,6 +57,15 @@ int getSocket() {
     return socket(SOCKET_FAMILY, SOCKET_TYPE, 0);
 }
 
+/**
+ * @brief Crée et retourne un socket UDP, pour le mode datagramme (voir Datagram.h).
+ *
+ * @return int Le descripteur du socket créé.
+ */
+int getDatagramSocket() {
+    return socket(SOCKET_FAMILY, DATAGRAM_SOCKET_TYPE, 0);
+}
+
 /**
  * @brief Retourne l'adresse du serveur sous forme de structure in_addr.
  *
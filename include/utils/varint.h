@@ -0,0 +1,95 @@
+/**
+ * @file varint.h
+ * @brief Définit le codage des entiers en longueur variable (varint) utilisé par les messages compacts.
+ *
+ * Un varint code un entier non signé par groupes de 7 bits, des poids faibles aux poids forts ; le bit de poids fort
+ * de chaque octet indique qu'un octet suit. Les petites valeurs, les plus fréquentes (timers, écarts entre
+ * identifiants), tiennent donc sur un seul octet. Les entiers signés passent d'abord par le codage zigzag, qui
+ * range 0, -1, 1, -2, 2... sur 0, 1, 2, 3, 4... pour que les petites valeurs négatives restent courtes.
+ *
+ * Les fonctions définies sont :
+ *  - **zigzagEncode()** / **zigzagDecode()** : Conversion entre entiers signés et non signés.
+ *  - **writeVarint()** : Écrit un varint dans un tampon.
+ *  - **readVarint()** : Lit un varint depuis un tampon, en vérifiant ses bornes.
+ *
+ * La macro **VARINT_MAX_SIZE** donne la taille maximale d'un varint de 64 bits.
+ *
+ * Les inclusions nécessaires sont <stdint.h>, <stddef.h> et <stdbool.h>.
+ */
+
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Taille maximale d'un varint de 64 bits.
+ */
+#define VARINT_MAX_SIZE 10
+
+/**
+ * @brief Convertit un entier signé en entier non signé par le codage zigzag.
+ *
+ * @param value L'entier signé.
+ * @return uint64_t L'entier codé.
+ */
+uint64_t zigzagEncode(int64_t value) {
+    return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+/**
+ * @brief Retrouve un entier signé codé par zigzagEncode().
+ *
+ * @param value L'entier codé.
+ * @return int64_t L'entier signé.
+ */
+int64_t zigzagDecode(uint64_t value) {
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+/**
+ * @brief Écrit un varint dans un tampon.
+ *
+ * @param buffer Le tampon, d'au moins VARINT_MAX_SIZE octets disponibles.
+ * @param value La valeur à écrire.
+ * @return size_t Le nombre d'octets écrits.
+ */
+size_t writeVarint(uint8_t *buffer, uint64_t value) {
+    size_t size = 0;
+
+    while (value >= 0x80) {
+        buffer[size++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+
+    buffer[size++] = (uint8_t) value;
+    return size;
+}
+
+/**
+ * @brief Lit un varint depuis un tampon.
+ *
+ * @param buffer Le tampon.
+ * @param size Taille du tampon.
+ * @param offset Position de lecture, avancée après le varint.
+ * @param value Reçoit la valeur lue.
+ * @return bool false si le varint dépasse la fin du tampon ou 64 bits.
+ */
+bool readVarint(const uint8_t *buffer, size_t size, size_t *offset, uint64_t *value) {
+    *value = 0;
+
+    for (int shift = 0; shift < 64 && *offset < size; shift += 7) {
+        uint8_t byte = buffer[(*offset)++];
+        *value |= (uint64_t) (byte & 0x7f) << shift;
+
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif
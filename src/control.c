@@ -0,0 +1,98 @@
+/**
+ * @file control.c
+ * @brief Outil d'envoi de commandes au socket de contrôle du serveur.
+ *
+ * Le serveur écoute un socket Unix local (CONTROL_SOCKET_PATH, voir Control.h) sur lequel un opérateur peut agir
+ * sur la table sans la redémarrer. Cet outil envoie une commande, affiche la réponse du serveur puis se termine.
+ *
+ * Utilisation (depuis le dossier src, comme le serveur) : `control <commande> [arguments]`
+ *  - `control stats` : état de la table et statistiques.
+ *  - `control loglevel [none|server|all]` : affiche ou change le niveau de logs.
+ *  - `control capacity [n]` : affiche ou change le nombre maximum de philosophes à table.
+ *  - `control policy [counter|ordered]` : affiche ou change la politique d'arbitrage.
+ *  - `control drain <philosophe>` / `control resume <philosophe>` : cesse ou reprend le service d'un philosophe.
+ *  - `control evict <philosophe>` : retire un philosophe de la table.
+ *  - `control checkpoint` : écrit l'état de la table dans CHECKPOINT_PATH.
+ *  - `control ledger [sync|async|<ms>]` : état du registre des repas, attente de durabilité, intervalle de validation.
+ *  - `control upgrade [chemin]` : met à jour le serveur à chaud vers un nouveau binaire.
+ *  - `control help` : liste des commandes.
+ *
+ * Le code de sortie est 1 si le serveur répond par une erreur ou n'est pas joignable.
+ *
+ * Compilation : `gcc control.c -o control`
+ */
+
+#include "../include/utils/print_message.h"
+#include "../include/entities/Control.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/**
+ * @brief Point d'entrée de l'outil.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments : la commande suivie de ses arguments.
+ * @return int Code de sortie.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("Utilisation : %s <commande> [arguments]   (%s help pour la liste des commandes)\n", argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Les arguments sont réunis en une seule ligne, terminée par un retour à la ligne
+    char command[CONTROL_BUFFER_SIZE] = "";
+    size_t length = 0;
+
+    for (int i = 1; i < argc; i++) {
+        int written = snprintf(command + length, sizeof(command) - length, "%s%s", i > 1 ? " " : "", argv[i]);
+
+        if (written < 0 || (size_t) written >= sizeof(command) - length - 1) {
+            printMessage(ERROR, "Commande trop longue (%d octets max).\n", CONTROL_BUFFER_SIZE - 2);
+            return EXIT_FAILURE;
+        }
+
+        length += written;
+    }
+
+    command[length++] = '\n';
+
+    int controlSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, CONTROL_SOCKET_PATH, sizeof(address.sun_path) - 1);
+
+    if (controlSocket == -1 || connect(controlSocket, (struct sockaddr *) &address, sizeof(address)) == -1) {
+        printMessage(ERROR, "Impossible de joindre le serveur sur %s (serveur arrêté ou outil lancé hors du dossier src).\n", CONTROL_SOCKET_PATH);
+        perror("connect");
+        return EXIT_FAILURE;
+    }
+
+    if (write(controlSocket, command, length) != (ssize_t) length) {
+        printMessage(ERROR, "Erreur lors de l'envoi de la commande.\n");
+        perror("write");
+        close(controlSocket);
+        return EXIT_FAILURE;
+    }
+
+    // Le serveur ferme la connexion après sa réponse
+    char reply[CONTROL_REPLY_SIZE];
+    size_t replyLength = 0;
+    ssize_t bytesReceived;
+
+    while (replyLength < sizeof(reply) - 1 && (bytesReceived = read(controlSocket, reply + replyLength, sizeof(reply) - 1 - replyLength)) > 0) {
+        replyLength += bytesReceived;
+    }
+
+    reply[replyLength] = '\0';
+    close(controlSocket);
+
+    fputs(reply, stdout);
+
+    return strncmp(reply, "error", 5) == 0 || replyLength == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,439 @@
+/**
+ * @file dashboard.c
+ * @brief Tableau de bord en direct de la table, lu directement dans la mémoire partagée du serveur.
+ *
+ * L'outil s'attache en lecture seule (SHM_RDONLY) au segment de mémoire partagée du serveur, retrouvé grâce à sa
+ * clé nommée (voir SharedResources.h), et affiche plusieurs fois par seconde :
+ *  - l'état de chaque philosophe, son timer, l'âge de sa faim et son nombre de repas,
+ *  - le philosophe qui tient chaque baguette,
+ *  - le nombre de places libres au compteur, le nombre total de repas et le débit de repas accordés,
+ *  - l'histogramme des temps d'attente et ses percentiles.
+ *
+ * Aucune donnée ne passe par le serveur ni par la file des logs : l'observation ne prend aucun sémaphore et
+ * n'ajoute aucune charge à la table. Les valeurs sont lues sans verrou, un affichage peut donc mêler deux états
+ * successifs d'un même philosophe, ce qui est sans conséquence pour un affichage rafraîchi en continu.
+ *
+ * L'écran est redessiné avec des séquences ANSI : chaque image est comparée ligne par ligne à la précédente et
+ * seules les lignes modifiées sont réécrites, ce qui évite le scintillement d'un effacement complet.
+ *
+ * Utilisation (depuis le dossier src, comme le serveur) : `dashboard [-r fréquence]`
+ *  - `-r` : nombre d'images par seconde, entre 1 et 30 (par défaut 10).
+ *
+ * L'outil s'arrête avec Ctrl+C ou lorsque le serveur supprime son segment.
+ *
+ * Compilation : `gcc dashboard.c -o dashboard -lpthread`
+ */
+
+#include "../include/utils/print_message.h"
+#include "../include/entities/SharedResources.h"
+#include "../include/managers/SharedResources.c"
+#include "../include/managers/Statistics.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/shm.h>
+
+/**
+ * @brief Nombre maximum de lignes d'une image.
+ */
+#define DASHBOARD_MAX_LINES 128
+
+/**
+ * @brief Taille maximum d'une ligne d'une image.
+ */
+#define DASHBOARD_LINE_SIZE 160
+
+/**
+ * @brief Largeur maximum des barres de l'histogramme.
+ */
+#define DASHBOARD_BAR_WIDTH 40
+
+/**
+ * @brief Image du tableau de bord, ligne par ligne.
+ */
+typedef struct {
+    char lines[DASHBOARD_MAX_LINES][DASHBOARD_LINE_SIZE];
+    int numberLines;
+} Frame;
+
+/**
+ * @brief Flag indiquant la demande d'arrêt du tableau de bord.
+ */
+volatile sig_atomic_t shutdownFlag = 0;
+
+/**
+ * @brief Handler de signal pour terminer le programme.
+ *
+ * @param signum Numéro du signal reçu.
+ */
+void programEndHandler(int signum) {
+    shutdownFlag = 1;
+}
+
+/**
+ * @brief Affiche l'utilisation de l'outil.
+ *
+ * @param program Nom du programme.
+ */
+void usage(const char *program) {
+    printf("Utilisation : %s [-r fréquence]\n", program);
+    printf("  -r : images par seconde, entre 1 et 30 (par défaut 10)\n");
+}
+
+/**
+ * @brief Ajoute une ligne formatée à une image.
+ *
+ * @param frame L'image.
+ * @param format Le format de la ligne, comme pour printf.
+ */
+void addLine(Frame *frame, const char *format, ...) {
+    if (frame->numberLines >= DASHBOARD_MAX_LINES) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(frame->lines[frame->numberLines], DASHBOARD_LINE_SIZE, format, args);
+    va_end(args);
+
+    frame->numberLines += 1;
+}
+
+/**
+ * @brief Formate une durée exprimée en microsecondes avec une unité lisible.
+ *
+ * @param buffer Le tampon de destination.
+ * @param size La taille du tampon.
+ * @param microseconds La durée.
+ */
+void formatDuration(char *buffer, size_t size, uint64_t microseconds) {
+    if (microseconds < 1000) {
+        snprintf(buffer, size, "%lu µs", (unsigned long) microseconds);
+    } else if (microseconds < 1000000) {
+        snprintf(buffer, size, "%.1f ms", microseconds / 1000.0);
+    } else {
+        snprintf(buffer, size, "%.1f s", microseconds / 1000000.0);
+    }
+}
+
+/**
+ * @brief Retourne le libellé d'un état de philosophe.
+ *
+ * @param philosopher Le philosophe.
+ * @return const char* Le libellé.
+ */
+const char *getStateLabel(const ServerPhilosopher *philosopher) {
+    if (philosopher->departed) {
+        return "parti";
+    }
+
+    switch (philosopher->base.state) {
+        case THINKING: return "pense";
+        case HUNGRY:   return "a faim";
+        case EATING:   return "mange";
+    }
+    return "?";
+}
+
+/**
+ * @brief Construit l'image du tableau de bord à partir de la mémoire partagée.
+ *
+ * Le résumé et l'histogramme des attentes passent en premier. Les places et les baguettes se partagent les lignes
+ * restantes de l'image : sur une grande table, chaque section indique le nombre de lignes qu'elle n'a pas pu afficher.
+ *
+ * @param frame L'image à remplir.
+ * @param sharedResources Les ressources partagées, attachées en lecture seule.
+ * @param mealsRate Le débit de repas accordés (repas par seconde) mesuré sur la dernière seconde.
+ */
+void renderFrame(Frame *frame, const SharedResources *sharedResources, double mealsRate) {
+    frame->numberLines = 0;
+
+    uint64_t now = getMonotonicTime();
+    int numberPhilosophers = sharedResources->numberPhilosophers;
+
+    if (numberPhilosophers < 0 || numberPhilosophers > MAX_PHILOSOPHERS) {
+        numberPhilosophers = 0;
+    }
+
+    int allowedEating = 0;
+    sem_getvalue((sem_t *) &sharedResources->maxAllowedEating, &allowedEating);
+
+    // Copie de l'histogramme pour que les percentiles et les barres soient calculés sur les mêmes valeurs
+    Histogram waits = sharedResources->statistics.waitHistogram;
+    char p50[32], p90[32], p99[32];
+    formatDuration(p50, sizeof(p50), getHistogramPercentile(&waits, 50));
+    formatDuration(p90, sizeof(p90), getHistogramPercentile(&waits, 90));
+    formatDuration(p99, sizeof(p99), getHistogramPercentile(&waits, 99));
+
+    static const char *policies[] = { "compteur", "ordonnée", "séquencée" };
+    int numberSeated = sharedResources->numberSeated;
+
+    addLine(frame, "\x1B[1mTable des philosophes\x1B[0m  (%d/%d places, politique %s)", numberSeated, sharedResources->capacity, policies[sharedResources->policy]);
+    addLine(frame, "Compteur : %d place(s) libre(s) sur %d", allowedEating, numberSeated / 2);
+    addLine(frame, "Repas accordés : %lu  (%.2f repas/s)", (unsigned long) sharedResources->statistics.meals, mealsRate);
+    addLine(frame, "Attente p50 < %s   p90 < %s   p99 < %s", p50, p90, p99);
+    addLine(frame, "");
+
+    // Histogramme des attentes, des plus courtes aux plus longues classes non vides, affiché avant les places pour
+    // ne jamais être coupé par une grande table
+    int first = -1, last = -1;
+    uint64_t highest = 0;
+
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        if (waits.buckets[i]) {
+            if (first == -1) {
+                first = i;
+            }
+            last = i;
+            if (waits.buckets[i] > highest) {
+                highest = waits.buckets[i];
+            }
+        }
+    }
+
+    addLine(frame, "\x1B[1mTemps d'attente avant de manger\x1B[0m");
+    if (first == -1) {
+        addLine(frame, "(aucun repas accordé)");
+    }
+
+    for (int i = first; first != -1 && i <= last; i++) {
+        char bound[32];
+        char bar[DASHBOARD_BAR_WIDTH + 1];
+        int width = (int) (waits.buckets[i] * DASHBOARD_BAR_WIDTH / highest);
+
+        formatDuration(bound, sizeof(bound), i == 0 ? 1 : 1ULL << i);
+        memset(bar, '#', width);
+        bar[width] = '\0';
+
+        addLine(frame, "< %-10s %-*s %lu", bound, DASHBOARD_BAR_WIDTH, bar, (unsigned long) waits.buckets[i]);
+    }
+
+    // Les places et les baguettes se partagent les lignes restantes (hors titres et lignes vides) ; une section qui
+    // n'a pas besoin de sa moitié laisse le reste à l'autre
+    int numberSeats = 0, numberChopsticks = 0;
+
+    for (int i = 0; i < numberPhilosophers; i++) {
+        numberSeats += sharedResources->philosophers[i].base.id != 0;
+        numberChopsticks += sharedResources->chopsticks[i].id != 0;
+    }
+
+    int rows = DASHBOARD_MAX_LINES - frame->numberLines - 4;
+    rows = rows < 0 ? 0 : rows;
+    int seatRows = numberSeats;
+
+    if (seatRows > rows / 2 && seatRows > rows - numberChopsticks) {
+        seatRows = rows - numberChopsticks > rows / 2 ? rows - numberChopsticks : rows / 2;
+    }
+
+    int chopstickRows = rows - seatRows;
+
+    // Une section coupée garde sa dernière ligne pour indiquer le nombre de lignes masquées
+    int shownSeats = numberSeats > seatRows ? seatRows - 1 : numberSeats;
+    int shownChopsticks = numberChopsticks > chopstickRows ? chopstickRows - 1 : numberChopsticks;
+
+    addLine(frame, "");
+    addLine(frame, "\x1B[1m%-10s %-8s %-6s %-12s %s\x1B[0m", "Philosophe", "État", "Timer", "Faim depuis", "Repas");
+    for (int i = 0, shown = 0; i < numberPhilosophers && shown < shownSeats; i++) {
+        const ServerPhilosopher *philosopher = &sharedResources->philosophers[i];
+        uint64_t hungrySince = philosopher->hungrySince;
+        char hunger[32] = "-";
+
+        // Place vide laissée par le compactage
+        if (philosopher->base.id == 0) {
+            continue;
+        }
+
+        if (hungrySince && now > hungrySince) {
+            formatDuration(hunger, sizeof(hunger), (now - hungrySince) / 1000);
+        }
+
+        addLine(
+            frame,
+            "%-10d %-8s %-6d %-12s %-8lu%s",
+            philosopher->base.id,
+            getStateLabel(philosopher),
+            philosopher->base.stateTimer,
+            hunger,
+            (unsigned long) philosopher->meals,
+            philosopher->draining && !philosopher->departed ? "en drain" : ""
+        );
+        shown++;
+    }
+    if (shownSeats < numberSeats) {
+        addLine(frame, "+%d autre(s) philosophe(s)", numberSeats - (shownSeats > 0 ? shownSeats : 0));
+    }
+    addLine(frame, "");
+
+    // Chaque philosophe apporte sa baguette gauche : il y a autant de baguettes que de philosophes
+    addLine(frame, "\x1B[1m%-10s %s\x1B[0m", "Baguette", "Tenue par");
+    for (int i = 0, shown = 0; i < numberPhilosophers && shown < shownChopsticks; i++) {
+        int holderId = sharedResources->chopsticks[i].holderId;
+
+        if (sharedResources->chopsticks[i].id == 0) {
+            continue;
+        }
+
+        if (holderId) {
+            addLine(frame, "%-10d philosophe %d", sharedResources->chopsticks[i].id, holderId);
+        } else {
+            addLine(frame, "%-10d libre", sharedResources->chopsticks[i].id);
+        }
+        shown++;
+    }
+    if (shownChopsticks < numberChopsticks) {
+        addLine(frame, "+%d autre(s) baguette(s)", numberChopsticks - (shownChopsticks > 0 ? shownChopsticks : 0));
+    }
+}
+
+/**
+ * @brief Affiche une image en ne réécrivant que les lignes qui diffèrent de l'image précédente.
+ *
+ * @param frame La nouvelle image.
+ * @param previous L'image actuellement affichée.
+ */
+void drawFrame(const Frame *frame, const Frame *previous) {
+    int numberLines = frame->numberLines > previous->numberLines ? frame->numberLines : previous->numberLines;
+    bool drawn = false;
+
+    for (int i = 0; i < numberLines; i++) {
+        const char *line = i < frame->numberLines ? frame->lines[i] : "";
+        const char *shown = i < previous->numberLines ? previous->lines[i] : "";
+
+        if (i < previous->numberLines && i < frame->numberLines && strcmp(line, shown) == 0) {
+            continue;
+        }
+
+        // Placement du curseur en début de ligne, écriture puis effacement de la fin de l'ancienne ligne
+        printf("\x1B[%d;1H%s\x1B[K", i + 1, line);
+        drawn = true;
+    }
+
+    if (drawn) {
+        printf("\x1B[%d;1H", frame->numberLines + 1);
+        fflush(stdout);
+    }
+}
+
+/**
+ * @brief Indique si le serveur a supprimé le segment de mémoire partagée.
+ *
+ * @param sharedResourcesMemoryId L'identifiant du segment.
+ * @return true si le segment a été supprimé (ou n'est plus accessible), false sinon.
+ */
+bool isSharedResourcesRemoved(int sharedResourcesMemoryId) {
+    struct shmid_ds status;
+
+    if (shmctl(sharedResourcesMemoryId, IPC_STAT, &status) == -1) {
+        return true;
+    }
+
+    return (status.shm_perm.mode & SHM_DEST) != 0;
+}
+
+/**
+ * @brief Fonction principale du tableau de bord.
+ *
+ * @param argc Nombre d'arguments en ligne de commande.
+ * @param argv Tableau des arguments en ligne de commande.
+ * @return int Code de sortie (0 en cas de succès).
+ */
+int main(int argc, char *argv[]) {
+    int rate = 10;
+    int option;
+
+    while ((option = getopt(argc, argv, "r:")) != -1) {
+        switch (option) {
+            case 'r': rate = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (rate < 1 || rate > 30) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    key_t sharedResourcesKey = getSharedResourcesKey();
+    int sharedResourcesMemoryId = sharedResourcesKey == -1 ? -1 : shmget(sharedResourcesKey, 0, 0);
+
+    if (sharedResourcesMemoryId == -1) {
+        printMessage(ERROR, "Aucun serveur trouvé, le lancer avant le tableau de bord (depuis le dossier src).\n");
+        perror("shmget");
+        return EXIT_FAILURE;
+    }
+
+    const SharedResources *sharedResources = shmat(sharedResourcesMemoryId, NULL, SHM_RDONLY);
+
+    if (sharedResources == (void *) -1) {
+        printMessage(ERROR, "Impossible de s'attacher à la mémoire partagée du serveur.\n");
+        perror("shmat");
+        return EXIT_FAILURE;
+    }
+
+    // Les heures de la table sont lues avec l'étalonnage du serveur, pour être comparables aux siennes
+    setClockSource(&sharedResources->clock);
+
+    struct sigaction signalAction;
+    signalAction.sa_handler = programEndHandler;
+    sigemptyset(&signalAction.sa_mask);
+    signalAction.sa_flags = 0;
+    sigaction(SIGINT, &signalAction, NULL);
+    sigaction(SIGTERM, &signalAction, NULL);
+
+    // Deux images allouées une fois pour toutes : l'une est affichée pendant que l'autre est construite
+    Frame *frames = calloc(2, sizeof(Frame));
+
+    if (!frames) {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+
+    Frame *current = &frames[0];
+    Frame *previous = &frames[1];
+
+    // Effacement de l'écran et masquage du curseur
+    printf("\x1B[2J\x1B[?25l");
+
+    uint64_t rateSampleTime = getMonotonicTime();
+    uint64_t rateSampleMeals = sharedResources->statistics.meals;
+    double mealsRate = 0;
+
+    while (!shutdownFlag && !isSharedResourcesRemoved(sharedResourcesMemoryId)) {
+        uint64_t now = getMonotonicTime();
+
+        // Le débit est recalculé chaque seconde pour rester lisible
+        if (now - rateSampleTime >= 1000000000ULL) {
+            uint64_t meals = sharedResources->statistics.meals;
+            mealsRate = (meals - rateSampleMeals) * 1e9 / (now - rateSampleTime);
+            rateSampleMeals = meals;
+            rateSampleTime = now;
+        }
+
+        renderFrame(current, sharedResources, mealsRate);
+        drawFrame(current, previous);
+
+        Frame *swap = previous;
+        previous = current;
+        current = swap;
+
+        usleep(1000000 / rate);
+    }
+
+    // Restauration du curseur sous la dernière image
+    printf("\x1B[%d;1H\x1B[?25h", previous->numberLines + 1);
+
+    if (!shutdownFlag) {
+        printMessage(INFO, "Le serveur s'est arrêté.\n");
+    }
+
+    free(frames);
+    shmdt(sharedResources);
+
+    return EXIT_SUCCESS;
+}
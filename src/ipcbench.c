@@ -0,0 +1,977 @@
+/**
+ * @file ipcbench.c
+ * @brief Banc d'essai des mécanismes de communication et de synchronisation entre processus utilisés par le serveur.
+ *
+ * Le serveur repose sur une file de messages SysV (logs), des sémaphores `sem_t` partagés entre processus, une
+ * mémoire partagée SysV et une connexion TCP par client. Cet outil mesure le coût de chacun de ces mécanismes face à
+ * ses alternatives, avec un nombre croissant de processus en concurrence, pour que les choix de conception reposent
+ * sur des mesures faites sur nos noyaux.
+ *
+ * Trois groupes de mesures sont disponibles :
+ *  - **queues** : convergence de `n` producteurs vers un consommateur (comme les processus de service vers le thread
+ *    des logs), avec une file SysV, une file POSIX (mqueue), un tube et un anneau en mémoire partagée. La latence est
+ *    mesurée de l'envoi à la réception, file d'attente comprise.
+ *  - **locks** : `n` processus qui prennent et relâchent le même verrou pour incrémenter un compteur partagé, avec
+ *    un `sem_t`, un futex, un `pthread_mutex` partagé (simple et robuste), un `pthread_rwlock` partagé (en écriture,
+ *    comme le verrou de politique) et un verrou actif en opérations atomiques. La latence est celle d'une prise et
+ *    d'un relâchement.
+ *  - **transports** : `n` clients qui font chacun des allers-retours avec leur propre processus d'écho (comme un
+ *    philosophe et son processus de service), en TCP sur la boucle locale, en socket Unix et par deux anneaux en
+ *    mémoire partagée. La latence est celle d'un aller-retour.
+ *
+ * Les messages font BENCH_MESSAGE_SIZE octets, l'ordre de grandeur d'une requête ou d'un message de log.
+ *
+ * Utilisation : `ipcbench [-g groupe] [-c processus] [-n opérations]`
+ *  - `-g` : queues, locks, transports ou all (par défaut all).
+ *  - `-c` : liste des nombres de processus en concurrence, séparés par des virgules (par défaut 1,2,4,8).
+ *  - `-n` : nombre d'opérations par processus (par défaut 20000).
+ *
+ * Les résultats sont affichés au format CSV, une ligne par mécanisme et par nombre de processus : durée totale,
+ * débit (opérations par seconde, tous processus confondus) et percentiles de la latence en nanosecondes.
+ *
+ * Compilation : `gcc ipcbench.c -o ipcbench -lpthread -lrt`
+ */
+
+#include "../include/utils/print_message.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <mqueue.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <semaphore.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/mman.h>
+#include <sys/msg.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+/**
+ * @brief Taille d'un message échangé, en octets.
+ */
+#define BENCH_MESSAGE_SIZE 64
+
+/**
+ * @brief Nombre maximum de processus en concurrence.
+ */
+#define BENCH_MAX_PROCESSES 64
+
+/**
+ * @brief Nombre de places d'un anneau en mémoire partagée (puissance de 2).
+ */
+#define BENCH_RING_SIZE 1024
+
+/**
+ * @brief Nombre de tentatives actives avant de s'endormir sur un futex ou de céder le processeur.
+ */
+#define BENCH_SPINS 100
+
+/**
+ * @brief Message échangé : heure d'envoi, émetteur et numéro, complétés jusqu'à BENCH_MESSAGE_SIZE octets.
+ */
+typedef struct {
+    uint64_t sentAt;   /**< Heure monotone d'envoi (ns) */
+    uint32_t producer; /**< Indice de l'émetteur */
+    uint32_t sequence; /**< Numéro du message chez l'émetteur */
+    char payload[BENCH_MESSAGE_SIZE - 16]; /**< Remplissage */
+} BenchMessage;
+
+/**
+ * @brief Message d'une file SysV : type, puis contenu.
+ */
+typedef struct {
+    long type;           /**< Type du message, toujours 1 */
+    BenchMessage message; /**< Contenu */
+} BenchSysvMessage;
+
+/**
+ * @brief Place d'un anneau : numéro de tour (voir pushRing()) et message.
+ */
+typedef struct {
+    uint64_t sequence;    /**< Numéro attendu pour écrire (libre) ou pour lire (occupée) cette place */
+    BenchMessage message; /**< Message */
+} RingSlot;
+
+/**
+ * @brief Anneau borné en mémoire partagée, plusieurs producteurs et un consommateur.
+ *
+ * Un producteur réserve une position par incrément atomique de `tail`, puis attend que sa place soit libérée par le
+ * tour précédent. Les attentes tournent BENCH_SPINS fois puis s'endorment sur un futex (`readable` ou `writable`),
+ * réveillé seulement si quelqu'un attend.
+ */
+typedef struct {
+    uint64_t head __attribute__((aligned(64))); /**< Prochaine position à lire (consommateur seulement) */
+    uint64_t tail __attribute__((aligned(64))); /**< Prochaine position à réserver (producteurs) */
+    uint32_t readable __attribute__((aligned(64))); /**< Futex, incrémenté à chaque message publié */
+    uint32_t readers;     /**< Consommateur endormi sur `readable` */
+    uint32_t writable;    /**< Futex, incrémenté à chaque place libérée */
+    uint32_t writers;     /**< Producteurs endormis sur `writable` */
+    RingSlot slots[BENCH_RING_SIZE]; /**< Places */
+} Ring;
+
+/**
+ * @brief Verrous comparés et compteur qu'ils protègent, en mémoire partagée.
+ */
+typedef struct {
+    sem_t semaphore;             /**< Sémaphore partagé, comme les baguettes et sémaphores du serveur */
+    uint32_t futexWord;          /**< Mutex à base de futex (0 libre, 1 pris, 2 pris avec attente) */
+    pthread_mutex_t mutex;       /**< Mutex partagé */
+    pthread_mutex_t robustMutex; /**< Mutex partagé et robuste */
+    pthread_rwlock_t rwlock;     /**< Verrou lecteurs/rédacteur partagé, pris en écriture */
+    uint32_t spinWord;           /**< Verrou actif (0 libre, 1 pris) */
+    uint64_t counter __attribute__((aligned(64))); /**< Compteur protégé */
+} Locks;
+
+/**
+ * @brief Groupes de mesures.
+ */
+typedef enum {
+    GROUP_QUEUES,     /**< Convergence de producteurs vers un consommateur */
+    GROUP_LOCKS,      /**< Verrou en concurrence */
+    GROUP_TRANSPORTS  /**< Allers-retours client / processus d'écho */
+} BenchGroup;
+
+/**
+ * @brief Mécanismes mesurés.
+ */
+typedef enum {
+    SYSV_QUEUE, POSIX_QUEUE, PIPE_QUEUE, RING_QUEUE,
+    SEMAPHORE_LOCK, FUTEX_LOCK, MUTEX_LOCK, ROBUST_MUTEX_LOCK, RWLOCK_LOCK, SPIN_LOCK,
+    TCP_TRANSPORT, UNIX_TRANSPORT, RING_TRANSPORT,
+    NUMBER_MECHANISMS
+} Mechanism;
+
+/**
+ * @brief Nom et groupe de chaque mécanisme.
+ */
+const struct {
+    const char *name;
+    BenchGroup group;
+} mechanisms[NUMBER_MECHANISMS] = {
+    [SYSV_QUEUE] = { "sysv-msg", GROUP_QUEUES },
+    [POSIX_QUEUE] = { "posix-mqueue", GROUP_QUEUES },
+    [PIPE_QUEUE] = { "pipe", GROUP_QUEUES },
+    [RING_QUEUE] = { "shm-ring", GROUP_QUEUES },
+    [SEMAPHORE_LOCK] = { "sem_t", GROUP_LOCKS },
+    [FUTEX_LOCK] = { "futex", GROUP_LOCKS },
+    [MUTEX_LOCK] = { "pthread_mutex", GROUP_LOCKS },
+    [ROBUST_MUTEX_LOCK] = { "pthread_mutex-robust", GROUP_LOCKS },
+    [RWLOCK_LOCK] = { "pthread_rwlock", GROUP_LOCKS },
+    [SPIN_LOCK] = { "atomic-spin", GROUP_LOCKS },
+    [TCP_TRANSPORT] = { "tcp-loopback", GROUP_TRANSPORTS },
+    [UNIX_TRANSPORT] = { "unix-socket", GROUP_TRANSPORTS },
+    [RING_TRANSPORT] = { "shm-ring", GROUP_TRANSPORTS }
+};
+
+/**
+ * @brief Noms des groupes, dans l'ordre de BenchGroup.
+ */
+const char *groupNames[] = { "queues", "locks", "transports" };
+
+/**
+ * @brief État d'une mesure, partagé par les processus créés (copié au fork, les zones pointées sont partagées).
+ */
+typedef struct {
+    Mechanism mechanism;  /**< Mécanisme mesuré */
+    int processes;        /**< Nombre de producteurs, de processus en concurrence ou de clients */
+    long operations;      /**< Opérations par processus */
+    uint32_t *samples;    /**< Latences en ns (mémoire partagée), `operations` par processus */
+
+    int queueId;          /**< File SysV */
+    mqd_t posixQueue;     /**< File POSIX */
+    int pipe[2];          /**< Tube */
+    Ring *rings;          /**< Anneaux (mémoire partagée) : un pour les files, deux par client pour les transports */
+    Locks *locks;         /**< Verrous (mémoire partagée) */
+    int listenSocket;     /**< Socket d'écoute TCP des processus d'écho */
+    struct sockaddr_in address; /**< Adresse d'écoute TCP */
+    int pairs[BENCH_MAX_PROCESSES][2]; /**< Paires de sockets Unix, une par client */
+} Bench;
+
+/**
+ * @brief Retourne l'heure monotone en nanosecondes.
+ *
+ * @return uint64_t L'heure.
+ */
+uint64_t nowNanoseconds() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+/**
+ * @brief Enregistre une latence, plafonnée à UINT32_MAX ns.
+ */
+void recordSample(Bench *bench, int process, long operation, uint64_t latency) {
+    bench->samples[(size_t) process * bench->operations + operation] = latency > UINT32_MAX ? UINT32_MAX : (uint32_t) latency;
+}
+
+/**
+ * @brief Appel système futex sur un mot partagé entre processus.
+ */
+long futex(uint32_t *address, int operation, uint32_t value) {
+    return syscall(SYS_futex, address, operation, value, NULL, NULL, 0);
+}
+
+/**
+ * @brief Pause d'une attente active.
+ */
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Attend qu'une place d'anneau porte le numéro attendu, en tournant puis en dormant sur un futex.
+ *
+ * @param slot La place.
+ * @param expected Le numéro attendu.
+ * @param signal Le futex incrémenté par l'autre côté.
+ * @param waiters Le compteur des processus endormis sur ce futex.
+ */
+void waitSlot(RingSlot *slot, uint64_t expected, uint32_t *signal, uint32_t *waiters) {
+    for (int spin = 0; spin < BENCH_SPINS; spin++) {
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) == expected) {
+            return;
+        }
+        cpuRelax();
+    }
+
+    while (1) {
+        uint32_t seen = __atomic_load_n(signal, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_SEQ_CST) == expected) {
+            __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+            return;
+        }
+
+        futex(signal, FUTEX_WAIT, seen);
+        __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+/**
+ * @brief Signale une place publiée ou libérée, et réveille l'autre côté s'il dort.
+ */
+void notifyRing(uint32_t *signal, uint32_t *waiters) {
+    __atomic_add_fetch(signal, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex(signal, FUTEX_WAKE, INT_MAX);
+    }
+}
+
+/**
+ * @brief Initialise un anneau : la place i est libre pour la position i.
+ */
+void initRing(Ring *ring) {
+    memset(ring, 0, sizeof(*ring));
+
+    for (uint64_t i = 0; i < BENCH_RING_SIZE; i++) {
+        ring->slots[i].sequence = i;
+    }
+}
+
+/**
+ * @brief Publie un message dans un anneau.
+ *
+ * La place de la position p est libre quand son numéro vaut p, occupée quand il vaut p + 1 ; le consommateur la
+ * libère pour le tour suivant en y écrivant p + BENCH_RING_SIZE.
+ */
+void pushRing(Ring *ring, const BenchMessage *message) {
+    uint64_t position = __atomic_fetch_add(&ring->tail, 1, __ATOMIC_RELAXED);
+    RingSlot *slot = &ring->slots[position % BENCH_RING_SIZE];
+
+    waitSlot(slot, position, &ring->writable, &ring->writers);
+    slot->message = *message;
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+    notifyRing(&ring->readable, &ring->readers);
+}
+
+/**
+ * @brief Retire le prochain message d'un anneau (un seul consommateur).
+ */
+void popRing(Ring *ring, BenchMessage *message) {
+    uint64_t position = ring->head;
+    RingSlot *slot = &ring->slots[position % BENCH_RING_SIZE];
+
+    waitSlot(slot, position + 1, &ring->readable, &ring->readers);
+    *message = slot->message;
+    __atomic_store_n(&slot->sequence, position + BENCH_RING_SIZE, __ATOMIC_RELEASE);
+    ring->head = position + 1;
+    notifyRing(&ring->writable, &ring->writers);
+}
+
+/**
+ * @brief Prend le mutex à base de futex (algorithme de Drepper, « Futexes Are Tricky »).
+ */
+void futexLock(uint32_t *word) {
+    uint32_t state = 0;
+
+    if (__atomic_compare_exchange_n(word, &state, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    if (state != 2) {
+        state = __atomic_exchange_n(word, 2, __ATOMIC_ACQUIRE);
+    }
+
+    while (state != 0) {
+        futex(word, FUTEX_WAIT, 2);
+        state = __atomic_exchange_n(word, 2, __ATOMIC_ACQUIRE);
+    }
+}
+
+/**
+ * @brief Relâche le mutex à base de futex, en réveillant un processus s'il y a eu attente.
+ */
+void futexUnlock(uint32_t *word) {
+    if (__atomic_fetch_sub(word, 1, __ATOMIC_RELEASE) != 1) {
+        __atomic_store_n(word, 0, __ATOMIC_RELEASE);
+        futex(word, FUTEX_WAKE, 1);
+    }
+}
+
+/**
+ * @brief Prend le verrou actif. Le processeur est cédé après BENCH_SPINS tentatives, sans quoi un détenteur
+ * préempté bloquerait les autres pendant tout leur quantum.
+ */
+void spinLock(uint32_t *word) {
+    int spins = 0;
+
+    while (__atomic_exchange_n(word, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(word, __ATOMIC_RELAXED)) {
+            if (++spins % BENCH_SPINS == 0) {
+                sched_yield();
+            } else {
+                cpuRelax();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Relâche le verrou actif.
+ */
+void spinUnlock(uint32_t *word) {
+    __atomic_store_n(word, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Écrit tout un bloc sur un descripteur.
+ *
+ * @return bool false en cas d'erreur.
+ */
+bool writeAll(int descriptor, const void *data, size_t size) {
+    size_t written = 0;
+
+    while (written < size) {
+        ssize_t bytesWritten = write(descriptor, (const char *) data + written, size - written);
+
+        if (bytesWritten == -1 && errno != EINTR) {
+            return false;
+        }
+
+        written += bytesWritten > 0 ? bytesWritten : 0;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Lit tout un bloc sur un descripteur.
+ *
+ * @return bool false en cas d'erreur ou de fin de fichier.
+ */
+bool readAll(int descriptor, void *data, size_t size) {
+    size_t received = 0;
+
+    while (received < size) {
+        ssize_t bytesRead = read(descriptor, (char *) data + received, size - received);
+
+        if (bytesRead == 0 || (bytesRead == -1 && errno != EINTR)) {
+            return false;
+        }
+
+        received += bytesRead > 0 ? bytesRead : 0;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Alloue une zone de mémoire partagée avec les processus créés ensuite.
+ */
+void *sharedAllocate(size_t size) {
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? NULL : memory;
+}
+
+/**
+ * @brief Prépare les ressources d'une mesure.
+ *
+ * @param bench La mesure (mécanisme, processus et opérations renseignés).
+ * @return bool false si le mécanisme n'est pas disponible.
+ */
+bool setupBench(Bench *bench) {
+    pthread_mutexattr_t mutexAttributes;
+    pthread_rwlockattr_t rwlockAttributes;
+
+    switch (bench->mechanism) {
+        case SYSV_QUEUE:
+            bench->queueId = msgget(IPC_PRIVATE, IPC_CREAT | 0600);
+            return bench->queueId != -1;
+
+        case POSIX_QUEUE: {
+            char name[64];
+            struct mq_attr attributes = { .mq_maxmsg = 10, .mq_msgsize = sizeof(BenchMessage) };
+            snprintf(name, sizeof(name), "/ipcbench_%d", getpid());
+            bench->posixQueue = mq_open(name, O_CREAT | O_EXCL | O_RDWR, 0600, &attributes);
+            mq_unlink(name);
+            return bench->posixQueue != (mqd_t) -1;
+        }
+
+        case PIPE_QUEUE:
+            return pipe(bench->pipe) == 0;
+
+        case RING_QUEUE:
+        case RING_TRANSPORT: {
+            int numberRings = bench->mechanism == RING_QUEUE ? 1 : 2 * bench->processes;
+            bench->rings = sharedAllocate(numberRings * sizeof(Ring));
+
+            for (int i = 0; bench->rings && i < numberRings; i++) {
+                initRing(&bench->rings[i]);
+            }
+            return bench->rings != NULL;
+        }
+
+        case SEMAPHORE_LOCK:
+        case FUTEX_LOCK:
+        case MUTEX_LOCK:
+        case ROBUST_MUTEX_LOCK:
+        case RWLOCK_LOCK:
+        case SPIN_LOCK:
+            bench->locks = sharedAllocate(sizeof(Locks));
+
+            if (!bench->locks) {
+                return false;
+            }
+
+            sem_init(&bench->locks->semaphore, 1, 1);
+            pthread_mutexattr_init(&mutexAttributes);
+            pthread_mutexattr_setpshared(&mutexAttributes, PTHREAD_PROCESS_SHARED);
+            pthread_mutex_init(&bench->locks->mutex, &mutexAttributes);
+            pthread_mutexattr_setrobust(&mutexAttributes, PTHREAD_MUTEX_ROBUST);
+            pthread_mutex_init(&bench->locks->robustMutex, &mutexAttributes);
+            pthread_mutexattr_destroy(&mutexAttributes);
+            pthread_rwlockattr_init(&rwlockAttributes);
+            pthread_rwlockattr_setpshared(&rwlockAttributes, PTHREAD_PROCESS_SHARED);
+            pthread_rwlock_init(&bench->locks->rwlock, &rwlockAttributes);
+            pthread_rwlockattr_destroy(&rwlockAttributes);
+            return true;
+
+        case TCP_TRANSPORT: {
+            socklen_t length = sizeof(bench->address);
+            bench->address = (struct sockaddr_in) { .sin_family = AF_INET, .sin_port = 0 };
+            bench->address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            bench->listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+
+            return bench->listenSocket != -1
+                && bind(bench->listenSocket, (struct sockaddr *) &bench->address, sizeof(bench->address)) == 0
+                && listen(bench->listenSocket, BENCH_MAX_PROCESSES) == 0
+                && getsockname(bench->listenSocket, (struct sockaddr *) &bench->address, &length) == 0;
+        }
+
+        case UNIX_TRANSPORT:
+            for (int i = 0; i < bench->processes; i++) {
+                if (socketpair(AF_UNIX, SOCK_STREAM, 0, bench->pairs[i]) == -1) {
+                    return false;
+                }
+            }
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Libère les ressources d'une mesure.
+ */
+void cleanupBench(Bench *bench) {
+    switch (bench->mechanism) {
+        case SYSV_QUEUE:
+            msgctl(bench->queueId, IPC_RMID, NULL);
+            break;
+
+        case POSIX_QUEUE:
+            mq_close(bench->posixQueue);
+            break;
+
+        case PIPE_QUEUE:
+            close(bench->pipe[0]);
+            close(bench->pipe[1]);
+            break;
+
+        case RING_QUEUE:
+            munmap(bench->rings, sizeof(Ring));
+            break;
+
+        case RING_TRANSPORT:
+            munmap(bench->rings, 2 * bench->processes * sizeof(Ring));
+            break;
+
+        case TCP_TRANSPORT:
+            close(bench->listenSocket);
+            break;
+
+        case UNIX_TRANSPORT:
+            for (int i = 0; i < bench->processes; i++) {
+                close(bench->pairs[i][0]);
+                close(bench->pairs[i][1]);
+            }
+            break;
+
+        default:
+            sem_destroy(&bench->locks->semaphore);
+            munmap(bench->locks, sizeof(Locks));
+            break;
+    }
+}
+
+/**
+ * @brief Envoie un message dans la file mesurée (groupe queues).
+ */
+bool sendQueue(Bench *bench, BenchMessage *message) {
+    BenchSysvMessage sysvMessage;
+
+    switch (bench->mechanism) {
+        case SYSV_QUEUE:
+            sysvMessage.type = 1;
+            sysvMessage.message = *message;
+            return msgsnd(bench->queueId, &sysvMessage, sizeof(BenchMessage), 0) == 0;
+
+        case POSIX_QUEUE:
+            return mq_send(bench->posixQueue, (const char *) message, sizeof(*message), 0) == 0;
+
+        case PIPE_QUEUE:
+            // Une écriture d'au plus PIPE_BUF octets est atomique : les messages des producteurs ne se mélangent pas
+            return writeAll(bench->pipe[1], message, sizeof(*message));
+
+        default:
+            pushRing(&bench->rings[0], message);
+            return true;
+    }
+}
+
+/**
+ * @brief Reçoit un message de la file mesurée (groupe queues).
+ */
+bool receiveQueue(Bench *bench, BenchMessage *message) {
+    BenchSysvMessage sysvMessage;
+
+    switch (bench->mechanism) {
+        case SYSV_QUEUE:
+            if (msgrcv(bench->queueId, &sysvMessage, sizeof(BenchMessage), 0, 0) != sizeof(BenchMessage)) {
+                return false;
+            }
+            *message = sysvMessage.message;
+            return true;
+
+        case POSIX_QUEUE:
+            return mq_receive(bench->posixQueue, (char *) message, sizeof(*message), NULL) == sizeof(*message);
+
+        case PIPE_QUEUE:
+            return readAll(bench->pipe[0], message, sizeof(*message));
+
+        default:
+            popRing(&bench->rings[0], message);
+            return true;
+    }
+}
+
+/**
+ * @brief Rôle d'un processus du groupe queues : le processus 0 consomme, les autres produisent.
+ *
+ * @return bool false en cas d'erreur.
+ */
+bool runQueue(Bench *bench, int process) {
+    BenchMessage message;
+    memset(&message, 0, sizeof(message));
+
+    if (process > 0) {
+        message.producer = process - 1;
+
+        for (long i = 0; i < bench->operations; i++) {
+            message.sequence = i;
+            message.sentAt = nowNanoseconds();
+
+            if (!sendQueue(bench, &message)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    for (long i = 0; i < bench->operations * bench->processes; i++) {
+        if (!receiveQueue(bench, &message)) {
+            return false;
+        }
+
+        uint64_t receivedAt = nowNanoseconds();
+        recordSample(bench, 0, i, receivedAt - message.sentAt);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Rôle d'un processus du groupe locks : prendre et relâcher le verrou autour d'un incrément.
+ *
+ * @return bool false en cas d'erreur.
+ */
+bool runLock(Bench *bench, int process) {
+    Locks *locks = bench->locks;
+
+    for (long i = 0; i < bench->operations; i++) {
+        uint64_t start = nowNanoseconds();
+
+        switch (bench->mechanism) {
+            case SEMAPHORE_LOCK:
+                while (sem_wait(&locks->semaphore) == -1 && errno == EINTR);
+                locks->counter += 1;
+                sem_post(&locks->semaphore);
+                break;
+
+            case FUTEX_LOCK:
+                futexLock(&locks->futexWord);
+                locks->counter += 1;
+                futexUnlock(&locks->futexWord);
+                break;
+
+            case MUTEX_LOCK:
+                pthread_mutex_lock(&locks->mutex);
+                locks->counter += 1;
+                pthread_mutex_unlock(&locks->mutex);
+                break;
+
+            case ROBUST_MUTEX_LOCK:
+                if (pthread_mutex_lock(&locks->robustMutex) == EOWNERDEAD) {
+                    pthread_mutex_consistent(&locks->robustMutex);
+                }
+                locks->counter += 1;
+                pthread_mutex_unlock(&locks->robustMutex);
+                break;
+
+            case RWLOCK_LOCK:
+                pthread_rwlock_wrlock(&locks->rwlock);
+                locks->counter += 1;
+                pthread_rwlock_unlock(&locks->rwlock);
+                break;
+
+            default:
+                spinLock(&locks->spinWord);
+                locks->counter += 1;
+                spinUnlock(&locks->spinWord);
+                break;
+        }
+
+        recordSample(bench, process, i, nowNanoseconds() - start);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Rôle d'un processus du groupe transports : les `processes` premiers sont les processus d'écho, les suivants
+ * les clients qui mesurent leurs allers-retours.
+ *
+ * @return bool false en cas d'erreur.
+ */
+bool runTransport(Bench *bench, int process) {
+    bool echo = process < bench->processes;
+    int client = echo ? process : process - bench->processes;
+    BenchMessage message;
+    memset(&message, 0, sizeof(message));
+    message.producer = client;
+
+    if (bench->mechanism == RING_TRANSPORT) {
+        Ring *requests = &bench->rings[2 * client];
+        Ring *responses = &bench->rings[2 * client + 1];
+
+        for (long i = 0; i < bench->operations; i++) {
+            if (echo) {
+                popRing(requests, &message);
+                pushRing(responses, &message);
+                continue;
+            }
+
+            uint64_t start = nowNanoseconds();
+            message.sequence = i;
+            pushRing(requests, &message);
+            popRing(responses, &message);
+            recordSample(bench, client, i, nowNanoseconds() - start);
+        }
+
+        return true;
+    }
+
+    int descriptor;
+    int noDelay = 1;
+
+    if (bench->mechanism == UNIX_TRANSPORT) {
+        descriptor = bench->pairs[client][echo ? 1 : 0];
+    } else if (echo) {
+        descriptor = accept(bench->listenSocket, NULL, NULL);
+    } else {
+        descriptor = socket(AF_INET, SOCK_STREAM, 0);
+
+        if (descriptor == -1 || connect(descriptor, (struct sockaddr *) &bench->address, sizeof(bench->address)) == -1) {
+            return false;
+        }
+    }
+
+    if (descriptor == -1) {
+        return false;
+    }
+
+    if (bench->mechanism == TCP_TRANSPORT) {
+        setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+
+    for (long i = 0; i < bench->operations; i++) {
+        if (echo) {
+            if (!readAll(descriptor, &message, sizeof(message)) || !writeAll(descriptor, &message, sizeof(message))) {
+                return false;
+            }
+            continue;
+        }
+
+        uint64_t start = nowNanoseconds();
+        message.sequence = i;
+
+        if (!writeAll(descriptor, &message, sizeof(message)) || !readAll(descriptor, &message, sizeof(message))) {
+            return false;
+        }
+
+        recordSample(bench, client, i, nowNanoseconds() - start);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compare deux latences, pour qsort().
+ */
+int compareSamples(const void *a, const void *b) {
+    uint32_t first = *(const uint32_t *) a;
+    uint32_t second = *(const uint32_t *) b;
+    return (first > second) - (first < second);
+}
+
+/**
+ * @brief Retourne un percentile de latences triées.
+ */
+uint32_t percentile(const uint32_t *samples, size_t count, double fraction) {
+    size_t index = (size_t) (fraction * count);
+    return samples[index < count ? index : count - 1];
+}
+
+/**
+ * @brief Exécute une mesure : crée ses processus, les libère en même temps et attend leur fin.
+ *
+ * Les processus attendent la fermeture d'un tube pour commencer, la durée est mesurée de cette fermeture à la fin
+ * du dernier processus.
+ *
+ * @param bench La mesure.
+ * @return bool false si le mécanisme n'est pas disponible ou si un processus a échoué.
+ */
+bool runBench(Bench *bench) {
+    BenchGroup group = mechanisms[bench->mechanism].group;
+    int numberProcesses = group == GROUP_QUEUES ? bench->processes + 1 : group == GROUP_TRANSPORTS ? 2 * bench->processes : bench->processes;
+    size_t numberSamples = (size_t) bench->processes * bench->operations;
+    pid_t processIds[2 * BENCH_MAX_PROCESSES];
+    int startPipe[2];
+    bool succeeded = true;
+
+    bench->samples = sharedAllocate(numberSamples * sizeof(uint32_t));
+
+    if (!bench->samples || !setupBench(bench)) {
+        printMessage(WARNING, "%s : mécanisme indisponible (%s), mesure ignorée.\n", mechanisms[bench->mechanism].name, strerror(errno));
+        if (bench->samples) {
+            munmap(bench->samples, numberSamples * sizeof(uint32_t));
+        }
+        return false;
+    }
+
+    if (pipe(startPipe) == -1) {
+        perror("pipe");
+        exit(EXIT_FAILURE);
+    }
+
+    fflush(stdout);
+
+    for (int i = 0; i < numberProcesses; i++) {
+        processIds[i] = fork();
+
+        if (processIds[i] == -1) {
+            perror("fork");
+            exit(EXIT_FAILURE);
+        }
+
+        if (processIds[i] == 0) {
+            char start;
+            close(startPipe[1]);
+            while (read(startPipe[0], &start, 1) == -1 && errno == EINTR);
+
+            bool done = group == GROUP_QUEUES ? runQueue(bench, i) : group == GROUP_LOCKS ? runLock(bench, i) : runTransport(bench, i);
+            _exit(done ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+    }
+
+    close(startPipe[0]);
+    uint64_t start = nowNanoseconds();
+    close(startPipe[1]);
+
+    for (int i = 0; i < numberProcesses; i++) {
+        int status;
+        waitpid(processIds[i], &status, 0);
+        succeeded = succeeded && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+    }
+
+    uint64_t elapsed = nowNanoseconds() - start;
+
+    if (group == GROUP_LOCKS && bench->locks->counter != (uint64_t) numberSamples) {
+        printMessage(ERROR, "%s : compteur incohérent (%llu au lieu de %zu), le verrou n'exclut pas.\n", mechanisms[bench->mechanism].name, (unsigned long long) bench->locks->counter, numberSamples);
+        succeeded = false;
+    }
+
+    cleanupBench(bench);
+
+    if (!succeeded) {
+        printMessage(ERROR, "%s : un processus de mesure a échoué.\n", mechanisms[bench->mechanism].name);
+        munmap(bench->samples, numberSamples * sizeof(uint32_t));
+        return false;
+    }
+
+    qsort(bench->samples, numberSamples, sizeof(uint32_t), compareSamples);
+
+    printf(
+        "%s,%s,%d,%zu,%.3f,%.0f,%u,%u,%u,%u,%u\n",
+        groupNames[group],
+        mechanisms[bench->mechanism].name,
+        bench->processes,
+        numberSamples,
+        elapsed / 1e6,
+        numberSamples / (elapsed / 1e9),
+        percentile(bench->samples, numberSamples, 0.5),
+        percentile(bench->samples, numberSamples, 0.9),
+        percentile(bench->samples, numberSamples, 0.99),
+        percentile(bench->samples, numberSamples, 0.999),
+        bench->samples[numberSamples - 1]
+    );
+    fflush(stdout);
+
+    munmap(bench->samples, numberSamples * sizeof(uint32_t));
+    return true;
+}
+
+/**
+ * @brief Affiche l'utilisation de l'outil.
+ *
+ * @param program Nom du programme.
+ */
+void usage(const char *program) {
+    printf("Utilisation : %s [-g queues|locks|transports|all] [-c processus,...] [-n opérations]\n", program);
+    printf("Par défaut : -g all -c 1,2,4,8 -n 20000\n");
+}
+
+/**
+ * @brief Point d'entrée de l'outil.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments : groupe, nombres de processus et opérations par processus.
+ * @return int Code de sortie.
+ */
+int main(int argc, char *argv[]) {
+    const char *groupName = "all";
+    char contentionList[256] = "1,2,4,8";
+    long operations = 20000;
+    int option;
+
+    while ((option = getopt(argc, argv, "g:c:n:")) != -1) {
+        switch (option) {
+            case 'g': groupName = optarg; break;
+            case 'c': snprintf(contentionList, sizeof(contentionList), "%s", optarg); break;
+            case 'n': operations = atol(optarg); break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    int selectedGroup = -1;
+
+    for (int group = GROUP_QUEUES; group <= GROUP_TRANSPORTS; group++) {
+        if (strcmp(groupName, groupNames[group]) == 0) {
+            selectedGroup = group;
+        }
+    }
+
+    if ((selectedGroup == -1 && strcmp(groupName, "all") != 0) || operations <= 0 || optind != argc) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int contentions[BENCH_MAX_PROCESSES];
+    int numberContentions = 0;
+
+    for (char *level = strtok(contentionList, ","); level && numberContentions < BENCH_MAX_PROCESSES; level = strtok(NULL, ",")) {
+        int processes = atoi(level);
+
+        if (processes < 1 || processes > BENCH_MAX_PROCESSES) {
+            printMessage(ERROR, "Nombre de processus invalide : %s (1 à %d).\n", level, BENCH_MAX_PROCESSES);
+            return EXIT_FAILURE;
+        }
+
+        contentions[numberContentions++] = processes;
+    }
+
+    // Un processus de mesure qui écrit dans un tube ou un socket fermé doit échouer, et non être tué
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("groupe,mécanisme,processus,opérations,durée_ms,débit_par_s,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n");
+
+    for (int mechanism = 0; mechanism < NUMBER_MECHANISMS; mechanism++) {
+        if (selectedGroup != -1 && mechanisms[mechanism].group != (BenchGroup) selectedGroup) {
+            continue;
+        }
+
+        for (int i = 0; i < numberContentions; i++) {
+            Bench bench;
+            memset(&bench, 0, sizeof(bench));
+            bench.mechanism = mechanism;
+            bench.processes = contentions[i];
+            bench.operations = operations;
+
+            runBench(&bench);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
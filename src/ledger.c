@@ -0,0 +1,252 @@
+/**
+ * @file ledger.c
+ * @brief Outil de lecture et de vérification du registre des repas.
+ *
+ * Le serveur consigne chaque repas accordé et chaque libération de baguettes dans le fichier LEDGER_FILE (voir
+ * Ledger.h). Cet outil le relit, y compris pendant que le serveur l'alimente.
+ *
+ * Utilisation (depuis le dossier src, comme le serveur) :
+ *  - `ledger dump [-p philosophe] [fichier]` : affiche les événements, éventuellement ceux d'un seul philosophe.
+ *  - `ledger verify [fichier]` : vérifie le registre et affiche un résumé.
+ *
+ * La vérification contrôle la somme de contrôle de chaque enregistrement, la continuité des séquences, et la
+ * cohérence des repas d'une même table (entre deux événements LEDGER_OPEN) : un philosophe ne reçoit pas de repas
+ * sans avoir terminé le précédent, une baguette n'est jamais accordée à deux philosophes à la fois, et toute
+ * libération correspond à un repas accordé. Les séquences perdues (LEDGER_HOLE) sont comptées, sans être des erreurs.
+ *
+ * Le code de sortie est 1 si le fichier est illisible ou si la vérification trouve une incohérence.
+ *
+ * Compilation : `gcc ledger.c -o ledger`
+ */
+
+#include "../include/utils/print_message.h"
+#include "../include/maxmin_philosophers.h"
+#include "../include/entities/Ledger.h"
+#include "../include/managers/Ledger.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * @brief Nombre de baguettes et de philosophes suivis par la vérification (identifiants de 1 à LEDGER_MAX_IDS - 1).
+ */
+#define LEDGER_MAX_IDS 65536
+
+/**
+ * @brief Affiche l'utilisation de l'outil.
+ *
+ * @param program Nom du programme.
+ */
+void usage(const char *program) {
+    printf("Utilisation :\n");
+    printf("  %s dump [-p philosophe] [fichier]\n", program);
+    printf("  %s verify [fichier]\n", program);
+    printf("Fichier par défaut : %s\n", LEDGER_FILE);
+}
+
+/**
+ * @brief Retourne le nom d'un type d'événement.
+ *
+ * @param type Le type.
+ * @return const char* Son nom.
+ */
+const char *getLedgerEventName(uint16_t type) {
+    switch (type) {
+        case LEDGER_GRANT:   return "grant";
+        case LEDGER_RELEASE: return "release";
+        case LEDGER_HOLE:    return "hole";
+        case LEDGER_OPEN:    return "open";
+        default:             return "?";
+    }
+}
+
+/**
+ * @brief Affiche un événement.
+ *
+ * @param record L'événement.
+ */
+void printLedgerRecord(const LedgerRecord *record) {
+    time_t seconds = (time_t) (record->timestamp / 1000000000ULL);
+    struct tm date;
+    char text[32] = "-";
+
+    if (record->timestamp) {
+        localtime_r(&seconds, &date);
+        strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &date);
+    }
+
+    printf(
+        "%lu %s.%06lu %-7s philosophe %d baguettes %u %u\n",
+        (unsigned long) record->sequence, text, (unsigned long) (record->timestamp % 1000000000ULL / 1000),
+        getLedgerEventName(record->type), record->philosopherId, record->leftChopstick, record->rightChopstick
+    );
+}
+
+/**
+ * @brief État de la vérification d'un registre.
+ */
+typedef struct {
+    int32_t chopstickHolders[LEDGER_MAX_IDS]; /**< Philosophe tenant chaque baguette, 0 si elle est libre */
+    bool eating[LEDGER_MAX_IDS];              /**< Philosophes dont le repas est en cours */
+    uint64_t grants;                          /**< Repas accordés */
+    uint64_t releases;                        /**< Repas terminés */
+    uint64_t holes;                           /**< Séquences perdues */
+    uint64_t tables;                          /**< Tables ouvertes (événements LEDGER_OPEN) */
+    uint64_t errors;                          /**< Incohérences trouvées */
+} LedgerAudit;
+
+/**
+ * @brief Signale une incohérence d'un événement.
+ *
+ * @param audit L'état de la vérification.
+ * @param record L'événement.
+ * @param reason La raison.
+ */
+void reportLedgerError(LedgerAudit *audit, const LedgerRecord *record, const char *reason) {
+    audit->errors += 1;
+    printf("séquence %lu : %s\n  ", (unsigned long) record->sequence, reason);
+    printLedgerRecord(record);
+}
+
+/**
+ * @brief Vérifie un événement par rapport aux précédents de la même table.
+ *
+ * @param audit L'état de la vérification.
+ * @param record L'événement.
+ */
+void auditLedgerRecord(LedgerAudit *audit, const LedgerRecord *record) {
+    int id = record->philosopherId;
+    int left = record->leftChopstick;
+    int right = record->rightChopstick;
+
+    if (record->type == LEDGER_OPEN) {
+        memset(audit->chopstickHolders, 0, sizeof(audit->chopstickHolders));
+        memset(audit->eating, 0, sizeof(audit->eating));
+        audit->tables += 1;
+        return;
+    }
+
+    if (record->type == LEDGER_HOLE) {
+        audit->holes += 1;
+        return;
+    }
+
+    if (id <= 0 || id >= LEDGER_MAX_IDS || (record->type != LEDGER_GRANT && record->type != LEDGER_RELEASE)) {
+        reportLedgerError(audit, record, "événement invalide");
+        return;
+    }
+
+    if (record->type == LEDGER_GRANT) {
+        audit->grants += 1;
+
+        if (audit->eating[id]) {
+            reportLedgerError(audit, record, "repas accordé alors que le précédent n'est pas terminé");
+        }
+        if (audit->chopstickHolders[left] != 0 || audit->chopstickHolders[right] != 0) {
+            reportLedgerError(audit, record, "baguette déjà tenue par un autre philosophe");
+        }
+
+        audit->eating[id] = true;
+        audit->chopstickHolders[left] = id;
+        audit->chopstickHolders[right] = id;
+        return;
+    }
+
+    audit->releases += 1;
+
+    if (!audit->eating[id] || audit->chopstickHolders[left] != id || audit->chopstickHolders[right] != id) {
+        reportLedgerError(audit, record, "libération sans repas accordé correspondant");
+    }
+
+    audit->eating[id] = false;
+    audit->chopstickHolders[left] = 0;
+    audit->chopstickHolders[right] = 0;
+}
+
+/**
+ * @brief Point d'entrée de l'outil.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments : la commande (`dump` ou `verify`) suivie de ses options et du fichier.
+ * @return int Code de sortie.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 2 || (strcmp(argv[1], "dump") != 0 && strcmp(argv[1], "verify") != 0)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bool verify = strcmp(argv[1], "verify") == 0;
+    int philosopherId = 0;
+    int i = 2;
+
+    if (!verify && i + 1 < argc && strcmp(argv[i], "-p") == 0) {
+        philosopherId = atoi(argv[i + 1]);
+        i += 2;
+    }
+
+    const char *path = i < argc ? argv[i] : LEDGER_FILE;
+    FILE *file = fopen(path, "rb");
+    LedgerFileHeader header;
+
+    if (!file || fread(&header, sizeof(header), 1, file) != 1
+        || header.magic != LEDGER_MAGIC || header.version != LEDGER_VERSION || header.recordSize != sizeof(LedgerRecord)) {
+        printMessage(ERROR, "%s : registre absent ou d'un autre format.\n", path);
+        if (file) {
+            fclose(file);
+        }
+        return EXIT_FAILURE;
+    }
+
+    LedgerAudit *audit = calloc(1, sizeof(LedgerAudit));
+    LedgerRecord record;
+    uint64_t records = 0;
+    uint64_t expectedSequence = 0;
+
+    if (!audit) {
+        perror("calloc");
+        fclose(file);
+        return EXIT_FAILURE;
+    }
+
+    while (fread(&record, sizeof(record), 1, file) == 1) {
+        if (!verify) {
+            if (philosopherId == 0 || record.philosopherId == philosopherId) {
+                printLedgerRecord(&record);
+            }
+            continue;
+        }
+
+        if (record.checksum != getLedgerChecksum(&record)) {
+            reportLedgerError(audit, &record, "somme de contrôle invalide");
+            expectedSequence = record.sequence + 1;
+            records += 1;
+            continue;
+        }
+
+        if (records > 0 && record.sequence != expectedSequence) {
+            printf("séquence %lu attendue, %lu lue\n", (unsigned long) expectedSequence, (unsigned long) record.sequence);
+            audit->errors += 1;
+        }
+
+        auditLedgerRecord(audit, &record);
+        expectedSequence = record.sequence + 1;
+        records += 1;
+    }
+
+    fclose(file);
+
+    if (verify) {
+        printf(
+            "%lu événement(s), %lu table(s), %lu repas accordé(s), %lu terminé(s), %lu séquence(s) perdue(s), %lu incohérence(s)\n",
+            (unsigned long) records, (unsigned long) audit->tables, (unsigned long) audit->grants,
+            (unsigned long) audit->releases, (unsigned long) audit->holes, (unsigned long) audit->errors
+        );
+    }
+
+    int status = audit->errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    free(audit);
+    return status;
+}
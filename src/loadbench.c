@@ -0,0 +1,986 @@
+/**
+ * @file loadbench.c
+ * @brief Banc d'essai de bout en bout : montée en charge du serveur et des philosophes.
+ *
+ * Pour chaque point de mesure, l'outil compile un serveur à la taille de table demandée (`-DMAX_PHILOSOPHERS`), le
+ * lance sur le nombre de cœurs demandé, installe à la table autant de philosophes sans interface (un thread par
+ * philosophe, même protocole que le client), les fait penser et manger pendant la durée de mesure, puis arrête le
+ * serveur. Les temps de pensée et de repas sont ceux du client (MIN_STATE_TIME à MAX_STATE_TIME secondes) multipliés
+ * par l'échelle de temps, pour atteindre les régimes de forte charge sans attendre des heures.
+ *
+ * Chaque point produit une ligne CSV :
+ *  - le point : transport, philosophes, cœurs, échelle de temps, graine et préallocation des places ;
+ *  - le débit : repas servis pendant la mesure et repas par seconde ;
+ *  - la latence : percentiles de l'attente d'un philosophe affamé, de la demande à l'autorisation de manger (µs) ;
+ *  - le coût côté serveur, pour le processus principal et ses processus de service, pendant la mesure : temps CPU
+ *    utilisateur et système, changements de contexte volontaires et involontaires, mémoire (somme des PSS en Kio,
+ *    la mémoire partagée n'est comptée qu'une fois) et nombre de processus ;
+ *  - le démarrage : temps entre le lancement du serveur et l'ouverture de son socket de contrôle, puis jusqu'au
+ *    premier repas accordé à l'un des philosophes (installation de la table comprise), en millisecondes ;
+ *  - les dégradations réseau : réglages du proxy (voir Proxy.h) lus dans PROXY_SETTINGS_PATH quand les philosophes
+ *    passent par lui (`-p`), `aucune` sinon.
+ *
+ * Utilisation (depuis le dossier src, avec les logs du serveur dans ../logs) :
+ * `loadbench [-n tailles] [-w cœurs] [-t échelles] [-m transports] [-d durée] [-s graine] [-p port] [-a]`
+ *  - `-n` : tailles de table, séparées par des virgules (par défaut 7).
+ *  - `-w` : nombres de cœurs alloués au serveur (par défaut tous).
+ *  - `-t` : échelles de temps (par défaut 0.01, soit des états de 50 à 100 ms).
+ *  - `-m` : transports, tcp et/ou udp (par défaut tcp).
+ *  - `-d` : durée de la mesure en secondes, après l'installation des philosophes (par défaut 10).
+ *  - `-s` : graine fixe des durées des états, pour rejouer exactement la même charge (par défaut l'heure).
+ *  - `-p` : port auquel se connectent les philosophes, celui du proxy par exemple (par défaut PORT).
+ *  - `-a` : lance le serveur avec PREALLOCATE_ARGUMENT, toutes les places initialisées au démarrage (par défaut,
+ *    elles le sont à l'arrivée de chaque philosophe).
+ *
+ * En TCP, le serveur crée un processus de service par philosophe : les très grandes tables se mesurent en udp. Une
+ * seule instance du serveur peut fonctionner à la fois (port et socket de contrôle) : aucun autre serveur ne doit
+ * être lancé pendant la mesure.
+ *
+ * Compilation : `gcc loadbench.c -o loadbench -lpthread`
+ */
+
+// Pour sched_setaffinity() et les macros CPU_*
+#define _GNU_SOURCE
+
+#include "../include/maxmin_philosophers.h"
+#include "../include/utils/print_message.h"
+#include "../include/utils/sockets.h"
+#include "../include/entities/Philosopher.h"
+#include "../include/entities/Control.h"
+#include "../include/entities/Proxy.h"
+#include "../include/entities/SharedResources.h"
+#include "../include/managers/Request.c"
+#include "../include/managers/Response.c"
+#include "../include/managers/Datagram.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+/**
+ * @brief Chemin du serveur compilé pour une taille de table (%d : la taille).
+ */
+#define LOADBENCH_SERVER_PATH "/tmp/loadbench_server_%d"
+
+/**
+ * @brief Commande de compilation du serveur pour une taille de table (%d : la taille, %s : le chemin produit).
+ */
+#define LOADBENCH_BUILD_COMMAND "gcc -DMAX_PHILOSOPHERS=%d server.c -o %s -lpthread -lm"
+
+/**
+ * @brief Attente maximale du démarrage du serveur, en millisecondes.
+ */
+#define LOADBENCH_START_TIMEOUT 5000
+
+/**
+ * @brief Intervalle de vérification du démarrage du serveur, en millisecondes (précision du temps de démarrage).
+ */
+#define LOADBENCH_START_POLL 5
+
+/**
+ * @brief Intervalle maximal entre deux mises à jour d'un philosophe, en millisecondes (le client en envoie une par
+ * seconde, le service datagramme retire un philosophe silencieux).
+ */
+#define LOADBENCH_HEARTBEAT 1000
+
+/**
+ * @brief Taille de la pile des threads des philosophes.
+ */
+#define LOADBENCH_STACK_SIZE (128 * 1024)
+
+/**
+ * @brief Nombre maximum de valeurs d'une liste d'options.
+ */
+#define LOADBENCH_MAX_VALUES 32
+
+/**
+ * @brief Philosophe sans interface du banc d'essai.
+ */
+typedef struct {
+    Philosopher base;      /**< État du philosophe, tel que connu du serveur */
+    int socket;            /**< Connexion TCP ou socket UDP connecté */
+    bool joined;           /**< Installé à la table */
+    uint64_t token;        /**< Jeton de session en mode datagramme */
+    uint32_t sequence;     /**< Dernier numéro de séquence en mode datagramme */
+    uint64_t randomState;  /**< Générateur des durées des états (xorshift) */
+    pthread_t thread;      /**< Thread du philosophe */
+    uint64_t meals;        /**< Repas obtenus pendant la mesure */
+    uint32_t *waits;       /**< Attentes mesurées (µs) */
+    size_t numberWaits;    /**< Nombre d'attentes mesurées */
+    size_t waitsCapacity;  /**< Capacité de `waits` */
+} BenchPhilosopher;
+
+/**
+ * @brief Ressources consommées par le serveur et ses processus de service.
+ */
+typedef struct {
+    double user;           /**< Temps CPU utilisateur (s) */
+    double system;         /**< Temps CPU système (s) */
+    uint64_t voluntary;    /**< Changements de contexte volontaires */
+    uint64_t involuntary;  /**< Changements de contexte involontaires */
+    uint64_t pss;          /**< Somme des PSS (Kio) */
+    int processes;         /**< Nombre de processus */
+} TreeUsage;
+
+/**
+ * @brief Réglages d'un point de mesure.
+ */
+typedef struct {
+    bool datagram;         /**< Transport UDP (mode datagramme) plutôt que TCP */
+    int philosophers;      /**< Taille de la table */
+    int cores;             /**< Cœurs alloués au serveur */
+    double scale;          /**< Échelle des durées des états */
+    uint64_t seed;         /**< Graine des durées des états */
+    int duration;          /**< Durée de la mesure (s) */
+    int port;              /**< Port auquel se connectent les philosophes */
+    bool preallocate;      /**< Serveur lancé avec PREALLOCATE_ARGUMENT */
+} BenchPoint;
+
+/**
+ * @brief Point en cours : lu par les threads des philosophes.
+ */
+BenchPoint currentPoint;
+
+/**
+ * @brief Mesure en cours : les repas et attentes ne sont comptés que pendant la mesure.
+ */
+volatile bool measuring = false;
+
+/**
+ * @brief Arrêt demandé aux threads des philosophes.
+ */
+volatile bool stopping = false;
+
+/**
+ * @brief Heure du premier repas accordé du point en cours (µs), 0 tant qu'aucun ne l'a été.
+ */
+uint64_t firstGrantAt = 0;
+
+/**
+ * @brief Retourne l'heure monotone en microsecondes.
+ *
+ * @return uint64_t L'heure.
+ */
+uint64_t nowMicroseconds() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000 + time.tv_nsec / 1000;
+}
+
+/**
+ * @brief Tire la durée d'un état (ms), entre MIN_STATE_TIME et MAX_STATE_TIME secondes mises à l'échelle.
+ *
+ * @param philosopher Le philosophe, dont le générateur avance.
+ * @return long La durée.
+ */
+long drawStateTime(BenchPhilosopher *philosopher) {
+    philosopher->randomState ^= philosopher->randomState << 13;
+    philosopher->randomState ^= philosopher->randomState >> 7;
+    philosopher->randomState ^= philosopher->randomState << 17;
+
+    double seconds = MIN_STATE_TIME + (philosopher->randomState >> 11) * (1.0 / 9007199254740992.0) * (MAX_STATE_TIME - MIN_STATE_TIME);
+    return (long) (seconds * currentPoint.scale * 1000);
+}
+
+/**
+ * @brief Endort le thread appelant.
+ *
+ * @param milliseconds La durée.
+ */
+void sleepMilliseconds(long milliseconds) {
+    struct timespec duration = { .tv_sec = milliseconds / 1000, .tv_nsec = (milliseconds % 1000) * 1000000 };
+    while (nanosleep(&duration, &duration) == -1 && errno == EINTR);
+}
+
+/**
+ * @brief Envoie l'état courant du philosophe au serveur, sans attendre de réponse.
+ *
+ * @param philosopher Le philosophe.
+ * @return uint32_t Le numéro de séquence du datagramme (0 en TCP), ou UINT32_MAX si l'envoi a échoué.
+ */
+uint32_t sendUpdate(BenchPhilosopher *philosopher) {
+    if (currentPoint.datagram) {
+        Datagram datagram = buildDatagram(DATAGRAM_UPDATE, philosopher->token, ++philosopher->sequence, philosopher->base);
+        send(philosopher->socket, &datagram, sizeof(datagram), 0);
+        return datagram.sequence;
+    }
+
+    Request request = updateRequest(philosopher->base);
+    return trySocketWrite(philosopher->socket, &request, sizeof(request)) == -1 ? UINT32_MAX : 0;
+}
+
+/**
+ * @brief Reste dans l'état courant pendant la durée donnée, en donnant des nouvelles au serveur régulièrement.
+ *
+ * @param philosopher Le philosophe.
+ * @param milliseconds La durée.
+ * @return bool false si le serveur n'est plus joignable ou si l'arrêt est demandé.
+ */
+bool holdState(BenchPhilosopher *philosopher, long milliseconds) {
+    while (milliseconds > 0 && !stopping) {
+        long nap = milliseconds < LOADBENCH_HEARTBEAT ? milliseconds : LOADBENCH_HEARTBEAT;
+        sleepMilliseconds(nap);
+        milliseconds -= nap;
+
+        if (milliseconds > 0) {
+            philosopher->base.stateTimer = (int) ((milliseconds + 999) / 1000);
+
+            if (sendUpdate(philosopher) == UINT32_MAX) {
+                return false;
+            }
+        }
+    }
+
+    return !stopping;
+}
+
+/**
+ * @brief Demande à manger et attend l'autorisation du serveur.
+ *
+ * En mode datagramme, la demande est renvoyée toutes les DATAGRAM_RETRY_INTERVAL ms tant que le serveur ne répond
+ * pas, et l'autorisation est acquittée, comme le fait le client.
+ *
+ * @param philosopher Le philosophe, en état HUNGRY.
+ * @return bool false si le philosophe a été refusé, si le serveur ne répond plus ou si l'arrêt est demandé.
+ */
+bool requestMeal(BenchPhilosopher *philosopher) {
+    uint32_t sequence = sendUpdate(philosopher);
+
+    if (sequence == UINT32_MAX) {
+        return false;
+    }
+
+    if (!currentPoint.datagram) {
+        Response response;
+
+        if (trySocketRead(philosopher->socket, &response, sizeof(response)) <= 0 || response.type != RESPONSE_UPDATE) {
+            return false;
+        }
+
+        philosopher->base.state = response.philosopher.state;
+        return true;
+    }
+
+    Datagram request = buildDatagram(DATAGRAM_UPDATE, philosopher->token, sequence, philosopher->base);
+    int silentRetries = 0;
+
+    while (!stopping) {
+        Datagram reply;
+        int received = receiveDatagram(philosopher->socket, &reply, DATAGRAM_RETRY_INTERVAL);
+
+        if (received == -1 || (received == 1 && reply.type == DATAGRAM_REFUSED)) {
+            return false;
+        }
+
+        if (received == 0) {
+            if (++silentRetries * DATAGRAM_RETRY_INTERVAL >= DATAGRAM_SESSION_TIMEOUT) {
+                return false;
+            }
+
+            send(philosopher->socket, &request, sizeof(request), 0);
+            continue;
+        }
+
+        silentRetries = 0;
+
+        if (reply.type == DATAGRAM_GRANT) {
+            Datagram ack = buildDatagram(DATAGRAM_ACK, philosopher->token, reply.sequence, philosopher->base);
+            send(philosopher->socket, &ack, sizeof(ack), 0);
+
+            if (reply.sequence == sequence) {
+                philosopher->base.state = reply.philosopher.state;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Enregistre l'attente d'un repas obtenu pendant la mesure.
+ *
+ * @param philosopher Le philosophe.
+ * @param wait L'attente (µs).
+ */
+void recordWait(BenchPhilosopher *philosopher, uint64_t wait) {
+    if (philosopher->numberWaits == philosopher->waitsCapacity) {
+        size_t capacity = philosopher->waitsCapacity ? philosopher->waitsCapacity * 2 : 64;
+        uint32_t *waits = realloc(philosopher->waits, capacity * sizeof(uint32_t));
+
+        if (!waits) {
+            return;
+        }
+
+        philosopher->waits = waits;
+        philosopher->waitsCapacity = capacity;
+    }
+
+    philosopher->waits[philosopher->numberWaits++] = wait > UINT32_MAX ? UINT32_MAX : (uint32_t) wait;
+    philosopher->meals += 1;
+}
+
+/**
+ * @brief Routine du thread d'un philosophe : penser, demander à manger, manger, jusqu'à l'arrêt.
+ *
+ * @param arg Pointeur vers le `BenchPhilosopher`.
+ * @return void* Toujours NULL.
+ */
+void *benchPhilosopherThread(void *arg) {
+    BenchPhilosopher *philosopher = (BenchPhilosopher *) arg;
+
+    while (!stopping) {
+        philosopher->base.state = THINKING;
+
+        if (!holdState(philosopher, drawStateTime(philosopher))) {
+            break;
+        }
+
+        philosopher->base.state = HUNGRY;
+        philosopher->base.stateTimer = 0;
+        uint64_t askedAt = nowMicroseconds();
+
+        if (!requestMeal(philosopher)) {
+            break;
+        }
+
+        uint64_t expected = 0;
+        __atomic_compare_exchange_n(&firstGrantAt, &expected, nowMicroseconds(), false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+
+        if (measuring) {
+            recordWait(philosopher, nowMicroseconds() - askedAt);
+        }
+
+        long mealTime = drawStateTime(philosopher);
+        philosopher->base.stateTimer = (int) ((mealTime + 999) / 1000);
+
+        if (!holdState(philosopher, mealTime)) {
+            break;
+        }
+
+        // Fin du repas : le serveur libère les baguettes
+        philosopher->base.state = THINKING;
+
+        if (sendUpdate(philosopher) == UINT32_MAX) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Installe un philosophe à la table, en TCP ou en mode datagramme.
+ *
+ * @param philosopher Le philosophe, complété par la fonction.
+ * @return bool false si le serveur a refusé le philosophe ou ne répond pas.
+ */
+bool joinBenchTable(BenchPhilosopher *philosopher) {
+    struct sockaddr_in address = getSocketAddress();
+    address.sin_port = htons(currentPoint.port);
+
+    philosopher->socket = currentPoint.datagram ? getDatagramSocket() : getSocket();
+
+    if (philosopher->socket == -1 || connect(philosopher->socket, (struct sockaddr *) &address, sizeof(address)) == -1) {
+        perror("connect");
+        return false;
+    }
+
+    if (!currentPoint.datagram) {
+        Request request = createRequest();
+        Response response;
+
+        if (trySocketWrite(philosopher->socket, &request, sizeof(request)) == -1
+            || trySocketRead(philosopher->socket, &response, sizeof(response)) <= 0
+            || response.type != RESPONSE_CREATE) {
+            close(philosopher->socket);
+            return false;
+        }
+
+        philosopher->base = response.philosopher;
+        return true;
+    }
+
+    Datagram request = buildDatagram(DATAGRAM_CREATE, 0, (uint32_t) philosopher->randomState, philosopher->base);
+
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        Datagram reply;
+        int received;
+
+        send(philosopher->socket, &request, sizeof(request), 0);
+
+        while ((received = receiveDatagram(philosopher->socket, &reply, DATAGRAM_RETRY_INTERVAL)) == 1 && reply.sequence != request.sequence);
+
+        if (received == 1 && reply.type == DATAGRAM_CREATED) {
+            philosopher->base = reply.philosopher;
+            philosopher->token = reply.token;
+            return true;
+        }
+
+        if (received != 0) {
+            break;
+        }
+    }
+
+    close(philosopher->socket);
+    return false;
+}
+
+/**
+ * @brief Compile le serveur pour une taille de table.
+ *
+ * @param philosophers La taille de table.
+ * @param path Reçoit le chemin du serveur compilé.
+ * @param size Taille de `path`.
+ * @return bool false si la compilation a échoué.
+ */
+bool buildServer(int philosophers, char *path, size_t size) {
+    char command[512];
+
+    snprintf(path, size, LOADBENCH_SERVER_PATH, philosophers);
+    snprintf(command, sizeof(command), LOADBENCH_BUILD_COMMAND, philosophers, path);
+
+    return system(command) == 0;
+}
+
+/**
+ * @brief Vérifie que le serveur accepte les connexions sur son socket de contrôle.
+ *
+ * @return bool true si le serveur est prêt.
+ */
+bool serverReady() {
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", CONTROL_SOCKET_PATH);
+
+    int controlSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    bool ready = controlSocket != -1 && connect(controlSocket, (struct sockaddr *) &address, sizeof(address)) == 0;
+
+    if (controlSocket != -1) {
+        close(controlSocket);
+    }
+
+    return ready;
+}
+
+/**
+ * @brief Lance le serveur sur les premiers cœurs autorisés, sorties redirigées vers /dev/null.
+ *
+ * @param path Chemin du serveur compilé.
+ * @param cores Nombre de cœurs alloués.
+ * @param preallocate true pour lancer le serveur avec PREALLOCATE_ARGUMENT.
+ * @return pid_t PID du serveur, -1 s'il n'a pas démarré.
+ */
+pid_t startServer(const char *path, int cores, bool preallocate) {
+    cpu_set_t allowed, selected;
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+    CPU_ZERO(&selected);
+
+    for (int cpu = 0, count = 0; cpu < CPU_SETSIZE && count < cores; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            CPU_SET(cpu, &selected);
+            count++;
+        }
+    }
+
+    pid_t serverProcessId = fork();
+
+    if (serverProcessId == 0) {
+        int null = open("/dev/null", O_RDWR);
+        dup2(null, STDIN_FILENO);
+        dup2(null, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        sched_setaffinity(0, sizeof(selected), &selected);
+        execl(path, path, preallocate ? PREALLOCATE_ARGUMENT : (char *) NULL, (char *) NULL);
+        _exit(EXIT_FAILURE);
+    }
+
+    if (serverProcessId == -1) {
+        return -1;
+    }
+
+    for (int waited = 0; waited < LOADBENCH_START_TIMEOUT; waited += LOADBENCH_START_POLL) {
+        if (waitpid(serverProcessId, NULL, WNOHANG) == serverProcessId) {
+            return -1;
+        }
+
+        if (serverReady()) {
+            return serverProcessId;
+        }
+
+        sleepMilliseconds(LOADBENCH_START_POLL);
+    }
+
+    kill(serverProcessId, SIGKILL);
+    waitpid(serverProcessId, NULL, 0);
+    return -1;
+}
+
+/**
+ * @brief Ajoute les ressources consommées par un processus.
+ *
+ * Le temps CPU est celui de tout le processus ; les changements de contexte sont comptés par thread.
+ *
+ * @param processId Le processus.
+ * @param usage Les ressources, complétées.
+ * @return bool false si le processus n'existe plus.
+ */
+bool addProcessUsage(pid_t processId, TreeUsage *usage) {
+    char path[320], line[512];
+    unsigned long userTicks, systemTicks;
+
+    snprintf(path, sizeof(path), "/proc/%d/stat", processId);
+    FILE *file = fopen(path, "r");
+
+    if (!file) {
+        return false;
+    }
+
+    bool parsed = fgets(line, sizeof(line), file) != NULL;
+    fclose(file);
+    char *fields = parsed ? strrchr(line, ')') : NULL;
+
+    // Après le nom : état, ppid, pgrp, session, tty, tpgid, flags, minflt, cminflt, majflt, cmajflt, utime, stime
+    if (!fields || sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &userTicks, &systemTicks) != 2) {
+        return false;
+    }
+
+    usage->user += (double) userTicks / sysconf(_SC_CLK_TCK);
+    usage->system += (double) systemTicks / sysconf(_SC_CLK_TCK);
+    usage->processes += 1;
+
+    snprintf(path, sizeof(path), "/proc/%d/task", processId);
+    DIR *tasks = opendir(path);
+    struct dirent *task;
+
+    while (tasks && (task = readdir(tasks))) {
+        if (task->d_name[0] == '.') {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "/proc/%d/task/%s/status", processId, task->d_name);
+
+        if ((file = fopen(path, "r"))) {
+            unsigned long long value;
+
+            while (fgets(line, sizeof(line), file)) {
+                if (sscanf(line, "voluntary_ctxt_switches: %llu", &value) == 1) {
+                    usage->voluntary += value;
+                } else if (sscanf(line, "nonvoluntary_ctxt_switches: %llu", &value) == 1) {
+                    usage->involuntary += value;
+                }
+            }
+            fclose(file);
+        }
+    }
+
+    if (tasks) {
+        closedir(tasks);
+    }
+
+    snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", processId);
+
+    if ((file = fopen(path, "r"))) {
+        unsigned long long value;
+
+        while (fgets(line, sizeof(line), file)) {
+            if (sscanf(line, "Pss: %llu kB", &value) == 1) {
+                usage->pss += value;
+            }
+        }
+        fclose(file);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Relève les ressources consommées par le serveur et ses processus fils (processus de service et service
+ * datagramme).
+ *
+ * @param serverProcessId Le processus principal du serveur.
+ * @return TreeUsage Les ressources.
+ */
+TreeUsage readTreeUsage(pid_t serverProcessId) {
+    TreeUsage usage;
+    memset(&usage, 0, sizeof(usage));
+    addProcessUsage(serverProcessId, &usage);
+
+    DIR *processes = opendir("/proc");
+    struct dirent *entry;
+
+    while (processes && (entry = readdir(processes))) {
+        char path[64], line[512];
+        int parentProcessId;
+        pid_t processId = atoi(entry->d_name);
+
+        if (processId <= 0) {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "/proc/%d/stat", processId);
+        FILE *file = fopen(path, "r");
+
+        if (!file) {
+            continue;
+        }
+
+        char *fields = fgets(line, sizeof(line), file) ? strrchr(line, ')') : NULL;
+        fclose(file);
+
+        if (fields && sscanf(fields + 2, "%*c %d", &parentProcessId) == 1 && parentProcessId == serverProcessId) {
+            addProcessUsage(processId, &usage);
+        }
+    }
+
+    if (processes) {
+        closedir(processes);
+    }
+
+    return usage;
+}
+
+/**
+ * @brief Compare deux attentes, pour qsort().
+ */
+int compareWaits(const void *a, const void *b) {
+    uint32_t first = *(const uint32_t *) a;
+    uint32_t second = *(const uint32_t *) b;
+    return (first > second) - (first < second);
+}
+
+/**
+ * @brief Retourne un percentile d'attentes triées, 0 s'il n'y en a pas.
+ */
+uint32_t percentile(const uint32_t *waits, size_t count, double fraction) {
+    size_t index = (size_t) (fraction * count);
+    return count == 0 ? 0 : waits[index < count ? index : count - 1];
+}
+
+/**
+ * @brief Lit les réglages du proxy de dégradation réseau en une seule valeur CSV.
+ *
+ * @param settings Reçoit les réglages (lignes séparées par des points-virgules), `aucune` si le proxy n'est pas utilisé.
+ * @param size Taille de `settings`.
+ */
+void readImpairments(char *settings, size_t size) {
+    FILE *file = currentPoint.port != PORT ? fopen(PROXY_SETTINGS_PATH, "r") : NULL;
+    char line[256];
+    size_t length = 0;
+
+    snprintf(settings, size, "aucune");
+
+    while (file && fgets(line, sizeof(line), file) && length < size) {
+        line[strcspn(line, "\n")] = '\0';
+        length += snprintf(settings + length, size - length, "%s%s", length > 0 ? ";" : "", line);
+    }
+
+    if (file) {
+        fclose(file);
+    }
+}
+
+/**
+ * @brief Mesure un point : lance le serveur, installe et fait vivre les philosophes, relève les résultats.
+ *
+ * @param point Le point.
+ * @param serverPath Le serveur compilé à la taille du point.
+ * @return bool false si le serveur n'a pas démarré ou si des philosophes n'ont pas pu s'installer.
+ */
+bool runPoint(BenchPoint point, const char *serverPath) {
+    currentPoint = point;
+    measuring = false;
+    stopping = false;
+    firstGrantAt = 0;
+
+    uint64_t launchedAt = nowMicroseconds();
+    pid_t serverProcessId = startServer(serverPath, point.cores, point.preallocate);
+    uint64_t readyAt = nowMicroseconds();
+
+    if (serverProcessId == -1) {
+        printMessage(ERROR, "Le serveur %s n'a pas démarré (un autre serveur est-il lancé ?).\n", serverPath);
+        return false;
+    }
+
+    BenchPhilosopher *philosophers = calloc(point.philosophers, sizeof(BenchPhilosopher));
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, LOADBENCH_STACK_SIZE);
+    int joined = 0;
+
+    for (int i = 0; philosophers && i < point.philosophers; i++) {
+        philosophers[i].randomState = point.seed * 2654435761u + i + 1;
+
+        if (!joinBenchTable(&philosophers[i])) {
+            break;
+        }
+
+        philosophers[i].joined = true;
+
+        if (pthread_create(&philosophers[i].thread, &attributes, benchPhilosopherThread, &philosophers[i]) != 0) {
+            perror("pthread_create");
+            break;
+        }
+
+        joined++;
+    }
+
+    pthread_attr_destroy(&attributes);
+
+    TreeUsage before = readTreeUsage(serverProcessId);
+    uint64_t start = nowMicroseconds();
+    measuring = true;
+
+    if (joined == point.philosophers) {
+        sleep(point.duration);
+    }
+
+    measuring = false;
+    double elapsed = (nowMicroseconds() - start) / 1e6;
+    TreeUsage after = readTreeUsage(serverProcessId);
+
+    // Arrêt : les lectures TCP bloquées sont débloquées, les attentes UDP s'arrêtent au prochain délai
+    stopping = true;
+
+    for (int i = 0; i < joined; i++) {
+        if (!point.datagram) {
+            shutdown(philosophers[i].socket, SHUT_RDWR);
+        }
+    }
+
+    size_t numberWaits = 0;
+    uint64_t meals = 0;
+
+    for (int i = 0; i < joined; i++) {
+        pthread_join(philosophers[i].thread, NULL);
+        numberWaits += philosophers[i].numberWaits;
+        meals += philosophers[i].meals;
+    }
+
+    for (int i = 0; philosophers && i < point.philosophers; i++) {
+        if (philosophers[i].joined && point.datagram) {
+            Datagram leave = buildDatagram(DATAGRAM_LEAVE, philosophers[i].token, ++philosophers[i].sequence, philosophers[i].base);
+            send(philosophers[i].socket, &leave, sizeof(leave), 0);
+        }
+        if (philosophers[i].joined) {
+            close(philosophers[i].socket);
+        }
+    }
+
+    kill(serverProcessId, SIGINT);
+    waitpid(serverProcessId, NULL, 0);
+
+    if (joined < point.philosophers) {
+        printMessage(ERROR, "Seuls %d philosophes sur %d ont pu s'installer à la table.\n", joined, point.philosophers);
+
+        for (int i = 0; philosophers && i < point.philosophers; i++) {
+            free(philosophers[i].waits);
+        }
+        free(philosophers);
+        return false;
+    }
+
+    uint32_t *waits = malloc((numberWaits ? numberWaits : 1) * sizeof(uint32_t));
+    size_t offset = 0;
+
+    for (int i = 0; i < point.philosophers; i++) {
+        if (waits) {
+            memcpy(waits + offset, philosophers[i].waits, philosophers[i].numberWaits * sizeof(uint32_t));
+        }
+        offset += philosophers[i].numberWaits;
+        free(philosophers[i].waits);
+    }
+
+    free(philosophers);
+
+    if (!waits) {
+        perror("malloc");
+        return false;
+    }
+
+    qsort(waits, numberWaits, sizeof(uint32_t), compareWaits);
+
+    char impairments[512];
+    readImpairments(impairments, sizeof(impairments));
+
+    printf(
+        "%s,%d,%d,%g,%llu,%s,%.3f,%llu,%.1f,%u,%u,%u,%u,%.3f,%.3f,%llu,%llu,%llu,%d,%.1f,%.1f,%s\n",
+        point.datagram ? "udp" : "tcp",
+        point.philosophers,
+        point.cores,
+        point.scale,
+        (unsigned long long) point.seed,
+        point.preallocate ? "oui" : "non",
+        elapsed,
+        (unsigned long long) meals,
+        meals / elapsed,
+        percentile(waits, numberWaits, 0.5),
+        percentile(waits, numberWaits, 0.9),
+        percentile(waits, numberWaits, 0.99),
+        numberWaits ? waits[numberWaits - 1] : 0,
+        after.user - before.user,
+        after.system - before.system,
+        (unsigned long long) (after.voluntary - before.voluntary),
+        (unsigned long long) (after.involuntary - before.involuntary),
+        (unsigned long long) after.pss,
+        after.processes,
+        (readyAt - launchedAt) / 1e3,
+        firstGrantAt ? (firstGrantAt - launchedAt) / 1e3 : -1.0,
+        impairments
+    );
+    fflush(stdout);
+
+    free(waits);
+    return true;
+}
+
+/**
+ * @brief Lit une liste de valeurs séparées par des virgules.
+ *
+ * @param text La liste.
+ * @param values Reçoit les valeurs.
+ * @return int Le nombre de valeurs, 0 si une valeur est invalide.
+ */
+int parseList(const char *text, double *values) {
+    char copy[256];
+    int count = 0;
+    snprintf(copy, sizeof(copy), "%s", text);
+
+    for (char *value = strtok(copy, ","); value && count < LOADBENCH_MAX_VALUES; value = strtok(NULL, ",")) {
+        char *end;
+        values[count] = strtod(value, &end);
+
+        if (*end != '\0' || values[count] <= 0) {
+            return 0;
+        }
+
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Affiche l'utilisation de l'outil.
+ *
+ * @param program Nom du programme.
+ */
+void usage(const char *program) {
+    printf("Utilisation : %s [-n tailles] [-w cœurs] [-t échelles] [-m tcp,udp] [-d durée] [-s graine] [-p port] [-a]\n", program);
+    printf("Par défaut : -n %d -w <tous> -t 0.01 -m tcp -d 10 -p %d, places initialisées à l'arrivée des philosophes\n", MAX_PHILOSOPHERS, PORT);
+}
+
+/**
+ * @brief Point d'entrée de l'outil : balaye toutes les combinaisons de tailles, cœurs, échelles et transports.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments.
+ * @return int Code de sortie, en échec si un point n'a pas pu être mesuré.
+ */
+int main(int argc, char *argv[]) {
+    double sizes[LOADBENCH_MAX_VALUES] = { MAX_PHILOSOPHERS }, cores[LOADBENCH_MAX_VALUES], scales[LOADBENCH_MAX_VALUES] = { 0.01 };
+    int numberSizes = 1, numberCores = 1, numberScales = 1;
+    bool transports[2] = { true, false };
+    int duration = 10, port = PORT;
+    bool preallocate = false;
+    uint64_t seed = (uint64_t) time(NULL);
+    cpu_set_t allowed;
+    int option;
+
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+    cores[0] = CPU_COUNT(&allowed);
+
+    while ((option = getopt(argc, argv, "n:w:t:m:d:s:p:a")) != -1) {
+        bool valid = true;
+
+        switch (option) {
+            case 'n': valid = (numberSizes = parseList(optarg, sizes)) > 0; break;
+            case 'w': valid = (numberCores = parseList(optarg, cores)) > 0; break;
+            case 't': valid = (numberScales = parseList(optarg, scales)) > 0; break;
+            case 'm':
+                transports[0] = strstr(optarg, "tcp") != NULL;
+                transports[1] = strstr(optarg, "udp") != NULL;
+                valid = transports[0] || transports[1];
+                break;
+            case 'd': valid = (duration = atoi(optarg)) > 0; break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 'p': valid = (port = atoi(optarg)) > 0; break;
+            case 'a': preallocate = true; break;
+            default: valid = false; break;
+        }
+
+        if (!valid) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (int i = 0; i < numberSizes; i++) {
+        if (sizes[i] < MIN_PHILOSOPHERS) {
+            printMessage(ERROR, "Une table compte au moins %d philosophes.\n", MIN_PHILOSOPHERS);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Un descripteur par philosophe, ici comme dans le serveur qui hérite de la limite
+    struct rlimit files;
+    getrlimit(RLIMIT_NOFILE, &files);
+    files.rlim_cur = files.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &files);
+
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("transport,philosophes,coeurs,echelle,graine,preallocation,duree_s,repas,repas_par_s,attente_p50_us,attente_p90_us,attente_p99_us,attente_max_us,cpu_utilisateur_s,cpu_systeme_s,cs_volontaires,cs_involontaires,pss_kio,processus,demarrage_ms,premier_repas_ms,degradations\n");
+    fflush(stdout);
+
+    bool succeeded = true;
+
+    for (int size = 0; size < numberSizes; size++) {
+        char serverPath[256];
+
+        if (!buildServer((int) sizes[size], serverPath, sizeof(serverPath))) {
+            printMessage(ERROR, "La compilation du serveur pour %d philosophes a échoué.\n", (int) sizes[size]);
+            succeeded = false;
+            continue;
+        }
+
+        for (int core = 0; core < numberCores; core++) {
+            for (int scale = 0; scale < numberScales; scale++) {
+                for (int transport = 0; transport < 2; transport++) {
+                    if (!transports[transport]) {
+                        continue;
+                    }
+
+                    BenchPoint point = {
+                        .datagram = transport == 1,
+                        .philosophers = (int) sizes[size],
+                        .cores = (int) cores[core],
+                        .scale = scales[scale],
+                        .seed = seed,
+                        .duration = duration,
+                        .port = port,
+                        .preallocate = preallocate
+                    };
+
+                    succeeded = runPoint(point, serverPath) && succeeded;
+                }
+            }
+        }
+
+        unlink(serverPath);
+    }
+
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
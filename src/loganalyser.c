@@ -0,0 +1,629 @@
+/**
+ * @file loganalyser.c
+ * @brief Analyseur parallèle du fichier de log du serveur, produisant des rapports par philosophe.
+ *
+ * Cet outil relit le fichier `server.log` après coup pour en extraire le nombre de repas, les temps d'attente et
+ * l'utilisation des baguettes. Le fichier est projeté en mémoire puis découpé en autant de tranches que de threads,
+ * chaque tranche commençant et finissant sur une fin de ligne. Chaque thread reconnaît les messages émis par
+ * ServerPhilosopher.c et Chopstick.c dans sa tranche et produit une liste d'événements ; les listes, déjà ordonnées,
+ * sont ensuite mises bout à bout pour reconstituer la chronologie de chaque philosophe.
+ *
+ * Les messages reconnus sont :
+ *  - "Création du philosophe %d..."
+ *  - "Le philosophe %d attend que le compteur se libère" / "Le philosophe %d s'ajoute au compteur ..."
+ *  - "Le philosophe %d attend que la baguette %d à sa gauche|droite se libère"
+ *  - "Le philosophe %d prend la baguette %d à sa gauche|droite"
+ *  - "Le philosophe %d libère la baguette %d à sa gauche|droite" / "Le philosophe %d libère le compteur"
+ *
+ * L'heure d'un message est lue dans l'index du fichier (voir LogIndex.h), à la nanoseconde, lorsqu'il existe ;
+ * sinon dans l'heure écrite en tête du message, à la microseconde. Sans l'une ni l'autre (fichiers écrits avant
+ * l'horodatage des messages), seuls les décomptes (repas, attentes) sont produits.
+ *
+ * Utilisation : `loganalyser [-j threads] [-r seats|chopsticks|timeline] [-s philosophe] [-c] <server.log>`
+ *  - `-j` : nombre de threads (par défaut, le nombre de cœurs disponibles),
+ *  - `-r` : rapport à produire (par défaut `seats`),
+ *  - `-s` : philosophe dont la chronologie est affichée avec `-r timeline`,
+ *  - `-c` : sortie au format CSV plutôt qu'en tableau.
+ *
+ * Compilation : `gcc loganalyser.c -o loganalyser -lpthread`
+ */
+
+#include "../include/utils/print_message.h"
+#include "../include/entities/LogIndex.h"
+#include "../include/managers/LogIndex.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Types d'événements reconnus dans le log du serveur.
+ */
+typedef enum {
+    EVENT_JOIN,            /**< Création du philosophe */
+    EVENT_WAIT_ADMISSION,  /**< Attente du compteur */
+    EVENT_ADMITTED,        /**< Prise du compteur */
+    EVENT_WAIT_CHOPSTICK,  /**< Attente d'une baguette */
+    EVENT_TAKE_LEFT,       /**< Prise de la baguette gauche */
+    EVENT_TAKE_RIGHT,      /**< Prise de la baguette droite */
+    EVENT_RELEASE_CHOPSTICK, /**< Libération d'une baguette */
+    EVENT_RELEASE_ADMISSION  /**< Libération du compteur */
+} EventType;
+
+/**
+ * @brief Événement extrait d'une ligne du log.
+ */
+typedef struct {
+    uint64_t offset;    /**< Position de la ligne dans le fichier */
+    uint64_t timestamp; /**< Horodatage lu dans l'index ou en tête du message, 0 si inconnu */
+    int32_t seatId;     /**< Philosophe concerné */
+    int32_t chopstickId;/**< Baguette concernée, 0 si aucune */
+    EventType type;     /**< Type de l'événement */
+} Event;
+
+/**
+ * @brief Tranche du fichier traitée par un thread.
+ */
+typedef struct {
+    const char *text;     /**< Début du fichier projeté */
+    size_t start;         /**< Début de la tranche */
+    size_t end;           /**< Fin de la tranche (exclue) */
+    const LogIndexEntry *times; /**< Entrées de l'index triées par position, NULL sans index */
+    size_t numberTimes;
+    Event *events;        /**< Événements extraits */
+    size_t numberEvents;
+    size_t capacity;
+} Chunk;
+
+/**
+ * @brief Statistiques reconstituées pour un philosophe.
+ */
+typedef struct {
+    bool seen;
+    unsigned long meals;
+    unsigned long admissionWaits;
+    unsigned long chopstickWaits;
+    uint64_t hungrySince;   /**< Début de la demande en cours, 0 si aucune */
+    uint64_t mealStart;     /**< Début du repas en cours, 0 si aucun */
+    int held;               /**< Nombre de baguettes tenues */
+    uint64_t totalWait;
+    uint64_t maxWait;
+    uint64_t totalEating;
+    unsigned long timedMeals; /**< Repas dont l'attente a pu être mesurée */
+    unsigned long timedEatings;
+} SeatReport;
+
+/**
+ * @brief Statistiques reconstituées pour une baguette.
+ */
+typedef struct {
+    bool seen;
+    unsigned long takes;
+    unsigned long waits;
+    uint64_t heldSince;
+    uint64_t totalHeld;
+} ChopstickReport;
+
+/**
+ * @brief Vérifie qu'un texte commence par un préfixe, sans dépasser la fin de la ligne.
+ */
+static inline bool startsWith(const char *text, const char *end, const char *prefix, size_t prefixLength) {
+    return (size_t) (end - text) >= prefixLength && memcmp(text, prefix, prefixLength) == 0;
+}
+
+#define STARTS_WITH(text, end, literal) startsWith((text), (end), (literal), sizeof(literal) - 1)
+
+/**
+ * @brief Lit un entier positif et avance le curseur.
+ */
+static inline int32_t readNumber(const char **cursor, const char *end) {
+    int32_t value = 0;
+    while (*cursor < end && **cursor >= '0' && **cursor <= '9') {
+        value = value * 10 + (**cursor - '0');
+        (*cursor)++;
+    }
+    return value;
+}
+
+/**
+ * @brief Reconnaît le message d'une ligne du log.
+ *
+ * @param line Début de la ligne.
+ * @param end Fin de la ligne.
+ * @param event Événement à compléter.
+ * @return bool true si la ligne correspond à un message connu.
+ */
+bool parseLine(const char *line, const char *end, Event *event) {
+    const char *cursor = line;
+    event->chopstickId = 0;
+
+    if (STARTS_WITH(cursor, end, "Création du philosophe ")) {
+        cursor += sizeof("Création du philosophe ") - 1;
+        event->seatId = readNumber(&cursor, end);
+        event->type = EVENT_JOIN;
+        return true;
+    }
+
+    if (!STARTS_WITH(cursor, end, "Le philosophe ")) {
+        return false;
+    }
+
+    cursor += sizeof("Le philosophe ") - 1;
+    event->seatId = readNumber(&cursor, end);
+
+    if (STARTS_WITH(cursor, end, " attend que le compteur")) {
+        event->type = EVENT_WAIT_ADMISSION;
+        return true;
+    }
+
+    if (STARTS_WITH(cursor, end, " s'ajoute au compteur")) {
+        event->type = EVENT_ADMITTED;
+        return true;
+    }
+
+    if (STARTS_WITH(cursor, end, " libère le compteur")) {
+        event->type = EVENT_RELEASE_ADMISSION;
+        return true;
+    }
+
+    if (STARTS_WITH(cursor, end, " attend que la baguette ")) {
+        cursor += sizeof(" attend que la baguette ") - 1;
+        event->chopstickId = readNumber(&cursor, end);
+        event->type = EVENT_WAIT_CHOPSTICK;
+        return true;
+    }
+
+    if (STARTS_WITH(cursor, end, " prend la baguette ")) {
+        cursor += sizeof(" prend la baguette ") - 1;
+        event->chopstickId = readNumber(&cursor, end);
+        event->type = STARTS_WITH(cursor, end, " à sa gauche") ? EVENT_TAKE_LEFT : EVENT_TAKE_RIGHT;
+        return true;
+    }
+
+    if (STARTS_WITH(cursor, end, " libère la baguette ")) {
+        cursor += sizeof(" libère la baguette ") - 1;
+        event->chopstickId = readNumber(&cursor, end);
+        event->type = EVENT_RELEASE_CHOPSTICK;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Recherche dans l'index (trié par position) l'horodatage du message commençant à une position donnée.
+ *
+ * @param chunk Tranche en cours, dont le curseur `cursor` avance avec les lignes.
+ * @param cursor Position courante dans les entrées de l'index.
+ * @param offset Position de la ligne dans le fichier.
+ * @return uint64_t L'horodatage du message contenant la ligne, 0 si inconnu.
+ */
+static inline uint64_t findTimestamp(const Chunk *chunk, size_t *cursor, uint64_t offset) {
+    while (*cursor + 1 < chunk->numberTimes && chunk->times[*cursor + 1].offset <= offset) {
+        *cursor += 1;
+    }
+
+    if (*cursor < chunk->numberTimes) {
+        const LogIndexEntry *entry = &chunk->times[*cursor];
+        if (entry->offset <= offset && offset < entry->offset + entry->length) {
+            return entry->timestamp;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Routine d'un thread d'analyse : extrait les événements de sa tranche.
+ *
+ * @param arg Pointeur vers la tranche `Chunk` à traiter.
+ * @return void* Toujours NULL.
+ */
+void *parseChunkThread(void *arg) {
+    Chunk *chunk = (Chunk *) arg;
+    size_t position = chunk->start;
+    size_t timeCursor = 0;
+
+    // Première entrée de l'index concernant la tranche
+    if (chunk->times) {
+        size_t low = 0, high = chunk->numberTimes;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (chunk->times[middle].offset + chunk->times[middle].length <= position) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        timeCursor = low;
+    }
+
+    while (position < chunk->end) {
+        const char *line = chunk->text + position;
+        const char *newLine = memchr(line, '\n', chunk->end - position);
+        const char *end = newLine ? newLine : chunk->text + chunk->end;
+
+        Event event;
+        uint64_t lineTimestamp = 0;
+        size_t timestampLength = parseLogTimestamp(line, (size_t) (end - line), &lineTimestamp);
+
+        if (parseLine(line + timestampLength, end, &event)) {
+            if (chunk->numberEvents == chunk->capacity) {
+                chunk->capacity = chunk->capacity ? chunk->capacity * 2 : 4096;
+                chunk->events = realloc(chunk->events, chunk->capacity * sizeof(Event));
+                if (!chunk->events) {
+                    perror("realloc");
+                    exit(EXIT_FAILURE);
+                }
+            }
+
+            event.offset = position;
+            event.timestamp = chunk->times ? findTimestamp(chunk, &timeCursor, position) : lineTimestamp;
+            chunk->events[chunk->numberEvents++] = event;
+        }
+
+        position = (size_t) (end - chunk->text) + 1;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Ordre des entrées de l'index par position dans le fichier.
+ */
+int compareEntriesByOffset(const void *a, const void *b) {
+    const LogIndexEntry *first = (const LogIndexEntry *) a;
+    const LogIndexEntry *second = (const LogIndexEntry *) b;
+
+    if (first->offset != second->offset) {
+        return first->offset < second->offset ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Charge les horodatages de l'index du fichier, triés par position.
+ *
+ * @param logFilePath Chemin du fichier de log.
+ * @param numberTimes Nombre d'entrées chargées.
+ * @return LogIndexEntry* Les entrées horodatées triées par position, NULL si l'index est absent ou sans horodatage.
+ */
+LogIndexEntry *loadTimes(const char *logFilePath, size_t *numberTimes) {
+    LogIndexMap map;
+    *numberTimes = 0;
+
+    if (mapLogIndex(logFilePath, &map) == -1) {
+        return NULL;
+    }
+
+    LogIndexEntry *times = malloc(map.numberEntries * sizeof(LogIndexEntry) + 1);
+    for (size_t i = 0; times && i < map.numberEntries; i++) {
+        if (map.entries[i].timestamp) {
+            times[(*numberTimes)++] = map.entries[i];
+        }
+    }
+    unmapLogIndex(&map);
+
+    if (!times || *numberTimes == 0) {
+        free(times);
+        *numberTimes = 0;
+        return NULL;
+    }
+
+    qsort(times, *numberTimes, sizeof(LogIndexEntry), compareEntriesByOffset);
+    return times;
+}
+
+/**
+ * @brief Agrandit si besoin un tableau de rapports indexé par identifiant.
+ */
+void *growReports(void *reports, size_t *capacity, int32_t id, size_t elementSize) {
+    if ((size_t) id < *capacity) {
+        return reports;
+    }
+
+    size_t newCapacity = *capacity ? *capacity : 16;
+    while (newCapacity <= (size_t) id) {
+        newCapacity *= 2;
+    }
+
+    reports = realloc(reports, newCapacity * elementSize);
+    if (!reports) {
+        perror("realloc");
+        exit(EXIT_FAILURE);
+    }
+
+    memset((char *) reports + *capacity * elementSize, 0, (newCapacity - *capacity) * elementSize);
+    *capacity = newCapacity;
+    return reports;
+}
+
+/**
+ * @brief Affiche une durée en secondes, ou "-" si elle n'a pas pu être mesurée.
+ */
+void printSeconds(bool csv, bool known, double seconds) {
+    if (!known) {
+        printf(csv ? "," : " %12s", "-");
+    } else {
+        printf(csv ? ",%.3f" : " %12.3f", seconds);
+    }
+}
+
+/**
+ * @brief Affiche l'aide de l'outil.
+ */
+void usage(const char *program) {
+    printf("Utilisation : %s [-j threads] [-r seats|chopsticks|timeline] [-s philosophe] [-c] <server.log>\n", program);
+}
+
+/**
+ * @brief Point d'entrée de l'analyseur.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments (voir la description du fichier).
+ * @return int Code de sortie.
+ */
+int main(int argc, char *argv[]) {
+    long numberThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *report = "seats";
+    int32_t timelineSeat = -1;
+    bool csv = false;
+    int option;
+
+    while ((option = getopt(argc, argv, "j:r:s:c")) != -1) {
+        switch (option) {
+            case 'j': numberThreads = atol(optarg); break;
+            case 'r': report = optarg; break;
+            case 's': timelineSeat = atoi(optarg); break;
+            case 'c': csv = true; break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc || numberThreads < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char *logFilePath = argv[optind];
+    int fd = open(logFilePath, O_RDONLY);
+    struct stat logStat;
+
+    if (fd == -1 || fstat(fd, &logStat) == -1) {
+        printMessage(ERROR, "Impossible d'ouvrir %s.\n", logFilePath);
+        perror("open");
+        return EXIT_FAILURE;
+    }
+
+    size_t size = logStat.st_size;
+    const char *text = size ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+    close(fd);
+
+    if (text == MAP_FAILED) {
+        perror("mmap");
+        return EXIT_FAILURE;
+    }
+
+    size_t numberTimes;
+    LogIndexEntry *times = loadTimes(logFilePath, &numberTimes);
+    uint64_t firstLineTimestamp;
+    bool timed = times || (text && parseLogTimestamp(text, size, &firstLineTimestamp) > 0);
+
+    if (!timed) {
+        printMessage(WARNING, "Index absent ou sans horodatage, messages sans heure : seuls les décomptes sont disponibles.\n");
+    }
+
+    // Découpage en tranches alignées sur les fins de ligne
+    if ((size_t) numberThreads > size / 4096 + 1) {
+        numberThreads = size / 4096 + 1;
+    }
+
+    Chunk *chunks = calloc(numberThreads, sizeof(Chunk));
+    pthread_t *threads = calloc(numberThreads, sizeof(pthread_t));
+    size_t start = 0;
+
+    for (long i = 0; i < numberThreads; i++) {
+        size_t end = (i == numberThreads - 1) ? size : size / numberThreads * (i + 1);
+
+        if (end < start) {
+            end = start;
+        }
+
+        const char *newLine = end < size ? memchr(text + end, '\n', size - end) : NULL;
+        end = newLine ? (size_t) (newLine - text) + 1 : size;
+
+        chunks[i].text = text;
+        chunks[i].start = start;
+        chunks[i].end = end;
+        chunks[i].times = times;
+        chunks[i].numberTimes = numberTimes;
+        start = end;
+
+        if (pthread_create(&threads[i], NULL, parseChunkThread, &chunks[i]) != 0) {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (long i = 0; i < numberThreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Reconstitution des chronologies : les tranches sont contiguës, leurs événements sont donc déjà dans l'ordre
+    SeatReport *seats = NULL;
+    ChopstickReport *chopsticks = NULL;
+    size_t seatsCapacity = 0, chopsticksCapacity = 0;
+    uint64_t firstTimestamp = 0, lastTimestamp = 0;
+    bool timeline = strcmp(report, "timeline") == 0;
+
+    if (timeline && csv) {
+        printf("seat,event,timestamp,chopstick\n");
+    }
+
+    for (long i = 0; i < numberThreads; i++) {
+        for (size_t j = 0; j < chunks[i].numberEvents; j++) {
+            Event *event = &chunks[i].events[j];
+            uint64_t now = event->timestamp;
+
+            seats = growReports(seats, &seatsCapacity, event->seatId, sizeof(SeatReport));
+            SeatReport *seat = &seats[event->seatId];
+            seat->seen = true;
+
+            if (now) {
+                firstTimestamp = firstTimestamp ? firstTimestamp : now;
+                lastTimestamp = now;
+            }
+
+            if (event->chopstickId) {
+                chopsticks = growReports(chopsticks, &chopsticksCapacity, event->chopstickId, sizeof(ChopstickReport));
+                chopsticks[event->chopstickId].seen = true;
+            }
+
+            switch (event->type) {
+                case EVENT_WAIT_ADMISSION:
+                    seat->admissionWaits += 1;
+                    // fallthrough
+                case EVENT_ADMITTED:
+                    if (!seat->hungrySince) {
+                        seat->hungrySince = now;
+                    }
+                    break;
+
+                // L'ordre de prise des baguettes dépend de la politique d'arbitrage (compteur ou baguettes ordonnées) :
+                // le repas commence à la prise de la seconde baguette et se termine à la libération de la première
+                case EVENT_WAIT_CHOPSTICK:
+                    seat->chopstickWaits += 1;
+                    chopsticks[event->chopstickId].waits += 1;
+                    if (!seat->hungrySince && seat->held == 0) {
+                        seat->hungrySince = now;
+                    }
+                    break;
+
+                case EVENT_TAKE_LEFT:
+                case EVENT_TAKE_RIGHT:
+                    chopsticks[event->chopstickId].takes += 1;
+                    chopsticks[event->chopstickId].heldSince = now;
+
+                    if (!seat->hungrySince && seat->held == 0) {
+                        seat->hungrySince = now;
+                    }
+
+                    if (++seat->held == 2) {
+                        seat->meals += 1;
+                        seat->mealStart = now;
+
+                        if (now && seat->hungrySince) {
+                            uint64_t wait = now - seat->hungrySince;
+                            seat->totalWait += wait;
+                            seat->maxWait = wait > seat->maxWait ? wait : seat->maxWait;
+                            seat->timedMeals += 1;
+                        }
+                        seat->hungrySince = 0;
+                    }
+                    break;
+
+                case EVENT_RELEASE_CHOPSTICK:
+                    if (now && chopsticks[event->chopstickId].heldSince) {
+                        chopsticks[event->chopstickId].totalHeld += now - chopsticks[event->chopstickId].heldSince;
+                    }
+                    chopsticks[event->chopstickId].heldSince = 0;
+
+                    if (seat->held == 2) {
+                        if (now && seat->mealStart) {
+                            seat->totalEating += now - seat->mealStart;
+                            seat->timedEatings += 1;
+                        }
+                        seat->mealStart = 0;
+                    }
+                    seat->held = seat->held > 0 ? seat->held - 1 : 0;
+                    break;
+
+                default:
+                    break;
+            }
+
+            if (timeline && event->seatId == timelineSeat) {
+                static const char *names[] = {
+                    "arrivée", "attente compteur", "compteur pris", "attente baguette",
+                    "baguette gauche prise", "baguette droite prise", "baguette libérée", "compteur libéré"
+                };
+                double seconds = now ? (double) now / 1e9 : 0;
+
+                if (csv) {
+                    printf("%d,%s,%.6f,%d\n", event->seatId, names[event->type], seconds, event->chopstickId);
+                } else {
+                    printf("%17.6f  %-32s", seconds, names[event->type]);
+                    if (event->chopstickId) {
+                        printf(" baguette %d", event->chopstickId);
+                    }
+                    printf("\n");
+                }
+            }
+        }
+    }
+
+    double observed = (double) (lastTimestamp - firstTimestamp) / 1e9;
+
+    if (strcmp(report, "seats") == 0) {
+        printf(csv ? "seat,meals,admission_waits,chopstick_waits,avg_wait_s,max_wait_s,avg_meal_s\n"
+                   : "Philosophe   Repas  Att.compteur  Att.baguettes  Attente moy(s) Attente max(s)   Repas moy(s)\n");
+
+        for (size_t id = 1; id < seatsCapacity; id++) {
+            SeatReport *seat = &seats[id];
+            if (!seat->seen) {
+                continue;
+            }
+
+            printf(csv ? "%zu,%lu,%lu,%lu" : "%10zu %7lu %13lu %14lu", id, seat->meals, seat->admissionWaits, seat->chopstickWaits);
+            printSeconds(csv, seat->timedMeals > 0, seat->timedMeals ? (double) seat->totalWait / seat->timedMeals / 1e9 : 0);
+            printSeconds(csv, seat->timedMeals > 0, (double) seat->maxWait / 1e9);
+            printSeconds(csv, seat->timedEatings > 0, seat->timedEatings ? (double) seat->totalEating / seat->timedEatings / 1e9 : 0);
+            printf("\n");
+        }
+    } else if (strcmp(report, "chopsticks") == 0) {
+        printf(csv ? "chopstick,takes,waits,held_s,utilisation\n"
+                   : "  Baguette   Prises  Attentes   Tenue (s)  Utilisation\n");
+
+        for (size_t id = 1; id < chopsticksCapacity; id++) {
+            ChopstickReport *chopstick = &chopsticks[id];
+            if (!chopstick->seen) {
+                continue;
+            }
+
+            printf(csv ? "%zu,%lu,%lu" : "%10zu %8lu %9lu", id, chopstick->takes, chopstick->waits);
+            printSeconds(csv, timed, (double) chopstick->totalHeld / 1e9);
+
+            if (timed && observed > 0) {
+                printf(csv ? ",%.4f" : " %11.1f%%", csv ? chopstick->totalHeld / 1e9 / observed : 100.0 * chopstick->totalHeld / 1e9 / observed);
+            } else {
+                printf(csv ? "," : " %12s", "-");
+            }
+            printf("\n");
+        }
+    } else if (!timeline) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (long i = 0; i < numberThreads; i++) {
+        free(chunks[i].events);
+    }
+    free(chunks);
+    free(threads);
+    free(seats);
+    free(chopsticks);
+    free(times);
+
+    if (text) {
+        munmap((void *) text, size);
+    }
+
+    return EXIT_SUCCESS;
+}
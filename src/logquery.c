@@ -0,0 +1,384 @@
+/**
+ * @file logquery.c
+ * @brief Outil d'interrogation des fichiers de logs du serveur à l'aide de leur index.
+ *
+ * Le serveur écrit, à côté de chaque fichier de log, un index associant chaque message au philosophe concerné et
+ * à son heure d'écriture (voir LogIndex.h). Cet outil exploite ces index pour répondre à des questions comme
+ * "que s'est-il passé pour le philosophe 4 entre 14:02 et 14:05" sans relire tout le texte : seules les
+ * entrées concernées de l'index sont parcourues (recherche dichotomique dans la partie triée) et seuls les
+ * messages correspondants sont lus dans les fichiers de logs projetés en mémoire.
+ *
+ * Utilisation (depuis le dossier src, comme le serveur) :
+ *  - `logquery index <fichier.log>...` : trie l'index existant d'un fichier de log, ou le reconstruit depuis
+ *    le texte s'il n'existe pas (les messages ont alors l'heure de leur en-tête, s'ils en ont une).
+ *  - `logquery query [-s philosophe] [-f début] [-t fin] <fichier.log>...` : affiche, dans l'ordre chronologique,
+ *    les messages correspondant aux critères dans l'ensemble des fichiers donnés.
+ *
+ * Les heures de début et de fin acceptent les formats "HH:MM[:SS]" (jour courant), "AAAA-MM-JJ HH:MM[:SS]",
+ * "AAAA-MM-JJTHH:MM[:SS]" ou "@secondes" (epoch). Sans les secondes, la borne de fin couvre la minute entière.
+ *
+ * Compilation : `gcc logquery.c -o logquery`
+ */
+
+#include "../include/utils/print_message.h"
+#include "../include/utils/dates.h"
+#include "../include/entities/LogIndex.h"
+#include "../include/managers/LogIndex.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Message retenu par une requête.
+ */
+typedef struct {
+    int file;           /**< Indice du fichier de log dans la liste donnée en argument */
+    uint64_t timestamp; /**< Horodatage du message */
+    uint64_t offset;    /**< Position du message dans le fichier */
+    uint32_t length;    /**< Taille du message */
+} QueryMatch;
+
+/**
+ * @brief Ensemble des messages retenus par une requête.
+ */
+typedef struct {
+    QueryMatch *matches;
+    size_t numberMatches;
+    size_t capacity;
+    size_t undatedSkipped; /**< Messages du philosophe ignorés car sans horodatage alors qu'une plage horaire est demandée */
+} QueryResult;
+
+/**
+ * @brief Fichier de log projeté en mémoire.
+ */
+typedef struct {
+    const char *path;
+    const char *text;
+    size_t size;
+} MappedLog;
+
+/**
+ * @brief Ajoute un message au résultat d'une requête.
+ *
+ * @param result Résultat de la requête.
+ * @param file Indice du fichier de log.
+ * @param entry Entrée de l'index correspondant au message.
+ */
+void addQueryMatch(QueryResult *result, int file, const LogIndexEntry *entry) {
+    if (result->numberMatches == result->capacity) {
+        result->capacity = result->capacity ? result->capacity * 2 : 256;
+        result->matches = realloc(result->matches, result->capacity * sizeof(QueryMatch));
+
+        if (!result->matches) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    QueryMatch *match = &result->matches[result->numberMatches++];
+    match->file = file;
+    match->timestamp = entry->timestamp;
+    match->offset = entry->offset;
+    match->length = entry->length;
+}
+
+/**
+ * @brief Vérifie si une entrée de l'index correspond aux critères de la requête.
+ */
+bool matchesQuery(const LogIndexEntry *entry, int32_t seatId, uint64_t from, uint64_t to, bool hasRange, QueryResult *result) {
+    if (seatId != -1 && entry->seatId != seatId) {
+        return false;
+    }
+
+    if (hasRange && entry->timestamp == 0) {
+        result->undatedSkipped += 1;
+        return false;
+    }
+
+    return entry->timestamp >= from && entry->timestamp <= to;
+}
+
+/**
+ * @brief Recherche dans l'index d'un fichier les messages correspondant aux critères.
+ *
+ * Pour un philosophe donné, la partie triée de l'index est parcourue à partir de la première entrée du
+ * philosophe postérieure au début de la plage, et s'arrête dès que la plage ou le philosophe est dépassé.
+ * La partie non triée (entrées ajoutées depuis le dernier tri) est parcourue entièrement.
+ *
+ * @return bool false si l'index du fichier est absent ou invalide.
+ */
+bool queryLogIndex(int file, const char *logFilePath, int32_t seatId, uint64_t from, uint64_t to, bool hasRange, QueryResult *result) {
+    LogIndexMap map;
+
+    if (mapLogIndex(logFilePath, &map) == -1) {
+        return false;
+    }
+
+    size_t start = 0;
+    size_t end = map.sortedEntries;
+
+    if (seatId != -1) {
+        start = lowerBoundLogIndex(&map, seatId, from);
+
+        // Les entrées sans horodatage (index reconstruit) sont triées en tête de chaque philosophe
+        if (hasRange) {
+            size_t firstDated = lowerBoundLogIndex(&map, seatId, 1);
+            result->undatedSkipped += firstDated - lowerBoundLogIndex(&map, seatId, 0);
+
+            if (start < firstDated) {
+                start = firstDated;
+            }
+        }
+    }
+
+    for (size_t i = start; i < end; i++) {
+        const LogIndexEntry *entry = &map.entries[i];
+
+        if (seatId != -1 && (entry->seatId != seatId || entry->timestamp > to)) {
+            break;
+        }
+
+        if (matchesQuery(entry, seatId, from, to, hasRange, result)) {
+            addQueryMatch(result, file, entry);
+        }
+    }
+
+    for (size_t i = map.sortedEntries; i < map.numberEntries; i++) {
+        if (matchesQuery(&map.entries[i], seatId, from, to, hasRange, result)) {
+            addQueryMatch(result, file, &map.entries[i]);
+        }
+    }
+
+    unmapLogIndex(&map);
+    return true;
+}
+
+/**
+ * @brief Ordre chronologique des messages retenus.
+ */
+int compareQueryMatches(const void *a, const void *b) {
+    const QueryMatch *first = (const QueryMatch *) a;
+    const QueryMatch *second = (const QueryMatch *) b;
+
+    if (first->timestamp != second->timestamp) {
+        return first->timestamp < second->timestamp ? -1 : 1;
+    }
+
+    if (first->file != second->file) {
+        return first->file < second->file ? -1 : 1;
+    }
+
+    if (first->offset != second->offset) {
+        return first->offset < second->offset ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Projette un fichier de log en lecture seule.
+ */
+void mapLogFile(MappedLog *log) {
+    log->text = NULL;
+    log->size = 0;
+
+    int fd = open(log->path, O_RDONLY);
+    if (fd == -1) {
+        return;
+    }
+
+    struct stat logStat;
+    if (fstat(fd, &logStat) == 0 && logStat.st_size > 0) {
+        void *address = mmap(NULL, logStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (address != MAP_FAILED) {
+            log->text = address;
+            log->size = logStat.st_size;
+        }
+    }
+
+    close(fd);
+}
+
+/**
+ * @brief Affiche les messages retenus, dans l'ordre chronologique.
+ *
+ * Seules les pages des fichiers de logs contenant les messages retenus sont lues.
+ */
+void printQueryResult(QueryResult *result, MappedLog *logs, int numberLogs) {
+    qsort(result->matches, result->numberMatches, sizeof(QueryMatch), compareQueryMatches);
+
+    for (size_t i = 0; i < result->numberMatches; i++) {
+        QueryMatch *match = &result->matches[i];
+        MappedLog *log = &logs[match->file];
+
+        if (!log->text) {
+            mapLogFile(log);
+        }
+
+        // Le fichier a pu être tronqué depuis l'écriture de l'index
+        if (match->offset + match->length > log->size) {
+            continue;
+        }
+
+        uint64_t lineTimestamp;
+        bool stamped = parseLogTimestamp(log->text + match->offset, match->length, &lineTimestamp) > 0;
+
+        // Les messages horodatés à l'émission portent déjà leur heure en tête de ligne
+        if (!stamped && match->timestamp) {
+            time_t seconds = (time_t) (match->timestamp / 1000000000ULL);
+            struct tm date;
+            char formatted[32];
+
+            localtime_r(&seconds, &date);
+            strftime(formatted, sizeof(formatted), "%Y-%m-%d %H:%M:%S", &date);
+            printf("[%s.%03llu] ", formatted, (unsigned long long) (match->timestamp / 1000000ULL % 1000ULL));
+        } else if (!stamped) {
+            printf("[--] ");
+        }
+
+        if (numberLogs > 1) {
+            const char *name = strrchr(log->path, '/');
+            printf("%s: ", name ? name + 1 : log->path);
+        }
+
+        fwrite(log->text + match->offset, 1, match->length, stdout);
+        if (match->length == 0 || log->text[match->offset + match->length - 1] != '\n') {
+            putchar('\n');
+        }
+    }
+}
+
+/**
+ * @brief Affiche l'aide de l'outil.
+ */
+void usage(const char *program) {
+    printf("Utilisation :\n");
+    printf("  %s index <fichier.log>...\n", program);
+    printf("  %s query [-s philosophe] [-f début] [-t fin] <fichier.log>...\n", program);
+    printf("Formats d'heure : HH:MM[:SS], AAAA-MM-JJ HH:MM[:SS], @secondes\n");
+}
+
+/**
+ * @brief Commande `index` : trie ou reconstruit l'index des fichiers donnés.
+ */
+int indexCommand(int argc, char *argv[]) {
+    int status = EXIT_SUCCESS;
+
+    for (int i = 0; i < argc; i++) {
+        long numberEntries = sortLogIndex(argv[i]);
+
+        if (numberEntries != -1) {
+            printMessage(SUCCESS, "%s : %ld entrées triées.\n", argv[i], numberEntries);
+            continue;
+        }
+
+        // Pas d'index : reconstruction depuis le texte, les fichiers des clients ne rappellent pas toujours le philosophe
+        bool isClientLog = strstr(argv[i], "client_") != NULL;
+        numberEntries = buildLogIndex(argv[i], isClientLog);
+
+        if (numberEntries == -1) {
+            printMessage(ERROR, "%s : impossible de construire l'index.\n", argv[i]);
+            perror("index");
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        printMessage(WARNING, "%s : index reconstruit depuis le texte (%ld entrées, horodatées par leur en-tête s'il existe).\n", argv[i], numberEntries);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Commande `query` : affiche les messages correspondant aux critères.
+ */
+int queryCommand(int argc, char *argv[]) {
+    int32_t seatId = -1;
+    uint64_t from = 0;
+    uint64_t to = UINT64_MAX;
+    bool hasRange = false;
+    int i = 0;
+
+    for (; i < argc && argv[i][0] == '-'; i += 2) {
+        if (i + 1 >= argc) {
+            printMessage(ERROR, "L'option %s attend une valeur.\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        if (strcmp(argv[i], "-s") == 0) {
+            seatId = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "-f") == 0 && parseQueryTime(argv[i + 1], false, &from)) {
+            hasRange = true;
+        } else if (strcmp(argv[i], "-t") == 0 && parseQueryTime(argv[i + 1], true, &to)) {
+            hasRange = true;
+        } else {
+            printMessage(ERROR, "Option ou heure invalide : %s %s\n", argv[i], argv[i + 1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    int numberLogs = argc - i;
+    if (numberLogs <= 0) {
+        usage("logquery");
+        return EXIT_FAILURE;
+    }
+
+    MappedLog *logs = calloc(numberLogs, sizeof(MappedLog));
+    QueryResult result;
+    memset(&result, 0, sizeof(result));
+
+    for (int file = 0; file < numberLogs; file++) {
+        logs[file].path = argv[i + file];
+
+        if (!queryLogIndex(file, logs[file].path, seatId, from, to, hasRange, &result)) {
+            printMessage(WARNING, "%s : index absent ou invalide, lancer d'abord 'logquery index %s'.\n", logs[file].path, logs[file].path);
+        }
+    }
+
+    printQueryResult(&result, logs, numberLogs);
+
+    if (result.undatedSkipped > 0) {
+        printMessage(WARNING, "%zu messages sans horodatage ignorés (index reconstruit depuis le texte).\n", result.undatedSkipped);
+    }
+
+    for (int file = 0; file < numberLogs; file++) {
+        if (logs[file].text) {
+            munmap((void *) logs[file].text, logs[file].size);
+        }
+    }
+
+    free(logs);
+    free(result.matches);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Point d'entrée de l'outil.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments : la commande (`index` ou `query`) suivie de ses options et des fichiers de logs.
+ * @return int Code de sortie.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (strcmp(argv[1], "index") == 0) {
+        return indexCommand(argc - 2, argv + 2);
+    }
+
+    if (strcmp(argv[1], "query") == 0) {
+        return queryCommand(argc - 2, argv + 2);
+    }
+
+    usage(argv[0]);
+    return EXIT_FAILURE;
+}
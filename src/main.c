@@ -12,9 +12,14 @@
  *  - La gestion des fichiers, sockets et commandes (files.h, sockets.h, commands.h).
  *  - La génération de nombres aléatoires (random.h).
  *  - La définition de la structure `ClientPhilosopher` qui représente un philosophe côté client.
- *  - L'implémentation des fonctions de requêtes et de réponses (Request.c et Response.c).
+ *  - L'implémentation des fonctions de requêtes et de réponses (Request.c et Response.c), et des datagrammes
+ *    du mode datagramme (Datagram.c).
  *  - Les bibliothèques standard pour les opérations d'entrée/sortie, la gestion des threads et des erreurs.
  *
+ * Lancé avec l'option DATAGRAM_OPTION, le client utilise le mode datagramme (voir Datagram.h) : chaque philosophe
+ * échange des datagrammes UDP avec le service datagramme du serveur au lieu d'ouvrir une connexion TCP. L'option
+ * `PORT_OPTION port` change le port du serveur, pour passer par le proxy de dégradation réseau (outil `proxy`).
+ *
  * @note Ce fichier utilise une boucle infinie pour permettre à l'utilisateur d'ajouter dynamiquement
  * des philosophes et de gérer leur cycle de vie via des threads.
  */
@@ -28,10 +33,46 @@
 #include "../include/entities/ClientPhilosopher.h"
 #include "../include/managers/Request.c"
 #include "../include/managers/Response.c"
+#include "../include/managers/Datagram.c"
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 #include <stdbool.h>
 #include <unistd.h>
 #include <errno.h>
+#include <signal.h>
+
+/**
+ * @brief Mode datagramme (option DATAGRAM_OPTION) : les philosophes échangent des datagrammes UDP avec le serveur.
+ */
+bool datagramMode = false;
+
+/**
+ * @brief Port du serveur, PORT par défaut ou celui de l'option PORT_OPTION (le proxy de dégradation réseau par exemple).
+ */
+int serverPort = PORT;
+
+/**
+ * @brief Retourne le prochain numéro de séquence d'un philosophe en mode datagramme.
+ *
+ * @param philosopher Le philosophe.
+ * @return uint32_t Le numéro de séquence.
+ */
+uint32_t nextSequence(ClientPhilosopher *philosopher) {
+    return __atomic_add_fetch(&philosopher->sequence, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Envoie un datagramme au serveur sur le socket UDP connecté d'un philosophe.
+ *
+ * Un datagramme peut se perdre : l'envoi n'est pas vérifié, le protocole renvoie ce qui doit l'être.
+ *
+ * @param philosopher Le philosophe.
+ * @param datagram Le datagramme.
+ */
+void sendDatagram(ClientPhilosopher *philosopher, Datagram datagram) {
+    send(philosopher->clientSocket.socket, &datagram, sizeof(datagram), 0);
+}
 
 /**
  * @brief Quitte le programme en affichant un message d'information.
@@ -39,10 +80,20 @@
  * Cette fonction affiche un message indiquant la fermeture du programme et des clients, puis termine l'exécution
  * de l'application en appelant exit().
  * 
- * En cas de coupure, les sockets se fermeront et le serveur sera immédiatement notifié.
+ * En cas de coupure, les sockets se fermeront et le serveur sera immédiatement notifié. En mode datagramme, il n'y a
+ * pas de connexion à couper : chaque philosophe envoie un datagramme de départ (s'il se perd, le serveur retirera le
+ * philosophe après DATAGRAM_SESSION_TIMEOUT ms sans nouvelles).
+ *
+ * @param philosophers Les philosophes du client.
+ * @param numberOfPhilosophers Le nombre de philosophes.
  */
-void quit() {
+void quit(ClientPhilosopher *philosophers, int numberOfPhilosophers) {
     printMessage(INFO, "Fermeture du programme et des clients...");
+
+    for (int i = 0; datagramMode && i < numberOfPhilosophers; i++) {
+        sendDatagram(&philosophers[i], buildDatagram(DATAGRAM_LEAVE, philosophers[i].token, nextSequence(&philosophers[i]), philosophers[i].base));
+    }
+
     exit(EXIT_SUCCESS);
 }
 
@@ -59,6 +110,9 @@ void quit() {
  *  - Si le philosophe est en état HUNGRY, il attend la réponse du serveur qui lui accorde l'autorisation de manger.
  *  - Une fois la réponse reçue, il met à jour son état et réinitialise le timer.
  *
+ * Si le serveur ferme la connexion (philosophe évincé depuis le socket de contrôle), le philosophe quitte la table :
+ * le thread se termine sans arrêter les autres philosophes.
+ *
  * @param arg Pointeur vers la structure `ClientPhilosopher` représentant le philosophe concerné.
  * @return void* Toujours retourne NULL à la fin de l'exécution du thread.
  */
@@ -93,7 +147,15 @@ void *philosopherThread(void *arg) {
 
         Request request = updateRequest(philosopher->base);
 
-        if (trySocketWrite(philosopher->clientSocket.socket, &request, sizeof(request)) == -1) {
+        ssize_t bytesSent = trySocketWrite(philosopher->clientSocket.socket, &request, sizeof(request));
+
+        if (bytesSent == -1 && (errno == EPIPE || errno == ECONNRESET)) {
+            printMessage(WARNING, "Le philosophe %d a été retiré de la table par le serveur.\n", philosopher->base.id);
+            close(philosopher->clientSocket.socket);
+            return NULL;
+        }
+
+        if (bytesSent == -1) {
             printMessage(ERROR, "Erreur lors d'une tentative d'envoi d'un requête de mise à jour.\n");
             perror("write");
             exit(EXIT_FAILURE);
@@ -104,7 +166,15 @@ void *philosopherThread(void *arg) {
 
             Response response;
 
-            if (trySocketRead(philosopher->clientSocket.socket, &response, sizeof(response)) == -1) {
+            ssize_t bytesReceived = trySocketRead(philosopher->clientSocket.socket, &response, sizeof(response));
+
+            if (bytesReceived == 0 || (bytesReceived == -1 && errno == ECONNRESET)) {
+                printMessage(WARNING, "Le philosophe %d a été retiré de la table par le serveur.\n", philosopher->base.id);
+                close(philosopher->clientSocket.socket);
+                return NULL;
+            }
+
+            if (bytesReceived == -1) {
                 printMessage(ERROR, "Erreur lors d'une tentative d'envoi d'un requête de mise à jour.\n");
                 perror("write");
                 close(philosopher->clientSocket.socket);
@@ -126,15 +196,256 @@ void *philosopherThread(void *arg) {
     return NULL;
 }
 
+/**
+ * @brief Attend l'autorisation de manger en mode datagramme.
+ *
+ * La demande est renvoyée toutes les DATAGRAM_RETRY_INTERVAL ms tant que le serveur ne répond pas ; le serveur
+ * acquitte chaque envoi tant qu'il traite la demande. Chaque autorisation reçue est acquittée, y compris les
+ * renvois d'une autorisation plus ancienne.
+ *
+ * @param philosopher Le philosophe.
+ * @param request La demande HUNGRY envoyée.
+ * @return bool false si le philosophe a été retiré de la table ou si le serveur ne répond plus.
+ */
+bool waitForGrant(ClientPhilosopher *philosopher, Datagram request) {
+    int silentRetries = 0;
+
+    while (1) {
+        Datagram reply;
+        int received = receiveDatagram(philosopher->clientSocket.socket, &reply, DATAGRAM_RETRY_INTERVAL);
+
+        if (received == -1) {
+            printMessage(ERROR, "Erreur lors de la réception d'un datagramme.\n");
+            perror("recv");
+            return false;
+        }
+
+        if (received == 0) {
+            silentRetries += 1;
+
+            if (silentRetries * DATAGRAM_RETRY_INTERVAL >= DATAGRAM_SESSION_TIMEOUT) {
+                printMessage(WARNING, "Le serveur ne répond plus au philosophe %d.\n", philosopher->base.id);
+                return false;
+            }
+
+            sendDatagram(philosopher, request);
+            continue;
+        }
+
+        silentRetries = 0;
+
+        if (reply.type == DATAGRAM_REFUSED) {
+            printMessage(WARNING, "Le philosophe %d a été retiré de la table par le serveur.\n", philosopher->base.id);
+            return false;
+        }
+
+        if (reply.type == DATAGRAM_GRANT) {
+            sendDatagram(philosopher, buildDatagram(DATAGRAM_ACK, philosopher->token, reply.sequence, philosopher->base));
+
+            if (reply.sequence == request.sequence) {
+                philosopher->base.state = reply.philosopher.state;
+                return true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Routine du thread associé à chaque philosophe en mode datagramme.
+ *
+ * Même cycle que philosopherThread(), sur le socket UDP du philosophe : l'état est envoyé chaque seconde sans
+ * attendre de réponse, et seule la demande HUNGRY attend l'autorisation du serveur (voir waitForGrant()).
+ * Entre deux envois, les datagrammes reçus sont lus sans attendre : un refus signale que le philosophe a été retiré
+ * de la table (évincé depuis le socket de contrôle), le thread se termine alors sans arrêter les autres philosophes.
+ *
+ * @param arg Pointeur vers la structure `ClientPhilosopher` représentant le philosophe concerné.
+ * @return void* Toujours retourne NULL à la fin de l'exécution du thread.
+ */
+void *datagramPhilosopherThread(void *arg) {
+    ClientPhilosopher *philosopher = (ClientPhilosopher *) arg;
+
+    while (1) {
+
+        sleep(1);
+        philosopher->base.stateTimer -= 1;
+
+        if (philosopher->base.stateTimer <= 0) {
+            switch(philosopher->base.state) {
+
+                case THINKING:
+                    philosopher->base.state = HUNGRY;
+                    break;
+
+                case EATING:
+                    philosopher->base.state = THINKING;
+                    philosopher->base.stateTimer = randomRange(MIN_STATE_TIME, MAX_STATE_TIME);
+                    break;
+
+                default:
+                    printMessage(ERROR, "L'état du philosophe n'est pas pris en charge.\n");
+                    exit(EXIT_FAILURE);
+            }
+        }
+
+        // Datagrammes arrivés depuis le dernier envoi : refus, ou autorisation déjà acquittée renvoyée par le serveur
+        Datagram received;
+
+        while (receiveDatagram(philosopher->clientSocket.socket, &received, 0) == 1) {
+            if (received.type == DATAGRAM_REFUSED) {
+                printMessage(WARNING, "Le philosophe %d a été retiré de la table par le serveur.\n", philosopher->base.id);
+                close(philosopher->clientSocket.socket);
+                return NULL;
+            }
+        }
+
+        Datagram update = buildDatagram(DATAGRAM_UPDATE, philosopher->token, nextSequence(philosopher), philosopher->base);
+        sendDatagram(philosopher, update);
+
+        if (philosopher->base.state == HUNGRY) {
+
+            if (!waitForGrant(philosopher, update)) {
+                close(philosopher->clientSocket.socket);
+                return NULL;
+            }
+
+            philosopher->base.stateTimer = randomRange(MIN_STATE_TIME, MAX_STATE_TIME);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Installe un philosophe à la table par une connexion TCP.
+ *
+ * Un socket client est créé et connecté au serveur, puis une requête de création est envoyée. Le client reçoit en
+ * réponse les informations initiales du philosophe (identifiant, état, timer).
+ *
+ * @param philosopher Le philosophe, complété par la fonction.
+ * @return bool false si la connexion ou la création a échoué (table pleine notamment).
+ */
+bool joinTable(ClientPhilosopher *philosopher) {
+    // Création d'un socket client par philosophe
+    philosopher->clientSocket.socket = getSocket();
+    philosopher->clientSocket.socketAddress = getSocketAddress();
+    philosopher->clientSocket.socketAddress.sin_port = htons(serverPort);
+
+    // Tentative de connexion
+    if (connect(philosopher->clientSocket.socket, (struct sockaddr *) &philosopher->clientSocket.socketAddress, sizeof(philosopher->clientSocket.socketAddress)) == -1) {
+        printMessage(ERROR, "Une erreur est survenue lors d'une tentative de connexion au serveur.\n");
+        perror("connect");
+        return false;
+    }
+
+    // On commence la liaison en attribuant un id par le serveur
+    // Avec l'envoi d'une requête pour créer un philosophe, utilisation de write() plutôt que send() car pas besoin de flag
+
+    Request request = createRequest();
+   
+    if (trySocketWrite(philosopher->clientSocket.socket, &request, sizeof(request)) == -1) {
+        printMessage(ERROR, "Une erreur est survenue lors d'une requête d'ajout de philosophe.\n");
+        perror("write");
+        close(philosopher->clientSocket.socket);
+        return false;
+    }
+
+    // Récéption du philosophe (id, état, timer)
+    Response response;
+
+    ssize_t bytesReceived = trySocketRead(philosopher->clientSocket.socket, &response, sizeof(response));
+
+    if (bytesReceived == -1) {
+        printMessage(ERROR, "Une erreur est survenue lors de la réception d'une réponse d'ajout de philosophe.\n");
+        perror("write");
+        close(philosopher->clientSocket.socket);
+        return false;
+    }
+
+    // Capacité de la table atteinte (réglable côté serveur) ou processus de service refusé
+    if (bytesReceived == 0 || response.type == RESPONSE_REFUSED) {
+        printMessage(WARNING, "Le serveur a refusé le philosophe : la table est pleine.\n");
+        close(philosopher->clientSocket.socket);
+        return false;
+    }
+ 
+    if (response.type != RESPONSE_CREATE) {
+        printMessage(ERROR, "Le type de réponse attendu n'est pas correct.\n");
+        close(philosopher->clientSocket.socket);
+        return false;
+    }
+
+    philosopher->base = response.philosopher;
+    return true;
+}
+
+/**
+ * @brief Installe un philosophe à la table en mode datagramme.
+ *
+ * Un socket UDP est créé et connecté au serveur (seuls ses datagrammes sont alors reçus), puis une demande de
+ * création est envoyée, et renvoyée jusqu'à MAX_ATTEMPTS fois si elle reste sans réponse.
+ *
+ * @param philosopher Le philosophe, complété par la fonction (jeton de session compris).
+ * @return bool false si le serveur n'a pas répondu ou a refusé le philosophe.
+ */
+bool joinTableByDatagram(ClientPhilosopher *philosopher) {
+    philosopher->clientSocket.socket = getDatagramSocket();
+    philosopher->clientSocket.socketAddress = getSocketAddress();
+    philosopher->clientSocket.socketAddress.sin_port = htons(serverPort);
+
+    if (connect(philosopher->clientSocket.socket, (struct sockaddr *) &philosopher->clientSocket.socketAddress, sizeof(philosopher->clientSocket.socketAddress)) == -1) {
+        printMessage(ERROR, "Une erreur est survenue lors de l'ouverture du socket UDP.\n");
+        perror("connect");
+        close(philosopher->clientSocket.socket);
+        return false;
+    }
+
+    Datagram request = buildDatagram(DATAGRAM_CREATE, 0, (uint32_t) rand(), philosopher->base);
+
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        sendDatagram(philosopher, request);
+
+        Datagram reply;
+        int received;
+
+        while ((received = receiveDatagram(philosopher->clientSocket.socket, &reply, DATAGRAM_RETRY_INTERVAL)) == 1 && reply.sequence != request.sequence);
+
+        if (received == -1) {
+            printMessage(ERROR, "Erreur lors de la réception d'un datagramme.\n");
+            perror("recv");
+            break;
+        }
+
+        if (received == 0) {
+            continue;
+        }
+
+        if (reply.type == DATAGRAM_CREATED) {
+            philosopher->base = reply.philosopher;
+            philosopher->token = reply.token;
+            philosopher->sequence = 0;
+            return true;
+        }
+
+        printMessage(WARNING, "Le serveur a refusé le philosophe : la table est pleine.\n");
+        close(philosopher->clientSocket.socket);
+        return false;
+    }
+
+    printMessage(ERROR, "Le serveur n'a pas répondu en mode datagramme.\n");
+    close(philosopher->clientSocket.socket);
+    return false;
+}
+
 /**
  * @brief Ajoute des philosophes côté client et crée leur thread associé.
  *
  * Cette fonction permet d'ajouter un nombre spécifié de philosophes. Pour chaque philosophe :
- *  - Un nouveau socket client est créé et une connexion au serveur est établie.
- *  - Une requête de création de philosophe est envoyée au serveur.
+ *  - Le philosophe est installé à la table par une connexion TCP (joinTable()) ou, en mode datagramme, par des
+ *    datagrammes UDP (joinTableByDatagram()).
  *  - Le client reçoit en réponse les informations initiales du philosophe (identifiant, état, timer).
  *  - Le philosophe est ajouté à la liste locale des philosophes et son état est initialisé.
- *  - Un thread est créé pour gérer le cycle de vie du philosophe via la fonction `philosopherThread`.
+ *  - Un thread est créé pour gérer le cycle de vie du philosophe via la fonction `philosopherThread`
+ *    (`datagramPhilosopherThread` en mode datagramme).
  *
  * @param number Nombre de philosophes à ajouter.
  * @param currentNumber Pointeur vers le compteur actuel de philosophes.
@@ -147,49 +458,14 @@ void addPhilosophers(int number, int *currentNumber, ClientPhilosopher *philosop
 
         // On créer un philosophe
         ClientPhilosopher newPhilosopher;
+        memset(&newPhilosopher, 0, sizeof(newPhilosopher));
 
-        // Création d'un socket client par philosophe
-        newPhilosopher.clientSocket.socket = getSocket();
-        newPhilosopher.clientSocket.socketAddress = getSocketAddress();
-
-        // Tentative de connexion
-        if (connect(newPhilosopher.clientSocket.socket, (struct sockaddr *) &newPhilosopher.clientSocket.socketAddress, sizeof(newPhilosopher.clientSocket.socketAddress)) == -1) {
-            printMessage(ERROR, "Une erreur est survenue lors d'une tentative de connexion au serveur.\n");
-            perror("connect");
-            break;
-        }
-
-        // On commence la liaison en attribuant un id par le serveur
-        // Avec l'envoi d'une requête pour créer un philosophe, utilisation de write() plutôt que send() car pas besoin de flag
-
-        Request request = createRequest();
-       
-        if (trySocketWrite(newPhilosopher.clientSocket.socket, &request, sizeof(request)) == -1) {
-            printMessage(ERROR, "Une erreur est survenue lors d'une requête d'ajout de philosophe.\n");
-            perror("write");
-            close(newPhilosopher.clientSocket.socket);
-            break;
-        }
-
-        // Récéption du philosophe (id, état, timer)
-        Response response;
-
-        if (trySocketRead(newPhilosopher.clientSocket.socket, &response, sizeof(response)) == -1) {
-            printMessage(ERROR, "Une erreur est survenue lors de la réception d'une réponse d'ajout de philosophe.\n");
-            perror("write");
-            close(newPhilosopher.clientSocket.socket);
-            break;
-        }
-     
-        if (response.type != RESPONSE_CREATE) {
-            printMessage(ERROR, "Le type de réponse attendu n'est pas correct.\n");
-            close(newPhilosopher.clientSocket.socket);
+        if (!(datagramMode ? joinTableByDatagram(&newPhilosopher) : joinTable(&newPhilosopher))) {
             break;
         }
 
-        printMessage(INFO, "Philosophe reçu par le serveur : %d \n", response.philosopher.id);
+        printMessage(INFO, "Philosophe reçu par le serveur : %d \n", newPhilosopher.base.id);
 
-        newPhilosopher.base = response.philosopher;
         newPhilosopher.base.state = THINKING;
         newPhilosopher.base.stateTimer = randomRange(MIN_STATE_TIME, MAX_STATE_TIME);
         
@@ -197,7 +473,7 @@ void addPhilosophers(int number, int *currentNumber, ClientPhilosopher *philosop
         philosophers[*currentNumber] = newPhilosopher;
 
         // On créé son thread associé
-        if (pthread_create(&philosophers[*currentNumber].thread, NULL, philosopherThread, &philosophers[*currentNumber]) == 0) {
+        if (pthread_create(&philosophers[*currentNumber].thread, NULL, datagramMode ? datagramPhilosopherThread : philosopherThread, &philosophers[*currentNumber]) == 0) {
             printMessage(
                 SUCCESS, 
                 "Le philosphe %d a été créé et connecté avec succès. \n",
@@ -212,6 +488,9 @@ void addPhilosophers(int number, int *currentNumber, ClientPhilosopher *philosop
 /**
  * @brief Fonction principale du client.
  *
+ * Avec l'option DATAGRAM_OPTION, les philosophes utilisent le mode datagramme ; avec `PORT_OPTION port`, ils se
+ * connectent à ce port plutôt qu'à PORT.
+ *
  * La fonction main initialise les variables nécessaires et entre dans une boucle infinie permettant
  * à l'utilisateur d'ajouter dynamiquement des philosophes via des commandes saisies au clavier.
  * Pour chaque ajout, la fonction vérifie la validité de la commande, détermine le nombre de philosophes à ajouter,
@@ -226,6 +505,24 @@ int main(int argc, char *argv[]) {
     ClientPhilosopher philosophers[MAX_PHILOSOPHERS];
     int numberOfPhilosophers = 0;
 
+    // Une écriture vers un philosophe évincé par le serveur doit échouer (EPIPE) et non tuer le client
+    signal(SIGPIPE, SIG_IGN);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], DATAGRAM_OPTION) == 0) {
+            datagramMode = true;
+        } else if (strcmp(argv[i], PORT_OPTION) == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            serverPort = atoi(argv[++i]);
+        } else {
+            printMessage(ERROR, "Utilisation : %s [%s] [%s port]\n", argv[0], DATAGRAM_OPTION, PORT_OPTION);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (datagramMode) {
+        printMessage(INFO, "Mode datagramme : les philosophes communiquent avec le serveur par UDP.\n");
+    }
+
     // Boucle pour ajouter autant de philosophes que souhaité
     while (1) {
 
@@ -273,7 +570,7 @@ int main(int argc, char *argv[]) {
             }
 
             if (isQuitCommand(command)) {
-                quit();
+                quit(philosophers, numberOfPhilosophers);
             }
 
             if (isAddCommand(command)) {
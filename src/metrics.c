@@ -0,0 +1,245 @@
+/**
+ * @file metrics.c
+ * @brief Outil de consultation du fichier circulaire des métriques du serveur.
+ *
+ * Le serveur échantillonne ses compteurs à intervalle fixe dans le fichier METRICS_FILE (voir Metrics.h). Cet
+ * outil le relit, y compris pendant que le serveur l'alimente, et restitue les échantillons au format CSV pour
+ * l'analyse de capacité (tableur, gnuplot, etc.).
+ *
+ * Utilisation (depuis le dossier src, comme le serveur) :
+ *  - `metrics info [fichier]` : affiche les dimensions du fichier et la période couverte.
+ *  - `metrics query [-f début] [-t fin] [fichier]` : affiche en CSV les échantillons de la période demandée.
+ *
+ * Les colonnes produites sont l'heure (en millisecondes depuis l'epoch et lisible), le nombre total de repas
+ * et le débit de repas par seconde (calculé entre deux échantillons consécutifs), le nombre de philosophes, le
+ * nombre de philosophes en attente, les places libres au compteur, la profondeur de la file des logs et les
+ * percentiles des attentes servies pendant l'intervalle (en microsecondes, bornes supérieures à un facteur 2 près).
+ *
+ * Les heures de début et de fin acceptent les mêmes formats que `logquery` (voir dates.h).
+ *
+ * Compilation : `gcc metrics.c -o metrics`
+ */
+
+#include "../include/utils/print_message.h"
+#include "../include/utils/dates.h"
+#include "../include/entities/Metrics.h"
+#include "../include/managers/Metrics.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * @brief Affiche l'utilisation de l'outil.
+ *
+ * @param program Nom du programme.
+ */
+void usage(const char *program) {
+    printf("Utilisation :\n");
+    printf("  %s info [fichier]\n", program);
+    printf("  %s query [-f début] [-t fin] [fichier]\n", program);
+    printf("Formats d'heure : HH:MM[:SS], AAAA-MM-JJ HH:MM[:SS], @secondes\n");
+    printf("Fichier par défaut : %s\n", METRICS_FILE);
+}
+
+/**
+ * @brief Retourne le numéro du plus ancien bloc encore présent dans le fichier.
+ *
+ * @param store Le fichier de métriques.
+ * @return uint64_t Le numéro du plus ancien bloc, 0 si le fichier est vide.
+ */
+uint64_t getOldestMetricsBlock(const MetricsStore *store) {
+    uint64_t current = __atomic_load_n(&store->header->currentBlock, __ATOMIC_ACQUIRE);
+
+    if (current == 0) {
+        return 0;
+    }
+
+    return current >= METRICS_BLOCKS ? current - METRICS_BLOCKS + 1 : 1;
+}
+
+/**
+ * @brief Formate une heure en millisecondes depuis l'epoch.
+ *
+ * @param buffer Le tampon de destination.
+ * @param size La taille du tampon.
+ * @param milliseconds L'heure à formater.
+ */
+void formatMilliseconds(char *buffer, size_t size, int64_t milliseconds) {
+    time_t seconds = (time_t) (milliseconds / 1000);
+    struct tm date;
+    localtime_r(&seconds, &date);
+
+    size_t length = strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &date);
+    snprintf(buffer + length, size - length, ".%03d", (int) (milliseconds % 1000));
+}
+
+/**
+ * @brief Commande `info` : affiche les dimensions du fichier et la période couverte.
+ *
+ * @param store Le fichier de métriques.
+ * @param path Le chemin du fichier.
+ * @return int Code de sortie.
+ */
+int infoCommand(const MetricsStore *store, const char *path) {
+    printf("Fichier : %s (%zu octets)\n", path, store->size);
+    printf("Intervalle : %u ms, %u blocs de %u échantillons (%.1f heures d'historique au plus)\n",
+        store->header->intervalMs,
+        store->header->blocks,
+        store->header->blockSamples,
+        (double) store->header->blocks * store->header->blockSamples * store->header->intervalMs / 3600000.0
+    );
+
+    uint64_t oldest = getOldestMetricsBlock(store);
+    uint64_t current = store->header->currentBlock;
+
+    if (oldest == 0) {
+        printf("Aucun échantillon.\n");
+        return EXIT_SUCCESS;
+    }
+
+    static int64_t samples[METRICS_BLOCK_SAMPLES][METRICS_COLUMNS];
+    int64_t first = -1, last = -1;
+    uint64_t numberSamples = 0;
+
+    for (uint64_t number = oldest; number <= current; number++) {
+        int count = decodeMetricsBlock(store, number, samples);
+
+        if (count == 0) {
+            continue;
+        }
+
+        if (first == -1) {
+            first = samples[0][METRICS_TIMESTAMP];
+        }
+
+        last = samples[count - 1][METRICS_TIMESTAMP];
+        numberSamples += count;
+    }
+
+    char firstTime[32], lastTime[32];
+    formatMilliseconds(firstTime, sizeof(firstTime), first);
+    formatMilliseconds(lastTime, sizeof(lastTime), last);
+    printf("Blocs %lu à %lu, %lu échantillons, du %s au %s\n", (unsigned long) oldest, (unsigned long) current, (unsigned long) numberSamples, firstTime, lastTime);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Commande `query` : affiche en CSV les échantillons compris entre deux heures.
+ *
+ * @param store Le fichier de métriques.
+ * @param from Début de la période, en nanosecondes depuis l'epoch.
+ * @param to Fin de la période, en nanosecondes depuis l'epoch.
+ * @return int Code de sortie.
+ */
+int queryCommand(const MetricsStore *store, uint64_t from, uint64_t to) {
+    static int64_t samples[METRICS_BLOCK_SAMPLES][METRICS_COLUMNS];
+    int64_t fromMs = (int64_t) (from / 1000000ULL);
+    int64_t toMs = to == UINT64_MAX ? INT64_MAX : (int64_t) (to / 1000000ULL);
+
+    int64_t previousTimestamp = -1;
+    int64_t previousMeals = 0;
+
+    printf("timestamp_ms,time,meals,meals_per_s,philosophers,waiters,admission_tokens,log_queue_depth,wait_p50_us,wait_p90_us,wait_p99_us\n");
+
+    uint64_t current = store->header->currentBlock;
+
+    for (uint64_t number = getOldestMetricsBlock(store); number && number <= current; number++) {
+        int count = decodeMetricsBlock(store, number, samples);
+
+        // Les blocs sont rangés chronologiquement : ceux qui se terminent avant le début sont ignorés d'un coup
+        if (count == 0 || samples[count - 1][METRICS_TIMESTAMP] < fromMs) {
+            continue;
+        }
+
+        for (int i = 0; i < count; i++) {
+            int64_t *sample = samples[i];
+            int64_t timestamp = sample[METRICS_TIMESTAMP];
+
+            if (timestamp > toMs) {
+                return EXIT_SUCCESS;
+            }
+
+            // Le débit n'a de sens qu'entre deux échantillons d'un même démarrage du serveur
+            char rate[32] = "";
+            if (previousTimestamp != -1 && timestamp > previousTimestamp && sample[METRICS_MEALS] >= previousMeals) {
+                snprintf(rate, sizeof(rate), "%.3f", (sample[METRICS_MEALS] - previousMeals) * 1000.0 / (timestamp - previousTimestamp));
+            }
+
+            previousTimestamp = timestamp;
+            previousMeals = sample[METRICS_MEALS];
+
+            if (timestamp < fromMs) {
+                continue;
+            }
+
+            char time[32];
+            formatMilliseconds(time, sizeof(time), timestamp);
+
+            printf(
+                "%ld,%s,%ld,%s,%ld,%ld,%ld,%ld,%ld,%ld,%ld\n",
+                (long) timestamp,
+                time,
+                (long) sample[METRICS_MEALS],
+                rate,
+                (long) sample[METRICS_PHILOSOPHERS],
+                (long) sample[METRICS_WAITERS],
+                (long) sample[METRICS_ADMISSION_TOKENS],
+                (long) sample[METRICS_LOG_QUEUE_DEPTH],
+                (long) sample[METRICS_WAIT_P50],
+                (long) sample[METRICS_WAIT_P90],
+                (long) sample[METRICS_WAIT_P99]
+            );
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Point d'entrée de l'outil.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments : la commande (`info` ou `query`) suivie de ses options et du fichier.
+ * @return int Code de sortie.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 2 || (strcmp(argv[1], "info") != 0 && strcmp(argv[1], "query") != 0)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    uint64_t from = 0;
+    uint64_t to = UINT64_MAX;
+    int i = 2;
+
+    for (; i < argc && argv[i][0] == '-'; i += 2) {
+        if (i + 1 >= argc) {
+            printMessage(ERROR, "L'option %s attend une valeur.\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        bool valid = (strcmp(argv[i], "-f") == 0 && parseQueryTime(argv[i + 1], false, &from))
+            || (strcmp(argv[i], "-t") == 0 && parseQueryTime(argv[i + 1], true, &to));
+
+        if (!valid) {
+            printMessage(ERROR, "Option ou heure invalide : %s %s\n", argv[i], argv[i + 1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const char *path = i < argc ? argv[i] : METRICS_FILE;
+    MetricsStore store;
+
+    if (!openMetricsStore(&store, path, false)) {
+        printMessage(ERROR, "%s : fichier de métriques absent ou d'un autre format.\n", path);
+        return EXIT_FAILURE;
+    }
+
+    int status = strcmp(argv[1], "info") == 0 ? infoCommand(&store, path) : queryCommand(&store, from, to);
+
+    closeMetricsStore(&store);
+    return status;
+}
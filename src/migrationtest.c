@@ -0,0 +1,145 @@
+/**
+ * @file migrationtest.c
+ * @brief Test des instantanés de la table pris pendant des échanges de places (voir Migration.h et Snapshot.h).
+ *
+ * Un échange de places copie deux philosophes l'un sur l'autre : pendant la copie, un même identifiant peut occuper
+ * deux places. Un instantané qui chevauche l'échange ne doit donc pas être marqué cohérent.
+ *
+ * Le test installe une table en mémoire privée, puis fait tourner en parallèle un thread qui échange sans arrêt des
+ * places au hasard et un thread qui prend des instantanés. Chaque instantané cohérent est décodé : chaque
+ * identifiant doit y apparaître une seule fois.
+ *
+ * Le code de sortie est 1 si un instantané cohérent contient un identifiant en double, ou si aucun instantané
+ * cohérent n'a pu être pris.
+ *
+ * Compilation : `gcc migrationtest.c -o migrationtest -lpthread -lm -lrt`
+ */
+
+#include "../include/utils/print_message.h"
+#include "../include/entities/SharedResources.h"
+#include "../include/managers/Migration.c"
+#include "../include/managers/Snapshot.c"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+/**
+ * @brief Nombre de places de la table de test.
+ */
+#define TEST_SEATS (MAX_PHILOSOPHERS < 64 ? MAX_PHILOSOPHERS : 64)
+
+/**
+ * @brief Durée du test, en millisecondes.
+ */
+#define TEST_DURATION_MS 2000
+
+static SharedResources *sharedResources;
+static volatile bool stopping = false;
+static uint64_t swaps = 0;
+
+/**
+ * @brief Installe des philosophes qui pensent sur toutes les places de la table de test.
+ */
+void seatPhilosophers() {
+    sem_init(&sharedResources->philosopherCreationProcess, 0, 1);
+
+    for (int i = 0; i < TEST_SEATS; i++) {
+        ServerPhilosopher *seat = &sharedResources->philosophers[i];
+        seat->base.id = i + 1;
+        seat->base.state = THINKING;
+        seat->leftChopstick = &sharedResources->chopsticks[i];
+        seat->rightChopstick = &sharedResources->chopsticks[(i + 1) % TEST_SEATS];
+        sharedResources->chopsticks[i].id = i + 1;
+        sharedResources->seatSlots[i] = i + 1;
+    }
+
+    sharedResources->numberPhilosophers = TEST_SEATS;
+    sharedResources->numberChopsticks = TEST_SEATS;
+    sharedResources->numberSeated = TEST_SEATS;
+}
+
+/**
+ * @brief Échange des places tirées au hasard jusqu'à la fin du test.
+ *
+ * @param arg Inutilisé.
+ * @return void* NULL.
+ */
+void *swapThread(void *arg) {
+    (void) arg;
+    unsigned int seed = 1;
+
+    while (!stopping) {
+        int firstId = 1 + rand_r(&seed) % TEST_SEATS;
+        int secondId = 1 + rand_r(&seed) % TEST_SEATS;
+
+        if (swapSeats(firstId, secondId, sharedResources)) {
+            swaps++;
+        }
+    }
+
+    return NULL;
+}
+
+int main() {
+    static const LogLevel noLogs = LOG_LEVEL_NONE;
+    sharedResources = calloc(1, sizeof(SharedResources));
+    Arena arena;
+
+    if (!sharedResources || !initArena(&arena, SCRATCH_ARENA_SIZE)) {
+        printMessage(ERROR, "Impossible d'allouer la table de test\n");
+        return 1;
+    }
+
+    setLogLevelSource(&noLogs);
+    seatPhilosophers();
+
+    pthread_t swapper;
+    pthread_create(&swapper, NULL, swapThread, NULL);
+
+    uint64_t deadline = getMonotonicTime() + (uint64_t) TEST_DURATION_MS * 1000000;
+    int ids[MAX_PHILOSOPHERS], chopstickIds[MAX_PHILOSOPHERS], timers[MAX_PHILOSOPHERS], holders[MAX_PHILOSOPHERS];
+    uint8_t states[MAX_PHILOSOPHERS];
+    uint64_t snapshots = 0, consistentSnapshots = 0, duplicates = 0;
+
+    while (getMonotonicTime() < deadline) {
+        size_t size;
+        uint8_t *snapshot = takeSnapshot(sharedResources, &arena, &size);
+
+        if (!snapshot) {
+            printMessage(ERROR, "Instantané impossible à prendre\n");
+            return 1;
+        }
+
+        SnapshotHeader *header = (SnapshotHeader *) snapshot;
+        snapshots++;
+
+        if (header->consistent && decodeSnapshot(header, snapshot + sizeof(SnapshotHeader), ids, chopstickIds, states, timers, holders)) {
+            bool seen[MAX_PHILOSOPHERS + 1] = { false };
+            consistentSnapshots++;
+
+            for (uint32_t i = 0; i < header->numberSeats; i++) {
+                if (ids[i] < 1 || ids[i] > MAX_PHILOSOPHERS || seen[ids[i]]) {
+                    duplicates++;
+                    break;
+                }
+
+                seen[ids[i]] = true;
+            }
+        }
+
+        resetArena(&arena, 0);
+    }
+
+    stopping = true;
+    pthread_join(swapper, NULL);
+
+    printf("Échanges : %lu, instantanés : %lu, cohérents : %lu, cohérents avec un doublon : %lu\n",
+           (unsigned long) swaps, (unsigned long) snapshots, (unsigned long) consistentSnapshots, (unsigned long) duplicates);
+
+    bool passed = duplicates == 0 && consistentSnapshots > 0;
+    printMessage(passed ? SUCCESS : ERROR, passed ? "Aucun instantané cohérent ne chevauche un échange\n" : "Instantané cohérent incorrect\n");
+    free(sharedResources);
+    return passed ? 0 : 1;
+}
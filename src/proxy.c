@@ -0,0 +1,731 @@
+/**
+ * @file proxy.c
+ * @brief Proxy local de dégradation réseau entre le client et le serveur.
+ *
+ * Le proxy écoute sur son propre port (TCP et UDP) et relaie chaque connexion et chaque flux de datagrammes vers le
+ * serveur, en ajoutant latence, gigue, limite de débit, désordre, pertes et coupures, réglables séparément dans
+ * chaque sens (voir Proxy.h). Il permet d'observer la latence des repas, l'équité et le comportement des délais du
+ * protocole comme si client et serveur étaient sur deux machines.
+ *
+ * Utilisation (depuis le dossier src) : `proxy [-l port] [-t port] [-s graine] [--up réglages] [--down réglages]
+ * [--both réglages]`
+ *  - `-l` : port d'écoute du proxy (par défaut PROXY_PORT).
+ *  - `-t` : port du serveur (par défaut PORT).
+ *  - `-s` : graine du tirage aléatoire, pour rejouer les mêmes dégradations (par défaut l'heure).
+ *  - `--up`, `--down`, `--both` : réglages du sens montant, descendant ou des deux, sous la forme
+ *    `latency=50,jitter=10,rate=100000,reorder=0.05,loss=0.01,reset=0.001` (clés omises : pas de dégradation).
+ *
+ * Le client se connecte alors au proxy : `client -p 9003` (ou `client --udp -p 9003`).
+ *
+ * Les compteurs de chaque sens sont affichés à l'arrêt (Ctrl+C). Une coupure d'une connexion de philosophe fait
+ * réagir le serveur comme à une vraie déconnexion.
+ *
+ * Compilation : `gcc proxy.c -o proxy`
+ */
+
+#include "../include/utils/print_message.h"
+#include "../include/utils/sockets.h"
+#include "../include/entities/Proxy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+/**
+ * @brief Connexion TCP ou flux de datagrammes relayé.
+ */
+typedef struct {
+    bool used;                      /**< Le lien est ouvert */
+    bool datagram;                  /**< Flux de datagrammes (sinon connexion TCP) */
+    uint32_t generation;            /**< Incrémenté à chaque fermeture : les blocs d'un lien fermé sont abandonnés */
+    int clientSocket;               /**< Connexion avec le client (TCP uniquement) */
+    int serverSocket;               /**< Connexion (TCP) ou socket connecté (UDP) vers le serveur */
+    struct sockaddr_in clientAddress; /**< Adresse du client (UDP uniquement) */
+    uint64_t lastDelivery[2];       /**< Heure (µs) de livraison du dernier bloc de chaque sens (TCP uniquement) */
+} Link;
+
+/**
+ * @brief Bloc en attente de livraison. Un bloc TCP vide représente la fin de la connexion.
+ */
+typedef struct {
+    uint64_t deliverAt;  /**< Heure (µs) de livraison */
+    uint64_t order;      /**< Ordre d'arrivée, départage deux blocs de même heure */
+    int link;            /**< Indice du lien */
+    uint32_t generation; /**< Génération du lien à l'arrivée */
+    ProxyDirection direction; /**< Sens */
+    size_t size;         /**< Taille des données */
+    char *data;          /**< Données */
+} Packet;
+
+/**
+ * @brief Réglages et compteurs de chaque sens.
+ */
+Impairment impairments[2];
+
+/**
+ * @brief Liens ouverts.
+ */
+Link links[PROXY_MAX_LINKS];
+
+/**
+ * @brief File des blocs en attente, tas ordonné par heure de livraison.
+ */
+Packet *pending = NULL;
+size_t numberPending = 0;
+size_t pendingCapacity = 0;
+uint64_t arrivals = 0;
+
+/**
+ * @brief État du générateur aléatoire (xorshift), initialisé par la graine.
+ */
+uint64_t randomState;
+
+/**
+ * @brief Flag d'arrêt, activé par SIGINT ou SIGTERM.
+ */
+volatile sig_atomic_t stopFlag = 0;
+
+/**
+ * @brief Handler des signaux d'arrêt.
+ *
+ * @param signum Le signal reçu.
+ */
+void stopHandler(int signum) {
+    stopFlag = 1;
+}
+
+/**
+ * @brief Retourne l'heure monotone en microsecondes.
+ *
+ * @return uint64_t L'heure.
+ */
+uint64_t nowMicroseconds() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000 + time.tv_nsec / 1000;
+}
+
+/**
+ * @brief Tire un nombre aléatoire uniforme dans [0, 1).
+ *
+ * @return double Le nombre tiré.
+ */
+double randomUnit() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 7;
+    randomState ^= randomState << 17;
+    return (randomState >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Tire un événement de probabilité donnée.
+ *
+ * @param probability La probabilité.
+ * @return bool true si l'événement a lieu.
+ */
+bool chance(double probability) {
+    return probability > 0 && randomUnit() < probability;
+}
+
+/**
+ * @brief Lit les réglages d'un sens, sous la forme `clé=valeur,clé=valeur`.
+ *
+ * @param text Les réglages.
+ * @param impairment Le sens à régler.
+ * @return bool false si une clé est inconnue ou une valeur invalide.
+ */
+bool parseImpairment(const char *text, Impairment *impairment) {
+    char copy[256];
+    snprintf(copy, sizeof(copy), "%s", text);
+
+    for (char *setting = strtok(copy, ","); setting; setting = strtok(NULL, ",")) {
+        char key[32];
+        double value;
+
+        if (sscanf(setting, "%31[^=]=%lf", key, &value) != 2 || value < 0) {
+            return false;
+        }
+
+        if (strcmp(key, "latency") == 0) {
+            impairment->latency = (int) value;
+        } else if (strcmp(key, "jitter") == 0) {
+            impairment->jitter = (int) value;
+        } else if (strcmp(key, "rate") == 0) {
+            impairment->rate = (long) value;
+        } else if (strcmp(key, "reorder") == 0 && value <= 1) {
+            impairment->reorder = value;
+        } else if (strcmp(key, "loss") == 0 && value <= 1) {
+            impairment->loss = value;
+        } else if (strcmp(key, "reset") == 0 && value <= 1) {
+            impairment->reset = value;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Écrit les réglages d'un sens sur une ligne.
+ *
+ * @param file Le fichier.
+ * @param name Le nom du sens.
+ * @param impairment Les réglages.
+ */
+void printImpairment(FILE *file, const char *name, const Impairment *impairment) {
+    fprintf(
+        file,
+        "%s latency=%d jitter=%d rate=%ld reorder=%g loss=%g reset=%g\n",
+        name,
+        impairment->latency,
+        impairment->jitter,
+        impairment->rate,
+        impairment->reorder,
+        impairment->loss,
+        impairment->reset
+    );
+}
+
+/**
+ * @brief Compare deux blocs en attente : le plus tôt livré d'abord, puis le premier arrivé.
+ */
+bool packetBefore(const Packet *a, const Packet *b) {
+    return a->deliverAt < b->deliverAt || (a->deliverAt == b->deliverAt && a->order < b->order);
+}
+
+/**
+ * @brief Ajoute un bloc à la file des blocs en attente.
+ *
+ * @param packet Le bloc.
+ */
+void pushPacket(Packet packet) {
+    if (numberPending == pendingCapacity) {
+        pendingCapacity = pendingCapacity ? pendingCapacity * 2 : 256;
+        pending = realloc(pending, pendingCapacity * sizeof(Packet));
+
+        if (!pending) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    size_t index = numberPending++;
+    pending[index] = packet;
+
+    while (index > 0 && packetBefore(&pending[index], &pending[(index - 1) / 2])) {
+        Packet parent = pending[(index - 1) / 2];
+        pending[(index - 1) / 2] = pending[index];
+        pending[index] = parent;
+        index = (index - 1) / 2;
+    }
+}
+
+/**
+ * @brief Retire le prochain bloc à livrer de la file.
+ *
+ * @return Packet Le bloc.
+ */
+Packet popPacket() {
+    Packet first = pending[0];
+    pending[0] = pending[--numberPending];
+
+    size_t index = 0;
+
+    while (1) {
+        size_t smallest = index;
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+
+        if (left < numberPending && packetBefore(&pending[left], &pending[smallest])) {
+            smallest = left;
+        }
+        if (right < numberPending && packetBefore(&pending[right], &pending[smallest])) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+
+        Packet child = pending[smallest];
+        pending[smallest] = pending[index];
+        pending[index] = child;
+        index = smallest;
+    }
+
+    return first;
+}
+
+/**
+ * @brief Ferme un lien. Ses blocs encore en attente seront abandonnés.
+ *
+ * @param index Indice du lien.
+ * @param reset Couper brutalement (RST) plutôt que fermer normalement.
+ */
+void closeLink(int index, bool reset) {
+    Link *link = &links[index];
+
+    if (reset) {
+        struct linger linger = { .l_onoff = 1, .l_linger = 0 };
+        setsockopt(link->clientSocket, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+        setsockopt(link->serverSocket, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+    }
+
+    if (!link->datagram) {
+        close(link->clientSocket);
+    }
+
+    close(link->serverSocket);
+    link->used = false;
+    link->generation += 1;
+}
+
+/**
+ * @brief Ouvre un lien et sa connexion (ou son socket connecté) vers le serveur.
+ *
+ * @param datagram Flux de datagrammes plutôt que connexion TCP.
+ * @param targetAddress L'adresse du serveur.
+ * @return int Indice du lien, -1 si tous les liens sont ouverts ou si le serveur est injoignable.
+ */
+int openLink(bool datagram, struct sockaddr_in targetAddress) {
+    for (int i = 0; i < PROXY_MAX_LINKS; i++) {
+        if (links[i].used) {
+            continue;
+        }
+
+        int serverSocket = datagram ? getDatagramSocket() : getSocket();
+
+        if (serverSocket == -1 || connect(serverSocket, (struct sockaddr *) &targetAddress, sizeof(targetAddress)) == -1) {
+            perror("connect");
+            if (serverSocket != -1) {
+                close(serverSocket);
+            }
+            return -1;
+        }
+
+        fcntl(serverSocket, F_SETFL, fcntl(serverSocket, F_GETFL) | O_NONBLOCK);
+
+        links[i].used = true;
+        links[i].datagram = datagram;
+        links[i].serverSocket = serverSocket;
+        links[i].clientSocket = -1;
+        links[i].lastDelivery[PROXY_UPSTREAM] = 0;
+        links[i].lastDelivery[PROXY_DOWNSTREAM] = 0;
+        return i;
+    }
+
+    printMessage(WARNING, "Connexion refusée : %d liens sont déjà ouverts.\n", PROXY_MAX_LINKS);
+    return -1;
+}
+
+/**
+ * @brief Applique les dégradations d'un sens à un bloc reçu, et le met en attente de livraison.
+ *
+ * @param index Indice du lien.
+ * @param direction Sens du bloc.
+ * @param data Les données (copiées), NULL pour la fin d'une connexion TCP.
+ * @param size Taille des données.
+ */
+void schedulePacket(int index, ProxyDirection direction, const char *data, size_t size) {
+    Link *link = &links[index];
+    Impairment *impairment = &impairments[direction];
+    uint64_t now = nowMicroseconds();
+
+    if (link->datagram && chance(impairment->loss)) {
+        impairment->lost += 1;
+        return;
+    }
+
+    if (!link->datagram && size > 0 && chance(impairment->reset)) {
+        impairment->resets += 1;
+        printMessage(WARNING, "Coupure de la connexion %d (%s).\n", index, direction == PROXY_UPSTREAM ? "montant" : "descendant");
+        closeLink(index, true);
+        return;
+    }
+
+    int64_t delay = (int64_t) impairment->latency * 1000;
+
+    if (impairment->jitter > 0) {
+        delay += (int64_t) ((randomUnit() * 2 - 1) * impairment->jitter * 1000);
+    }
+
+    if (link->datagram && chance(impairment->reorder)) {
+        impairment->reordered += 1;
+        delay += PROXY_REORDER_DELAY * 1000;
+    }
+
+    uint64_t deliverAt = now + (delay > 0 ? delay : 0);
+
+    // Le lien limité en débit transmet les blocs les uns après les autres
+    if (impairment->rate > 0 && size > 0) {
+        uint64_t start = impairment->linkFreeAt > now ? impairment->linkFreeAt : now;
+        impairment->linkFreeAt = start + (uint64_t) size * 1000000 / impairment->rate;
+        deliverAt += impairment->linkFreeAt - now;
+    }
+
+    // Un flux TCP reste ordonné : un bloc n'est jamais livré avant le précédent
+    if (!link->datagram) {
+        if (deliverAt < link->lastDelivery[direction]) {
+            deliverAt = link->lastDelivery[direction];
+        }
+        link->lastDelivery[direction] = deliverAt;
+    }
+
+    Packet packet = {
+        .deliverAt = deliverAt,
+        .order = arrivals++,
+        .link = index,
+        .generation = link->generation,
+        .direction = direction,
+        .size = size,
+        .data = NULL
+    };
+
+    if (size > 0) {
+        packet.data = malloc(size);
+
+        if (!packet.data) {
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+
+        memcpy(packet.data, data, size);
+    }
+
+    pushPacket(packet);
+}
+
+/**
+ * @brief Livre un bloc arrivé à échéance.
+ *
+ * @param packet Le bloc.
+ * @param datagramSocket Le socket UDP d'écoute du proxy, qui répond aux clients en mode datagramme.
+ */
+void deliverPacket(Packet packet, int datagramSocket) {
+    Link *link = &links[packet.link];
+
+    if (!link->used || link->generation != packet.generation) {
+        free(packet.data);
+        return;
+    }
+
+    Impairment *impairment = &impairments[packet.direction];
+    impairment->forwarded += 1;
+    impairment->bytes += packet.size;
+
+    if (link->datagram) {
+        if (packet.direction == PROXY_UPSTREAM) {
+            send(link->serverSocket, packet.data, packet.size, MSG_DONTWAIT);
+        } else {
+            sendto(datagramSocket, packet.data, packet.size, MSG_DONTWAIT, (struct sockaddr *) &link->clientAddress, sizeof(link->clientAddress));
+        }
+        free(packet.data);
+        return;
+    }
+
+    // Fin de connexion d'un côté, livrée après ses dernières données : la connexion est fermée des deux côtés
+    if (packet.size == 0) {
+        closeLink(packet.link, false);
+        return;
+    }
+
+    int destination = packet.direction == PROXY_UPSTREAM ? link->serverSocket : link->clientSocket;
+    size_t written = 0;
+
+    while (written < packet.size) {
+        struct pollfd event = { .fd = destination, .events = POLLOUT };
+        ssize_t bytesSent = send(destination, packet.data + written, packet.size - written, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+        if (bytesSent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            poll(&event, 1, 100);
+            continue;
+        }
+
+        if (bytesSent == -1) {
+            closeLink(packet.link, false);
+            break;
+        }
+
+        written += bytesSent;
+    }
+
+    free(packet.data);
+}
+
+/**
+ * @brief Accepte les connexions TCP en attente et ouvre leur connexion vers le serveur.
+ *
+ * @param listenSocket Le socket d'écoute TCP.
+ * @param targetAddress L'adresse du serveur.
+ */
+void acceptLinks(int listenSocket, struct sockaddr_in targetAddress) {
+    int clientSocket;
+
+    while ((clientSocket = accept(listenSocket, NULL, NULL)) != -1) {
+        int index = openLink(false, targetAddress);
+
+        if (index == -1) {
+            close(clientSocket);
+            continue;
+        }
+
+        fcntl(clientSocket, F_SETFL, fcntl(clientSocket, F_GETFL) | O_NONBLOCK);
+        links[index].clientSocket = clientSocket;
+    }
+}
+
+/**
+ * @brief Lit les datagrammes des clients et les met en attente vers le serveur, un flux par adresse de client.
+ *
+ * @param datagramSocket Le socket UDP d'écoute.
+ * @param targetAddress L'adresse du serveur.
+ */
+void receiveClientDatagrams(int datagramSocket, struct sockaddr_in targetAddress) {
+    char data[PROXY_CHUNK_SIZE];
+    struct sockaddr_in address;
+    socklen_t addressLength = sizeof(address);
+    ssize_t size;
+
+    while ((size = recvfrom(datagramSocket, data, sizeof(data), MSG_DONTWAIT, (struct sockaddr *) &address, &addressLength)) >= 0) {
+        int index = -1;
+
+        for (int i = 0; i < PROXY_MAX_LINKS && index == -1; i++) {
+            if (links[i].used && links[i].datagram && links[i].clientAddress.sin_port == address.sin_port && links[i].clientAddress.sin_addr.s_addr == address.sin_addr.s_addr) {
+                index = i;
+            }
+        }
+
+        if (index == -1 && (index = openLink(true, targetAddress)) != -1) {
+            links[index].clientAddress = address;
+        }
+
+        if (index != -1) {
+            schedulePacket(index, PROXY_UPSTREAM, data, size);
+        }
+
+        addressLength = sizeof(address);
+    }
+}
+
+/**
+ * @brief Lit ce qu'un lien a reçu d'un côté et le met en attente vers l'autre.
+ *
+ * @param index Indice du lien.
+ * @param direction Sens : PROXY_UPSTREAM si le client a envoyé, PROXY_DOWNSTREAM si c'est le serveur.
+ */
+void readLink(int index, ProxyDirection direction) {
+    Link *link = &links[index];
+    int source = direction == PROXY_UPSTREAM ? link->clientSocket : link->serverSocket;
+    char data[PROXY_CHUNK_SIZE];
+    ssize_t size;
+
+    while (link->used && (size = recv(source, data, sizeof(data), MSG_DONTWAIT)) != 0) {
+
+        if (size == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || (link->datagram && errno == ECONNREFUSED)) {
+                return;
+            }
+            break;
+        }
+
+        schedulePacket(index, direction, data, size);
+    }
+
+    // Fin de connexion (ou erreur) : elle suit les dernières données, avec leur retard
+    if (link->used && !link->datagram) {
+        schedulePacket(index, direction, NULL, 0);
+        shutdown(source, SHUT_RD);
+    }
+}
+
+/**
+ * @brief Ouvre les sockets d'écoute TCP et UDP du proxy.
+ *
+ * @param port Le port d'écoute.
+ * @param listenSocket Reçoit le socket TCP.
+ * @param datagramSocket Reçoit le socket UDP.
+ * @return bool false en cas d'erreur.
+ */
+bool openListenSockets(int port, int *listenSocket, int *datagramSocket) {
+    struct sockaddr_in address = getSocketAddress();
+    address.sin_port = htons(port);
+    int reuse = 1;
+
+    *listenSocket = getSocket();
+    *datagramSocket = getDatagramSocket();
+
+    if (*listenSocket == -1 || *datagramSocket == -1) {
+        return false;
+    }
+
+    setsockopt(*listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if (bind(*listenSocket, (struct sockaddr *) &address, sizeof(address)) == -1
+        || listen(*listenSocket, 64) == -1
+        || bind(*datagramSocket, (struct sockaddr *) &address, sizeof(address)) == -1) {
+        return false;
+    }
+
+    fcntl(*listenSocket, F_SETFL, fcntl(*listenSocket, F_GETFL) | O_NONBLOCK);
+    fcntl(*datagramSocket, F_SETFL, fcntl(*datagramSocket, F_GETFL) | O_NONBLOCK);
+
+    return true;
+}
+
+/**
+ * @brief Point d'entrée de l'outil.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments : ports, graine et réglages de chaque sens.
+ * @return int Code de sortie.
+ */
+int main(int argc, char *argv[]) {
+    int listenPort = PROXY_PORT;
+    int targetPort = PORT;
+    uint64_t seed = (uint64_t) time(NULL);
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        bool valid = hasValue;
+
+        if (strcmp(argv[i], "-l") == 0 && hasValue) {
+            listenPort = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && hasValue) {
+            targetPort = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && hasValue) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--up") == 0 && hasValue) {
+            valid = parseImpairment(argv[++i], &impairments[PROXY_UPSTREAM]);
+        } else if (strcmp(argv[i], "--down") == 0 && hasValue) {
+            valid = parseImpairment(argv[++i], &impairments[PROXY_DOWNSTREAM]);
+        } else if (strcmp(argv[i], "--both") == 0 && hasValue) {
+            valid = parseImpairment(argv[i + 1], &impairments[PROXY_UPSTREAM]) && parseImpairment(argv[i + 1], &impairments[PROXY_DOWNSTREAM]);
+            i++;
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printf("Utilisation : %s [-l port] [-t port] [-s graine] [--up réglages] [--down réglages] [--both réglages]\n", argv[0]);
+            printf("Réglages : latency=<ms>,jitter=<ms>,rate=<octets/s>,reorder=<p>,loss=<p>,reset=<p>\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Le générateur xorshift ne doit pas partir de 0
+    randomState = seed * 2654435761u + 1;
+
+    int listenSocket, datagramSocket;
+
+    if (!openListenSockets(listenPort, &listenSocket, &datagramSocket)) {
+        printMessage(ERROR, "Le proxy n'a pas pu écouter sur le port %d.\n", listenPort);
+        perror("bind");
+        return EXIT_FAILURE;
+    }
+
+    struct sockaddr_in targetAddress = getSocketAddress();
+    targetAddress.sin_port = htons(targetPort);
+
+    struct sigaction stopAction = { .sa_handler = stopHandler };
+    sigemptyset(&stopAction.sa_mask);
+    sigaction(SIGINT, &stopAction, NULL);
+    sigaction(SIGTERM, &stopAction, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    FILE *settings = fopen(PROXY_SETTINGS_PATH, "w");
+
+    if (settings) {
+        printImpairment(settings, "up", &impairments[PROXY_UPSTREAM]);
+        printImpairment(settings, "down", &impairments[PROXY_DOWNSTREAM]);
+        fprintf(settings, "seed=%llu\n", (unsigned long long) seed);
+        fclose(settings);
+    }
+
+    printMessage(SUCCESS, "Proxy en écoute sur le port %d (TCP et UDP), vers le port %d du serveur. Graine : %llu\n", listenPort, targetPort, (unsigned long long) seed);
+    printImpairment(stdout, "up", &impairments[PROXY_UPSTREAM]);
+    printImpairment(stdout, "down", &impairments[PROXY_DOWNSTREAM]);
+    fflush(stdout);
+
+    struct pollfd events[2 + 2 * PROXY_MAX_LINKS];
+    int owners[2 + 2 * PROXY_MAX_LINKS];
+
+    while (!stopFlag) {
+        int numberEvents = 2;
+        events[0] = (struct pollfd) { .fd = listenSocket, .events = POLLIN };
+        events[1] = (struct pollfd) { .fd = datagramSocket, .events = POLLIN };
+
+        // Un côté déjà fermé (fin en attente de livraison) n'est plus surveillé : son descripteur reste lisible
+        for (int i = 0; i < PROXY_MAX_LINKS; i++) {
+            if (!links[i].used) {
+                continue;
+            }
+
+            owners[numberEvents] = i;
+            events[numberEvents++] = (struct pollfd) { .fd = links[i].serverSocket, .events = POLLIN };
+
+            if (!links[i].datagram) {
+                owners[numberEvents] = -1 - i;
+                events[numberEvents++] = (struct pollfd) { .fd = links[i].clientSocket, .events = POLLIN };
+            }
+        }
+
+        int timeout = -1;
+
+        if (numberPending > 0) {
+            uint64_t now = nowMicroseconds();
+            timeout = pending[0].deliverAt <= now ? 0 : (int) ((pending[0].deliverAt - now + 999) / 1000);
+        }
+
+        if (poll(events, numberEvents, timeout) == -1 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+
+        if (events[0].revents) {
+            acceptLinks(listenSocket, targetAddress);
+        }
+
+        if (events[1].revents) {
+            receiveClientDatagrams(datagramSocket, targetAddress);
+        }
+
+        for (int i = 2; i < numberEvents; i++) {
+            if (events[i].revents) {
+                readLink(owners[i] >= 0 ? owners[i] : -1 - owners[i], owners[i] >= 0 ? PROXY_DOWNSTREAM : PROXY_UPSTREAM);
+            }
+        }
+
+        uint64_t now = nowMicroseconds();
+
+        while (numberPending > 0 && pending[0].deliverAt <= now) {
+            deliverPacket(popPacket(), datagramSocket);
+        }
+    }
+
+    unlink(PROXY_SETTINGS_PATH);
+
+    printf("\n");
+    for (int direction = PROXY_UPSTREAM; direction <= PROXY_DOWNSTREAM; direction++) {
+        Impairment *impairment = &impairments[direction];
+        printMessage(
+            INFO,
+            "%s : %llu blocs (%llu octets) relayés, %llu désordonnés, %llu perdus, %llu coupures\n",
+            direction == PROXY_UPSTREAM ? "Montant" : "Descendant",
+            (unsigned long long) impairment->forwarded,
+            (unsigned long long) impairment->bytes,
+            (unsigned long long) impairment->reordered,
+            (unsigned long long) impairment->lost,
+            (unsigned long long) impairment->resets
+        );
+    }
+
+    return EXIT_SUCCESS;
+}
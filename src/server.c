@@ -10,59 +10,111 @@
  *  - Une file de messages IPC pour la gestion asynchrone des logs (logs globaux du serveur et logs spécifiques aux clients).
  *
  * Les fonctionnalités principales de ce fichier comprennent :
- *  - L'initialisation des gestionnaires de signaux via initEndSignals() et le handler programEndHandler(), afin de
- *    détecter les demandes d'arrêt (SIGINT) ou les erreurs critiques (SIGSEGV) et d'activer un flag de shutdown global.
+ *  - L'initialisation de la réception des signaux via initEndSignals() : les demandes d'arrêt (SIGINT, SIGTERM) et
+ *    les fins de processus de service (SIGCHLD) sont lues par un descripteur signalfd dans la boucle d'événements,
+ *    les erreurs critiques (SIGSEGV) activent un flag de shutdown global via le handler programEndHandler().
  *
  *  - La gestion des logs via deux threads dédiés :
  *      - serverStateLogsThread() : Lit les logs de type SERVER_LOG_TYPE depuis la file de messages et les écrit
  *        dans un fichier de log d'état du serveur, permettant de suivre l'activité globale.
  *      - clientInfoLogsThread() : Pour chaque client (processus fils), lit les logs spécifiques à ce client (identifiés
  *        par le PID) depuis la file de messages et les écrit dans un fichier dédié.
+ *    Chaque fichier de log est accompagné d'un index (LogIndex.c) interrogeable avec l'outil `logquery`.
+ *
+ *  - L'échantillonnage des métriques via metricsSamplerThread(), qui relève à intervalle fixe les compteurs de la
+ *    mémoire partagée dans un fichier circulaire de taille fixe (Metrics.c), interrogeable avec l'outil `metrics`.
+ *
+ *  - Le registre des repas via ledgerWriterThread(), qui consigne durablement chaque repas accordé et terminé, par
+ *    validations groupées (Ledger.c), vérifiable avec l'outil `ledger`.
+ *
+ *  - Le profileur par échantillonnage (Profiler.c), démarré dans chaque processus et activé à chaud par la commande
+ *    de contrôle `profile` : ses profils au format replié alimentent directement les outils de flame graphs.
+ *
+ *  - Les compteurs matériels (PerfCounters.c), activés à chaud par la commande de contrôle `perf`, qui mesurent
+ *    cycles, instructions, défauts de cache et changements de contexte de chaque étape d'un repas accordé, et les
+ *    spans des requêtes (RequestSpan.c), qui horodatent ces étapes et gardent les repas les plus lents en exemples.
+ *
+ *  - Le cœur de la table via tableCoreThread(), épinglé sur un processeur, qui applique seul les événements publiés
+ *    par les processus de service sous la politique `sequenced` (TableCore.c), suivi par tableConsumerThread() :
+ *    logs, registre des repas et réponses.
+ *
+ *  - Le compactage des places via compactionThread(), qui range les places encore occupées au début de la table dans
+ *    les moments calmes (Compaction.c), puis déplace un philosophe d'un voisinage trop chargé (Migration.c). Il
+ *    ré-ancre aussi périodiquement l'étalonnage de l'horloge à haute résolution (Clock.c).
  *
  *  - Le traitement des requêtes clients :
  *      - manageCreateRequest() : Gère les requêtes de création de philosophes (REQUEST_CREATE) en créant un nouveau
  *        philosophe côté serveur et en renvoyant une réponse (RESPONSE_CREATE) au client.
  *      - manageUpdateRequest() : Gère les requêtes de mise à jour de l'état d'un philosophe (REQUEST_UPDATE) et envoie
  *        une réponse (RESPONSE_UPDATE) correspondante.
+ *      - manageWatchRequest() : Abonne la connexion aux changements d'état de la table (REQUEST_WATCH, Watch.c).
+ *      - manageSnapshotRequest() : Renvoie un instantané compact de toute la table (REQUEST_SNAPSHOT, Snapshot.c).
  *
  *  - La gestion d'un processus client via clientProcess(), qui :
  *      - Initialise le générateur de nombres aléatoires.
- *      - Attend et traite les requêtes envoyées par le client sur son socket de service.
- *      - Réagit aux différentes demandes (création ou mise à jour) et communique les réponses appropriées.
+ *      - Lit les requêtes envoyées par le client sur son socket de service par blocs, et les traite en lot.
+ *      - Réagit aux différentes demandes (création ou mise à jour) et envoie les réponses du lot en un seul writev().
  *
  *  - La boucle principale du serveur dans main(), qui effectue les opérations suivantes :
  *      - Vérifie la compatibilité avec le nombre maximal de fichiers ouverts (FOPEN_MAX) et avertit si nécessaire.
  *      - Crée et attache un segment de mémoire partagée pour héberger les ressources partagées (philosophes, baguettes,
- *        logs, etc.).
+ *        logs, statistiques, etc.). Sa clé nommée permet à l'outil `dashboard` de l'observer en lecture seule. Les
+ *        places ne sont initialisées qu'à l'arrivée des philosophes, sauf si le serveur est lancé avec
+ *        PREALLOCATE_ARGUMENT (`./server --preallocate`) : elles le sont alors toutes au démarrage, en parallèle.
  *      - Initialise et configure le socket serveur (création, binding, écoute).
  *      - Crée la file de messages pour la gestion des logs.
  *      - Configure le ServerContext pour centraliser la gestion des ressources (sockets, mémoire partagée, logs).
- *      - Lance un thread pour le log global du serveur.
- *      - Entre dans une boucle d'acceptation des connexions clients, et pour chaque connexion :
+ *      - Lance un thread pour le log global du serveur, un thread d'échantillonnage des métriques et le thread
+ *        d'écriture du registre des repas.
+ *      - Ouvre le socket Unix de contrôle (Control.c), sur lequel l'outil `control` envoie des commandes d'exploitation.
+ *      - Entre dans une boucle d'événements (poll()) qui traite les signaux, les commandes de contrôle et les
+ *        connexions clients. Pour chaque connexion client (acceptClient()) :
  *          - Accepte la connexion sur le socket de service.
  *          - Crée un processus fils via fork() pour gérer le client avec clientProcess().
  *          - Dans le processus parent, ouvre un thread de logs dédié pour le nouveau client et met à jour le contexte serveur.
+ *      - Lance le service datagramme (startDatagramService(), DatagramService.c), un processus qui sert depuis un seul
+ *        socket UDP tous les philosophes en mode datagramme.
+ *      - Sur demande du socket de contrôle, remplace son binaire à chaud (upgradeServer(), Upgrade.c) ; lancé avec
+ *        UPGRADE_ARGUMENT, le nouveau binaire reprend la table au lieu d'en créer une (resumeTable()).
  *      - Sur détection d'une demande d'arrêt (shutdownFlag), procède à un nettoyage global des ressources via cleanup()
  *        avant de terminer.
  *
  * Les modules utilisés dans ce fichier proviennent de divers fichiers d'en-tête et d'implémentation, notamment :
  *  - Utilitaires : sockets.h, print_message.h, random.h, files.h.
- *  - Gestion des ressources partagées et des logs : Logs.c, SharedResources.c, ServerPhilosopher.c, Request.c,
- *    Response.c, ServerContext.c.
+ *  - Gestion des ressources partagées et des logs : Logs.c, LogIndex.c, SharedResources.c, ServerPhilosopher.c, Request.c,
+ *    Response.c, ServerContext.c, Metrics.c, Control.c, Upgrade.c, Watch.c, Snapshot.c,
+ *    ServiceConnection.c, DatagramService.c, Ledger.c, Clock.c, Profiler.c, PerfCounters.c,
+ *    RequestSpan.c, TableEvents.c, TableCore.c.
  *
  * @note Ce fichier constitue le cœur du serveur, orchestrant la communication entre les clients et la gestion centralisée
  *       des ressources partagées, tout en assurant une synchronisation fine.
  */
 
+#define _GNU_SOURCE
+
 #include "../include/utils/sockets.h"
 #include "../include/utils/print_message.h"
 #include "../include/utils/random.h"
 #include "../include/managers/Logs.c"
+#include "../include/managers/LogIndex.c"
 #include "../include/managers/SharedResources.c"
 #include "../include/managers/ServerPhilosopher.c"
 #include "../include/managers/Request.c"
 #include "../include/managers/Response.c"
 #include "../include/managers/ServerContext.c"
+#include "../include/managers/Metrics.c"
+#include "../include/managers/Control.c"
+#include "../include/managers/Upgrade.c"
+#include "../include/managers/Watch.c"
+#include "../include/managers/Snapshot.c"
+#include "../include/managers/ServiceConnection.c"
+#include "../include/managers/DatagramService.c"
+#include "../include/managers/Compaction.c"
+#include "../include/managers/Migration.c"
+#include "../include/managers/Profiler.c"
+#include "../include/managers/PerfCounters.c"
+#include "../include/managers/RequestSpan.c"
+#include "../include/managers/TableCore.c"
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/shm.h>
@@ -73,6 +125,12 @@
 #include <string.h>
 #include <semaphore.h>
 #include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 /**
  * @brief Flag global indiquant la demande d'arrêt du serveur.
@@ -87,7 +145,7 @@ volatile sig_atomic_t shutdownFlag = 0;
 /**
  * @brief Handler de signal pour terminer le programme.
  *
- * Cette fonction est appelée lorsqu'un signal d'arrêt (SIGINT, SIGSEGV) est reçu.
+ * Cette fonction est appelée lorsqu'une erreur critique (SIGSEGV) est reçue.
  * Elle met à jour le flag global shutdownFlag pour indiquer qu'un arrêt est demandé.
  *
  * @param signum Numéro du signal reçu.
@@ -97,29 +155,87 @@ void programEndHandler(int signum) {
 }
 
 /**
- * @brief Initialise les handlers pour les signaux SIGINT et SIGSEGV.
+ * @brief Initialise la réception des signaux du processus principal.
+ *
+ * SIGINT, SIGTERM et SIGCHLD sont bloqués puis reçus par un descripteur signalfd, surveillé par la boucle
+ * d'événements au même titre que les sockets : aucun handler ne vient interrompre un appel système, et les
+ * processus de service terminés peuvent être attendus hors de tout contexte de signal. Le masque étant hérité,
+ * cette fonction doit être appelée avant la création des threads.
  *
- * Configure le handler programEndHandler pour SIGINT et SIGSEGV. En cas d'échec de l'installation
- * du handler, un message d'erreur est affiché et le programme se termine.
+ * SIGSEGV garde un handler classique (programEndHandler). En cas d'échec, un message d'erreur est affiché et le
+ * programme se termine.
+ *
+ * @param previousMask Reçoit le masque initial, à restaurer dans les processus de service.
+ * @return int Le descripteur signalfd (non bloquant).
  */
-void initEndSignals() {
+int initEndSignals(sigset_t *previousMask) {
 
     struct sigaction sigalAction;
     sigalAction.sa_handler = programEndHandler;
     sigemptyset(&sigalAction.sa_mask);
     sigalAction.sa_flags = 0;
 
-    if (sigaction(SIGINT, &sigalAction, NULL) == -1) {
-        printMessage(ERROR, "Erreur lors de l'installation du handler pour le signal SIGINT.\n");
-        exit(EXIT_FAILURE);
-    }
-
     // A été nécéssaire pendant le dev, car les segmentation faults qui apparaissaient laissaient des ressources ouvertes
     if (sigaction(SIGSEGV, &sigalAction, NULL) == -1) {
         printMessage(ERROR, "Erreur lors de l'installation du handler pour le signal SIGSEGV.\n");
         exit(EXIT_FAILURE);
     }
 
+    sigset_t eventSignals;
+    sigemptyset(&eventSignals);
+    sigaddset(&eventSignals, SIGINT);
+    sigaddset(&eventSignals, SIGTERM);
+    sigaddset(&eventSignals, SIGCHLD);
+
+    if (pthread_sigmask(SIG_BLOCK, &eventSignals, previousMask) != 0) {
+        printMessage(ERROR, "Erreur lors du blocage des signaux SIGINT, SIGTERM et SIGCHLD.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Après une mise à jour à chaud, le masque hérité bloque déjà ces signaux : ils ne doivent pas l'être chez les fils
+    sigdelset(previousMask, SIGINT);
+    sigdelset(previousMask, SIGTERM);
+    sigdelset(previousMask, SIGCHLD);
+
+    int signalFd = signalfd(-1, &eventSignals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    if (signalFd == -1) {
+        printMessage(ERROR, "Erreur lors de la création du descripteur des signaux.\n");
+        perror("signalfd");
+        exit(EXIT_FAILURE);
+    }
+
+    return signalFd;
+}
+
+/**
+ * @brief Écrit un message de log reçu dans son fichier, précédé de son heure d'émission, et l'ajoute à l'index.
+ *
+ * L'heure monotone du message n'est convertie en heure murale qu'ici. Un message sans heure (envoyé par le binaire
+ * précédent pendant une mise à jour à chaud) reçoit l'heure de son écriture.
+ *
+ * @param logFile Le fichier de log.
+ * @param indexWriter L'écrivain de l'index du fichier.
+ * @param log Le message reçu.
+ * @param receivedLogSize La taille du message reçu.
+ */
+void writeLogMessage(FILE *logFile, LogIndexWriter *indexWriter, const Log *log, ssize_t receivedLogSize) {
+    uint64_t timestamp = receivedLogSize >= (ssize_t) LOG_MESSAGE_SIZE ? log->timestamp : getMonotonicTime();
+    uint64_t realtime = getRealtimeFromTimestamp(timestamp);
+    char line[LOG_TIMESTAMP_LENGTH + LOG_BUFFER_SIZE];
+
+    int length = formatTimestamp(realtime, line, sizeof(line));
+    length += snprintf(line + length, sizeof(line) - length, " %.*s", LOG_BUFFER_SIZE, log->text);
+
+    if (length >= (int) sizeof(line)) {
+        length = sizeof(line) - 1;
+    }
+
+    long offset = ftell(logFile);
+    fwrite(line, 1, length, logFile);
+    // On inscrit immédiatement le contenu dans le fichier, sinon il reste dans un buffer et tail ne peut pas voir le contenu
+    fflush(logFile);
+    appendLogIndexEntry(indexWriter, offset, line, length, realtime);
 }
 
 /**
@@ -133,35 +249,51 @@ void initEndSignals() {
  */
 void *serverStateLogsThread(void *arg) {
     int *logsQueueId = (int *) arg;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    registerProfilerThread();
 
-    Log *log = malloc(sizeof(Log));
+    LogThreadInfo *session = slabAlloc(getSessionPool());
     char *serveStateLogsFilePath = getServerStateFilePath();
-    FILE *logFile = fopen(serveStateLogsFilePath, "a");
-    free(serveStateLogsFilePath);
+    FILE *logFile = session && serveStateLogsFilePath ? fopen(serveStateLogsFilePath, "a") : NULL;
 
     if (!logFile) {
-        free(log);
-        fclose(logFile);
+        releaseFilePath(serveStateLogsFilePath);
+        slabFree(getSessionPool(), session);
         exit(EXIT_FAILURE);
     }
 
+    Log *log = &session->log;
+
+    // Index des messages, alimenté à chaque écriture pour permettre les recherches par philosophe et par date
+    fseek(logFile, 0, SEEK_END);
+    LogIndexWriter indexWriter;
+    openLogIndexWriter(&indexWriter, serveStateLogsFilePath, ftell(logFile), false);
+    releaseFilePath(serveStateLogsFilePath);
+
     while (!shutdownFlag) {
+        // Le thread ne peut être annulé (mise à jour à chaud) que pendant l'attente : un message reçu est toujours écrit
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
         // Pas besoin de gérer l'erreur, si ça ne passe pas on passe de nouveau en attente
-        ssize_t receivedLogSize = msgrcv(*logsQueueId, log, LOG_BUFFER_SIZE, SERVER_LOG_TYPE, 0);
+        ssize_t receivedLogSize = msgrcv(*logsQueueId, log, LOG_MESSAGE_SIZE, SERVER_LOG_TYPE, 0);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
 
         if (receivedLogSize == -1) {
             continue;
         }
 
+        // Message vide : le processus de service est terminé et tous ses messages ont été écrits
+        if (receivedLogSize == 0) {
+            break;
+        }
+
         if (receivedLogSize > 0) {
-            fprintf(logFile, "%s", log->text);
-            // On inscrit immédiatement le contenu dans le fichier, sinon il reste dans un buffer et tail ne peut pas voir le contenu
-            fflush(logFile);
+            writeLogMessage(logFile, &indexWriter, log, receivedLogSize);
         }
     }
 
+    closeLogIndexWriter(&indexWriter);
     fclose(logFile);
-    free(log);
+    slabFree(getSessionPool(), session);
     return NULL;
 }
 
@@ -172,330 +304,1428 @@ void *serverStateLogsThread(void *arg) {
  * depuis la file de messages IPC et les écrit dans un fichier de log dédié. La boucle s'exécute
  * tant que shutdownFlag n'est pas activé.
  *
- * @param arg Pointeur vers une structure LogThreadInfo contenant l'identifiant de la file de messages et le PID du client.
+ * @param arg Pointeur vers une structure LogThreadInfo contenant l'identifiant de la file de messages et le PID du client,
+ *            prise dans la réserve des sessions et rendue par le thread.
  * @return void* Retourne toujours NULL.
  */
 void *clientInfoLogsThread(void *arg) {
 
     LogThreadInfo *logThreadInfo = (LogThreadInfo *) arg;
-    Log *log = malloc(sizeof(Log));
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    registerProfilerThread();
+    Log *log = &logThreadInfo->log;
 
     char *filePath = getClientInfoFilepath(logThreadInfo->childProcessId);
-    FILE *logFile = fopen(filePath, "a");
-    free(filePath);
+    FILE *logFile = filePath ? fopen(filePath, "a") : NULL;
 
     if (!logFile) {
-        free(log);
+        releaseFilePath(filePath);
+        slabFree(getSessionPool(), logThreadInfo);
         raise(SIGINT);
+        return NULL;
     }
 
+    // Les messages d'un client ne rappellent pas tous le philosophe concerné, l'index retient le dernier rencontré
+    fseek(logFile, 0, SEEK_END);
+    LogIndexWriter indexWriter;
+    openLogIndexWriter(&indexWriter, filePath, ftell(logFile), true);
+    releaseFilePath(filePath);
+
     while (!shutdownFlag) {
+        // Le thread ne peut être annulé (mise à jour à chaud) que pendant l'attente : un message reçu est toujours écrit
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
         // Pas besoin de gérer l'erreur, si ça ne passe pas on passe de nouveau en attente
-        ssize_t receivedLogSize = msgrcv(logThreadInfo->logsQueueId, log, LOG_BUFFER_SIZE, (long) logThreadInfo->childProcessId, 0);
+        ssize_t receivedLogSize = msgrcv(logThreadInfo->logsQueueId, log, LOG_MESSAGE_SIZE, (long) logThreadInfo->childProcessId, 0);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
 
         if (receivedLogSize == -1) {
             continue;
         }
 
+        // Message vide : le processus de service est terminé et tous ses messages ont été écrits
+        if (receivedLogSize == 0) {
+            break;
+        }
+
         if (receivedLogSize > 0) {
-            fprintf(logFile, "%s", log->text);
-            // On inscrit immédiatement le contenu dans le fichier, sinon il reste dans un buffer et tail ne peut pas voir le contenu
-            fflush(logFile);
+            writeLogMessage(logFile, &indexWriter, log, receivedLogSize);
         }
     }
 
+    closeLogIndexWriter(&indexWriter);
     fclose(logFile);
-    free(log);
+    slabFree(getSessionPool(), logThreadInfo);
     return NULL;
 }
 
 /**
- * @brief Gère une requête de création de philosophe.
+ * @brief Relève un échantillon des compteurs du serveur.
  *
- * Lorsqu'une requête de création (REQUEST_CREATE) est reçue, cette fonction crée un nouveau philosophe côté serveur
- * en appelant createPhilosopher(), prépare une réponse (RESPONSE_CREATE) avec les informations du philosophe, et
- * envoie cette réponse au client via le socket de service. En cas d'erreur lors de l'envoi, le serveur déclenche
- * un arrêt contrôlé.
+ * Les percentiles d'attente sont calculés sur les seuls repas accordés depuis l'échantillon précédent, par
+ * différence avec la copie de l'histogramme conservée par l'appelant.
  *
- * @param request Requête de création reçue du client.
- * @param serviceSocket Socket de service associé à la connexion client.
  * @param sharedResources Pointeur vers les ressources partagées.
+ * @param previousWaits Histogramme des attentes lors de l'échantillon précédent, mis à jour par la fonction.
+ * @param values Valeurs de l'échantillon, une par colonne de MetricsColumn.
  */
-void manageCreateRequest(Request request, int serviceSocket, SharedResources *sharedResources) {
-    ServerPhilosopher created = createPhilosopher(sharedResources);
-                
-    // Renvoi du philosophe au client
-    Response response = createResponse(created.base);
-    ssize_t bytesSent = trySocketWrite(serviceSocket, &response, sizeof(response));
-
-    if (bytesSent == -1) {
-        logClientInfo(sharedResources->logsQueueId, "Erreur lors d'une tentative d'envoi d'une réponse de création.\n");
-    } else if(bytesSent == 0) {
-        logClientInfo(sharedResources->logsQueueId, "Le client a coupé la connexion.\n");
+void collectMetricsSample(SharedResources *sharedResources, Histogram *previousWaits, int64_t values[METRICS_COLUMNS]) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    int numberPhilosophers = sharedResources->numberPhilosophers;
+    int waiters = 0;
+    for (int i = 0; i < numberPhilosophers; i++) {
+        if (sharedResources->philosophers[i].hungrySince) {
+            waiters += 1;
+        }
     }
 
-    if (bytesSent == -1 || bytesSent == 0) {
-        // En coupant le parent, on lance le mécanisme de cleanup centralisé.
-        kill(getppid(), SIGINT);
-        exit(EXIT_FAILURE);
-    }
+    int allowedEating = 0;
+    sem_getvalue(&sharedResources->maxAllowedEating, &allowedEating);
 
-    logClientInfo(sharedResources->logsQueueId, "Philosophe connecté et ajouté à la table !\n");
+    struct msqid_ds queueStatus;
+    int64_t queueDepth = msgctl(sharedResources->logsQueueId, IPC_STAT, &queueStatus) == -1 ? -1 : (int64_t) queueStatus.msg_qnum;
+
+    Histogram waits = sharedResources->statistics.waitHistogram;
+    Histogram intervalWaits;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        intervalWaits.buckets[i] = waits.buckets[i] - previousWaits->buckets[i];
+    }
+    *previousWaits = waits;
+
+    values[METRICS_TIMESTAMP] = (int64_t) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+    values[METRICS_MEALS] = (int64_t) sharedResources->statistics.meals;
+    values[METRICS_PHILOSOPHERS] = sharedResources->numberSeated;
+    values[METRICS_WAITERS] = waiters;
+    values[METRICS_ADMISSION_TOKENS] = allowedEating;
+    values[METRICS_LOG_QUEUE_DEPTH] = queueDepth;
+    values[METRICS_WAIT_P50] = (int64_t) getHistogramPercentile(&intervalWaits, 50);
+    values[METRICS_WAIT_P90] = (int64_t) getHistogramPercentile(&intervalWaits, 90);
+    values[METRICS_WAIT_P99] = (int64_t) getHistogramPercentile(&intervalWaits, 99);
 }
 
 /**
- * @brief Gère une requête de mise à jour de l'état d'un philosophe.
+ * @brief Thread d'échantillonnage des métriques du serveur.
  *
- * Cette fonction traite une requête de mise à jour (REQUEST_UPDATE) en appelant updatePhilosopher() pour
- * mettre à jour l'état du philosophe côté serveur. Si la mise à jour aboutit, une réponse (RESPONSE_UPDATE)
- * est envoyée au client. En cas d'échec d'envoi, le serveur déclenche un arrêt contrôlé.
+ * Toutes les METRICS_INTERVAL_MS millisecondes, le thread relève les compteurs de la mémoire partagée et les
+ * ajoute au fichier circulaire METRICS_FILE (voir Metrics.h), consultable avec l'outil `metrics`. Les réveils sont
+ * calés sur une échéance absolue pour que l'intervalle ne dérive pas. La boucle s'exécute tant que shutdownFlag
+ * n'est pas activé.
  *
- * @param request Requête de mise à jour reçue du client.
- * @param serviceSocket Socket de service associé à la connexion client.
- * @param sharedResources Pointeur vers les ressources partagées.
+ * @param arg Pointeur vers les ressources partagées.
+ * @return void* Retourne toujours NULL.
  */
-void manageUpdateRequest(Request request, int serviceSocket, SharedResources *sharedResources) {
+void *metricsSamplerThread(void *arg) {
+    SharedResources *sharedResources = (SharedResources *) arg;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    registerProfilerThread();
+    MetricsStore store;
+
+    if (!openMetricsStore(&store, METRICS_FILE, true)) {
+        printMessage(WARNING, "Le fichier des métriques %s n'a pas pu être ouvert, les métriques ne seront pas enregistrées.\n", METRICS_FILE);
+        return NULL;
+    }
 
-    ServerPhilosopher *serverPhilosopher = updatePhilosopher(request.philosopher, sharedResources);
+    Histogram previousWaits = sharedResources->statistics.waitHistogram;
+    int64_t values[METRICS_COLUMNS];
 
-    if (serverPhilosopher == NULL) {
-        return;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    while (!shutdownFlag) {
+        collectMetricsSample(sharedResources, &previousWaits, values);
+        appendMetricsSample(&store, values);
+
+        deadline.tv_nsec += (METRICS_INTERVAL_MS % 1000) * 1000000L;
+        deadline.tv_sec += METRICS_INTERVAL_MS / 1000 + deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+
+        // Interrompu par un signal, on reprend l'attente jusqu'à l'échéance sauf si l'arrêt est demandé
+        // Le thread ne peut être annulé (mise à jour à chaud) que pendant l'attente, jamais au milieu d'un échantillon
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR && !shutdownFlag);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
     }
 
-    Response response = updateResponse(serverPhilosopher->base);  
-    ssize_t bytesSent = trySocketWrite(serviceSocket, &response, sizeof(response));
+    closeMetricsStore(&store);
+    return NULL;
+}
+
+/**
+ * @brief État du thread d'écriture du registre des repas.
+ */
+LedgerWriter ledgerWriter;
+
+/**
+ * @brief Thread d'écriture du registre des repas.
+ *
+ * Toutes les `commitIntervalMs` millisecondes (réglable à chaud), le thread écrit d'un seul write() les événements
+ * déposés dans l'anneau du registre depuis son passage précédent, puis les valide par fdatasync() (voir Ledger.h).
+ * À l'arrêt, une dernière validation consigne les événements restants.
+ *
+ * @param arg Pointeur vers l'anneau du registre.
+ * @return void* Retourne toujours NULL.
+ */
+void *ledgerWriterThread(void *arg) {
+    Ledger *ledger = (Ledger *) arg;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    registerProfilerThread();
 
-    if (bytesSent == -1) {
-        logClientInfo(sharedResources->logsQueueId, "Erreur lors d'une tentative d'envoi d'une réponse pour autoriser le philosophe a manger.\n");
-    } else if(bytesSent == 0) {
-        logClientInfo(sharedResources->logsQueueId, "Le client a coupé la connexion.\n");
+    while (!shutdownFlag) {
+        uint32_t intervalMs = __atomic_load_n(&ledger->commitIntervalMs, __ATOMIC_RELAXED);
+        struct timespec interval = { .tv_sec = intervalMs / 1000, .tv_nsec = (intervalMs % 1000) * 1000000L };
+
+        // Le thread ne peut être annulé (mise à jour à chaud) que pendant l'attente, jamais au milieu d'une validation
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+        nanosleep(&interval, NULL);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+        if (commitLedger(ledger, &ledgerWriter) == -1) {
+            printMessage(WARNING, "Erreur d'écriture du registre des repas %s, les repas ne sont plus consignés.\n", LEDGER_FILE);
+            disableLedger(ledger);
+            break;
+        }
     }
 
-    if (bytesSent == -1 || bytesSent == 0) {
-        // En coupant le parent, on lance le mécanisme de cleanup centralisé.
-        kill(getppid(), SIGINT);
-        exit(EXIT_FAILURE);
+    if (__atomic_load_n(&ledger->enabled, __ATOMIC_ACQUIRE)) {
+        commitLedger(ledger, &ledgerWriter);
     }
+
+    close(ledgerWriter.fd);
+    return NULL;
 }
 
 /**
- * @brief Processus client dédié.
+ * @brief Ouvre le registre des repas et lance son thread d'écriture.
  *
- * Cette fonction est exécutée par le processus fils créé pour chaque client. Elle initialise le générateur
- * de nombres aléatoires, puis entre dans une boucle pour lire et traiter les requêtes envoyées par le client
- * via son socket de service. Selon le type de requête (création ou mise à jour), elle appelle la fonction
- * appropriée pour traiter la demande. En cas d'erreur ou de déconnexion du client, le processus termine
- * en déclenchant un arrêt contrôlé.
+ * L'anneau d'une nouvelle table est initialisé à la suite des séquences déjà dans le fichier, avant l'arrivée du
+ * premier client ; celui d'une table reprise par une mise à jour à chaud est gardé tel quel.
  *
- * @param serviceSocket Socket de service associé à la connexion client.
- * @param sharedResources Pointeur vers les ressources partagées.
+ * @param serverContext Pointeur vers le contexte du serveur.
  */
-void clientProcess(int serviceSocket, SharedResources *sharedResources) {
+void startLedger(ServerContext *serverContext) {
+    Ledger *ledger = &serverContext->sharedResources->ledger;
+    uint64_t nextSequence;
 
-    initRandom();
-    logClientInfo(sharedResources->logsQueueId, "Processus serveur ouvert pour le client !\n");
+    if (!openLedgerWriter(&ledgerWriter, LEDGER_FILE, &nextSequence)) {
+        printMessage(WARNING, "Le registre des repas %s n'a pas pu être ouvert, les repas ne seront pas consignés.\n", LEDGER_FILE);
+        disableLedger(ledger);
+        return;
+    }
 
-    while (1) {
+    bool newTable = ledger->commitIntervalMs == 0;
 
-        Request request;
+    if (newTable) {
+        initLedger(ledger, nextSequence);
+    }
 
-        // En cas d'erreur de récéption, étant déjà connecté, on peut tenter plusieurs essais avant d'abandonner
-        ssize_t bytesReceived = trySocketRead(serviceSocket, &request, sizeof(request));
+    __atomic_store_n(&ledger->enabled, true, __ATOMIC_RELEASE);
 
-        if (bytesReceived == -1) {
-            logClientInfo(sharedResources->logsQueueId, "Erreur à la lecture du socket\n");
-                
-        } else if(bytesReceived == 0) {
-            logClientInfo(sharedResources->logsQueueId, "Le client a coupé la connexion.\n");
-        }
+    if (newTable) {
+        appendLedgerRecord(ledger, LEDGER_OPEN, 0, 0, 0);
+    }
 
-        if (bytesReceived == -1 || bytesReceived == 0) {
-            // En coupant le parent, on lance le mécanisme de cleanup centralisé.
-            kill(getppid(), SIGINT);
-            exit(EXIT_FAILURE);
-        }
+    if (pthread_create(&serverContext->ledgerThread, NULL, ledgerWriterThread, ledger) != 0) {
+        printMessage(ERROR, "Erreur lors de la création du thread du registre des repas.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Thread de compactage des places de la table et de migration des philosophes.
+ *
+ * Toutes les COMPACTION_INTERVAL_MS millisecondes, le thread tente un passage de compactage (voir Compaction.h),
+ * qui n'a lieu que si des places ont été quittées et que la table est calme, puis évalue la charge des voisinages
+ * pour une éventuelle migration (voir Migration.h). Toutes les CLOCK_RECALIBRATION_INTERVAL_MS, il ré-ancre
+ * l'étalonnage de l'horloge (voir Clock.h). La boucle s'exécute tant que shutdownFlag n'est pas activé.
+ *
+ * @param arg Pointeur vers les ressources partagées.
+ * @return void* Retourne toujours NULL.
+ */
+void *compactionThread(void *arg) {
+    SharedResources *sharedResources = (SharedResources *) arg;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    registerProfilerThread();
 
-        switch (request.type) {
+    struct timespec interval = {
+        .tv_sec = COMPACTION_INTERVAL_MS / 1000,
+        .tv_nsec = (COMPACTION_INTERVAL_MS % 1000) * 1000000L
+    };
+    uint64_t lastCalibration = getMonotonicTime();
 
-            case REQUEST_CREATE: {
-                manageCreateRequest(request, serviceSocket, sharedResources);
-                break;
+    while (!shutdownFlag) {
+        // Annulable (mise à jour à chaud) pendant l'attente seulement, jamais au milieu d'un passage
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+        nanosleep(&interval, NULL);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+        if (!shutdownFlag) {
+            compactTable(sharedResources);
+            rebalanceTable(sharedResources);
+
+            if (getMonotonicTime() - lastCalibration >= (uint64_t) CLOCK_RECALIBRATION_INTERVAL_MS * 1000000) {
+                recalibrateClock(&sharedResources->clock);
+                lastCalibration = getMonotonicTime();
             }
-
-            case REQUEST_UPDATE:
-                manageUpdateRequest(request, serviceSocket, sharedResources);
-                break;
         }
     }
+
+    return NULL;
 }
 
 /**
- * @brief Fonction principale du serveur.
- *
- * La fonction main :
- * - initialise les signaux de fin, 
- * - crée la mémoire partagée,
- * - configure le socket serveur 
- * - configure la file de messages pour les logs
- * - centralise les ressources dans un ServerContext 
- * - lance ensuite un thread pour la gestion globale des logs du serveur
- * - entre dans une boucle d'acceptation des connexions clients.
- * 
- * Pour chaque connexion acceptée : 
- * - un processus fils est créé pour traiter les requêtes du client (via clientProcess()),
- * - le processus parent crée un thread dédié pour gérer les logs spécifiques au client. 
- * 
- * En cas d'arrêt (shutdownFlag activé),
- * le serveur procède au nettoyage global des ressources avant de terminer.
+ * @brief Épingle le thread courant sur le dernier processeur qui lui est permis, loin du processeur 0 qui reçoit
+ * souvent les interruptions.
  *
- * @param argc Nombre d'arguments en ligne de commande.
- * @param argv Tableau des arguments en ligne de commande.
- * @return int Code de sortie (0 en cas de succès).
+ * @return int Le processeur, -1 si l'épinglage a échoué.
  */
-int main(int argc, char *argv[]) {
+int pinTableCoreThread() {
+    cpu_set_t allowed;
 
-    initEndSignals();
-
-    if (MAX_PHILOSOPHERS > FOPEN_MAX) {
-        printMessage(
-            WARNING,
-            "Un fichier de log par client (thread) sera ouvert par la processus principal, le programme permet d'en créer %d max, et votre système permet l'ouverture de %d max. \n",
-            MAX_PHILOSOPHERS,
-            FOPEN_MAX
-        );
+    if (pthread_getaffinity_np(pthread_self(), sizeof(allowed), &allowed) != 0) {
+        return -1;
     }
-    
-    // Initialisation de la mémoire partagée
-    int sharedResourcesMemoryId = shmget(IPC_PRIVATE, sizeof(SharedResources) * MAX_PHILOSOPHERS, IPC_CREAT | 0600); // 0600 car uniquement ce processus et ses fils peuvent lire et écrire dans le segment
 
-    if (sharedResourcesMemoryId == -1) {
-        printMessage(ERROR, "Erreur lors de la création de la mémoire partagé.\n");
-        perror("shmget");
-        exit(EXIT_FAILURE);
+    for (int cpu = CPU_SETSIZE - 1; cpu >= 0; cpu--) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            cpu_set_t selected;
+            CPU_ZERO(&selected);
+            CPU_SET(cpu, &selected);
+            return pthread_setaffinity_np(pthread_self(), sizeof(selected), &selected) == 0 ? cpu : -1;
+        }
     }
 
-    // Attachement de la mémoire partagée
-    SharedResources *sharedResources = attachSharedResources(sharedResourcesMemoryId); 
-    
-    int serverSocket = getSocket();
-    struct sockaddr_in socketAddress = getSocketAddress();
+    return -1;
+}
 
-    if (bind(serverSocket, (struct sockaddr *) &socketAddress, sizeof(socketAddress)) == -1) {
-        printMessage(ERROR, "L'adresse n'a pas pu être associée au socket.\n");
-        perror("bind");
-        exit(EXIT_FAILURE);
-    }
+/**
+ * @brief Attend, annulable, qu'un compteur de l'anneau du cœur change, au plus TABLE_CORE_WAIT_MS millisecondes.
+ *
+ * Les threads du cœur ne peuvent être annulés (mise à jour à chaud) que pendant cette attente, jamais au milieu d'un
+ * lot : la file des affamés et les séquences restent cohérentes pour le binaire suivant.
+ *
+ * @param address Le compteur.
+ * @param value Sa valeur lue avant l'attente.
+ */
+void waitTableCore(uint32_t *address, uint32_t value) {
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+    pthread_testcancel();
+    ledgerFutexWait(address, value, TABLE_CORE_WAIT_MS);
+    pthread_testcancel();
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+}
 
-    printMessage(SUCCESS, "Socket initialisé avec succès !\n\n");
+/**
+ * @brief Thread du cœur de la table.
+ *
+ * Épinglé sur un processeur, le thread applique par lot les événements publiés dans l'anneau (voir TableCore.h),
+ * puis attend les suivants. La boucle s'exécute tant que shutdownFlag n'est pas activé.
+ *
+ * @param arg Pointeur vers les ressources partagées.
+ * @return void* Retourne toujours NULL.
+ */
+void *tableCoreThread(void *arg) {
+    SharedResources *sharedResources = (SharedResources *) arg;
+    TableCore *core = &sharedResources->tableCore;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    registerProfilerThread();
 
-    if (listen(serverSocket, 3) == -1) {
-        printMessage(ERROR, "Le serveur a échoué à se mettre en écoute.\n");
-        perror("bind");
-        exit(EXIT_FAILURE);
+    __atomic_store_n(&core->cpu, pinTableCoreThread(), __ATOMIC_RELAXED);
+
+    while (!shutdownFlag) {
+        uint32_t published = __atomic_load_n(&core->publishedFutex, __ATOMIC_ACQUIRE);
+
+        if (applyTableEvents(sharedResources) == 0) {
+            waitTableCore(&core->publishedFutex, published);
+        }
     }
 
-    // Création de la file de message pour accueillir les logs
-    sharedResources->logsQueueId = initLogsQueue();
+    return NULL;
+}
 
-    // Mise en contexte de toutes les ressources pour centraliser la gestion de la mémoire en cas de panne
-    ServerContext serverContext = initServerContext();
-    serverContext.serverSocket = serverSocket;
-    serverContext.sharedResourcesMemoryId = sharedResourcesMemoryId;
-    serverContext.sharedResources = sharedResources;
+/**
+ * @brief Thread d'un consommateur de l'anneau du cœur de la table : logs, registre des repas ou réponses.
+ *
+ * @param arg Pointeur vers le TableConsumerThread du consommateur.
+ * @return void* Retourne toujours NULL.
+ */
+void *tableConsumerThread(void *arg) {
+    TableConsumerThread *consumerThread = (TableConsumerThread *) arg;
+    SharedResources *sharedResources = consumerThread->sharedResources;
+    TableCore *core = &sharedResources->tableCore;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    registerProfilerThread();
 
-    // Ouverture d'un thread pour accueillir les log globaux
-    pthread_t serverStateThread;
+    // Les réponses suivent le registre, les autres consommateurs suivent le cœur
+    uint32_t *futex = consumerThread->consumer == TABLE_CONSUMER_RESPONSES ? &core->consumedFutex : &core->appliedFutex;
 
-    if (pthread_create(&serverStateThread, NULL, serverStateLogsThread, &sharedResources->logsQueueId) == -1) {
-        printMessage(ERROR, "Erreur lors de la création du thread de logs principal.\n");
-        perror("pthread_create");
-        exit(EXIT_FAILURE);
+    while (!shutdownFlag) {
+        uint32_t value = __atomic_load_n(futex, __ATOMIC_ACQUIRE);
+
+        if (consumeTableEvents(consumerThread->consumer, sharedResources) == 0) {
+            waitTableCore(futex, value);
+        }
     }
 
-    char *serverStateLogsFilePath = getServerStateFilePath();
-    printMessage(SUCCESS, "Le thread des logs du serveur a bien été ouvert, visionner les logs via la commande suivante dans un autre terminal: \n");
-    printf("tail -f \"%s\"\n\n", serverStateLogsFilePath);
-    free(serverStateLogsFilePath);
+    return NULL;
+}
 
-    logServerState(sharedResources->logsQueueId, "Adresse mémoire partagée : %p\n", sharedResources);
-    logServerState(sharedResources->logsQueueId, "Adresse baguettes : %p\n", sharedResources->chopsticks);
+/**
+ * @brief Lance le thread du cœur de la table et ceux de ses consommateurs.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ */
+void startTableCore(ServerContext *serverContext) {
+    SharedResources *sharedResources = serverContext->sharedResources;
 
-    // Gestion de la prise des connexions dans un thread pour que les processus
-    while (!shutdownFlag) {
-        int serviceSocket;
-        struct sockaddr clientAddress;
-        socklen_t clientAddressLength = sizeof(clientAddress);
+    if (pthread_create(&serverContext->tableCoreThread, NULL, tableCoreThread, sharedResources) != 0) {
+        printMessage(ERROR, "Erreur lors de la création du thread du cœur de la table.\n");
+        exit(EXIT_FAILURE);
+    }
 
-        printMessage(INFO, "En écoute sur le socket de service...\n");
+    for (int consumer = 0; consumer < TABLE_CONSUMERS; consumer++) {
+        TableConsumerThread *consumerThread = &serverContext->tableConsumers[consumer];
+        consumerThread->consumer = (TableConsumer) consumer;
+        consumerThread->sharedResources = sharedResources;
 
-        // Ici on peut tenter d'accepter d'autres demandes de connexions, pas besoin de tout fermer
-        if ((serviceSocket = accept(serverSocket, &clientAddress, &clientAddressLength)) == -1) {
-            printMessage(ERROR, "Le serveur a abdonné une connexion.\n");
-            perror("accept");
-            close(serviceSocket);
-            continue;
+        if (pthread_create(&consumerThread->thread, NULL, tableConsumerThread, consumerThread) != 0) {
+            printMessage(ERROR, "Erreur lors de la création d'un thread consommateur du cœur de la table.\n");
+            exit(EXIT_FAILURE);
         }
+    }
+}
 
-        printMessage(SUCCESS, "Connexion de client reçue et acceptée ! \n\n");
+/**
+ * @brief Termine le processus de service après un échec d'envoi.
+ *
+ * Si la connexion a un philosophe, l'échec déclenche un arrêt contrôlé du serveur ; sinon seul le processus de
+ * service se termine.
+ *
+ * @param seatId L'identifiant du philosophe de la connexion, 0 s'il n'y en a pas.
+ */
+void quitAfterSendError(int seatId) {
+    if (seatId) {
+        // En coupant le parent, on lance le mécanisme de cleanup centralisé.
+        kill(getppid(), SIGINT);
+        exit(EXIT_FAILURE);
+    }
 
-        int childProcessId;
+    exit(EXIT_SUCCESS);
+}
 
-        if ((childProcessId = fork()) == -1) {
-            printMessage(ERROR, "Le serveur n'a pas pu créer le processus fils pour le client.\n");
-            perror("fork");
-            close(serviceSocket);
-            continue;
-        }
+/**
+ * @brief Envoie les réponses en attente d'une connexion, et termine le processus de service si l'envoi échoue.
+ *
+ * @param connection La connexion.
+ * @param seatId L'identifiant du philosophe de la connexion, 0 s'il n'y en a pas.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ */
+void flushResponsesOrQuit(ServiceConnection *connection, int seatId, SharedResources *sharedResources) {
+    if (connection->outputLength == 0 || flushResponses(connection, NULL, 0)) {
+        return;
+    }
 
-        if (childProcessId == 0) {
-            clientProcess(serviceSocket, sharedResources);
-            // Le processus fils ne doit pas process la boucle du père
-            exit(EXIT_SUCCESS);
+    logClientInfo(sharedResources->logsQueueId, "Erreur lors de l'envoi des réponses, le client a coupé la connexion.\n");
+    quitAfterSendError(seatId);
+}
 
-        } else {
-            
-            char *logFilePath = getClientInfoFilepath(childProcessId);
-            FILE *logFile = fopen(logFilePath, "w");
-
-            // Ouverture d'un thread pour accueillir les logs du nouveau processus fils et de son fichier de logs
-            // S'il échoue, on ferme la connexion, on termine le processus fils et on annule
-
-            pthread_t clientLogsThread;
-            LogThreadInfo *logThreadInfo = malloc(sizeof(LogThreadInfo));
-            if (logThreadInfo == NULL) {
-                perror("malloc");
-                free(logFilePath);
-                fclose(logFile);
-                exit(EXIT_FAILURE);
-            }
+/**
+ * @brief Gère une requête de création de philosophe.
+ *
+ * Lorsqu'une requête de création (REQUEST_CREATE) est reçue, cette fonction crée un nouveau philosophe côté serveur
+ * en appelant createPhilosopher() et prépare une réponse (RESPONSE_CREATE) avec les informations du philosophe,
+ * envoyée au client à la fin du lot de requêtes en cours.
+ *
+ * Si la table est pleine, une réponse RESPONSE_REFUSED est envoyée et le processus de service se termine sans
+ * arrêter le serveur.
+ *
+ * @param request Requête de création reçue du client.
+ * @param connection Connexion client.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @return int L'identifiant du philosophe créé.
+ */
+int manageCreateRequest(const Request *request, ServiceConnection *connection, SharedResources *sharedResources) {
+    ServerPhilosopher created = createPhilosopher(sharedResources);
 
-            logThreadInfo->logsQueueId = sharedResources->logsQueueId;
-            logThreadInfo->childProcessId = childProcessId;
-            
-            if (pthread_create(&clientLogsThread, NULL, clientInfoLogsThread, logThreadInfo) == -1) {
-                printMessage(ERROR, "Erreur lors de la création du thread de logs.\n");
-                perror("pthread_create");
-                close(serviceSocket);
-                free(logFilePath);
-                fclose(logFile);
-                break;
-            }
+    if (created.base.id == 0) {
+        queueResponse(connection, refusedResponse());
+        flushResponses(connection, NULL, 0);
+        logClientInfo(sharedResources->logsQueueId, "Table pleine, création du philosophe refusée.\n");
+        close(connection->socket);
+        exit(EXIT_SUCCESS);
+    }
 
-            printMessage(SUCCESS, "Le thread de log a bien été ouvert, visionner les logs via la commande suivante dans un autre terminal: \n");
-            printf("tail -f \"%s\"\n\n", logFilePath);
-            
-            free(logFilePath);
-            fclose(logFile);
+    // Renvoi du philosophe au client
+    queueResponse(connection, createResponse(created.base));
 
-            serverContext.serviceSockets[serverContext.numberServiceSockets] = serviceSocket;
-            serverContext.clientsProcessIds[serverContext.numberClients] = childProcessId;
-            serverContext.numberServiceSockets += 1;
-            serverContext.numberClients += 1;
-            
-        }
+    logClientInfo(sharedResources->logsQueueId, "Philosophe connecté et ajouté à la table !\n");
+    return created.base.id;
+}
 
+/**
+ * @brief Gère une requête de mise à jour de l'état d'un philosophe.
+ *
+ * Cette fonction traite une requête de mise à jour (REQUEST_UPDATE) en appelant updatePhilosopher() pour
+ * mettre à jour l'état du philosophe côté serveur. Si la mise à jour aboutit, une réponse (RESPONSE_UPDATE)
+ * est préparée, et envoyée au client à la fin du lot de requêtes en cours.
+ *
+ * @param request Requête de mise à jour reçue du client.
+ * @param connection Connexion client.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ */
+void manageUpdateRequest(const Request *request, ServiceConnection *connection, SharedResources *sharedResources) {
+
+    Philosopher updated;
+
+    if (!updatePhilosopher(request->philosopher, sharedResources, &updated)) {
+        return;
+    }
+
+    queueResponse(connection, updateResponse(updated));
+}
+
+/**
+ * @brief Gère une requête d'instantané de la table.
+ *
+ * La réponse RESPONSE_SNAPSHOT et l'instantané (voir Snapshot.h) rejoignent les réponses du lot en cours, et sont
+ * envoyés avec elles. L'instantané est codé dans l'arène de travail du processus, puis rendu dès qu'il est copié
+ * dans le tampon de sortie (ou envoyé) : plusieurs instantanés d'un même lot ne l'épuisent pas. Si l'arène ne peut
+ * pas le contenir, la requête reçoit une réponse RESPONSE_REFUSED. La connexion reste ouverte : un client peut
+ * demander un instantané entre deux requêtes de son philosophe.
+ *
+ * @param connection Connexion client.
+ * @param seatId L'identifiant du philosophe de la connexion, 0 s'il n'y en a pas.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ */
+void manageSnapshotRequest(ServiceConnection *connection, int seatId, SharedResources *sharedResources) {
+    Arena *scratch = getScratchArena();
+    size_t mark = scratch ? scratch->used : 0;
+    size_t snapshotSize;
+    uint8_t *snapshot = takeSnapshot(sharedResources, scratch, &snapshotSize);
+    bool queued;
+
+    if (snapshot) {
+        queued = queueResponse(connection, snapshotResponse()) && queueOutput(connection, snapshot, snapshotSize);
+        resetArena(scratch, mark);
+    } else {
+        logClientInfo(sharedResources->logsQueueId, "Instantané refusé : l'arène de travail ne peut pas le contenir.\n");
+        queued = queueResponse(connection, refusedResponse());
+    }
+
+    if (!queued) {
+        logClientInfo(sharedResources->logsQueueId, "Erreur lors de l'envoi d'un instantané.\n");
+        quitAfterSendError(seatId);
+    }
+}
+
+/**
+ * @brief Gère une requête d'abonnement aux changements d'état de la table.
+ *
+ * Une connexion qui a déjà un philosophe ne peut pas devenir un abonné : les lots se mêleraient à ses réponses.
+ * Sinon, le processus de service ne sert plus que l'abonné (voir Watch.c) et se termine avec sa connexion, sans
+ * arrêter le serveur.
+ *
+ * @param request La requête reçue.
+ * @param connection Connexion client.
+ * @param seatId L'identifiant du philosophe de la connexion, 0 s'il n'y en a pas.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ */
+void manageWatchRequest(const Request *request, ServiceConnection *connection, int seatId, SharedResources *sharedResources) {
+    if (seatId || !isValidSubscription(request->watch, sharedResources)) {
+        queueResponse(connection, refusedResponse());
+        logClientInfo(sharedResources->logsQueueId, "Abonnement refusé.\n");
+
+        if (seatId) {
+            return;
+        }
+
+        flushResponses(connection, NULL, 0);
+        close(connection->socket);
+        exit(EXIT_SUCCESS);
+    }
+
+    if (!queueResponse(connection, watchResponse()) || !flushResponses(connection, NULL, 0)) {
+        logClientInfo(sharedResources->logsQueueId, "L'abonné a coupé la connexion.\n");
+        exit(EXIT_SUCCESS);
+    }
+
+    char message[LOG_BUFFER_SIZE];
+    snprintf(message, sizeof(message), "Abonnement accepté (étendue %d, place %d, %d lots/s max).\n", request->watch.scope, request->watch.seat, request->watch.maxRate);
+    logClientInfo(sharedResources->logsQueueId, message);
+    watchTable(connection->socket, request->watch, sharedResources);
+
+    close(connection->socket);
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Processus client dédié.
+ *
+ * Cette fonction est exécutée par le processus fils créé pour chaque client. Elle initialise le générateur
+ * de nombres aléatoires, puis entre dans une boucle qui lit le socket de service par blocs (ServiceConnection.c) et
+ * traite en lot toutes les requêtes complètes reçues. Selon le type de requête, elle appelle la fonction
+ * appropriée pour traiter la demande ; les réponses du lot sont envoyées ensemble à sa fin. En cas d'erreur ou de
+ * déconnexion du client, le processus termine en déclenchant un arrêt contrôlé.
+ *
+ * Une demande de repas peut bloquer longtemps : les réponses déjà prêtes sont envoyées avant de la traiter. Quand
+ * les compteurs matériels sont activés, ses étapes sont mesurées de la réception du bloc à l'envoi des réponses du
+ * lot (voir PerfCounters.h). Chaque requête porte aussi un span, qui horodate ses étapes de la lecture de son bloc à
+ * l'écriture de sa réponse (voir RequestSpan.h).
+ *
+ * Après chaque requête, si le philosophe a été évincé depuis le socket de contrôle, il quitte la table et la
+ * connexion est fermée ; le processus se termine alors sans arrêter le serveur. Il en va de même à la première
+ * requête invalide : les requêtes sont lues sur place dans le tampon de la connexion et validées par decodeRequest().
+ *
+ * @param serviceSocket Socket de service associé à la connexion client.
+ * @param sharedResources Pointeur vers les ressources partagées.
+ */
+void clientProcess(int serviceSocket, SharedResources *sharedResources) {
+
+    initRandom();
+    logClientInfo(sharedResources->logsQueueId, "Processus serveur ouvert pour le client !\n");
+
+    // Le compactage peut déplacer la place du philosophe : seul son identifiant est gardé
+    int seatId = 0;
+    ServiceConnection connection;
+    initServiceConnection(&connection, serviceSocket);
+    Arena *scratch = getScratchArena();
+
+    while (1) {
+
+        ssize_t bytesReceived = fillConnectionInput(&connection);
+
+        if (bytesReceived == -1) {
+            logClientInfo(sharedResources->logsQueueId, "Erreur à la lecture du socket\n");
+                
+        } else if(bytesReceived == 0) {
+            logClientInfo(sharedResources->logsQueueId, "Le client a coupé la connexion.\n");
+        }
+
+        // Une connexion sans philosophe (instantané seul) peut se fermer sans arrêter le serveur
+        if ((bytesReceived == -1 || bytesReceived == 0) && !seatId) {
+            exit(EXIT_SUCCESS);
+        }
+
+        if (bytesReceived == -1 || bytesReceived == 0) {
+            // En coupant le parent, on lance le mécanisme de cleanup centralisé.
+            kill(getppid(), SIGINT);
+            exit(EXIT_FAILURE);
+        }
+
+        const Request *request;
+        int decoded;
+        uint64_t readComplete = getMonotonicTime();
+
+        beginPerfSpan();
+        beginRequestSpan(readComplete);
+
+        while ((decoded = nextRequest(&connection, &request)) == 1) {
+
+            markRequestSpan(SPAN_DECODED);
+
+            if (request->type == REQUEST_UPDATE && request->philosopher.state == HUNGRY) {
+                markPerfStage(PERF_STAGE_DECODE);
+                flushResponsesOrQuit(&connection, seatId, sharedResources);
+                markPerfStage(PERF_STAGE_SEND);
+            }
+
+            switch (request->type) {
+
+                case REQUEST_CREATE: {
+                    seatId = manageCreateRequest(request, &connection, sharedResources);
+                    break;
+                }
+
+                case REQUEST_UPDATE:
+                    manageUpdateRequest(request, &connection, sharedResources);
+                    break;
+
+                case REQUEST_WATCH:
+                    manageWatchRequest(request, &connection, seatId, sharedResources);
+                    break;
+
+                case REQUEST_SNAPSHOT:
+                    manageSnapshotRequest(&connection, seatId, sharedResources);
+                    break;
+            }
+
+            ServerPhilosopher seat;
+
+            if (seatId && copyPhilosopher(seatId, sharedResources, &seat) && seat.evicted) {
+                flushResponses(&connection, NULL, 0);
+                leaveTable(seatId, sharedResources);
+                logClientInfo(sharedResources->logsQueueId, "Philosophe évincé de la table, fermeture de la connexion.\n");
+                close(serviceSocket);
+                exit(EXIT_SUCCESS);
+            }
+
+            // La requête suivante du lot est mesurée depuis ici, sauf si un repas accordé attend sa réponse
+            beginPerfSpan();
+            beginRequestSpan(readComplete);
+        }
+
+        // Requête invalide (type inconnu, contenu incohérent) : la suite du flux n'est plus fiable
+        if (decoded == -1) {
+            flushResponses(&connection, NULL, 0);
+
+            if (seatId) {
+                leaveTable(seatId, sharedResources);
+            }
+
+            logClientInfo(sharedResources->logsQueueId, "Requête invalide reçue, fermeture de la connexion.\n");
+            close(serviceSocket);
+            exit(EXIT_SUCCESS);
+        }
+
+        flushResponsesOrQuit(&connection, seatId, sharedResources);
+        endPerfSpan();
+        endRequestSpan(seatId);
+
+        // Les réponses du lot sont envoyées : les tampons de travail du lot (instantanés) sont rendus d'un coup
+        if (scratch) {
+            resetArena(scratch, 0);
+        }
+    }
+}
+
+/**
+ * @brief Traite les signaux reçus par le descripteur signalfd.
+ *
+ * SIGINT et SIGTERM demandent l'arrêt du serveur. SIGCHLD signale la fin d'un ou plusieurs processus de service
+ * (philosophe évincé ou création refusée) : ils sont attendus sans bloquer et retirés du contexte serveur.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ */
+void handleSignals(ServerContext *serverContext) {
+    struct signalfd_siginfo signalInfo;
+
+    while (read(serverContext->signalFd, &signalInfo, sizeof(signalInfo)) == sizeof(signalInfo)) {
+
+        if (signalInfo.ssi_signo == SIGINT || signalInfo.ssi_signo == SIGTERM) {
+            shutdownFlag = 1;
+            continue;
+        }
+
+        // Plusieurs fins de processus peuvent être regroupées en un seul signal
+        pid_t childProcessId;
+        while ((childProcessId = waitpid(-1, NULL, WNOHANG)) > 0) {
+            if (removeClient(serverContext, childProcessId)) {
+                printMessage(INFO, "Le processus de service %d s'est terminé.\n", childProcessId);
+            }
+
+            if (childProcessId == serverContext->datagramProcessId) {
+                printMessage(WARNING, "Le service datagramme s'est arrêté, le mode datagramme n'est plus disponible.\n");
+                serverContext->datagramProcessId = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Accepte les connexions de contrôle en attente.
+ *
+ * Le socket de contrôle est non bloquant : la fonction s'arrête dès qu'il n'y a plus de connexion à accepter,
+ * ou que CONTROL_MAX_CONNECTIONS connexions sont en cours de lecture.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ */
+void acceptControlConnections(ServerContext *serverContext) {
+    while (serverContext->numberControlConnections < CONTROL_MAX_CONNECTIONS) {
+        int controlConnection = accept4(serverContext->controlSocket, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (controlConnection == -1) {
+            return;
+        }
+
+        ControlConnection *connection = &serverContext->controlConnections[serverContext->numberControlConnections];
+        connection->socket = controlConnection;
+        connection->length = 0;
+        serverContext->numberControlConnections += 1;
+    }
+}
+
+/**
+ * @brief Lit la commande d'une connexion de contrôle, et l'exécute une fois complète.
+ *
+ * La commande est complète au premier retour à la ligne ou à la fermeture de la connexion par l'outil. La réponse
+ * est alors envoyée et la connexion fermée.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ * @param index L'indice de la connexion dans serverContext->controlConnections.
+ */
+void readControlConnection(ServerContext *serverContext, int index) {
+    ControlConnection *connection = &serverContext->controlConnections[index];
+    size_t available = CONTROL_BUFFER_SIZE - 1 - connection->length;
+    ssize_t bytesReceived = read(connection->socket, connection->buffer + connection->length, available);
+
+    if (bytesReceived == -1 && (errno == EAGAIN || errno == EINTR)) {
+        return;
+    }
+
+    if (bytesReceived > 0) {
+        connection->length += bytesReceived;
+    }
+
+    connection->buffer[connection->length] = '\0';
+    char *end = strchr(connection->buffer, '\n');
+    bool closed = bytesReceived <= 0;
+    bool full = connection->length == CONTROL_BUFFER_SIZE - 1;
+
+    if (!end && !closed && !full) {
+        return;
+    }
+
+    static char reply[CONTROL_REPLY_SIZE];
+    reply[0] = '\0';
+
+    if (end || (closed && connection->length > 0)) {
+        if (end) {
+            *end = '\0';
+        }
+        executeControlCommand(serverContext, connection->buffer, reply, sizeof(reply));
+    } else if (full) {
+        snprintf(reply, sizeof(reply), "error commande trop longue (%d octets max)\n", CONTROL_BUFFER_SIZE - 2);
+    }
+
+    // La réponse tient dans le tampon du socket Unix : une écriture partielle n'est pas attendue, et un outil déjà
+    // parti ne doit pas tuer le serveur par SIGPIPE
+    if (reply[0] != '\0' && send(connection->socket, reply, strlen(reply), MSG_NOSIGNAL) == -1) {
+        printMessage(WARNING, "La réponse à une commande de contrôle n'a pas pu être envoyée.\n");
+    }
+
+    close(connection->socket);
+    serverContext->numberControlConnections -= 1;
+    serverContext->controlConnections[index] = serverContext->controlConnections[serverContext->numberControlConnections];
+}
+
+/**
+ * @brief Ouvre le thread recevant les logs d'un processus de service.
+ *
+ * @param sharedResources Pointeur vers les ressources partagées.
+ * @param childProcessId Le PID du processus de service.
+ * @param thread Reçoit l'identifiant du thread.
+ * @return bool true si le thread a été créé.
+ */
+bool startClientLogsThread(SharedResources *sharedResources, pid_t childProcessId, pthread_t *thread) {
+    LogThreadInfo *logThreadInfo = slabAlloc(getSessionPool());
+    if (logThreadInfo == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+
+    logThreadInfo->logsQueueId = sharedResources->logsQueueId;
+    logThreadInfo->childProcessId = childProcessId;
+
+    if (pthread_create(thread, NULL, clientInfoLogsThread, logThreadInfo) != 0) {
+        printMessage(ERROR, "Erreur lors de la création du thread de logs.\n");
+        slabFree(getSessionPool(), logThreadInfo);
+        return false;
+    }
+
+    char *logFilePath = getClientInfoFilepath(childProcessId);
+    printMessage(SUCCESS, "Le thread de log a bien été ouvert, visionner les logs via la commande suivante dans un autre terminal: \n");
+    printf("tail -f \"%s\"\n\n", logFilePath ? logFilePath : "");
+    releaseFilePath(logFilePath);
+
+    return true;
+}
+
+/**
+ * @brief Ouvre les threads du processus principal : logs globaux, métriques, registre des repas, compactage, cœur de
+ * la table et logs de chaque client connu.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ */
+void startServerThreads(ServerContext *serverContext) {
+    SharedResources *sharedResources = serverContext->sharedResources;
+
+    // Ouverture d'un thread pour accueillir les log globaux
+    if (pthread_create(&serverContext->serverStateThread, NULL, serverStateLogsThread, &sharedResources->logsQueueId) != 0) {
+        printMessage(ERROR, "Erreur lors de la création du thread de logs principal.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    char *serverStateLogsFilePath = getServerStateFilePath();
+    printMessage(SUCCESS, "Le thread des logs du serveur a bien été ouvert, visionner les logs via la commande suivante dans un autre terminal: \n");
+    printf("tail -f \"%s\"\n\n", serverStateLogsFilePath ? serverStateLogsFilePath : "");
+    releaseFilePath(serverStateLogsFilePath);
+
+    // Ouverture d'un thread pour échantillonner les métriques
+    if (pthread_create(&serverContext->metricsThread, NULL, metricsSamplerThread, sharedResources) != 0) {
+        printMessage(ERROR, "Erreur lors de la création du thread des métriques.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Ouverture du registre des repas et de son thread d'écriture
+    startLedger(serverContext);
+
+    // Ouverture d'un thread pour compacter les places quittées
+    if (pthread_create(&serverContext->compactionThread, NULL, compactionThread, sharedResources) != 0) {
+        printMessage(ERROR, "Erreur lors de la création du thread de compactage.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Ouverture du cœur de la table (politique `sequenced`) et de ses consommateurs
+    startTableCore(serverContext);
+
+    // Clients déjà connectés, repris lors d'une mise à jour à chaud
+    for (size_t i = 0; i < serverContext->numberClients; i++) {
+        startClientLogsThread(sharedResources, serverContext->clientsProcessIds[i], &serverContext->clientsLogsThreads[i]);
+    }
+}
+
+/**
+ * @brief Arrête les threads du processus principal.
+ *
+ * Les threads ne sont annulables que pendant leurs attentes : aucun message de log reçu n'est perdu, et ceux encore
+ * dans la file seront lus par le binaire suivant.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ */
+void stopServerThreads(ServerContext *serverContext) {
+    pthread_cancel(serverContext->serverStateThread);
+    pthread_cancel(serverContext->metricsThread);
+    pthread_cancel(serverContext->compactionThread);
+    pthread_cancel(serverContext->tableCoreThread);
+
+    for (int consumer = 0; consumer < TABLE_CONSUMERS; consumer++) {
+        pthread_cancel(serverContext->tableConsumers[consumer].thread);
+    }
+
+    if (serverContext->sharedResources->ledger.enabled) {
+        pthread_cancel(serverContext->ledgerThread);
+    }
+
+    for (size_t i = 0; i < serverContext->numberClients; i++) {
+        pthread_cancel(serverContext->clientsLogsThreads[i]);
+    }
+
+    pthread_join(serverContext->serverStateThread, NULL);
+    pthread_join(serverContext->metricsThread, NULL);
+    pthread_join(serverContext->compactionThread, NULL);
+    pthread_join(serverContext->tableCoreThread, NULL);
+
+    for (int consumer = 0; consumer < TABLE_CONSUMERS; consumer++) {
+        pthread_join(serverContext->tableConsumers[consumer].thread, NULL);
+    }
+
+    if (serverContext->sharedResources->ledger.enabled) {
+        pthread_join(serverContext->ledgerThread, NULL);
+    }
+
+    for (size_t i = 0; i < serverContext->numberClients; i++) {
+        pthread_join(serverContext->clientsLogsThreads[i], NULL);
+    }
+}
+
+/**
+ * @brief Met à jour le serveur à chaud vers le binaire demandé par le socket de contrôle.
+ *
+ * Le processus principal remplace son binaire par exec() : il garde son PID, donc ses processus de service, qui
+ * continuent de servir les philosophes pendant la bascule, et les signaux qu'ils lui envoient. Le socket d'écoute,
+ * le socket de contrôle et les copies des sockets de service restent ouverts ; les connexions qui arrivent pendant
+ * la bascule attendent dans la file du socket d'écoute. Leur liste est transmise au nouveau binaire par un tube
+ * (voir Upgrade.h), avec un descripteur de l'ancien binaire pour y revenir si le nouveau ne peut pas reprendre la
+ * table. La mémoire partagée et la file des logs ne sont pas touchées.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ *
+ * @note Ne retourne qu'en cas d'échec, après avoir relancé les threads : le serveur continue avec l'ancien binaire.
+ */
+void upgradeServer(ServerContext *serverContext) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s", serverContext->upgradePath);
+    serverContext->upgradePath[0] = '\0';
+
+    printMessage(INFO, "Mise à jour à chaud vers %s...\n", path);
+    logServerState(serverContext->sharedResources->logsQueueId, "Mise à jour à chaud du serveur vers %s\n", path);
+
+    stopServerThreads(serverContext);
+
+    // Ouvert sans O_CLOEXEC : le nouveau binaire doit pouvoir y revenir
+    int previousBinary = open("/proc/self/exe", O_RDONLY);
+
+    if (serverContext->controlSocket != -1) {
+        setDescriptorInheritable(serverContext->controlSocket, true);
+    }
+
+    int stateFd = writeUpgradeState(serverContext, previousBinary);
+
+    // Ce qui reste dans le tampon de la sortie standard serait perdu par exec()
+    fflush(stdout);
+    // Un échantillon en attente reste bloqué jusqu'à ce que le nouveau binaire ait installé son handler
+    setProfilerSignalBlocked(true);
+
+    if (stateFd != -1) {
+        execUpgrade(path, -1, stateFd);
+        close(stateFd);
+    }
+
+    setProfilerSignalBlocked(false);
+
+    printMessage(ERROR, "La mise à jour à chaud a échoué, le serveur continue avec le binaire actuel.\n");
+    perror("exec");
+
+    if (previousBinary != -1) {
+        close(previousBinary);
+    }
+
+    if (serverContext->controlSocket != -1) {
+        setDescriptorInheritable(serverContext->controlSocket, false);
+    }
+
+    startServerThreads(serverContext);
+}
+
+/**
+ * @brief Crée une nouvelle table : mémoire partagée, socket d'écoute et file des logs.
+ *
+ * Le segment est seulement réservé (SHM_NORESERVE, aucune page touchée) : le démarrage prend le même temps quelle
+ * que soit MAX_PHILOSOPHERS, et chaque place est initialisée à l'arrivée de son philosophe. Si la préallocation est
+ * demandée (PREALLOCATE_ARGUMENT), toutes les places sont initialisées dès maintenant, en parallèle.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur, complété par la fonction.
+ * @param preallocate true pour initialiser toutes les places au démarrage.
+ */
+void createTable(ServerContext *serverContext, bool preallocate) {
+    // Initialisation de la mémoire partagée, avec une clé nommée pour que les outils d'observation puissent s'y attacher
+    key_t sharedResourcesKey = getSharedResourcesKey();
+
+    if (sharedResourcesKey == -1) {
+        printMessage(ERROR, "Impossible de générer la clé de la mémoire partagée (le serveur doit être lancé depuis le dossier src).\n");
+        perror("ftok");
+        exit(EXIT_FAILURE);
+    }
+
+    // 0600 car seul l'utilisateur du serveur peut lire et écrire dans le segment, IPC_EXCL pour ne pas reprendre l'état d'un ancien serveur
+    // SHM_NORESERVE : pas de réservation d'espace d'échange, les pages ne sont comptées qu'une fois touchées
+    int sharedResourcesMemoryId = shmget(sharedResourcesKey, sizeof(SharedResources), IPC_CREAT | IPC_EXCL | SHM_NORESERVE | 0600);
+
+    if (sharedResourcesMemoryId == -1) {
+        printMessage(ERROR, "Erreur lors de la création de la mémoire partagé.\n");
+        perror("shmget");
+
+        if (errno == EEXIST) {
+            printMessage(WARNING, "Un segment existe déjà pour cette clé (serveur déjà lancé ou arrêté brutalement), le supprimer avec : ipcrm -M 0x%x\n", (unsigned int) sharedResourcesKey);
+        }
+
+        exit(EXIT_FAILURE);
+    }
+
+    // Attachement de la mémoire partagée
+    SharedResources *sharedResources = attachSharedResources(sharedResourcesMemoryId); 
+
+    if (preallocate) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int numberThreads = preallocateSharedResources(sharedResources);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        printMessage(
+            INFO, "%d places préallouées en %.1f ms (%d thread(s)).\n", MAX_PHILOSOPHERS,
+            (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6, numberThreads
+        );
     }
     
+    int serverSocket = getSocket();
+    struct sockaddr_in socketAddress = getSocketAddress();
+
+    if (bind(serverSocket, (struct sockaddr *) &socketAddress, sizeof(socketAddress)) == -1) {
+        printMessage(ERROR, "L'adresse n'a pas pu être associée au socket.\n");
+        perror("bind");
+        exit(EXIT_FAILURE);
+    }
+
+    printMessage(SUCCESS, "Socket initialisé avec succès !\n\n");
+
+    if (listen(serverSocket, 3) == -1) {
+        printMessage(ERROR, "Le serveur a échoué à se mettre en écoute.\n");
+        perror("bind");
+        exit(EXIT_FAILURE);
+    }
+
+    // Le socket serveur est surveillé par poll() : accept() ne doit pas bloquer si la connexion a déjà disparu
+    fcntl(serverSocket, F_SETFL, fcntl(serverSocket, F_GETFL) | O_NONBLOCK);
+
+    // Création de la file de message pour accueillir les logs
+    sharedResources->logsQueueId = initLogsQueue();
+
+    serverContext->serverSocket = serverSocket;
+    serverContext->sharedResourcesMemoryId = sharedResourcesMemoryId;
+    serverContext->sharedResources = sharedResources;
+}
+
+/**
+ * @brief Reprend la table d'un serveur mis à jour à chaud.
+ *
+ * L'état transmis par l'ancien binaire (voir Upgrade.h) est relu, puis la mémoire partagée est retrouvée par sa clé
+ * nommée, sans être réinitialisée, et attachée à l'adresse qu'elle avait dans l'ancien binaire. Si ce binaire ne peut
+ * pas reprendre la table (segment introuvable, adresse déjà occupée ou structure différente), l'ancien binaire est
+ * relancé avec le même état.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur, complété par la fonction.
+ * @param stateFd Le descripteur de l'état transmis.
+ */
+void resumeTable(ServerContext *serverContext, int stateFd) {
+    int previousBinary;
+
+    if (!readUpgradeState(stateFd, serverContext, &previousBinary)) {
+        printMessage(ERROR, "L'état transmis par l'ancien binaire est incomplet, la table ne peut pas être reprise.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    SharedResources *segment = serverContext->sharedResources;
+    serverContext->sharedResources = reattachSharedResources(&serverContext->sharedResourcesMemoryId, segment);
+
+    if (serverContext->sharedResources == NULL) {
+        printMessage(ERROR, "La mémoire partagée est introuvable, ne peut pas être attachée à l'adresse %p ou a une autre structure, retour à l'ancien binaire.\n", (void *) segment);
+        serverContext->sharedResources = segment;
+
+        if (previousBinary != -1) {
+            if (serverContext->controlSocket != -1) {
+                setDescriptorInheritable(serverContext->controlSocket, true);
+            }
+
+            // Sans descripteur de binaire cette fois : si l'ancien binaire échoue aussi, il s'arrête
+            int rollbackStateFd = writeUpgradeState(serverContext, -1);
+            fflush(stdout);
+
+            if (rollbackStateFd != -1) {
+                execUpgrade(serverContext->executablePath, previousBinary, rollbackStateFd);
+            }
+        }
+
+        perror("exec");
+        exit(EXIT_FAILURE);
+    }
+
+    if (previousBinary != -1) {
+        close(previousBinary);
+    }
+
+    printMessage(
+        SUCCESS,
+        "Table reprise après mise à jour à chaud : %zu processus de service, %d philosophe(s) à table.\n\n",
+        serverContext->numberClients,
+        serverContext->sharedResources->numberSeated
+    );
+}
+
+/**
+ * @brief Prépare un processus de service tout juste créé par fork().
+ *
+ * Le processus fils ne surveille ni les signaux ni le socket de contrôle du père, et ne garde pas ouvertes
+ * les connexions des autres clients : elles doivent se fermer dès que leur propre processus se termine.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ * @param previousMask Masque des signaux à restaurer dans le processus de service.
+ */
+void prepareServiceProcess(ServerContext *serverContext, const sigset_t *previousMask) {
+    pthread_sigmask(SIG_SETMASK, previousMask, NULL);
+    for (int i = 0; i < serverContext->numberServiceSockets; i++) {
+        close(serverContext->serviceSockets[i]);
+    }
+    close(serverContext->signalFd);
+    close(serverContext->controlSocket);
+    for (int i = 0; i < serverContext->numberControlConnections; i++) {
+        close(serverContext->controlConnections[i].socket);
+    }
+}
+
+/**
+ * @brief Lance le service datagramme, qui sert les philosophes en mode datagramme (voir DatagramService.c).
+ *
+ * Le service est un processus de service comme les autres : il a son thread de logs, et le processus principal
+ * garde une copie de son socket. Si le socket UDP ne peut pas être ouvert, le serveur fonctionne sans mode datagramme.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ * @param previousMask Masque des signaux à restaurer dans le processus de service.
+ */
+void startDatagramService(ServerContext *serverContext, const sigset_t *previousMask) {
+    SharedResources *sharedResources = serverContext->sharedResources;
+    int datagramSocket = openDatagramSocket();
+
+    if (datagramSocket == -1) {
+        printMessage(WARNING, "Le socket du mode datagramme n'a pas pu être ouvert, seul le mode TCP est disponible.\n");
+        perror("udp");
+        return;
+    }
+
+    int childProcessId;
+
+    if ((childProcessId = fork()) == -1) {
+        printMessage(ERROR, "Le serveur n'a pas pu créer le processus du service datagramme.\n");
+        perror("fork");
+        close(datagramSocket);
+        return;
+    }
+
+    if (childProcessId == 0) {
+        prepareServiceProcess(serverContext, previousMask);
+        startProfiler(&sharedResources->profiler, "datagram");
+        datagramService(datagramSocket, sharedResources);
+        exit(EXIT_SUCCESS);
+    }
+
+    char *logFilePath = getClientInfoFilepath(childProcessId);
+    FILE *logFile = logFilePath ? fopen(logFilePath, "w") : NULL;
+    releaseFilePath(logFilePath);
+
+    if (logFile) {
+        fclose(logFile);
+    }
+
+    if (!startClientLogsThread(sharedResources, childProcessId, &serverContext->clientsLogsThreads[serverContext->numberClients])) {
+        kill(childProcessId, SIGKILL);
+        close(datagramSocket);
+        return;
+    }
+
+    serverContext->serviceSockets[serverContext->numberServiceSockets] = datagramSocket;
+    serverContext->clientsProcessIds[serverContext->numberClients] = childProcessId;
+    serverContext->numberServiceSockets += 1;
+    serverContext->numberClients += 1;
+    serverContext->datagramProcessId = childProcessId;
+
+    printMessage(SUCCESS, "Service datagramme ouvert sur le port UDP %d (client : ./client %s).\n\n", PORT, DATAGRAM_OPTION);
+}
+
+/**
+ * @brief Accepte une connexion client et crée son processus de service.
+ *
+ * Le socket serveur est non bloquant : si la connexion signalée par poll() a déjà disparu, la fonction ne fait rien.
+ * Lorsque MAX_SERVICE_PROCESSES processus de service sont ouverts, la connexion est fermée aussitôt.
+ *
+ * Pour chaque connexion acceptée :
+ * - un processus fils est créé pour traiter les requêtes du client (via clientProcess()),
+ * - le processus parent crée un thread dédié pour gérer les logs spécifiques au client.
+ *
+ * @param serverContext Pointeur vers le contexte du serveur.
+ * @param previousMask Masque des signaux à restaurer dans le processus de service.
+ * @return bool false si le serveur doit s'arrêter.
+ */
+bool acceptClient(ServerContext *serverContext, const sigset_t *previousMask) {
+    SharedResources *sharedResources = serverContext->sharedResources;
+    int serviceSocket;
+    struct sockaddr clientAddress;
+    socklen_t clientAddressLength = sizeof(clientAddress);
+
+    // Ici on peut tenter d'accepter d'autres demandes de connexions, pas besoin de tout fermer
+    if ((serviceSocket = accept(serverContext->serverSocket, &clientAddress, &clientAddressLength)) == -1) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            printMessage(ERROR, "Le serveur a abdonné une connexion.\n");
+            perror("accept");
+        }
+        return true;
+    }
+
+    if (serverContext->numberClients >= MAX_SERVICE_PROCESSES) {
+        printMessage(WARNING, "Connexion refusée : %d processus de service sont déjà ouverts.\n", MAX_SERVICE_PROCESSES);
+        close(serviceSocket);
+        return true;
+    }
+
+    printMessage(SUCCESS, "Connexion de client reçue et acceptée ! \n\n");
+
+    int childProcessId;
+
+    if ((childProcessId = fork()) == -1) {
+        printMessage(ERROR, "Le serveur n'a pas pu créer le processus fils pour le client.\n");
+        perror("fork");
+        close(serviceSocket);
+        return true;
+    }
+
+    if (childProcessId == 0) {
+        prepareServiceProcess(serverContext, previousMask);
+        startProfiler(&sharedResources->profiler, "service");
+        clientProcess(serviceSocket, sharedResources);
+        // Le processus fils ne doit pas process la boucle du père
+        exit(EXIT_SUCCESS);
+    }
+            
+    // Le fichier de logs du client est vidé à sa connexion
+    char *logFilePath = getClientInfoFilepath(childProcessId);
+    FILE *logFile = logFilePath ? fopen(logFilePath, "w") : NULL;
+    releaseFilePath(logFilePath);
+
+    if (logFile) {
+        fclose(logFile);
+    }
+
+    // S'il échoue, on ferme la connexion et on annule
+    if (!startClientLogsThread(sharedResources, childProcessId, &serverContext->clientsLogsThreads[serverContext->numberClients])) {
+        close(serviceSocket);
+        return false;
+    }
+
+    serverContext->serviceSockets[serverContext->numberServiceSockets] = serviceSocket;
+    serverContext->clientsProcessIds[serverContext->numberClients] = childProcessId;
+    serverContext->numberServiceSockets += 1;
+    serverContext->numberClients += 1;
+
+    printMessage(INFO, "En écoute sur le socket de service...\n");
+    return true;
+}
+
+/**
+ * @brief Fonction principale du serveur.
+ *
+ * La fonction main :
+ * - initialise les signaux de fin, 
+ * - crée la mémoire partagée,
+ * - configure le socket serveur 
+ * - configure la file de messages pour les logs
+ * - centralise les ressources dans un ServerContext 
+ * - lance ensuite un thread pour la gestion globale des logs du serveur
+ * - ouvre le socket de contrôle
+ * - lance le service datagramme, sauf s'il a été repris
+ * - entre dans une boucle d'événements (poll()) qui surveille, sans jamais bloquer sur l'un d'eux : le descripteur
+ *   des signaux, le socket serveur (connexions clients, voir acceptClient()), le socket de contrôle et les connexions
+ *   de contrôle en cours de lecture.
+ * 
+ * En cas d'arrêt (shutdownFlag activé),
+ * le serveur procède au nettoyage global des ressources avant de terminer.
+ *
+ * @param argc Nombre d'arguments en ligne de commande.
+ * @param argv Tableau des arguments en ligne de commande.
+ * @return int Code de sortie (0 en cas de succès).
+ */
+int main(int argc, char *argv[]) {
+
+    // Avant la création des threads, qui héritent du masque des signaux
+    sigset_t previousMask;
+    int signalFd = initEndSignals(&previousMask);
+
+    if (MAX_PHILOSOPHERS > FOPEN_MAX) {
+        printMessage(
+            WARNING,
+            "Un fichier de log par client (thread) sera ouvert par la processus principal, le programme permet d'en créer %d max, et votre système permet l'ouverture de %d max. \n",
+            MAX_PHILOSOPHERS,
+            FOPEN_MAX
+        );
+    }
+
+    // Mise en contexte de toutes les ressources pour centraliser la gestion de la mémoire en cas de panne
+    // Statique : ses tableaux par processus de service ne tiendraient pas sur la pile pour les très grandes tables
+    static ServerContext serverContext;
+    initServerContext(&serverContext);
+    serverContext.signalFd = signalFd;
+
+    bool upgrading = argc == 3 && strcmp(argv[1], UPGRADE_ARGUMENT) == 0;
+
+    if (upgrading) {
+        resumeTable(&serverContext, atoi(argv[2]));
+    } else {
+        createTable(&serverContext, argc == 2 && strcmp(argv[1], PREALLOCATE_ARGUMENT) == 0);
+
+        // Chemin absolu : le binaire peut être recompilé au même endroit avant une mise à jour à chaud
+        if (!realpath(argv[0], serverContext.executablePath)) {
+            snprintf(serverContext.executablePath, sizeof(serverContext.executablePath), "%s", argv[0]);
+        }
+    }
+
+    SharedResources *sharedResources = serverContext.sharedResources;
+
+    // Le niveau de logs est réglable depuis le socket de contrôle, pour tous les processus
+    setLogLevelSource(&sharedResources->logLevel);
+    setAllocationStatsSource(&sharedResources->allocations);
+    // L'horloge étalonnée à la création de la table est commune à tous les processus, mise à jour à chaud comprise
+    setClockSource(&sharedResources->clock);
+    // Avant les processus de service, qui héritent du réglage et rendent leur case de compteurs à leur sortie
+    setPerfCountersSource(&sharedResources->perf);
+    setRequestSpanSource(&sharedResources->spans);
+    // Avant les threads, qui s'enregistrent auprès du profileur à leur lancement
+    startProfiler(&sharedResources->profiler, "server");
+
+    startServerThreads(&serverContext);
+
+    if (!upgrading) {
+        logServerState(sharedResources->logsQueueId, "Adresse mémoire partagée : %p\n", sharedResources);
+        logServerState(sharedResources->logsQueueId, "Adresse baguettes : %p\n", sharedResources->chopsticks);
+    }
+
+    // Ouverture du socket de contrôle (sauf s'il a été repris), le serveur peut fonctionner sans
+    if (serverContext.controlSocket == -1) {
+        serverContext.controlSocket = openControlSocket();
+    }
+
+    if (serverContext.controlSocket == -1) {
+        printMessage(WARNING, "Le socket de contrôle %s n'a pas pu être ouvert.\n", CONTROL_SOCKET_PATH);
+        perror("control");
+    } else {
+        printMessage(SUCCESS, "Socket de contrôle ouvert, envoyer des commandes avec : ./control help\n\n");
+    }
+
+    // Après une mise à jour à chaud, le service datagramme déjà lancé continue de servir ses philosophes
+    if (serverContext.datagramProcessId == 0) {
+        startDatagramService(&serverContext, &previousMask);
+    }
+
+    printMessage(INFO, "En écoute sur le socket de service...\n");
+
+    struct pollfd events[3 + CONTROL_MAX_CONNECTIONS];
+
+    while (!shutdownFlag) {
+        int numberControlConnections = serverContext.numberControlConnections;
+
+        events[0] = (struct pollfd) { .fd = serverContext.signalFd, .events = POLLIN };
+        events[1] = (struct pollfd) { .fd = serverContext.serverSocket, .events = POLLIN };
+        // Un descripteur négatif est ignoré par poll() : plus d'acceptation tant que les connexions sont toutes occupées
+        events[2] = (struct pollfd) {
+            .fd = numberControlConnections < CONTROL_MAX_CONNECTIONS ? serverContext.controlSocket : -1,
+            .events = POLLIN
+        };
+
+        for (int i = 0; i < numberControlConnections; i++) {
+            events[3 + i] = (struct pollfd) { .fd = serverContext.controlConnections[i].socket, .events = POLLIN };
+        }
+
+        if (poll(events, 3 + numberControlConnections, -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll");
+            break;
+        }
+
+        if (events[0].revents) {
+            handleSignals(&serverContext);
+        }
+
+        // En partant de la fin : une connexion terminée est remplacée par la dernière, déjà traitée
+        for (int i = numberControlConnections - 1; i >= 0; i--) {
+            if (events[3 + i].revents) {
+                readControlConnection(&serverContext, i);
+            }
+        }
+
+        if (events[2].revents) {
+            acceptControlConnections(&serverContext);
+        }
+
+        if (events[1].revents && !shutdownFlag && !acceptClient(&serverContext, &previousMask)) {
+            break;
+        }
+
+        if (serverContext.upgradePath[0] != '\0' && !shutdownFlag) {
+            upgradeServer(&serverContext);
+        }
+    }
+    
+    // Les threads des métriques, du registre, du compactage et du cœur lisent la mémoire partagée : ils doivent s'arrêter avant qu'elle soit détachée
+    pthread_join(serverContext.metricsThread, NULL);
+    pthread_join(serverContext.compactionThread, NULL);
+    pthread_join(serverContext.tableCoreThread, NULL);
+
+    for (int consumer = 0; consumer < TABLE_CONSUMERS; consumer++) {
+        pthread_join(serverContext.tableConsumers[consumer].thread, NULL);
+    }
+
+    if (serverContext.sharedResources->ledger.enabled) {
+        pthread_join(serverContext.ledgerThread, NULL);
+    }
+
     // On procède au nettoyage global avant de quitter
     cleanup(&serverContext);
     printMessage(INFO, "Fin du process serveur principal.\n");
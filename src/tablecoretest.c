@@ -0,0 +1,174 @@
+/**
+ * @file tablecoretest.c
+ * @brief Test du cœur de la table (politique `sequenced`) face à un consommateur en retard.
+ *
+ * Le consommateur des journaux envoie ses messages de façon bloquante : il peut prendre TABLE_EVENT_RING_SIZE
+ * événements de retard, et les producteurs attendent alors une case libre. Le cœur ne doit pas les prendre pour des
+ * producteurs morts : une séquence sautée écraserait une case que le consommateur n'a pas encore lue, et l'événement
+ * du producteur serait perdu.
+ *
+ * Le test fait tourner le cœur sur une table en mémoire privée, bloque le consommateur des journaux plus longtemps
+ * que TABLE_EVENT_HOLE_TIMEOUT_MS pendant que plusieurs producteurs remplissent l'anneau, puis le libère. Les deux
+ * autres consommateurs suivent le cœur. Le test vérifie que tous les événements publiés sont appliqués, sans
+ * séquence sautée.
+ *
+ * Le code de sortie est 1 si un événement est perdu ou si le cœur n'a pas tout appliqué dans le délai imparti.
+ *
+ * Compilation : `gcc tablecoretest.c -o tablecoretest -lpthread -lm -lrt`
+ */
+
+#include "../include/utils/print_message.h"
+#include "../include/entities/TableCore.h"
+#include "../include/entities/SharedResources.h"
+#include "../include/managers/TableCore.c"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+/**
+ * @brief Nombre de producteurs et d'événements publiés par chacun (bien plus que la taille de l'anneau).
+ */
+#define TEST_PRODUCERS 4
+#define TEST_EVENTS_PER_PRODUCER (2 * TABLE_EVENT_RING_SIZE)
+
+/**
+ * @brief Durée du blocage du consommateur des journaux, en millisecondes.
+ */
+#define TEST_STALL_MS (3 * TABLE_EVENT_HOLE_TIMEOUT_MS)
+
+/**
+ * @brief Délai maximal laissé aux producteurs et au cœur pour tout publier et appliquer après le blocage, en
+ * millisecondes. Un événement perdu bloque les producteurs, qui attendent une case que le cœur ne libère plus.
+ */
+#define TEST_DRAIN_MS 10000
+
+static SharedResources *sharedResources;
+static volatile bool stopping = false;
+static volatile bool logsStalled = true;
+static int finishedProducers = 0;
+
+/**
+ * @brief Publie les événements d'un producteur.
+ *
+ * Des arrivées à table : le cœur les applique sans toucher aux places ni aux baguettes.
+ *
+ * @param arg L'indice du producteur.
+ * @return void* NULL.
+ */
+void *producerThread(void *arg) {
+    int philosopherId = 1 + (int) (long) arg;
+
+    for (int i = 0; i < TEST_EVENTS_PER_PRODUCER; i++) {
+        publishTableEvent(&sharedResources->tableCore, TABLE_EVENT_JOIN, philosopherId);
+    }
+
+    __atomic_fetch_add(&finishedProducers, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/**
+ * @brief Fait tourner le cœur, comme tableCoreThread() dans le serveur.
+ *
+ * @param arg Inutilisé.
+ * @return void* NULL.
+ */
+void *coreThread(void *arg) {
+    (void) arg;
+
+    while (!stopping) {
+        if (!applyTableEvents(sharedResources)) {
+            usleep(1000);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Suit le cœur pour un consommateur ; celui des journaux reste bloqué tant que logsStalled est vrai.
+ *
+ * @param arg Le consommateur.
+ * @return void* NULL.
+ */
+void *consumerThread(void *arg) {
+    TableConsumer consumer = (TableConsumer) (long) arg;
+    TableCore *core = &sharedResources->tableCore;
+
+    while (!stopping) {
+        if (consumer == TABLE_CONSUMER_LOGS && logsStalled) {
+            usleep(1000);
+            continue;
+        }
+
+        uint64_t applied = __atomic_load_n(&core->appliedSequence, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&core->consumedSequences[consumer], applied, __ATOMIC_RELEASE);
+        ledgerFutexWake(&core->consumedFutex);
+        usleep(200);
+    }
+
+    return NULL;
+}
+
+int main() {
+    sharedResources = calloc(1, sizeof(SharedResources));
+
+    if (!sharedResources) {
+        printMessage(ERROR, "Impossible d'allouer la table de test\n");
+        return 1;
+    }
+
+    TableCore *core = &sharedResources->tableCore;
+    pthread_t producers[TEST_PRODUCERS];
+    pthread_t consumers[TABLE_CONSUMERS];
+    pthread_t coreId;
+
+    pthread_create(&coreId, NULL, coreThread, NULL);
+
+    for (long consumer = 0; consumer < TABLE_CONSUMERS; consumer++) {
+        pthread_create(&consumers[consumer], NULL, consumerThread, (void *) consumer);
+    }
+
+    for (long producer = 0; producer < TEST_PRODUCERS; producer++) {
+        pthread_create(&producers[producer], NULL, producerThread, (void *) producer);
+    }
+
+    usleep(TEST_STALL_MS * 1000);
+    logsStalled = false;
+
+    uint64_t deadline = getMonotonicTime() + (uint64_t) TEST_DRAIN_MS * 1000000;
+
+    while (getMonotonicTime() < deadline
+           && (__atomic_load_n(&finishedProducers, __ATOMIC_ACQUIRE) < TEST_PRODUCERS
+               || __atomic_load_n(&core->appliedSequence, __ATOMIC_ACQUIRE)
+                  < __atomic_load_n(&core->nextSequence, __ATOMIC_ACQUIRE))) {
+        usleep(1000);
+    }
+
+    uint64_t published = __atomic_load_n(&core->nextSequence, __ATOMIC_ACQUIRE);
+    bool drained = __atomic_load_n(&finishedProducers, __ATOMIC_ACQUIRE) == TEST_PRODUCERS;
+    stopping = true;
+    pthread_join(coreId, NULL);
+
+    for (int consumer = 0; consumer < TABLE_CONSUMERS; consumer++) {
+        pthread_join(consumers[consumer], NULL);
+    }
+
+    // Des producteurs bloqués ne se termineront pas : ils ne sont rejoints que si tous ont fini
+    for (int producer = 0; drained && producer < TEST_PRODUCERS; producer++) {
+        pthread_join(producers[producer], NULL);
+    }
+
+    printf("Publiés : %lu, appliqués : %lu, sautés : %lu\n", (unsigned long) published,
+           (unsigned long) core->appliedEvents, (unsigned long) core->holes);
+
+    bool passed = drained && core->appliedEvents == (uint64_t) TEST_PRODUCERS * TEST_EVENTS_PER_PRODUCER && core->holes == 0;
+    printMessage(passed ? SUCCESS : ERROR, passed ? "Aucun événement perdu\n" : "Des événements ont été perdus\n");
+
+    if (drained) {
+        free(sharedResources);
+    }
+
+    return passed ? 0 : 1;
+}
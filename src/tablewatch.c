@@ -0,0 +1,260 @@
+/**
+ * @file tablewatch.c
+ * @brief Outil d'abonnement aux changements d'état de la table, et d'instantané de la table.
+ *
+ * L'outil se connecte au port du serveur comme un client, mais envoie une requête REQUEST_WATCH au lieu de créer un
+ * philosophe : le serveur lui envoie alors des lots de changements d'état (voir Watch.h), que l'outil affiche au
+ * fil de l'eau. Contrairement au tableau de bord, l'outil n'a pas besoin d'être sur la machine du serveur.
+ *
+ * Utilisation : `tablewatch [table | seat <philosophe> | neighbours <philosophe>] [-r fréquence]`
+ *             ou `tablewatch snapshot`
+ *  - `table` (par défaut) : toutes les places.
+ *  - `seat <philosophe>` : une seule place.
+ *  - `neighbours <philosophe>` : une place et ses deux voisins.
+ *  - `-r` : nombre maximum de lots par seconde, entre 1 et WATCH_MAX_RATE (par défaut WATCH_DEFAULT_RATE).
+ *  - `snapshot` : demande un seul instantané de toute la table (REQUEST_SNAPSHOT, voir Snapshot.h), l'affiche et
+ *    se termine.
+ *
+ * Chaque lot est affiché sur une ligne : son numéro, le nombre de changements fusionnés, puis le dernier état de
+ * chaque place modifiée. L'outil s'arrête avec Ctrl+C ou lorsque le serveur coupe la connexion.
+ *
+ * Compilation : `gcc tablewatch.c -o tablewatch`
+ */
+
+#include "../include/maxmin_philosophers.h"
+#include "../include/utils/print_message.h"
+#include "../include/utils/sockets.h"
+#include "../include/entities/Watch.h"
+#include "../include/entities/Snapshot.h"
+#include "../include/entities/SharedResources.h"
+#include "../include/managers/Request.c"
+#include "../include/managers/Response.c"
+#include "../include/managers/Snapshot.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/socket.h>
+
+/**
+ * @brief Lit exactement un nombre d'octets depuis le socket.
+ *
+ * @param socket Le socket.
+ * @param data Le tampon de destination.
+ * @param size Le nombre d'octets à lire.
+ * @return bool false si le serveur a coupé la connexion.
+ */
+bool readExactly(int socket, void *data, size_t size) {
+    return recv(socket, data, size, MSG_WAITALL) == (ssize_t) size;
+}
+
+/**
+ * @brief Retourne le libellé affiché pour l'état d'une place.
+ *
+ * @param entry La place.
+ * @return const char* Le libellé.
+ */
+const char *getWatchStateLabel(const WatchEntry *entry) {
+    switch (entry->state) {
+        case THINKING: return "pense";
+        case HUNGRY: return "a faim";
+        case EATING: return "mange";
+        case WATCH_STATE_DEPARTED: return "parti";
+        default: return "?";
+    }
+}
+
+/**
+ * @brief Demande un instantané de la table et l'affiche.
+ *
+ * @param serverSocket Le socket connecté au serveur.
+ * @return int Code de sortie.
+ */
+int printSnapshot(int serverSocket) {
+    Request request = snapshotRequest();
+    Response response;
+    SnapshotHeader header;
+
+    if (trySocketWrite(serverSocket, &request, sizeof(request)) != sizeof(request)
+        || !readExactly(serverSocket, &response, sizeof(response))) {
+        printMessage(ERROR, "Le serveur n'a pas renvoyé d'instantané.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (response.type == RESPONSE_REFUSED) {
+        printMessage(ERROR, "Le serveur n'a pas pu prendre l'instantané, réessayez.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (response.type != RESPONSE_SNAPSHOT
+        || !readExactly(serverSocket, &header, sizeof(header))) {
+        printMessage(ERROR, "Le serveur n'a pas renvoyé d'instantané.\n");
+        return EXIT_FAILURE;
+    }
+
+    uint8_t *body = malloc(header.length + 1);
+    uint8_t *states = malloc(header.numberSeats + 1);
+    int *timers = malloc(sizeof(int) * (header.numberSeats + 1));
+    int *holders = malloc(sizeof(int) * (header.numberChopsticks + 1));
+    int *ids = malloc(sizeof(int) * (header.numberSeats + 1));
+    int *chopstickIds = malloc(sizeof(int) * (header.numberChopsticks + 1));
+
+    if (!body || !states || !timers || !holders || !ids || !chopstickIds) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+
+    bool valid = readExactly(serverSocket, body, header.length) && decodeSnapshot(&header, body, ids, chopstickIds, states, timers, holders);
+
+    if (valid) {
+        printf(
+            "Instantané %s de la version %lu (%zu octets) : politique %s, %d place(s) libre(s) au compteur\n",
+            header.consistent ? "cohérent" : "approché",
+            (unsigned long) header.tableVersion,
+            sizeof(header) + header.length,
+            header.policy == POLICY_COUNTER ? "counter" : header.policy == POLICY_ORDERED ? "ordered" : "sequenced",
+            header.admissionAvailable
+        );
+
+        for (uint32_t i = 0; i < header.numberSeats; i++) {
+            WatchEntry entry = { .state = states[i] };
+
+            // Place vide laissée par le compactage
+            if (ids[i] == 0) {
+                continue;
+            }
+            printf("  philosophe %d : %-7s timer %d\n", ids[i], getWatchStateLabel(&entry), timers[i]);
+        }
+
+        for (uint32_t i = 0; i < header.numberChopsticks; i++) {
+            if (chopstickIds[i] == 0) {
+                continue;
+            } else if (holders[i]) {
+                printf("  baguette %d : tenue par le philosophe %d\n", chopstickIds[i], holders[i]);
+            } else {
+                printf("  baguette %d : libre\n", chopstickIds[i]);
+            }
+        }
+    } else {
+        printMessage(ERROR, "Instantané tronqué ou invalide.\n");
+    }
+
+    free(body);
+    free(states);
+    free(timers);
+    free(holders);
+    free(ids);
+    free(chopstickIds);
+
+    return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Lit l'abonnement demandé dans les arguments.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments.
+ * @param subscription Reçoit l'abonnement.
+ * @return bool false si les arguments sont invalides.
+ */
+bool parseSubscription(int argc, char *argv[], WatchSubscription *subscription) {
+    *subscription = (WatchSubscription) { .scope = WATCH_TABLE, .seat = 0, .maxRate = 0 };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "table") == 0) {
+            subscription->scope = WATCH_TABLE;
+        } else if ((strcmp(argv[i], "seat") == 0 || strcmp(argv[i], "neighbours") == 0) && i + 1 < argc) {
+            subscription->scope = strcmp(argv[i], "seat") == 0 ? WATCH_SEAT : WATCH_NEIGHBOURS;
+            subscription->seat = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            subscription->maxRate = atoi(argv[++i]);
+
+            if (subscription->maxRate < 1 || subscription->maxRate > WATCH_MAX_RATE) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    return subscription->scope == WATCH_TABLE || subscription->seat >= 1;
+}
+
+/**
+ * @brief Point d'entrée de l'outil.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments : l'étendue de l'abonnement et sa fréquence.
+ * @return int Code de sortie.
+ */
+int main(int argc, char *argv[]) {
+    WatchSubscription subscription;
+    bool snapshot = argc == 2 && strcmp(argv[1], "snapshot") == 0;
+
+    if (!snapshot && !parseSubscription(argc, argv, &subscription)) {
+        printf("Utilisation : %s [table | seat <philosophe> | neighbours <philosophe>] [-r fréquence (1 à %d)] | snapshot\n", argv[0], WATCH_MAX_RATE);
+        return EXIT_FAILURE;
+    }
+
+    int serverSocket = getSocket();
+    struct sockaddr_in socketAddress = getSocketAddress();
+
+    if (serverSocket == -1 || connect(serverSocket, (struct sockaddr *) &socketAddress, sizeof(socketAddress)) == -1) {
+        printMessage(ERROR, "Une erreur est survenue lors d'une tentative de connexion au serveur.\n");
+        perror("connect");
+        return EXIT_FAILURE;
+    }
+
+    if (snapshot) {
+        int exitCode = printSnapshot(serverSocket);
+        close(serverSocket);
+        return exitCode;
+    }
+
+    Request request = watchRequest(subscription);
+    Response response;
+
+    if (trySocketWrite(serverSocket, &request, sizeof(request)) != sizeof(request) || !readExactly(serverSocket, &response, sizeof(response))) {
+        printMessage(ERROR, "Le serveur n'a pas répondu à l'abonnement.\n");
+        close(serverSocket);
+        return EXIT_FAILURE;
+    }
+
+    if (response.type != RESPONSE_WATCH) {
+        printMessage(ERROR, "Abonnement refusé par le serveur (philosophe inconnu ou serveur plein).\n");
+        close(serverSocket);
+        return EXIT_FAILURE;
+    }
+
+    printMessage(SUCCESS, "Abonnement accepté, en attente des changements...\n");
+
+    WatchBatchHeader header;
+    WatchEntry entries[MAX_PHILOSOPHERS];
+
+    while (readExactly(serverSocket, &header, sizeof(header))) {
+        if (header.count > MAX_PHILOSOPHERS || !readExactly(serverSocket, entries, sizeof(WatchEntry) * header.count)) {
+            break;
+        }
+
+        printf("#%u (%u changement(s))", header.sequence, header.coalesced);
+
+        for (int i = 0; i < header.count; i++) {
+            printf(
+                "  %u:%s%s%s [%u repas]",
+                entries[i].id,
+                getWatchStateLabel(&entries[i]),
+                entries[i].flags & WATCH_FLAG_DRAINING ? ",drain" : "",
+                entries[i].flags & WATCH_FLAG_EVICTED ? ",évincé" : "",
+                entries[i].meals
+            );
+        }
+
+        printf("\n");
+        fflush(stdout);
+    }
+
+    printMessage(INFO, "Le serveur a coupé la connexion.\n");
+    close(serverSocket);
+
+    return EXIT_SUCCESS;
+}